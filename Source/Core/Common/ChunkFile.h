@@ -21,6 +21,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -46,14 +47,33 @@ public:
     Verify,
   };
 
+  // A named range of the buffer, see DoSection().
+  struct Section
+  {
+    std::string name;
+    size_t offset;
+    size_t size;
+  };
+
+  // Receives the data serialized in measure mode, see SetHasher().
+  class Hasher
+  {
+  public:
+    virtual ~Hasher() = default;
+    virtual void Update(const void* data, size_t size) = 0;
+  };
+
 private:
   u8** m_ptr_current;
+  u8* m_ptr_start;
   u8* m_ptr_end;
   Mode m_mode;
+  std::vector<Section>* m_sections = nullptr;
+  Hasher* m_hasher = nullptr;
 
 public:
   PointerWrap(u8** ptr, size_t size, Mode mode)
-      : m_ptr_current(ptr), m_ptr_end(*ptr + size), m_mode(mode)
+      : m_ptr_current(ptr), m_ptr_start(*ptr), m_ptr_end(*ptr + size), m_mode(mode)
   {
   }
 
@@ -64,6 +84,40 @@ public:
   bool IsMeasureMode() const { return m_mode == Mode::Measure; }
   bool IsVerifyMode() const { return m_mode == Mode::Verify; }
 
+  // Offset of the current position from the start of the buffer.
+  size_t GetOffset() const
+  {
+    return reinterpret_cast<size_t>(*m_ptr_current) - reinterpret_cast<size_t>(m_ptr_start);
+  }
+
+  // If set, every DoSection() appends the range it covered to sections.
+  void SetSectionLog(std::vector<Section>* sections) { m_sections = sections; }
+
+  // If set, everything serialized in measure mode is also passed to hasher, so that state can be
+  // hashed without serializing it into a buffer first.
+  void SetHasher(Hasher* hasher) { m_hasher = hasher; }
+  bool IsHashMode() const { return IsMeasureMode() && m_hasher; }
+
+  // Runs func unless the state is being hashed. For state which only exists on the host and can
+  // differ between otherwise identical emulated states, like copies of host GPU resources.
+  template <typename Func>
+  void DoHostOnly(Func func)
+  {
+    if (!IsHashMode())
+      func();
+  }
+
+  // Runs func and records the range of the buffer it serialized under the given name. Nothing is
+  // written to the buffer for this, so sections can be added without changing the format.
+  template <typename Func>
+  void DoSection(std::string_view name, Func func)
+  {
+    const size_t offset = GetOffset();
+    func();
+    if (m_sections)
+      m_sections->push_back(Section{std::string(name), offset, GetOffset() - offset});
+  }
+
   template <typename K, class V>
   void Do(std::map<K, V>& x)
   {
@@ -362,6 +416,8 @@ private:
       break;
 
     case Mode::Measure:
+      if (m_hasher)
+        m_hasher->Update(data, size);
       break;
 
     case Mode::Verify:
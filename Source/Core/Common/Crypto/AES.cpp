@@ -31,6 +31,17 @@
 
 namespace Common::AES
 {
+bool Context::CryptMultiple(const u8* const* ivs, const u8* const* bufs_in, u8* const* bufs_out,
+                            size_t count, size_t len) const
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!Crypt(ivs ? ivs[i] : nullptr, bufs_in[i], bufs_out[i], len))
+      return false;
+  }
+  return true;
+}
+
 // For x64 and arm64, it's very unlikely a user's cpu does not support the accelerated version,
 // fallback is just in case.
 template <Mode AesMode>
@@ -250,6 +261,63 @@ public:
     return true;
   }
 
+  // Encrypts NumBuffers buffers at once. Each buffer's CBC chain is serial, but the chains of
+  // different buffers are independent, so interleaving them hides the latency of aesenc.
+  template <size_t NumBuffers>
+  ATTRIBUTE_TARGET("aes")
+  inline void EncryptInterleaved(const u8* const* ivs, const u8* const* bufs_in,
+                                 u8* const* bufs_out, size_t len) const
+  {
+    __m128i iv_block[NumBuffers];
+    for (size_t b = 0; b < NumBuffers; b++)
+    {
+      iv_block[b] =
+          ivs && ivs[b] ? _mm_loadu_si128((const __m128i*)ivs[b]) : _mm_setzero_si128();
+    }
+
+    for (size_t offset = 0; offset < len; offset += BLOCK_SIZE)
+    {
+      __m128i block[NumBuffers];
+      for (size_t b = 0; b < NumBuffers; b++)
+      {
+        block[b] = _mm_loadu_si128((const __m128i*)(bufs_in[b] + offset));
+        block[b] = _mm_xor_si128(_mm_xor_si128(block[b], iv_block[b]), round_keys[0]);
+      }
+
+      for (size_t i = 1; i < Nr; ++i)
+        for (size_t b = 0; b < NumBuffers; b++)
+          block[b] = _mm_aesenc_si128(block[b], round_keys[i]);
+
+      for (size_t b = 0; b < NumBuffers; b++)
+      {
+        block[b] = _mm_aesenclast_si128(block[b], round_keys[Nr]);
+        iv_block[b] = block[b];
+        _mm_storeu_si128((__m128i*)(bufs_out[b] + offset), block[b]);
+      }
+    }
+  }
+
+  virtual bool CryptMultiple(const u8* const* ivs, const u8* const* bufs_in, u8* const* bufs_out,
+                             size_t count, size_t len) const override
+  {
+    // Decryption is already pipelined within each buffer
+    if constexpr (AesMode == Mode::Decrypt)
+      return Context::CryptMultiple(ivs, bufs_in, bufs_out, count, len);
+
+    if (len % BLOCK_SIZE)
+      return false;
+
+    // Enough to keep the AES unit busy without running out of registers
+    constexpr size_t INTERLEAVE_DEPTH = 8;
+    size_t i = 0;
+    for (; count - i >= INTERLEAVE_DEPTH; i += INTERLEAVE_DEPTH)
+      EncryptInterleaved<INTERLEAVE_DEPTH>(ivs ? ivs + i : nullptr, bufs_in + i, bufs_out + i, len);
+    for (; i < count; ++i)
+      EncryptInterleaved<1>(ivs ? ivs + i : nullptr, bufs_in + i, bufs_out + i, len);
+
+    return true;
+  }
+
 private:
   // Ensures alignment specifiers are respected.
   struct XmmReg
@@ -384,6 +452,54 @@ public:
     return true;
   }
 
+  // See the comments on the AES-NI version.
+  template <size_t NumBuffers>
+  inline void EncryptInterleaved(const u8* const* ivs, const u8* const* bufs_in,
+                                 u8* const* bufs_out, size_t len) const
+  {
+    uint8x16_t iv_block[NumBuffers];
+    for (size_t b = 0; b < NumBuffers; b++)
+      iv_block[b] = ivs && ivs[b] ? vld1q_u8(ivs[b]) : vmovq_n_u8(0);
+
+    for (size_t offset = 0; offset < len; offset += BLOCK_SIZE)
+    {
+      uint8x16_t block[NumBuffers];
+      for (size_t b = 0; b < NumBuffers; b++)
+        block[b] = veorq_u8(vld1q_u8(bufs_in[b] + offset), iv_block[b]);
+
+      for (size_t i = 0; i < Nr - 1; ++i)
+        for (size_t b = 0; b < NumBuffers; b++)
+          block[b] = vaesmcq_u8(vaeseq_u8(block[b], round_keys[i]));
+
+      for (size_t b = 0; b < NumBuffers; b++)
+      {
+        block[b] = vaeseq_u8(block[b], round_keys[Nr - 1]);
+        block[b] = veorq_u8(block[b], round_keys[Nr]);
+        iv_block[b] = block[b];
+        vst1q_u8(bufs_out[b] + offset, block[b]);
+      }
+    }
+  }
+
+  virtual bool CryptMultiple(const u8* const* ivs, const u8* const* bufs_in, u8* const* bufs_out,
+                             size_t count, size_t len) const override
+  {
+    if constexpr (AesMode == Mode::Decrypt)
+      return Context::CryptMultiple(ivs, bufs_in, bufs_out, count, len);
+
+    if (len % BLOCK_SIZE)
+      return false;
+
+    constexpr size_t INTERLEAVE_DEPTH = 8;
+    size_t i = 0;
+    for (; count - i >= INTERLEAVE_DEPTH; i += INTERLEAVE_DEPTH)
+      EncryptInterleaved<INTERLEAVE_DEPTH>(ivs ? ivs + i : nullptr, bufs_in + i, bufs_out + i, len);
+    for (; i < count; ++i)
+      EncryptInterleaved<1>(ivs ? ivs + i : nullptr, bufs_in + i, bufs_out + i, len);
+
+    return true;
+  }
+
 private:
   std::array<uint8x16_t, NUM_ROUND_KEYS> round_keys;
 };
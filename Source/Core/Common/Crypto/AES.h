@@ -41,6 +41,12 @@ public:
   {
     return Crypt(nullptr, nullptr, buf_in, buf_out, len);
   }
+
+  // Encrypts or decrypts count independent buffers of len bytes each. ivs may be nullptr, and so
+  // may each of its elements, to use an IV of zero. Unlike one Crypt call per buffer, this lets
+  // accelerated implementations interleave the otherwise serial CBC encryption of several buffers.
+  virtual bool CryptMultiple(const u8* const* ivs, const u8* const* bufs_in, u8* const* bufs_out,
+                             size_t count, size_t len) const;
 };
 
 std::unique_ptr<Context> CreateContextEncrypt(const u8* key);
@@ -4,6 +4,8 @@
 #include "SHA1.h"
 
 #include <array>
+#include <cstring>
+#include <iterator>
 #include <memory>
 
 #include <mbedtls/sha1.h>
@@ -152,10 +154,8 @@ private:
 
 #ifdef _M_X86_64
 
-// Uses the dedicated SHA1 instructions. Normal SSE(AVX*) would be needed for parallel
-// multi-message processing. While Dolphin could gain from such implementation, it requires the
-// calling code to be modified and/or making the SHA1 implementation asynchronous so it can
-// optimistically batch.
+// Uses the dedicated SHA1 instructions. For CPUs without them, CalculateDigests can instead hash
+// several messages at once using normal SSE, see MultiBufferSSE2 below.
 class ContextX64SHA1 final : public BlockContext
 {
 public:
@@ -260,6 +260,123 @@ private:
   std::array<XmmReg, 2> state{};
 };
 
+// Hashes four messages of the same length at once, one per 32-bit lane. This only needs SSE2, but
+// is still several times faster than hashing the messages one by one in scalar code.
+class MultiBufferSSE2
+{
+public:
+  static constexpr size_t LANES = 4;
+
+  static void CalculateDigests(const u8* const msgs[LANES], size_t len, Digest* out[LANES])
+  {
+    __m128i state[5];
+    for (size_t i = 0; i < std::size(state); i++)
+      state[i] = _mm_set1_epi32(H[i]);
+
+    const size_t full_blocks = len / BLOCK_LEN;
+    for (size_t i = 0; i < full_blocks; i++)
+    {
+      const u8* blocks[LANES];
+      for (size_t lane = 0; lane < LANES; lane++)
+        blocks[lane] = msgs[lane] + i * BLOCK_LEN;
+      ProcessBlocks(state, blocks);
+    }
+
+    // The padding is the same for every lane, only the remaining message bytes differ
+    const size_t remaining = len % BLOCK_LEN;
+    const size_t tail_blocks = remaining + 1 + sizeof(u64) > BLOCK_LEN ? 2 : 1;
+    std::array<std::array<u8, BLOCK_LEN * 2>, LANES> tails{};
+    for (size_t lane = 0; lane < LANES; lane++)
+    {
+      u8* tail = tails[lane].data();
+      std::memcpy(tail, msgs[lane] + full_blocks * BLOCK_LEN, remaining);
+      tail[remaining] = 0x80;
+      const u64 len_bits = Common::swap64(static_cast<u64>(len) * 8);
+      std::memcpy(tail + tail_blocks * BLOCK_LEN - sizeof(len_bits), &len_bits, sizeof(len_bits));
+    }
+    for (size_t i = 0; i < tail_blocks; i++)
+    {
+      const u8* blocks[LANES];
+      for (size_t lane = 0; lane < LANES; lane++)
+        blocks[lane] = tails[lane].data() + i * BLOCK_LEN;
+      ProcessBlocks(state, blocks);
+    }
+
+    for (size_t i = 0; i < std::size(state); i++)
+    {
+      alignas(16) u32 words[LANES];
+      _mm_store_si128((__m128i*)words, state[i]);
+      for (size_t lane = 0; lane < LANES; lane++)
+      {
+        const u32 word = Common::swap32(words[lane]);
+        std::memcpy(out[lane]->data() + i * sizeof(u32), &word, sizeof(word));
+      }
+    }
+  }
+
+private:
+  static constexpr size_t BLOCK_LEN = 64;
+  static constexpr u32 K[4]{0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6};
+  static constexpr u32 H[5]{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+  template <int N>
+  static inline __m128i Rotl(__m128i x)
+  {
+    return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N));
+  }
+
+  static void ProcessBlocks(__m128i state[5], const u8* const blocks[LANES])
+  {
+    __m128i w[16];
+    for (size_t i = 0; i < std::size(w); i++)
+    {
+      w[i] = _mm_set_epi32(Common::swap32(blocks[3] + i * 4), Common::swap32(blocks[2] + i * 4),
+                           Common::swap32(blocks[1] + i * 4), Common::swap32(blocks[0] + i * 4));
+    }
+
+    __m128i a = state[0];
+    __m128i b = state[1];
+    __m128i c = state[2];
+    __m128i d = state[3];
+    __m128i e = state[4];
+
+    for (size_t i = 0; i < 80; i++)
+    {
+      // See FIPS 180-4 6.1.3 Alternate Method for Computing a SHA-1 Message Digest
+      __m128i& wi = w[i % 16];
+      if (i >= 16)
+      {
+        wi = _mm_xor_si128(_mm_xor_si128(w[(i + 13) % 16], w[(i + 8) % 16]),
+                           _mm_xor_si128(w[(i + 2) % 16], wi));
+        wi = Rotl<1>(wi);
+      }
+
+      __m128i f;
+      if (i < 20)
+        f = _mm_or_si128(_mm_and_si128(b, c), _mm_andnot_si128(b, d));
+      else if (i < 40 || i >= 60)
+        f = _mm_xor_si128(_mm_xor_si128(b, c), d);
+      else
+        f = _mm_or_si128(_mm_and_si128(b, c), _mm_and_si128(d, _mm_or_si128(b, c)));
+
+      const __m128i temp =
+          _mm_add_epi32(_mm_add_epi32(Rotl<5>(a), f),
+                        _mm_add_epi32(_mm_add_epi32(e, wi), _mm_set1_epi32(K[i / 20])));
+      e = d;
+      d = c;
+      c = Rotl<30>(b);
+      b = a;
+      a = temp;
+    }
+
+    state[0] = _mm_add_epi32(state[0], a);
+    state[1] = _mm_add_epi32(state[1], b);
+    state[2] = _mm_add_epi32(state[2], c);
+    state[3] = _mm_add_epi32(state[3], d);
+    state[4] = _mm_add_epi32(state[4], e);
+  }
+};
+
 #endif
 
 #ifdef _M_ARM_64
@@ -386,6 +503,33 @@ Digest CalculateDigest(const u8* msg, size_t len)
   return ctx->Finish();
 }
 
+void CalculateDigests(const u8* msgs, size_t msg_len, size_t count, Digest* out)
+{
+  size_t i = 0;
+
+#ifdef _M_X86_64
+  // The SHA instructions beat hashing several messages at once using normal SSE
+  if (!cpu_info.bSHA1)
+  {
+    constexpr size_t LANES = MultiBufferSSE2::LANES;
+    for (; count - i >= LANES; i += LANES)
+    {
+      const u8* lane_msgs[LANES];
+      Digest* lane_out[LANES];
+      for (size_t lane = 0; lane < LANES; lane++)
+      {
+        lane_msgs[lane] = msgs + (i + lane) * msg_len;
+        lane_out[lane] = &out[i + lane];
+      }
+      MultiBufferSSE2::CalculateDigests(lane_msgs, msg_len, lane_out);
+    }
+  }
+#endif
+
+  for (; i < count; i++)
+    out[i] = CalculateDigest(msgs + i * msg_len, msg_len);
+}
+
 std::string DigestToString(const Digest& digest)
 {
   static constexpr std::array<char, 16> lookup = {'0', '1', '2', '3', '4', '5', '6', '7',
@@ -37,6 +37,10 @@ std::unique_ptr<Context> CreateContext();
 
 Digest CalculateDigest(const u8* msg, size_t len);
 
+// Calculates the digests of count consecutive messages of msg_len bytes each. This can be much
+// faster than calling CalculateDigest for each message, as several messages can be hashed at once.
+void CalculateDigests(const u8* msgs, size_t msg_len, size_t count, Digest* out);
+
 template <typename T>
 inline Digest CalculateDigest(const std::vector<T>& msg)
 {
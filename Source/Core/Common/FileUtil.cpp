@@ -357,6 +357,16 @@ u64 GetSize(const std::string& path)
   return FileInfo(path).GetSize();
 }
 
+u64 GetModificationTime(const std::string& path)
+{
+  std::error_code error;
+  const auto time = std::filesystem::last_write_time(StringToPath(path), error);
+  if (error)
+    return 0;
+
+  return static_cast<u64>(time.time_since_epoch().count());
+}
+
 // Overloaded GetSize, accepts FILE*
 u64 GetSize(FILE* f)
 {
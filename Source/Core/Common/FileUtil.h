@@ -148,6 +148,10 @@ bool IsFile(const std::string& path);
 // Returns the size of a file (or returns 0 if the path isn't a file that exists)
 u64 GetSize(const std::string& path);
 
+// Returns when a file was last modified, in an unspecified unit that is only meant to be compared
+// for equality (or returns 0 if the path doesn't exist)
+u64 GetModificationTime(const std::string& path);
+
 // Overloaded GetSize, accepts FILE*
 u64 GetSize(FILE* f);
 
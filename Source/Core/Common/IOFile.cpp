@@ -9,10 +9,12 @@
 
 #ifdef _WIN32
 #include <io.h>
+#include <windows.h>
 
 #include "Common/CommonFuncs.h"
 #include "Common/StringUtil.h"
 #else
+#include <sys/file.h>
 #include <unistd.h>
 #endif
 
@@ -178,4 +180,23 @@ bool IOFile::Resize(u64 size)
   return m_good;
 }
 
+bool IOFile::TryLockExclusive()
+{
+  if (!IsOpen())
+    return false;
+
+#ifdef _WIN32
+  // Windows locks are mandatory, so lock a byte far beyond the end of any file rather than the
+  // contents.
+  const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+  OVERLAPPED overlapped{};
+  overlapped.Offset = 0xFFFFFFFE;
+  overlapped.OffsetHigh = 0xFFFFFFFF;
+  return LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0,
+                    &overlapped) != 0;
+#else
+  return flock(fileno(m_file), LOCK_EX | LOCK_NB) == 0;
+#endif
+}
+
 }  // namespace File
@@ -112,6 +112,10 @@ public:
   bool Resize(u64 size);
   bool Flush();
 
+  // Takes an advisory lock on the file, which fails if another IOFile already holds one, even in
+  // the same process. The lock is released when the file is closed.
+  bool TryLockExclusive();
+
   // clear error state
   void ClearError()
   {
@@ -0,0 +1,184 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/IOUring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+
+namespace Common
+{
+static int SetupIOUring(u32 entries, io_uring_params* params)
+{
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int EnterIOUring(int fd, u32 to_submit, u32 min_complete, u32 flags)
+{
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static void* MapRing(int fd, size_t size, off_t offset)
+{
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+template <typename T>
+static T* RingPointer(void* ring, u32 offset)
+{
+  return reinterpret_cast<T*>(static_cast<u8*>(ring) + offset);
+}
+
+std::unique_ptr<IOUring> IOUring::Create(u32 entries)
+{
+  io_uring_params params{};
+  const int fd = SetupIOUring(entries, &params);
+  if (fd < 0)
+  {
+    WARN_LOG_FMT(COMMON, "io_uring is unavailable: {}", std::strerror(errno));
+    return nullptr;
+  }
+
+  std::unique_ptr<IOUring> ring(new IOUring());
+  ring->m_fd = fd;
+
+  ring->m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+  ring->m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    ring->m_sq_ring_size = std::max(ring->m_sq_ring_size, ring->m_cq_ring_size);
+    ring->m_cq_ring_size = 0;
+  }
+
+  ring->m_sq_ring = MapRing(fd, ring->m_sq_ring_size, IORING_OFF_SQ_RING);
+  if (!ring->m_sq_ring)
+    return nullptr;
+
+  if (ring->m_cq_ring_size == 0)
+  {
+    ring->m_cq_ring = ring->m_sq_ring;
+  }
+  else
+  {
+    ring->m_cq_ring = MapRing(fd, ring->m_cq_ring_size, IORING_OFF_CQ_RING);
+    if (!ring->m_cq_ring)
+      return nullptr;
+  }
+
+  ring->m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  ring->m_sqes = static_cast<io_uring_sqe*>(MapRing(fd, ring->m_sqes_size, IORING_OFF_SQES));
+  if (!ring->m_sqes)
+    return nullptr;
+
+  ring->m_sq_head = RingPointer<u32>(ring->m_sq_ring, params.sq_off.head);
+  ring->m_sq_tail = RingPointer<u32>(ring->m_sq_ring, params.sq_off.tail);
+  ring->m_sq_array = RingPointer<u32>(ring->m_sq_ring, params.sq_off.array);
+  ring->m_sq_mask = *RingPointer<u32>(ring->m_sq_ring, params.sq_off.ring_mask);
+  ring->m_sq_entries = params.sq_entries;
+
+  ring->m_cq_head = RingPointer<u32>(ring->m_cq_ring, params.cq_off.head);
+  ring->m_cq_tail = RingPointer<u32>(ring->m_cq_ring, params.cq_off.tail);
+  ring->m_cqes = RingPointer<io_uring_cqe>(ring->m_cq_ring, params.cq_off.cqes);
+  ring->m_cq_mask = *RingPointer<u32>(ring->m_cq_ring, params.cq_off.ring_mask);
+
+  return ring;
+}
+
+IOUring::~IOUring()
+{
+  if (m_sqes)
+    munmap(m_sqes, m_sqes_size);
+  if (m_cq_ring && m_cq_ring != m_sq_ring)
+    munmap(m_cq_ring, m_cq_ring_size);
+  if (m_sq_ring)
+    munmap(m_sq_ring, m_sq_ring_size);
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool IOUring::QueueRead(int fd, u64 offset, u32 size, u8* out_ptr, u64 user_data)
+{
+  if (m_to_submit + m_in_flight >= m_sq_entries)
+    return false;
+
+  // Only this thread writes the tail, and the kernel only reads entries up to the tail
+  const u32 tail = *m_sq_tail;
+  const u32 index = tail & m_sq_mask;
+
+  io_uring_sqe* sqe = &m_sqes[index];
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->off = offset;
+  sqe->addr = reinterpret_cast<u64>(out_ptr);
+  sqe->len = size;
+  sqe->user_data = user_data;
+
+  m_sq_array[index] = index;
+  std::atomic_ref(*m_sq_tail).store(tail + 1, std::memory_order_release);
+
+  ++m_to_submit;
+  return true;
+}
+
+bool IOUring::Submit()
+{
+  while (m_to_submit > 0)
+  {
+    const int submitted = EnterIOUring(m_fd, m_to_submit, 0, 0);
+    if (submitted < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      ERROR_LOG_FMT(COMMON, "io_uring_enter failed: {}", std::strerror(errno));
+      return false;
+    }
+
+    m_to_submit -= submitted;
+    m_in_flight += submitted;
+  }
+
+  return true;
+}
+
+bool IOUring::WaitForCompletion(u64* user_data, s32* result)
+{
+  while (m_in_flight > 0)
+  {
+    // Only this thread writes the head, and the kernel only writes entries past the head
+    const u32 head = *m_cq_head;
+    if (head != std::atomic_ref(*m_cq_tail).load(std::memory_order_acquire))
+    {
+      const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+      *user_data = cqe.user_data;
+      *result = cqe.res;
+
+      std::atomic_ref(*m_cq_head).store(head + 1, std::memory_order_release);
+      --m_in_flight;
+      return true;
+    }
+
+    if (EnterIOUring(m_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+    {
+      ERROR_LOG_FMT(COMMON, "io_uring_enter failed: {}", std::strerror(errno));
+      return false;
+    }
+  }
+
+  return false;
+}
+}  // namespace Common
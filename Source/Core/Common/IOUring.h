@@ -0,0 +1,70 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+
+#include "Common/CommonTypes.h"
+
+struct io_uring_cqe;
+struct io_uring_sqe;
+
+namespace Common
+{
+// A minimal wrapper around a Linux io_uring instance which lets several reads be in flight at once.
+// This talks to the kernel directly, so no library is needed. It is not thread-safe.
+class IOUring final
+{
+public:
+  // Returns nullptr if the kernel doesn't support io_uring or doesn't allow using it.
+  static std::unique_ptr<IOUring> Create(u32 entries);
+
+  IOUring(const IOUring&) = delete;
+  IOUring(IOUring&&) = delete;
+  IOUring& operator=(const IOUring&) = delete;
+  IOUring& operator=(IOUring&&) = delete;
+  ~IOUring();
+
+  // How many requests can be queued or in flight at once.
+  u32 GetQueueDepth() const { return m_sq_entries; }
+  // How many requests have been submitted but not yet returned by WaitForCompletion.
+  u32 GetInFlightCount() const { return m_in_flight; }
+
+  // Queues a read of up to size bytes. Returns false if the submission queue is full.
+  bool QueueRead(int fd, u64 offset, u32 size, u8* out_ptr, u64 user_data);
+
+  // Hands all queued requests to the kernel.
+  bool Submit();
+
+  // Waits until a submitted request completes. result is set to the number of bytes read or to a
+  // negative errno value. Returns false if nothing is in flight or waiting failed.
+  bool WaitForCompletion(u64* user_data, s32* result);
+
+private:
+  IOUring() = default;
+
+  int m_fd = -1;
+
+  void* m_sq_ring = nullptr;
+  size_t m_sq_ring_size = 0;
+  void* m_cq_ring = nullptr;
+  size_t m_cq_ring_size = 0;
+  io_uring_sqe* m_sqes = nullptr;
+  size_t m_sqes_size = 0;
+
+  u32* m_sq_head = nullptr;
+  u32* m_sq_tail = nullptr;
+  u32* m_sq_array = nullptr;
+  u32 m_sq_mask = 0;
+  u32 m_sq_entries = 0;
+
+  u32* m_cq_head = nullptr;
+  u32* m_cq_tail = nullptr;
+  io_uring_cqe* m_cqes = nullptr;
+  u32 m_cq_mask = 0;
+
+  u32 m_to_submit = 0;
+  u32 m_in_flight = 0;
+};
+}  // namespace Common
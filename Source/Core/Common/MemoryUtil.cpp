@@ -13,6 +13,7 @@
 #include "Common/MsgHandler.h"
 
 #ifdef _WIN32
+#include <io.h>
 #include <windows.h>
 #include "Common/StringUtil.h"
 #else
@@ -20,6 +21,7 @@
 #include <stdio.h>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <unistd.h>
 #if defined __APPLE__ || defined __FreeBSD__ || defined __OpenBSD__ || defined __NetBSD__
 #include <sys/sysctl.h>
 #elif defined __HAIKU__
@@ -289,4 +291,74 @@ size_t MemPhysical()
 #endif
 }
 
+const void* MapFileReadOnly(std::FILE* file, size_t size)
+{
+#ifdef _WIN32
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+  const HANDLE mapping = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+  {
+    ERROR_LOG_FMT(COMMON, "CreateFileMapping failed: {}", GetLastErrorString());
+    return nullptr;
+  }
+
+  // The view keeps the mapping alive on its own
+  void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+  if (!ptr)
+    ERROR_LOG_FMT(COMMON, "MapViewOfFile failed: {}", GetLastErrorString());
+  CloseHandle(mapping);
+  return ptr;
+#else
+  void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(file), 0);
+  if (ptr == MAP_FAILED)
+  {
+    ERROR_LOG_FMT(COMMON, "mmap failed: {}", LastStrerrorString());
+    return nullptr;
+  }
+  return ptr;
+#endif
+}
+
+void UnmapFile(const void* ptr, size_t size)
+{
+  if (!ptr)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(ptr);
+#else
+  munmap(const_cast<void*>(ptr), size);
+#endif
+}
+
+#ifndef _WIN32
+static void AdviseMappedRange(const void* ptr, size_t size, int advice)
+{
+  // The start of the range has to be page aligned
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t start = reinterpret_cast<uintptr_t>(ptr);
+  const uintptr_t aligned_start = start & ~(page_size - 1);
+  posix_madvise(reinterpret_cast<void*>(aligned_start), size + (start - aligned_start), advice);
+}
+#endif
+
+void AdviseSequentialAccess(const void* ptr, size_t size)
+{
+#ifndef _WIN32
+  AdviseMappedRange(ptr, size, POSIX_MADV_SEQUENTIAL);
+#endif
+}
+
+void AdviseWillNeed(const void* ptr, size_t size)
+{
+#ifdef _WIN32
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = const_cast<void*>(ptr);
+  range.NumberOfBytes = size;
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+  AdviseMappedRange(ptr, size, POSIX_MADV_WILLNEED);
+#endif
+}
+
 }  // namespace Common
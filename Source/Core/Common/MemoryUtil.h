@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdio>
 #include <string>
 
 namespace Common
@@ -35,4 +36,13 @@ bool WriteProtectMemory(void* ptr, size_t size, bool executable = false);
 bool UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute = false);
 size_t MemPhysical();
 
+// Maps the first size bytes of an open file into memory as read-only. Returns nullptr on failure.
+// Note that reading from the mapping crashes if the file can't be read at that point.
+const void* MapFileReadOnly(std::FILE* file, size_t size);
+void UnmapFile(const void* ptr, size_t size);
+// Hints to the OS that a range of a mapped file is about to be read from start to end.
+void AdviseSequentialAccess(const void* ptr, size_t size);
+// Hints to the OS that a range of a mapped file should be read into memory in the background.
+void AdviseWillNeed(const void* ptr, size_t size);
+
 }  // namespace Common
@@ -0,0 +1,95 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/WorkerPool.h"
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+WorkerPool::WorkerPool(std::string_view thread_name) : m_thread_name(thread_name)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+  StopWorkers();
+}
+
+void WorkerPool::SetThreadCount(size_t thread_count)
+{
+  if (thread_count == GetThreadCount())
+    return;
+
+  StopWorkers();
+  StartWorkers(thread_count);
+}
+
+void WorkerPool::Run(const std::function<void(size_t thread_index)>& job)
+{
+  if (m_workers.empty())
+  {
+    job(0);
+    return;
+  }
+
+  {
+    std::lock_guard lk(m_workers_mutex);
+    m_job = &job;
+    ++m_work_generation;
+    m_busy_workers = m_workers.size();
+  }
+  m_work_available.notify_all();
+
+  job(0);
+
+  std::unique_lock lk(m_workers_mutex);
+  m_work_done.wait(lk, [this] { return m_busy_workers == 0; });
+  m_job = nullptr;
+}
+
+void WorkerPool::StartWorkers(size_t thread_count)
+{
+  m_workers_exiting = false;
+  for (size_t i = 1; i < thread_count; ++i)
+    m_workers.emplace_back(&WorkerPool::WorkerThread, this, i, m_work_generation);
+}
+
+void WorkerPool::StopWorkers()
+{
+  {
+    std::lock_guard lk(m_workers_mutex);
+    m_workers_exiting = true;
+  }
+  m_work_available.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+  m_workers.clear();
+}
+
+void WorkerPool::WorkerThread(size_t thread_index, u64 work_generation)
+{
+  SetCurrentThreadName(m_thread_name.c_str());
+
+  while (true)
+  {
+    const std::function<void(size_t)>* job;
+    {
+      std::unique_lock lk(m_workers_mutex);
+      m_work_available.wait(
+          lk, [&] { return m_workers_exiting || m_work_generation != work_generation; });
+      if (m_workers_exiting)
+        return;
+      work_generation = m_work_generation;
+      job = m_job;
+    }
+
+    (*job)(thread_index);
+
+    std::lock_guard lk(m_workers_mutex);
+    if (--m_busy_workers == 0)
+      m_work_done.notify_one();
+  }
+}
+}  // namespace Common
@@ -0,0 +1,54 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// A set of threads which all run the same job at once, together with the thread giving it to
+// them. Each of them is told its index, 0 being the calling thread, so that the job can keep
+// state per thread. Splitting up the work, e.g. with an atomic counter, is up to the job.
+class WorkerPool final
+{
+public:
+  explicit WorkerPool(std::string_view thread_name);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Uses thread_count threads including the one calling Run, restarting the workers if that
+  // changes the count. 1 stops them.
+  void SetThreadCount(size_t thread_count);
+  size_t GetThreadCount() const { return m_workers.size() + 1; }
+
+  // Runs job on every thread and waits for all of them to finish
+  void Run(const std::function<void(size_t thread_index)>& job);
+
+private:
+  void StartWorkers(size_t thread_count);
+  void StopWorkers();
+  void WorkerThread(size_t thread_index, u64 work_generation);
+
+  std::string m_thread_name;
+  std::vector<std::thread> m_workers;
+  std::mutex m_workers_mutex;
+  std::condition_variable m_work_available;
+  std::condition_variable m_work_done;
+  const std::function<void(size_t)>* m_job = nullptr;
+  u64 m_work_generation = 0;
+  size_t m_busy_workers = 0;
+  bool m_workers_exiting = false;
+};
+}  // namespace Common
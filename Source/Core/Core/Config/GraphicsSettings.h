@@ -102,6 +102,8 @@ extern const Info<bool> GFX_SW_DUMP_OBJECTS;
 extern const Info<bool> GFX_SW_DUMP_TEV_STAGES;
 extern const Info<bool> GFX_SW_DUMP_TEV_TEX_FETCHES;
 
+extern const Info<bool> GFX_NULL_NO_RENDER;
+
 extern const Info<bool> GFX_PREFER_GLES;
 
 extern const Info<bool> GFX_MODS_ENABLE;
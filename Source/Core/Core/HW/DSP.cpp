@@ -79,7 +79,7 @@ constexpr int DSP_MAIL_SLICE = 72;
 void DSPManager::DoState(PointerWrap& p)
 {
   if (!m_aram.wii_mode)
-    p.DoArray(m_aram.ptr, m_aram.size);
+    p.DoSection("ARAM", [&] { p.DoArray(m_aram.ptr, m_aram.size); });
   p.Do(m_dsp_control);
   p.Do(m_audio_dma);
   p.Do(m_aram_dma);
@@ -3,14 +3,20 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
@@ -36,6 +42,14 @@
 
 namespace DVD
 {
+// Adjacent or overlapping requests are combined into reads of at most this size.
+constexpr u64 MAX_COALESCED_READ_SIZE = 0x400000;
+
+// How much data following a sequential read gets read into the cache ahead of time, and how much
+// of it is read at once. Prefetching stops as soon as a new request arrives.
+constexpr u64 PREFETCH_SIZE = 0x40000;
+constexpr u64 PREFETCH_CHUNK_SIZE = 0x20000;
+
 DVDThread::DVDThread(Core::System& system) : m_system(system)
 {
 }
@@ -62,6 +76,11 @@ void DVDThread::StartDVDThread()
 {
   ASSERT(!m_dvd_thread.joinable());
   m_dvd_thread_exiting.Clear();
+
+  // The CPU thread may change the disc before the next request arrives
+  m_prefetch_end = m_prefetch_offset;
+  m_last_read_end = 0;
+
   m_dvd_thread = std::thread(&DVDThread::DVDThreadMain, this);
 }
 
@@ -69,6 +88,7 @@ void DVDThread::Stop()
 {
   StopDVDThread();
   m_disc.reset();
+  m_read_cache.clear();
 }
 
 void DVDThread::StopDVDThread()
@@ -132,6 +152,7 @@ void DVDThread::SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   m_disc = std::move(disc);
+  m_read_cache.clear();
 }
 
 bool DVDThread::HasDisc() const
@@ -332,6 +353,8 @@ void DVDThread::DVDThreadMain()
 {
   Common::SetCurrentThreadName("DVD thread");
 
+  std::vector<ReadRequest> requests;
+
   while (true)
   {
     m_request_queue_expanded.Wait();
@@ -339,23 +362,210 @@ void DVDThread::DVDThreadMain()
     if (m_dvd_thread_exiting.IsSet())
       return;
 
-    ReadRequest request;
-    while (m_request_queue.Pop(request))
+    while (true)
+    {
+      // Take every queued request at once so that adjacent ones can be read together
+      ReadRequest request;
+      while (m_request_queue.Pop(request))
+        requests.push_back(std::move(request));
+
+      if (!requests.empty())
+      {
+        ProcessRequests(&requests);
+        requests.clear();
+      }
+      else if (m_prefetch_offset < m_prefetch_end)
+      {
+        const u64 length = std::min(PREFETCH_CHUNK_SIZE, m_prefetch_end - m_prefetch_offset);
+        Prefetch(m_prefetch_partition, m_prefetch_offset, length);
+        m_prefetch_offset += length;
+      }
+      else
+      {
+        break;
+      }
+
+      // All requests that were taken from the queue have been completed at this point, which
+      // WaitUntilIdle relies on
+      if (m_dvd_thread_exiting.IsSet())
+        return;
+    }
+  }
+}
+
+void DVDThread::ProcessRequests(std::vector<ReadRequest>* requests)
+{
+  size_t i = 0;
+  while (i < requests->size())
+  {
+    const DiscIO::Partition& partition = (*requests)[i].partition;
+    const u64 start = (*requests)[i].dvd_offset;
+    u64 end = start + (*requests)[i].length;
+
+    size_t j = i + 1;
+    for (; j < requests->size(); ++j)
+    {
+      const ReadRequest& next = (*requests)[j];
+      const u64 next_end = std::max(end, next.dvd_offset + next.length);
+      if (next.partition != partition || next.dvd_offset < start || next.dvd_offset > end ||
+          next_end - start > MAX_COALESCED_READ_SIZE)
+      {
+        break;
+      }
+      end = next_end;
+    }
+
+    // Memory-mapped images can be copied from directly
+    std::vector<u8> coalesced_buffer;
+    std::span<const u8> coalesced_data = m_disc->GetSpan(start, end - start, partition);
+    if (coalesced_data.empty())
+    {
+      coalesced_buffer.resize(end - start);
+      if (ReadCached(start, end - start, coalesced_buffer.data(), partition))
+        coalesced_data = coalesced_buffer;
+    }
+    const bool coalesced_success = !coalesced_data.empty();
+
+    for (size_t k = i; k < j; ++k)
     {
+      ReadRequest& request = (*requests)[k];
       m_file_logger.Log(*m_disc, request.partition, request.dvd_offset);
 
-      std::vector<u8> buffer(request.length);
-      if (!m_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      std::vector<u8> buffer;
+      if (coalesced_success)
+      {
+        const auto begin = coalesced_data.begin() + (request.dvd_offset - start);
+        buffer.assign(begin, begin + request.length);
+      }
+      else
+      {
+        // Read the requests one by one so that only the ones that actually fail report an error
+        buffer.resize(request.length);
+        if (!ReadCached(request.dvd_offset, request.length, buffer.data(), request.partition))
+          buffer.resize(0);
+      }
 
       request.realtime_done_us = Common::Timer::NowUs();
 
       m_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
       m_result_queue_expanded.Set();
+    }
 
-      if (m_dvd_thread_exiting.IsSet())
-        return;
+    // If this read continues the previous one or is large, the game is likely reading a file
+    // sequentially, so start reading the data that follows it
+    if ((partition == m_prefetch_partition && start == m_last_read_end) ||
+        end - start > READ_CACHE_BLOCK_SIZE)
+    {
+      m_prefetch_offset = Common::AlignUp(end, READ_CACHE_BLOCK_SIZE);
+      m_prefetch_end = m_prefetch_offset + PREFETCH_SIZE;
+    }
+    else
+    {
+      m_prefetch_end = m_prefetch_offset;
     }
+    m_prefetch_partition = partition;
+    m_last_read_end = end;
+
+    i = j;
+  }
+}
+
+void DVDThread::Prefetch(const DiscIO::Partition& partition, u64 offset, u64 length)
+{
+  // This fails when reaching the end of the disc, in which case there is nothing to prefetch
+  if (!ReadCached(offset, length, nullptr, partition))
+    m_prefetch_end = m_prefetch_offset;
+}
+
+bool DVDThread::ReadCached(u64 offset, u64 length, u8* out_ptr, const DiscIO::Partition& partition)
+{
+  // Memory-mapped images don't need a cache of their own
+  const std::span<const u8> data = m_disc->GetSpan(offset, length, partition);
+  if (!data.empty())
+  {
+    if (out_ptr)
+      std::copy(data.begin(), data.end(), out_ptr);
+    return true;
+  }
+
+  const u64 end = offset + length;
+  u64 block_offset = Common::AlignDown(offset, READ_CACHE_BLOCK_SIZE);
+
+  while (block_offset < end)
+  {
+    const u64 copy_start = std::max(offset, block_offset);
+
+    if (const CachedBlock* block = FindCachedBlock(partition, block_offset))
+    {
+      const u64 copy_end = std::min(end, block_offset + READ_CACHE_BLOCK_SIZE);
+      if (out_ptr)
+      {
+        std::memcpy(out_ptr + (copy_start - offset),
+                    block->data.data() + (copy_start - block_offset), copy_end - copy_start);
+      }
+      block_offset += READ_CACHE_BLOCK_SIZE;
+      continue;
+    }
+
+    // Read all consecutive blocks that aren't cached using a single read
+    u64 run_end = block_offset + READ_CACHE_BLOCK_SIZE;
+    while (run_end < end && !FindCachedBlock(partition, run_end))
+      run_end += READ_CACHE_BLOCK_SIZE;
+    const u64 copy_end = std::min(end, run_end);
+
+    m_read_buffer.resize(run_end - block_offset);
+    if (m_disc->Read(block_offset, run_end - block_offset, m_read_buffer.data(), partition))
+    {
+      for (u64 i = block_offset; i < run_end; i += READ_CACHE_BLOCK_SIZE)
+        AddCachedBlock(partition, i, m_read_buffer.data() + (i - block_offset));
+
+      if (out_ptr)
+      {
+        std::memcpy(out_ptr + (copy_start - offset),
+                    m_read_buffer.data() + (copy_start - block_offset), copy_end - copy_start);
+      }
+    }
+    else
+    {
+      // The aligned read may have gone past the end of the disc, so read only what was requested
+      if (!out_ptr || !m_disc->Read(copy_start, copy_end - copy_start,
+                                    out_ptr + (copy_start - offset), partition))
+      {
+        return false;
+      }
+    }
+
+    block_offset = run_end;
   }
+
+  return true;
+}
+
+const DVDThread::CachedBlock* DVDThread::FindCachedBlock(const DiscIO::Partition& partition,
+                                                         u64 offset)
+{
+  const auto it = std::find_if(m_read_cache.begin(), m_read_cache.end(),
+                               [&](const CachedBlock& block) {
+                                 return block.offset == offset && block.partition == partition;
+                               });
+  if (it == m_read_cache.end())
+    return nullptr;
+
+  m_read_cache.splice(m_read_cache.begin(), m_read_cache, it);
+  return &m_read_cache.front();
+}
+
+void DVDThread::AddCachedBlock(const DiscIO::Partition& partition, u64 offset, const u8* data)
+{
+  // Reuse the least recently used block once the cache is full
+  if (m_read_cache.size() < READ_CACHE_BLOCKS)
+    m_read_cache.emplace_front();
+  else
+    m_read_cache.splice(m_read_cache.begin(), m_read_cache, std::prev(m_read_cache.end()));
+
+  CachedBlock& block = m_read_cache.front();
+  block.partition = partition;
+  block.offset = offset;
+  std::memcpy(block.data.data(), data, READ_CACHE_BLOCK_SIZE);
 }
 }  // namespace DVD
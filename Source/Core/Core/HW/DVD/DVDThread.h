@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
@@ -126,6 +128,24 @@ private:
 
   using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
 
+  // Host-side cache of recently read data. Only used by the DVD thread. Emulated timing is not
+  // affected by whether data is in this cache, since that is computed when the read is scheduled.
+  static constexpr u64 READ_CACHE_BLOCK_SIZE = 0x8000;
+  static constexpr size_t READ_CACHE_BLOCKS = 64;
+
+  struct CachedBlock
+  {
+    DiscIO::Partition partition;
+    u64 offset = 0;
+    std::array<u8, READ_CACHE_BLOCK_SIZE> data;
+  };
+
+  void ProcessRequests(std::vector<ReadRequest>* requests);
+  void Prefetch(const DiscIO::Partition& partition, u64 offset, u64 length);
+  bool ReadCached(u64 offset, u64 length, u8* out_ptr, const DiscIO::Partition& partition);
+  const CachedBlock* FindCachedBlock(const DiscIO::Partition& partition, u64 offset);
+  void AddCachedBlock(const DiscIO::Partition& partition, u64 offset, const u8* data);
+
   CoreTiming::EventType* m_finish_read = nullptr;
 
   u64 m_next_id = 0;
@@ -141,6 +161,16 @@ private:
 
   std::unique_ptr<DiscIO::Volume> m_disc;
 
+  // Most recently used blocks first
+  std::list<CachedBlock> m_read_cache;
+  std::vector<u8> m_read_buffer;
+
+  // The next data to prefetch once the request queue is empty
+  DiscIO::Partition m_prefetch_partition;
+  u64 m_prefetch_offset = 0;
+  u64 m_prefetch_end = 0;
+  u64 m_last_read_end = 0;
+
   FileMonitor::FileLogger m_file_logger;
 
   Core::System& m_system;
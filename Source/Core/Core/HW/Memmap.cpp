@@ -328,14 +328,14 @@ void MemoryManager::DoState(PointerWrap& p)
     return;
   }
 
-  p.DoArray(m_ram, current_ram_size);
-  p.DoArray(m_l1_cache, current_l1_cache_size);
+  p.DoSection("MEM1", [&] { p.DoArray(m_ram, current_ram_size); });
+  p.DoSection("L1Cache", [&] { p.DoArray(m_l1_cache, current_l1_cache_size); });
   p.DoMarker("Memory RAM");
   if (current_have_fake_vmem)
-    p.DoArray(m_fake_vmem, current_fake_vmem_size);
+    p.DoSection("FakeVMEM", [&] { p.DoArray(m_fake_vmem, current_fake_vmem_size); });
   p.DoMarker("Memory FakeVMEM");
   if (current_have_exram)
-    p.DoArray(m_exram, current_exram_size);
+    p.DoSection("MEM2", [&] { p.DoArray(m_exram, current_exram_size); });
   p.DoMarker("Memory EXRAM");
 }
 
@@ -68,6 +68,30 @@ PowerPCManager::PowerPCManager(Core::System& system)
 
 PowerPCManager::~PowerPCManager() = default;
 
+void DoRegisterState(PowerPCState& ppc_state, PointerWrap& p)
+{
+  p.DoArray(ppc_state.gpr);
+  p.Do(ppc_state.pc);
+  p.Do(ppc_state.npc);
+  p.DoArray(ppc_state.cr.fields);
+  p.Do(ppc_state.msr);
+  p.Do(ppc_state.fpscr);
+  p.Do(ppc_state.Exceptions);
+  p.Do(ppc_state.downcount);
+  p.Do(ppc_state.xer_ca);
+  p.Do(ppc_state.xer_so_ov);
+  p.Do(ppc_state.xer_stringctrl);
+  p.DoArray(ppc_state.ps);
+  p.DoArray(ppc_state.sr);
+  p.DoArray(ppc_state.spr);
+  p.DoArray(ppc_state.tlb);
+  p.Do(ppc_state.pagetable_base);
+  p.Do(ppc_state.pagetable_hashmask);
+
+  p.Do(ppc_state.reserve);
+  p.Do(ppc_state.reserve_address);
+}
+
 void PowerPCManager::DoState(PointerWrap& p)
 {
   // some of this code has been disabled, because
@@ -80,26 +104,7 @@ void PowerPCManager::DoState(PointerWrap& p)
   // *((u64 *)&TL(m_ppc_state)) = SystemTimers::GetFakeTimeBase(); //works since we are little
   // endian and TL comes first :)
 
-  p.DoArray(m_ppc_state.gpr);
-  p.Do(m_ppc_state.pc);
-  p.Do(m_ppc_state.npc);
-  p.DoArray(m_ppc_state.cr.fields);
-  p.Do(m_ppc_state.msr);
-  p.Do(m_ppc_state.fpscr);
-  p.Do(m_ppc_state.Exceptions);
-  p.Do(m_ppc_state.downcount);
-  p.Do(m_ppc_state.xer_ca);
-  p.Do(m_ppc_state.xer_so_ov);
-  p.Do(m_ppc_state.xer_stringctrl);
-  p.DoArray(m_ppc_state.ps);
-  p.DoArray(m_ppc_state.sr);
-  p.DoArray(m_ppc_state.spr);
-  p.DoArray(m_ppc_state.tlb);
-  p.Do(m_ppc_state.pagetable_base);
-  p.Do(m_ppc_state.pagetable_hashmask);
-
-  p.Do(m_ppc_state.reserve);
-  p.Do(m_ppc_state.reserve_address);
+  p.DoSection("PowerPCRegisters", [&] { DoRegisterState(m_ppc_state, p); });
 
   auto& memory = m_system.GetMemory();
   m_ppc_state.iCache.DoState(memory, p);
@@ -360,4 +360,8 @@ void MSRUpdated(PowerPCState& ppc_state);
 void MMCRUpdated(PowerPCState& ppc_state);
 void RecalculateAllFeatureFlags(PowerPCState& ppc_state);
 
+// Serializes the architectural registers of ppc_state. This is the PowerPCRegisters section of a
+// savestate, so it can also be used to decode that section without an emulated system.
+void DoRegisterState(PowerPCState& ppc_state, PointerWrap& p);
+
 }  // namespace PowerPC
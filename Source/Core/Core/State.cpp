@@ -11,6 +11,9 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
+#include <span>
 #include <string>
 #include <thread>
 #include <utility>
@@ -21,12 +24,16 @@
 
 #include <lz4.h>
 #include <lzo/lzo1x.h>
+#include <xxhash.h>
 
 #include "Common/ChunkFile.h"
+#include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Common/TimeUtil.h"
@@ -36,6 +43,7 @@
 
 #include "Core/AchievementManager.h"
 #include "Core/Config/AchievementSettings.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -47,6 +55,7 @@
 #include "Core/Movie.h"
 #include "Core/NetPlayClient.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/StateChunkStore.h"
 #include "Core/System.h"
 
 #include "VideoCommon/FrameDumpFFMpeg.h"
@@ -78,6 +87,7 @@ static std::mutex s_load_or_save_in_progress_mutex;
 struct CompressAndDumpState_args
 {
   std::vector<u8> buffer_vector;
+  std::vector<PointerWrap::Section> sections;
   std::string filename;
   std::shared_ptr<Common::Event> state_write_done_event;
 };
@@ -97,15 +107,64 @@ static std::mutex s_state_writes_in_queue_mutex;
 static size_t s_state_writes_in_queue;
 static std::condition_variable s_state_write_queue_is_empty;
 
+struct PrefetchState_args
+{
+  u64 id;
+  std::string filename;
+};
+
+// Used to notice a state file being replaced by something other than this instance of Dolphin
+struct StateFileVersion
+{
+  u64 size = 0;
+  u64 modification_time = 0;
+
+  bool operator==(const StateFileVersion&) const = default;
+};
+
+static StateFileVersion GetStateFileVersion(const std::string& filename)
+{
+  return {File::GetSize(filename), File::GetModificationTime(filename)};
+}
+
+// A state which has been read and decompressed ahead of time by PrefetchState(), so that loading it
+// only has to apply the payload. Only one state is kept at a time.
+struct PrefetchedState
+{
+  u64 id = 0;
+  std::string filename;
+  StateFileVersion version;  // Taken before reading the file
+  bool pending = false;
+  std::shared_ptr<std::vector<u8>> buffer;
+};
+
+static std::mutex s_prefetch_mutex;
+static std::condition_variable s_prefetch_done;
+static PrefetchedState s_prefetched_state;
+static u64 s_next_prefetch_id = 1;
+
+// Queue for reading and decompressing prefetched states.
+static Common::WorkQueueThread<PrefetchState_args> s_prefetch_thread;
+
+// Chunk stores are shared by all states in a directory, and kept open until shutdown so that their
+// index doesn't have to be rebuilt for every save or load.
+static std::mutex s_chunk_stores_mutex;
+static std::map<std::string, std::unique_ptr<ChunkStore>> s_chunk_stores;
+
 // Don't forget to increase this after doing changes on the savestate system
 constexpr u32 STATE_VERSION = 169;  // Last changed in PR 13074
 
 // Increase this if the StateExtendedHeader definition changes
-constexpr u32 EXTENDED_HEADER_VERSION = 1;  // Last changed in PR 12217
+constexpr u32 EXTENDED_HEADER_VERSION = 2;  // Last changed when adding the section index
 
-// Change this if we ever need to store more data in the extended header
+// Change this if we ever need to store more data in the extended header. The section index is
+// stored after this and added to the payload offset separately.
 constexpr u32 COMPRESSED_DATA_OFFSET = 0;
 
+// Uncompressed size of the LZ4 blocks of new states. Small enough to allow decompressing a single
+// section of the payload without paying for much else, large enough to not hurt the ratio.
+constexpr u32 LZ4_BLOCK_SIZE = 1024 * 1024;
+
 constexpr u32 COOKIE_BASE = 0xBAADBABE;
 
 // Maps savestate versions to Dolphin versions.
@@ -138,6 +197,22 @@ void EnableCompression(bool compression)
   s_use_compression = compression;
 }
 
+static CompressionType GetCompressionTypeForSave()
+{
+  if (Config::Get(Config::MAIN_STATE_CHUNK_STORE))
+    return CompressionType::ChunkManifest;
+  return s_use_compression ? CompressionType::LZ4 : CompressionType::Uncompressed;
+}
+
+static ChunkStore& GetChunkStore(const std::string& directory)
+{
+  std::lock_guard lk(s_chunk_stores_mutex);
+  std::unique_ptr<ChunkStore>& store = s_chunk_stores[directory];
+  if (!store)
+    store = std::make_unique<ChunkStore>(directory);
+  return *store;
+}
+
 static void DoState(Core::System& system, PointerWrap& p)
 {
   bool is_wii = system.IsWii() || system.IsMIOS();
@@ -173,30 +248,32 @@ static void DoState(Core::System& system, PointerWrap& p)
 
   // Movie must be done before the video backend, because the window is redrawn in the video backend
   // state load, and the frame number must be up-to-date.
-  system.GetMovie().DoState(p);
+  p.DoSection("Movie", [&] { system.GetMovie().DoState(p); });
   p.DoMarker("Movie");
 
   // Begin with video backend, so that it gets a chance to clear its caches and writeback modified
   // things to RAM
-  g_video_backend->DoState(p);
+  p.DoSection("video_backend", [&] { g_video_backend->DoState(p); });
   p.DoMarker("video_backend");
 
   // CoreTiming needs to be restored before restoring Hardware because
   // the controller code might need to schedule an event if the controller has changed.
-  system.GetCoreTiming().DoState(p);
+  p.DoSection("CoreTiming", [&] { system.GetCoreTiming().DoState(p); });
   p.DoMarker("CoreTiming");
 
   // HW needs to be restored before PowerPC because the data cache might need to be flushed.
-  HW::DoState(system, p);
+  p.DoSection("HW", [&] { HW::DoState(system, p); });
   p.DoMarker("HW");
 
-  system.GetPowerPC().DoState(p);
+  p.DoSection("PowerPC", [&] { system.GetPowerPC().DoState(p); });
   p.DoMarker("PowerPC");
 
-  if (system.IsWii())
-    Wiimote::DoState(p);
+  p.DoSection("Wiimote", [&] {
+    if (system.IsWii())
+      Wiimote::DoState(p);
+  });
   p.DoMarker("Wiimote");
-  Gecko::DoState(p);
+  p.DoSection("Gecko", [&] { Gecko::DoState(p); });
   p.DoMarker("Gecko");
 
 #ifdef USE_RETRO_ACHIEVEMENTS
@@ -247,6 +324,46 @@ void SaveToBuffer(Core::System& system, std::vector<u8>& buffer)
       true);
 }
 
+namespace
+{
+class StateHasher final : public PointerWrap::Hasher
+{
+public:
+  StateHasher() { XXH3_128bits_reset(&m_state); }
+
+  void Update(const void* data, size_t size) override
+  {
+    XXH3_128bits_update(&m_state, data, size);
+  }
+
+  StateHash GetHash() const
+  {
+    const XXH128_hash_t hash = XXH3_128bits_digest(&m_state);
+    return {hash.low64, hash.high64};
+  }
+
+private:
+  XXH3_state_t m_state;
+};
+}  // namespace
+
+StateHash GetStateHash(Core::System& system)
+{
+  StateHash hash{};
+  Core::RunOnCPUThread(
+      system,
+      [&] {
+        StateHasher hasher;
+        u8* ptr = nullptr;
+        PointerWrap p(&ptr, 0, PointerWrap::Mode::Measure);
+        p.SetHasher(&hasher);
+        DoState(system, p);
+        hash = hasher.GetHash();
+      },
+      true);
+  return hash;
+}
+
 namespace
 {
 struct SlotWithTimestamp
@@ -294,6 +411,7 @@ static std::string SystemTimeAsDoubleToString(double time)
 }
 
 static std::string MakeStateFilename(int number);
+static bool IsChunkStoreStateFile(const std::string& filename);
 
 static std::vector<SlotWithTimestamp> GetUsedSlotsWithTimestamp()
 {
@@ -322,14 +440,15 @@ static void CompressBufferToFile(const u8* raw_buffer, u64 size, File::IOFile& f
 {
   u64 total_bytes_compressed = 0;
 
+  const int compressed_buffer_size = LZ4_compressBound(LZ4_BLOCK_SIZE);
+  auto compressed_buffer = std::make_unique<char[]>(compressed_buffer_size);
+
   while (true)
   {
     u64 bytes_left_to_compress = size - total_bytes_compressed;
 
     int bytes_to_compress =
-        static_cast<int>(std::min(static_cast<u64>(LZ4_MAX_INPUT_SIZE), bytes_left_to_compress));
-    int compressed_buffer_size = LZ4_compressBound(bytes_to_compress);
-    auto compressed_buffer = std::make_unique<char[]>(compressed_buffer_size);
+        static_cast<int>(std::min(static_cast<u64>(LZ4_BLOCK_SIZE), bytes_left_to_compress));
     s32 compressed_len =
         LZ4_compress_default(reinterpret_cast<const char*>(raw_buffer) + total_bytes_compressed,
                              compressed_buffer.get(), bytes_to_compress, compressed_buffer_size);
@@ -350,19 +469,37 @@ static void CompressBufferToFile(const u8* raw_buffer, u64 size, File::IOFile& f
   }
 }
 
-static void CreateExtendedHeader(StateExtendedHeader& extended_header, size_t uncompressed_size)
+static StateSectionIndexEntry CreateSectionIndexEntry(const PointerWrap::Section& section)
+{
+  StateSectionIndexEntry entry{};
+  section.name.copy(entry.name, std::size(entry.name) - 1);
+  entry.offset = section.offset;
+  entry.size = section.size;
+  return entry;
+}
+
+static void CreateExtendedHeader(StateExtendedHeader& extended_header, size_t uncompressed_size,
+                                 CompressionType compression_type,
+                                 std::vector<StateSectionIndexEntry> sections)
 {
   StateExtendedBaseHeader& base_header = extended_header.base_header;
   base_header.header_version = EXTENDED_HEADER_VERSION;
-  base_header.compression_type =
-      s_use_compression ? CompressionType::LZ4 : CompressionType::Uncompressed;
-  base_header.payload_offset = COMPRESSED_DATA_OFFSET;
+  base_header.compression_type = compression_type;
+  base_header.payload_offset =
+      static_cast<u32>(COMPRESSED_DATA_OFFSET + sizeof(StateSectionIndexHeader) +
+                       sections.size() * sizeof(StateSectionIndexEntry));
   base_header.uncompressed_size = uncompressed_size;
 
+  StateSectionIndexHeader& section_index_header = extended_header.section_index_header;
+  section_index_header.section_count = static_cast<u32>(sections.size());
+  section_index_header.lz4_block_size =
+      compression_type == CompressionType::LZ4 ? LZ4_BLOCK_SIZE : 0;
+  extended_header.sections = std::move(sections);
+
   // If more fields are added to StateExtendedHeader, set them here.
 }
 
-static void WriteHeadersToFile(size_t uncompressed_size, File::IOFile& f)
+static StateHeader CreateHeader()
 {
   StateHeader header{};
   SConfig::GetInstance().GetGameID().copy(header.legacy_header.game_id,
@@ -373,15 +510,63 @@ static void WriteHeadersToFile(size_t uncompressed_size, File::IOFile& f)
   header.version_string = Common::GetScmRevStr();
   header.version_header.version_string_length = static_cast<u32>(header.version_string.length());
 
+  return header;
+}
+
+static void WriteHeadersToFile(const StateHeader& header, size_t uncompressed_size,
+                               CompressionType compression_type,
+                               std::vector<StateSectionIndexEntry> sections, File::IOFile& f)
+{
   StateExtendedHeader extended_header{};
-  CreateExtendedHeader(extended_header, uncompressed_size);
+  CreateExtendedHeader(extended_header, uncompressed_size, compression_type, std::move(sections));
 
   f.WriteArray(&header.legacy_header, 1);
   f.WriteArray(&header.version_header, 1);
   f.WriteString(header.version_string);
 
   f.WriteArray(&extended_header.base_header, 1);
-  // If StateExtendedHeader is amended to include more than the base, add WriteBytes() calls here.
+  f.WriteArray(&extended_header.section_index_header, 1);
+  f.WriteArray(extended_header.sections.data(), extended_header.sections.size());
+  // If StateExtendedHeader is amended to include more, add WriteBytes() calls here.
+}
+
+// filename is the final location of the state, which decides the chunk store used for it.
+static bool WritePayloadToFile(const std::string& filename, CompressionType compression_type,
+                               std::span<const u8> payload, File::IOFile& f)
+{
+  switch (compression_type)
+  {
+  case CompressionType::LZ4:
+    CompressBufferToFile(payload.data(), payload.size(), f);
+    break;
+  case CompressionType::ChunkManifest:
+  {
+    const auto manifest =
+        GetChunkStore(ChunkStore::GetDirectoryForState(filename)).Store(payload);
+    if (!manifest)
+      return false;
+
+    const u64 chunk_count = manifest->size();
+    f.WriteArray(&chunk_count, 1);
+    f.WriteArray(manifest->data(), manifest->size());
+    break;
+  }
+  default:
+    f.WriteBytes(payload.data(), payload.size());
+    break;
+  }
+
+  return f.IsGood();
+}
+
+static void DiscardPrefetchedState(const std::string& filename)
+{
+  std::lock_guard lk(s_prefetch_mutex);
+  if (s_prefetched_state.filename != filename)
+    return;
+
+  s_prefetched_state = {};
+  s_prefetch_done.notify_all();
 }
 
 static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args& save_args)
@@ -408,14 +593,15 @@ static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args
     return;
   }
 
-  WriteHeadersToFile(buffer_size, f);
+  std::vector<StateSectionIndexEntry> sections;
+  sections.reserve(save_args.sections.size());
+  for (const PointerWrap::Section& section : save_args.sections)
+    sections.push_back(CreateSectionIndexEntry(section));
 
-  if (s_use_compression)
-    CompressBufferToFile(buffer_data, buffer_size, f);
-  else
-    f.WriteBytes(buffer_data, buffer_size);
+  const CompressionType compression_type = GetCompressionTypeForSave();
+  WriteHeadersToFile(CreateHeader(), buffer_size, compression_type, std::move(sections), f);
 
-  if (!f.IsGood())
+  if (!WritePayloadToFile(filename, compression_type, {buffer_data, buffer_size}, f))
     Core::DisplayMessage("Failed to write state file", 2000);
 
   const std::string last_state_filename = File::GetUserPath(D_STATESAVES_IDX) + "lastState.sav";
@@ -425,6 +611,10 @@ static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args
   {
     std::lock_guard lk(s_save_thread_mutex);
 
+    // Both files are about to be replaced.
+    DiscardPrefetchedState(filename);
+    DiscardPrefetchedState(last_state_filename);
+
     // Backup existing state (overwriting an existing backup, if any).
     if (File::Exists(filename))
     {
@@ -433,7 +623,22 @@ static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args
       if (File::Exists(last_state_dtmname))
         File::Delete((last_state_dtmname));
 
-      if (!File::Rename(filename, last_state_filename))
+      const bool moves_between_stores = ChunkStore::GetDirectoryForState(filename) !=
+                                        ChunkStore::GetDirectoryForState(last_state_filename);
+      bool backed_up;
+      if (moves_between_stores && IsChunkStoreStateFile(filename))
+      {
+        // A chunk store state only resolves against the store next to it, so one saved outside of
+        // the state directory can't simply be moved there.
+        backed_up = ConvertStateFile(filename, last_state_filename, CompressionType::LZ4) &&
+                    File::Delete(filename);
+      }
+      else
+      {
+        backed_up = File::Rename(filename, last_state_filename);
+      }
+
+      if (!backed_up)
       {
         Core::DisplayMessage("Failed to move previous state to state undo backup", 1000);
       }
@@ -495,6 +700,8 @@ void SaveAs(Core::System& system, const std::string& filename, bool wait)
         current_buffer.resize(buffer_size);
         ptr = current_buffer.data();
         PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
+        std::vector<PointerWrap::Section> sections;
+        p.SetSectionLog(&sections);
         DoState(system, p);
 
         if (p.IsWriteMode())
@@ -505,6 +712,7 @@ void SaveAs(Core::System& system, const std::string& filename, bool wait)
 
           CompressAndDumpState_args save_args;
           save_args.buffer_vector = std::move(current_buffer);
+          save_args.sections = std::move(sections);
           save_args.filename = filename;
           if (wait)
           {
@@ -662,6 +870,11 @@ u64 GetUnixTimeOfSlot(int slot)
   if (!ReadHeader(MakeStateFilename(slot), header))
     return 0;
 
+  return GetUnixTime(header);
+}
+
+u64 GetUnixTime(const StateHeader& header)
+{
   constexpr u64 MS_PER_SEC = 1000;
   return static_cast<u64>(header.legacy_header.time * MS_PER_SEC) +
          (DOUBLE_TIME_OFFSET * MS_PER_SEC);
@@ -770,44 +983,122 @@ static bool ValidateHeaders(const StateHeader& header)
   return success;
 }
 
-static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
+static bool ReadChunkManifest(File::IOFile& f, std::vector<ChunkReference>& manifest)
 {
-  File::IOFile f;
+  u64 chunk_count;
+  if (!f.ReadArray(&chunk_count, 1))
+    return false;
+
+  // Don't let a corrupted count trigger a huge allocation.
+  if (chunk_count > (f.GetSize() - f.Tell()) / sizeof(ChunkReference))
+    return false;
+
+  manifest.resize(chunk_count);
+  return f.ReadArray(manifest.data(), manifest.size());
+}
+
+static bool IsSupportedExtendedHeaderVersion(u16 version)
+{
+  // Version 1 only lacks the section index.
+  return version == 1 || version == EXTENDED_HEADER_VERSION;
+}
 
+// Reads up to the payload of a state file without reporting any errors, as this is used to scan
+// directories which may also contain other files.
+static bool SkipToPayload(File::IOFile& f, StateExtendedBaseHeader& base_header)
+{
+  StateHeaderLegacy legacy_header;
+  StateHeaderVersion version_header;
+  return f.ReadArray(&legacy_header, 1) && legacy_header.lzo_size == 0 &&
+         f.ReadArray(&version_header, 1) && version_header.version_cookie >= COOKIE_BASE &&
+         f.Seek(version_header.version_string_length, File::SeekOrigin::Current) &&
+         f.ReadArray(&base_header, 1) &&
+         IsSupportedExtendedHeaderVersion(base_header.header_version) &&
+         f.Seek(base_header.payload_offset, File::SeekOrigin::Current);
+}
+
+std::optional<CompressionType> GetCompressionTypeOfStateFile(const std::string& filename)
+{
+  File::IOFile f(filename, "rb");
+  StateExtendedBaseHeader base_header;
+  if (!SkipToPayload(f, base_header))
+    return std::nullopt;
+
+  return static_cast<CompressionType>(base_header.compression_type);
+}
+
+// Reads the chunk manifest of a state file without touching the chunk store. manifest is left empty
+// if the file isn't a state using the chunk store. Only returns false if it is, but its manifest
+// can't be read.
+static bool ReadChunkManifestFromFile(const std::string& filename,
+                                      std::vector<ChunkReference>& manifest)
+{
+  manifest.clear();
+
+  File::IOFile f(filename, "rb");
+  StateExtendedBaseHeader base_header;
+  if (!SkipToPayload(f, base_header) ||
+      base_header.compression_type != CompressionType::ChunkManifest)
   {
-    // If a state is currently saving, wait for that to end or time out.
-    std::unique_lock lk(s_state_writes_in_queue_mutex);
-    if (s_state_writes_in_queue != 0)
-    {
-      if (!s_state_write_queue_is_empty.wait_for(lk, std::chrono::seconds(3),
-                                                 []() { return s_state_writes_in_queue == 0; }))
-      {
-        Core::DisplayMessage(
-            "A previous state saving operation is still in progress, cancelling load.", 2000);
-        return;
-      }
-    }
-    f.Open(filename, "rb");
+    return true;
   }
 
-  StateHeader header;
-  if (!ReadStateHeaderFromFile(header, f) || !ValidateHeaders(header))
-    return;
+  return ReadChunkManifest(f, manifest) && !manifest.empty();
+}
 
-  StateExtendedHeader extended_header;
-  if (!f.ReadArray(&extended_header.base_header, 1))
+static bool IsChunkStoreStateFile(const std::string& filename)
+{
+  return GetCompressionTypeOfStateFile(filename) == CompressionType::ChunkManifest;
+}
+
+// Reads the extended header and leaves f at the start of the payload.
+static bool ReadExtendedHeader(File::IOFile& f, StateExtendedHeader& extended_header)
+{
+  StateExtendedBaseHeader& base_header = extended_header.base_header;
+  if (!f.ReadArray(&base_header, 1))
   {
     PanicAlertFmt("Unable to read state header");
-    return;
+    return false;
   }
-  // If StateExtendedHeader is amended to include more than the base, add ReadBytes() calls here.
 
-  if (extended_header.base_header.header_version != EXTENDED_HEADER_VERSION)
+  if (!IsSupportedExtendedHeaderVersion(base_header.header_version))
   {
     PanicAlertFmt("State header corrupted");
-    return;
+    return false;
+  }
+
+  const u64 payload_start = f.Tell() + base_header.payload_offset;
+
+  StateSectionIndexHeader& section_index_header = extended_header.section_index_header;
+  section_index_header = {};
+  extended_header.sections.clear();
+  if (base_header.header_version >= 2)
+  {
+    if (!f.ReadArray(&section_index_header, 1) ||
+        sizeof(StateSectionIndexHeader) +
+                u64{section_index_header.section_count} * sizeof(StateSectionIndexEntry) >
+            base_header.payload_offset)
+    {
+      PanicAlertFmt("State section index corrupted");
+      return false;
+    }
+
+    extended_header.sections.resize(section_index_header.section_count);
+    if (!f.ReadArray(extended_header.sections.data(), extended_header.sections.size()))
+    {
+      PanicAlertFmt("Unable to read state section index");
+      return false;
+    }
   }
+  // If StateExtendedHeader is amended to include more, add ReadBytes() calls here.
+
+  return f.Seek(payload_start, File::SeekOrigin::Begin);
+}
 
+static bool ReadStatePayload(const std::string& filename,
+                             const StateExtendedHeader& extended_header, File::IOFile& f,
+                             std::vector<u8>& ret_data)
+{
   std::vector<u8> buffer;
 
   switch (extended_header.base_header.compression_type)
@@ -816,21 +1107,18 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
   {
     Core::DisplayMessage("Decompressing State...", 500);
     if (!DecompressLZ4(buffer, extended_header.base_header.uncompressed_size, f))
-      return;
+      return false;
 
     break;
   }
   case CompressionType::Uncompressed:
   {
-    u64 header_len = sizeof(StateHeaderLegacy) + sizeof(StateHeaderVersion) +
-                     header.version_header.version_string_length + sizeof(StateExtendedBaseHeader) +
-                     extended_header.base_header.payload_offset;
-
-    u64 file_size = f.GetSize();
+    const u64 header_len = f.Tell();
+    const u64 file_size = f.GetSize();
     if (file_size < header_len)
     {
       PanicAlertFmt("State header length corrupted");
-      return;
+      return false;
     }
 
     const auto size = static_cast<size_t>(file_size - header_len);
@@ -839,17 +1127,356 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
     if (!f.ReadBytes(buffer.data(), size))
     {
       PanicAlertFmt("Error reading bytes: {0}", size);
-      return;
+      return false;
+    }
+    break;
+  }
+  case CompressionType::ChunkManifest:
+  {
+    std::vector<ChunkReference> manifest;
+    if (!ReadChunkManifest(f, manifest))
+    {
+      PanicAlertFmt("Could not read state chunk manifest");
+      return false;
+    }
+
+    const std::string store_directory = ChunkStore::GetDirectoryForState(filename);
+    if (!GetChunkStore(store_directory).Load(manifest, buffer))
+    {
+      PanicAlertFmt("Could not read state data from chunk store {0}", store_directory);
+      return false;
+    }
+
+    if (buffer.size() != extended_header.base_header.uncompressed_size)
+    {
+      PanicAlertFmt("State payload size mismatch ({0} / {1})", buffer.size(),
+                    extended_header.base_header.uncompressed_size);
+      return false;
     }
     break;
   }
   default:
     PanicAlertFmt("Unknown compression type {0}", extended_header.base_header.compression_type);
-    return;
+    return false;
   }
 
-  // all good
   ret_data.swap(buffer);
+  return true;
+}
+
+// Opens a state file and reads all of its headers, leaving f at the start of the payload.
+static bool OpenStateFile(const std::string& filename, File::IOFile& f, StateHeader& header,
+                          StateExtendedHeader& extended_header)
+{
+  f.Open(filename, "rb");
+  if (!ReadStateHeaderFromFile(header, f))
+    return false;
+
+  // States from before the switch to LZ4 can't be decompressed anymore.
+  if (header.legacy_header.lzo_size != 0)
+    return false;
+
+  return ReadExtendedHeader(f, extended_header);
+}
+
+bool ReadStateFileHeaders(const std::string& filename, StateHeader& header,
+                          StateExtendedHeader& extended_header)
+{
+  File::IOFile f;
+  return OpenStateFile(filename, f, header, extended_header);
+}
+
+const StateSectionIndexEntry* FindSection(const StateExtendedHeader& extended_header,
+                                          std::string_view name)
+{
+  const auto it = std::find_if(extended_header.sections.begin(), extended_header.sections.end(),
+                               [name](const StateSectionIndexEntry& section) {
+                                 return std::string_view(section.name,
+                                                         strnlen(section.name,
+                                                                 std::size(section.name))) == name;
+                               });
+  return it != extended_header.sections.end() ? &*it : nullptr;
+}
+
+// Decompresses the LZ4 blocks of a payload that overlap [offset, offset + data.size()), skipping
+// over all others.
+static bool DecompressLZ4Range(File::IOFile& f, u32 block_size, u64 payload_size, u64 offset,
+                               std::span<u8> data)
+{
+  const u64 end = offset + data.size();
+  std::vector<char> compressed_block;
+  std::vector<u8> block;
+
+  for (u64 block_start = 0; block_start < end; block_start += block_size)
+  {
+    s32 compressed_len;
+    if (!f.ReadArray(&compressed_len, 1) || compressed_len <= 0)
+      return false;
+
+    if (block_start + block_size <= offset)
+    {
+      if (!f.Seek(compressed_len, File::SeekOrigin::Current))
+        return false;
+      continue;
+    }
+
+    const u64 block_len = std::min<u64>(block_size, payload_size - block_start);
+    compressed_block.resize(compressed_len);
+    block.resize(block_len);
+    if (!f.ReadBytes(compressed_block.data(), compressed_len))
+      return false;
+
+    const int bytes_read =
+        LZ4_decompress_safe(compressed_block.data(), reinterpret_cast<char*>(block.data()),
+                            compressed_len, static_cast<int>(block_len));
+    if (bytes_read != static_cast<int>(block_len))
+      return false;
+
+    const u64 copy_start = std::max(offset, block_start);
+    const u64 copy_end = std::min(end, block_start + block_len);
+    std::copy(block.begin() + (copy_start - block_start), block.begin() + (copy_end - block_start),
+              data.begin() + (copy_start - offset));
+  }
+
+  return true;
+}
+
+bool ReadStatePayloadRange(const std::string& filename, u64 offset, u64 size,
+                           std::vector<u8>& data)
+{
+  File::IOFile f;
+  StateHeader header;
+  StateExtendedHeader extended_header;
+  if (!OpenStateFile(filename, f, header, extended_header))
+    return false;
+
+  const StateExtendedBaseHeader& base_header = extended_header.base_header;
+  if (offset > base_header.uncompressed_size || size > base_header.uncompressed_size - offset)
+    return false;
+
+  data.resize(size);
+  if (size == 0)
+    return true;
+
+  switch (base_header.compression_type)
+  {
+  case CompressionType::Uncompressed:
+    return f.Seek(offset, File::SeekOrigin::Current) && f.ReadBytes(data.data(), size);
+
+  case CompressionType::LZ4:
+  {
+    const u32 block_size = extended_header.section_index_header.lz4_block_size;
+    if (block_size != 0)
+      return DecompressLZ4Range(f, block_size, base_header.uncompressed_size, offset, data);
+
+    // Older states are compressed as a single block, so there is nothing to skip.
+    std::vector<u8> payload;
+    if (!DecompressLZ4(payload, base_header.uncompressed_size, f))
+      return false;
+    std::copy_n(payload.begin() + offset, size, data.begin());
+    return true;
+  }
+
+  case CompressionType::ChunkManifest:
+  {
+    std::vector<ChunkReference> manifest;
+    if (!ReadChunkManifest(f, manifest))
+      return false;
+
+    // Only fetch the chunks overlapping the range.
+    size_t first = 0;
+    u64 first_offset = 0;
+    while (first < manifest.size() && first_offset + manifest[first].size <= offset)
+      first_offset += manifest[first++].size;
+
+    size_t last = first;
+    u64 last_end = first_offset;
+    while (last < manifest.size() && last_end < offset + size)
+      last_end += manifest[last++].size;
+
+    std::vector<u8> chunks;
+    const std::span<const ChunkReference> needed(manifest.data() + first, last - first);
+    if (!GetChunkStore(ChunkStore::GetDirectoryForState(filename)).Load(needed, chunks) ||
+        chunks.size() < offset - first_offset + size)
+    {
+      return false;
+    }
+
+    std::copy_n(chunks.begin() + (offset - first_offset), size, data.begin());
+    return true;
+  }
+
+  default:
+    return false;
+  }
+}
+
+bool ReadStateFile(const std::string& filename, StateHeader& header,
+                   StateExtendedHeader& extended_header, std::vector<u8>& payload)
+{
+  File::IOFile f;
+  return OpenStateFile(filename, f, header, extended_header) &&
+         ReadStatePayload(filename, extended_header, f, payload);
+}
+
+bool ConvertStateFile(const std::string& in_filename, const std::string& out_filename,
+                      CompressionType compression_type)
+{
+  StateHeader header;
+  StateExtendedHeader extended_header;
+  std::vector<u8> payload;
+  if (!ReadStateFile(in_filename, header, extended_header, payload))
+    return false;
+
+  const std::string temp_filename = out_filename + ".tmp";
+  File::IOFile f(temp_filename, "wb");
+  if (!f)
+    return false;
+
+  WriteHeadersToFile(header, payload.size(), compression_type, extended_header.sections, f);
+  const bool written = WritePayloadToFile(out_filename, compression_type, payload, f);
+  if (!f.Close() || !written)
+  {
+    File::Delete(temp_filename);
+    return false;
+  }
+
+  return File::Rename(temp_filename, out_filename);
+}
+
+bool CollectChunkStore(const std::string& directory, u64* bytes_freed)
+{
+  if (bytes_freed)
+    *bytes_freed = 0;
+
+  const std::string store_directory = ChunkStore::GetDirectoryForState(directory + DIR_SEP);
+  if (!File::IsDirectory(store_directory))
+    return true;
+
+  std::set<ChunkHash> live_chunks;
+  std::vector<ChunkReference> manifest;
+  for (const File::FSTEntry& entry : File::ScanDirectoryTree(directory, false).children)
+  {
+    if (entry.isDirectory)
+      continue;
+
+    // Refuse to collect anything if a manifest is unreadable, as its chunks would be lost.
+    if (!ReadChunkManifestFromFile(entry.physicalName, manifest))
+    {
+      ERROR_LOG_FMT(CORE, "Unable to read chunk manifest of {}", entry.physicalName);
+      return false;
+    }
+
+    for (const ChunkReference& reference : manifest)
+      live_chunks.insert(reference.hash);
+  }
+
+  return GetChunkStore(store_directory).Collect(live_chunks, bytes_freed);
+}
+
+static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
+{
+  File::IOFile f;
+
+  {
+    // If a state is currently saving, wait for that to end or time out.
+    std::unique_lock lk(s_state_writes_in_queue_mutex);
+    if (s_state_writes_in_queue != 0)
+    {
+      if (!s_state_write_queue_is_empty.wait_for(lk, std::chrono::seconds(3),
+                                                 []() { return s_state_writes_in_queue == 0; }))
+      {
+        Core::DisplayMessage(
+            "A previous state saving operation is still in progress, cancelling load.", 2000);
+        return;
+      }
+    }
+    f.Open(filename, "rb");
+  }
+
+  StateHeader header;
+  if (!ReadStateHeaderFromFile(header, f) || !ValidateHeaders(header))
+    return;
+
+  StateExtendedHeader extended_header;
+  if (!ReadExtendedHeader(f, extended_header))
+    return;
+
+  ReadStatePayload(filename, extended_header, f, ret_data);
+}
+
+static void RunPrefetch(const PrefetchState_args& args)
+{
+  {
+    std::lock_guard lk(s_prefetch_mutex);
+    if (s_prefetched_state.id != args.id)
+      return;
+  }
+
+  auto buffer = std::make_shared<std::vector<u8>>();
+  LoadFileStateData(args.filename, *buffer);
+
+  std::lock_guard lk(s_prefetch_mutex);
+  // The state may have been superseded by another prefetch or overwritten while it was being read.
+  if (s_prefetched_state.id == args.id)
+  {
+    s_prefetched_state.pending = false;
+    if (!buffer->empty())
+      s_prefetched_state.buffer = std::move(buffer);
+    else
+      s_prefetched_state = {};
+  }
+  s_prefetch_done.notify_all();
+}
+
+// Returns the payload of the given state if it has been prefetched, waiting for the prefetch to
+// finish if it's still in progress. The buffer stays cached, so loading the same state again
+// doesn't need to read it again, unless the file has changed since it was prefetched.
+static std::shared_ptr<std::vector<u8>> GetPrefetchedState(const std::string& filename)
+{
+  const StateFileVersion version = GetStateFileVersion(filename);
+
+  std::unique_lock lk(s_prefetch_mutex);
+  if (s_prefetched_state.filename != filename)
+    return nullptr;
+
+  if (s_prefetched_state.version != version)
+  {
+    s_prefetched_state = {};
+    s_prefetch_done.notify_all();
+    return nullptr;
+  }
+
+  const u64 id = s_prefetched_state.id;
+  s_prefetch_done.wait(
+      lk, [id] { return s_prefetched_state.id != id || !s_prefetched_state.pending; });
+  if (s_prefetched_state.id != id)
+    return nullptr;
+
+  return s_prefetched_state.buffer;
+}
+
+void PrefetchState(Core::System& system, const std::string& filename)
+{
+  if (!Core::IsRunningOrStarting(system))
+    return;
+
+  const StateFileVersion version = GetStateFileVersion(filename);
+
+  PrefetchState_args args;
+  {
+    std::lock_guard lk(s_prefetch_mutex);
+    if (s_prefetched_state.filename == filename && s_prefetched_state.version == version)
+      return;
+
+    args.id = s_next_prefetch_id++;
+    args.filename = filename;
+    s_prefetched_state = {
+        .id = args.id, .filename = filename, .version = version, .pending = true, .buffer = {}};
+    s_prefetch_done.notify_all();
+  }
+
+  s_prefetch_thread.EmplaceItem(std::move(args));
 }
 
 void LoadAs(Core::System& system, const std::string& filename)
@@ -894,8 +1521,11 @@ void LoadAs(Core::System& system, const std::string& filename)
 
         // brackets here are so buffer gets freed ASAP
         {
-          std::vector<u8> buffer;
-          LoadFileStateData(filename, buffer);
+          std::shared_ptr<std::vector<u8>> prefetched_buffer = GetPrefetchedState(filename);
+          std::vector<u8> loaded_buffer;
+          if (!prefetched_buffer)
+            LoadFileStateData(filename, loaded_buffer);
+          std::vector<u8>& buffer = prefetched_buffer ? *prefetched_buffer : loaded_buffer;
 
           if (!buffer.empty())
           {
@@ -954,11 +1584,25 @@ void Init(Core::System& system)
     if (args.state_write_done_event)
       args.state_write_done_event->Set();
   });
+
+  s_prefetch_thread.Reset("Savestate Prefetch", RunPrefetch);
 }
 
 void Shutdown()
 {
   s_save_thread.Shutdown();
+  s_prefetch_thread.Shutdown();
+
+  {
+    std::lock_guard lk(s_prefetch_mutex);
+    s_prefetched_state = {};
+    s_prefetch_done.notify_all();
+  }
+
+  {
+    std::lock_guard lk(s_chunk_stores_mutex);
+    s_chunk_stores.clear();
+  }
 
   // swapping with an empty vector, rather than clear()ing
   // this gives a better guarantee to free the allocated memory right NOW (as opposed to, actually,
@@ -985,6 +1629,11 @@ void Load(Core::System& system, int slot)
   LoadAs(system, MakeStateFilename(slot));
 }
 
+void PrefetchState(Core::System& system, int slot)
+{
+  PrefetchState(system, MakeStateFilename(slot));
+}
+
 void LoadLastSaved(Core::System& system, int i)
 {
   if (i <= 0)
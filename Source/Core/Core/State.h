@@ -5,9 +5,12 @@
 
 #pragma once
 
+#include <compare>
 #include <cstddef>
 #include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -55,6 +58,8 @@ enum CompressionType : u16
 {
   Uncompressed = 0,
   LZ4 = 1,
+  // The payload is a chunk manifest, see StateChunkStore.h.
+  ChunkManifest = 2,
   // Add new compression types after this, as the compression type
   // is numerically stored in the state file.
 };
@@ -72,11 +77,38 @@ static_assert(offsetof(StateExtendedBaseHeader, payload_offset) == 4);
 static_assert(offsetof(StateExtendedBaseHeader, uncompressed_size) == 8);
 static_assert(std::is_trivially_copyable_v<StateExtendedBaseHeader>);
 
+// Table of contents of the payload, giving the location of each section recorded with
+// PointerWrap::DoSection(). Sections may be nested; nested sections are listed before the section
+// containing them.
+struct StateSectionIndexHeader
+{
+  u32 section_count;
+  // Uncompressed size of every LZ4 block of the payload except for the last one, so that a
+  // section can be read by only decompressing the blocks covering it. 0 if the payload isn't LZ4
+  // compressed.
+  u32 lz4_block_size;
+};
+static_assert(sizeof(StateSectionIndexHeader) == 8);
+static_assert(std::is_trivially_copyable_v<StateSectionIndexHeader>);
+
+struct StateSectionIndexEntry
+{
+  char name[32];  // Null-padded
+  u64 offset;     // Within the uncompressed payload
+  u64 size;
+};
+static_assert(sizeof(StateSectionIndexEntry) == 48);
+static_assert(std::is_trivially_copyable_v<StateSectionIndexEntry>);
+
 struct StateExtendedHeader
 {
   StateExtendedBaseHeader base_header;
+  // The section index is stored between the base header and the payload, and is accounted for in
+  // payload_offset. States with extended header version 1 don't have one.
+  StateSectionIndexHeader section_index_header;
+  std::vector<StateSectionIndexEntry> sections;
   // Feel free to add new fields here, adjusting COMPRESSED_DATA_OFFSET accordingly, as well as
-  // CreateExtendedHeader(). Add the appropriate IOFile read/write calls within LoadFileStateData()
+  // CreateExtendedHeader(). Add the appropriate IOFile read/write calls within ReadExtendedHeader()
   // and WriteHeadersToFile()
 };
 
@@ -88,6 +120,37 @@ void EnableCompression(bool compression);
 
 bool ReadHeader(const std::string& filename, StateHeader& header);
 
+// Returns how the payload of a state file is stored, or nullopt if the file isn't a state in the
+// current format. Doesn't report any errors, so it can be used to probe arbitrary files.
+std::optional<CompressionType> GetCompressionTypeOfStateFile(const std::string& filename);
+
+// Reads all headers of a state file, including its section index, without reading the payload.
+bool ReadStateFileHeaders(const std::string& filename, StateHeader& header,
+                          StateExtendedHeader& extended_header);
+
+// Returns the section with the given name, or nullptr if the state has no such section.
+const StateSectionIndexEntry* FindSection(const StateExtendedHeader& extended_header,
+                                          std::string_view name);
+
+// Reads size bytes starting at offset of the uncompressed payload of a state file. Only the parts
+// of the payload covering that range are decompressed, provided that the state has a section index.
+bool ReadStatePayloadRange(const std::string& filename, u64 offset, u64 size,
+                           std::vector<u8>& data);
+
+// Reads the headers and the decompressed payload of a state file. Unlike loading a state, this
+// doesn't check whether the state belongs to the running game or Dolphin version.
+bool ReadStateFile(const std::string& filename, StateHeader& header,
+                   StateExtendedHeader& extended_header, std::vector<u8>& payload);
+
+// Rewrites a state file using the given compression type, keeping its original headers.
+// in_filename and out_filename may be the same.
+bool ConvertStateFile(const std::string& in_filename, const std::string& out_filename,
+                      CompressionType compression_type);
+
+// Drops every chunk from the chunk store of the given directory which isn't referenced by one of
+// the state files in that directory. Must not run while states are being saved to that directory.
+bool CollectChunkStore(const std::string& directory, u64* bytes_freed = nullptr);
+
 // Returns a string containing information of the savestate in the given slot
 // which can be presented to the user for identification purposes
 std::string GetInfoStringOfSlot(int slot, bool translate = true);
@@ -95,6 +158,9 @@ std::string GetInfoStringOfSlot(int slot, bool translate = true);
 // Returns when the savestate in the given slot was created, or 0 if the slot is empty.
 u64 GetUnixTimeOfSlot(int slot);
 
+// Returns when the state with the given header was created, in milliseconds since the Unix epoch.
+u64 GetUnixTime(const StateHeader& header);
+
 // These don't happen instantly - they get scheduled as events.
 // ...But only if we're not in the main CPU thread.
 //    If we're in the main CPU thread then they run immediately instead
@@ -106,9 +172,29 @@ void Load(Core::System& system, int slot);
 void SaveAs(Core::System& system, const std::string& filename, bool wait = false);
 void LoadAs(Core::System& system, const std::string& filename);
 
+// Reads and decompresses a state on a worker thread ahead of time, so that a later Load() or
+// LoadAs() of it only has to apply it. The most recently prefetched state stays cached until
+// another one is prefetched or the file is overwritten by a save.
+void PrefetchState(Core::System& system, int slot);
+void PrefetchState(Core::System& system, const std::string& filename);
+
 void SaveToBuffer(Core::System& system, std::vector<u8>& buffer);
 void LoadFromBuffer(Core::System& system, std::vector<u8>& buffer);
 
+struct StateHash
+{
+  u64 low;
+  u64 high;
+
+  auto operator<=>(const StateHash&) const = default;
+};
+
+// Hashes the emulated state without serializing it into a buffer, using XXH3-128. The EFB is read
+// back and hashed at native resolution. Host-only state, like the texture cache copies of host GPU
+// resources or the free-look camera, is left out, so two states which would behave the same hash
+// the same regardless of the internal resolution they were rendered at or of free-look use.
+StateHash GetStateHash(Core::System& system);
+
 void LoadLastSaved(Core::System& system, int i = 1);
 void SaveFirstSaved(Core::System& system);
 void UndoSaveState(Core::System& system);
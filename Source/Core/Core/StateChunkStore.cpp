@@ -0,0 +1,440 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/StateChunkStore.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+#include <lz4.h>
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+namespace State
+{
+namespace
+{
+constexpr char CHUNK_STORE_DIRECTORY_NAME[] = "ChunkStore";
+constexpr char PACK_FILE_NAME[] = "chunks.pack";
+
+constexpr u32 PACK_MAGIC = 0x50534344;  // "DCSP"
+constexpr u32 PACK_VERSION = 1;
+
+struct PackFileHeader
+{
+  u32 magic;
+  u32 version;
+};
+static_assert(std::is_trivially_copyable_v<PackFileHeader>);
+
+// Every chunk in the pack file is preceded by this header. If stored_size equals size, the chunk
+// is stored uncompressed, otherwise it is LZ4 compressed.
+struct PackRecordHeader
+{
+  ChunkHash hash;
+  u32 size;
+  u32 stored_size;
+};
+static_assert(sizeof(PackRecordHeader) == 24);
+static_assert(std::is_trivially_copyable_v<PackRecordHeader>);
+
+// Chunk boundaries are placed where the top bits of a gear rolling hash are all zero. The hash
+// covers the last 64 bytes, so identical data produces identical boundaries no matter where it is
+// located in the payload, which is what lets a shifted MEM1 or MEM2 block still deduplicate.
+constexpr size_t MIN_CHUNK_SIZE = 0x1000;
+constexpr size_t MAX_CHUNK_SIZE = 0x10000;
+constexpr u64 BOUNDARY_MASK = 0xFFFC000000000000;  // 14 bits, 16 KiB average after the minimum
+
+constexpr std::array<u64, 256> GEAR_TABLE = [] {
+  // splitmix64, so that the table is fixed across builds and platforms.
+  std::array<u64, 256> table{};
+  u64 state = 0x2545F4914F6CDD1D;
+  for (u64& entry : table)
+  {
+    state += 0x9E3779B97F4A7C15;
+    u64 z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    entry = z ^ (z >> 31);
+  }
+  return table;
+}();
+
+ChunkHash HashChunk(const u8* data, size_t size)
+{
+  const XXH128_hash_t hash = XXH3_128bits(data, size);
+  return ChunkHash{hash.low64, hash.high64};
+}
+}  // namespace
+
+ChunkStore::ChunkStore(std::string directory)
+    : m_directory(std::move(directory)), m_pack_path(m_directory + DIR_SEP + PACK_FILE_NAME)
+{
+}
+
+ChunkStore::~ChunkStore() = default;
+
+std::string ChunkStore::GetDirectoryForState(const std::string& state_filename)
+{
+  std::string path;
+  SplitPath(state_filename, &path, nullptr, nullptr);
+  return path + CHUNK_STORE_DIRECTORY_NAME;
+}
+
+std::vector<size_t> ChunkStore::Split(std::span<const u8> data)
+{
+  std::vector<size_t> chunk_sizes;
+
+  size_t start = 0;
+  while (start < data.size())
+  {
+    const size_t remaining = data.size() - start;
+    if (remaining <= MIN_CHUNK_SIZE)
+    {
+      chunk_sizes.push_back(remaining);
+      break;
+    }
+
+    const size_t limit = std::min(remaining, MAX_CHUNK_SIZE);
+    const u8* const ptr = data.data() + start;
+
+    size_t size = MIN_CHUNK_SIZE;
+    u64 hash = 0;
+    for (; size < limit; ++size)
+    {
+      hash = (hash << 1) + GEAR_TABLE[ptr[size]];
+      if ((hash & BOUNDARY_MASK) == 0)
+      {
+        ++size;
+        break;
+      }
+    }
+
+    chunk_sizes.push_back(size);
+    start += size;
+  }
+
+  return chunk_sizes;
+}
+
+bool ChunkStore::EnsureOpen()
+{
+  if (m_pack.IsOpen())
+    return true;
+
+  if (!File::CreateDirs(m_directory))
+  {
+    ERROR_LOG_FMT(CORE, "Failed to create savestate chunk store {}", m_directory);
+    return false;
+  }
+
+  m_index.clear();
+
+  // Opening with "ab" first creates the pack without truncating one that another process might be
+  // using
+  File::IOFile(m_pack_path, "ab").Close();
+  if (!m_pack.Open(m_pack_path, "r+b"))
+    return false;
+
+  // Records are appended without any coordination, so only one process may use the pack at a time
+  if (!m_pack.TryLockExclusive())
+  {
+    ERROR_LOG_FMT(CORE, "Savestate chunk pack {} is in use by another process", m_pack_path);
+    m_pack.Close();
+    return false;
+  }
+
+  if (m_pack.GetSize() == 0)
+  {
+    const PackFileHeader header{PACK_MAGIC, PACK_VERSION};
+    if (!m_pack.WriteArray(&header, 1) || !m_pack.Flush())
+    {
+      m_pack.Close();
+      return false;
+    }
+    m_pack_size = sizeof(PackFileHeader);
+    return true;
+  }
+
+  PackFileHeader header;
+  if (!m_pack.ReadArray(&header, 1) || header.magic != PACK_MAGIC ||
+      header.version != PACK_VERSION)
+  {
+    ERROR_LOG_FMT(CORE, "{} is not a valid savestate chunk pack", m_pack_path);
+    m_pack.Close();
+    return false;
+  }
+
+  // The pack has no separate index, so rebuild it by walking the record headers.
+  const u64 file_size = m_pack.GetSize();
+  u64 offset = sizeof(PackFileHeader);
+  bool truncated_record = false;
+  while (offset < file_size)
+  {
+    // A record which doesn't fit in the file was being appended when a write was interrupted.
+    // It can only be the last one, and no savestate can be referring to it.
+    if (offset + sizeof(PackRecordHeader) > file_size)
+    {
+      truncated_record = true;
+      break;
+    }
+
+    PackRecordHeader record;
+    const u64 data_offset = offset + sizeof(PackRecordHeader);
+    if (!m_pack.Seek(offset, File::SeekOrigin::Begin) || !m_pack.ReadArray(&record, 1) ||
+        record.stored_size > record.size)
+    {
+      // Anything else means the pack is damaged. It is left alone, since discarding the records
+      // after this one would break the savestates referring to them.
+      ERROR_LOG_FMT(CORE, "{} has an invalid record at offset {:#x}", m_pack_path, offset);
+      m_pack.Close();
+      return false;
+    }
+
+    if (data_offset + record.stored_size > file_size)
+    {
+      truncated_record = true;
+      break;
+    }
+
+    m_index.emplace(record.hash, ChunkLocation{data_offset, record.size, record.stored_size});
+    offset = data_offset + record.stored_size;
+  }
+
+  if (truncated_record)
+  {
+    WARN_LOG_FMT(CORE, "Truncating incomplete record at the end of {}", m_pack_path);
+    m_pack.ClearError();
+    if (!m_pack.Resize(offset))
+    {
+      m_pack.Close();
+      return false;
+    }
+  }
+
+  m_pack_size = offset;
+  return true;
+}
+
+std::optional<std::vector<ChunkReference>> ChunkStore::Store(std::span<const u8> data)
+{
+  std::lock_guard lk(m_mutex);
+
+  if (!EnsureOpen())
+    return std::nullopt;
+
+  std::vector<ChunkReference> manifest;
+  bool pack_modified = false;
+
+  size_t offset = 0;
+  for (const size_t size : Split(data))
+  {
+    const u8* const chunk = data.data() + offset;
+    offset += size;
+
+    const ChunkHash hash = HashChunk(chunk, size);
+    manifest.push_back(ChunkReference{hash, size});
+
+    if (m_index.contains(hash))
+      continue;
+
+    const int bound = LZ4_compressBound(static_cast<int>(size));
+    m_scratch.resize(bound);
+    const int compressed_size = LZ4_compress_default(reinterpret_cast<const char*>(chunk),
+                                                     reinterpret_cast<char*>(m_scratch.data()),
+                                                     static_cast<int>(size), bound);
+
+    // Incompressible chunks are stored as is.
+    const bool compressed = compressed_size > 0 && static_cast<size_t>(compressed_size) < size;
+    const u8* const stored_data = compressed ? m_scratch.data() : chunk;
+    const u32 stored_size = static_cast<u32>(compressed ? compressed_size : size);
+
+    const PackRecordHeader record{hash, static_cast<u32>(size), stored_size};
+    if (!m_pack.Seek(m_pack_size, File::SeekOrigin::Begin) || !m_pack.WriteArray(&record, 1) ||
+        !m_pack.WriteBytes(stored_data, stored_size))
+    {
+      ERROR_LOG_FMT(CORE, "Failed to write to savestate chunk pack {}", m_pack_path);
+      m_pack.Close();
+      return std::nullopt;
+    }
+
+    const u64 data_offset = m_pack_size + sizeof(PackRecordHeader);
+    m_index.emplace(hash, ChunkLocation{data_offset, static_cast<u32>(size), stored_size});
+    m_pack_size = data_offset + stored_size;
+    pack_modified = true;
+  }
+
+  // The manifest referencing these chunks gets written right after this returns, so make sure the
+  // chunks actually made it to disk first.
+  if (pack_modified && !m_pack.Flush())
+  {
+    m_pack.Close();
+    return std::nullopt;
+  }
+
+  return manifest;
+}
+
+bool ChunkStore::ReadChunk(const ChunkHash& hash, const ChunkLocation& location, u8* out)
+{
+  if (!m_pack.Seek(location.offset, File::SeekOrigin::Begin))
+    return false;
+
+  if (location.stored_size == location.size)
+  {
+    if (!m_pack.ReadBytes(out, location.size))
+      return false;
+  }
+  else
+  {
+    m_scratch.resize(location.stored_size);
+    if (!m_pack.ReadBytes(m_scratch.data(), location.stored_size))
+      return false;
+
+    const int decompressed_size = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(m_scratch.data()), reinterpret_cast<char*>(out),
+        static_cast<int>(location.stored_size), static_cast<int>(location.size));
+    if (decompressed_size != static_cast<int>(location.size))
+      return false;
+  }
+
+  return HashChunk(out, location.size) == hash;
+}
+
+bool ChunkStore::Load(std::span<const ChunkReference> manifest, std::vector<u8>& data)
+{
+  std::lock_guard lk(m_mutex);
+
+  if (!EnsureOpen())
+    return false;
+
+  u64 total_size = 0;
+  for (const ChunkReference& reference : manifest)
+    total_size += reference.size;
+  data.resize(total_size);
+
+  u64 offset = 0;
+  for (const ChunkReference& reference : manifest)
+  {
+    const auto it = m_index.find(reference.hash);
+    if (it == m_index.end() || it->second.size != reference.size)
+    {
+      ERROR_LOG_FMT(CORE, "Savestate chunk {:016x}{:016x} is missing from {}", reference.hash.high,
+                    reference.hash.low, m_pack_path);
+      return false;
+    }
+
+    if (!ReadChunk(reference.hash, it->second, data.data() + offset))
+    {
+      ERROR_LOG_FMT(CORE, "Savestate chunk {:016x}{:016x} in {} is corrupted", reference.hash.high,
+                    reference.hash.low, m_pack_path);
+      m_pack.ClearError();
+      return false;
+    }
+
+    offset += reference.size;
+  }
+
+  return true;
+}
+
+bool ChunkStore::Collect(const std::set<ChunkHash>& live_chunks, u64* bytes_freed)
+{
+  std::lock_guard lk(m_mutex);
+
+  if (!EnsureOpen())
+    return false;
+
+  const std::string temp_path = m_pack_path + ".tmp";
+  File::IOFile new_pack(temp_path, "wb");
+  const PackFileHeader header{PACK_MAGIC, PACK_VERSION};
+  if (!new_pack.WriteArray(&header, 1))
+  {
+    ERROR_LOG_FMT(CORE, "Failed to write {}", temp_path);
+    new_pack.Close();
+    File::Delete(temp_path);
+    return false;
+  }
+
+  std::map<ChunkHash, ChunkLocation> new_index;
+  u64 new_size = sizeof(PackFileHeader);
+
+  // Walk the chunks in pack order to keep the copy sequential.
+  std::vector<std::pair<ChunkHash, ChunkLocation>> live;
+  for (const auto& [hash, location] : m_index)
+  {
+    if (live_chunks.contains(hash))
+      live.emplace_back(hash, location);
+  }
+  std::sort(live.begin(), live.end(),
+            [](const auto& a, const auto& b) { return a.second.offset < b.second.offset; });
+
+  for (const auto& [hash, location] : live)
+  {
+    m_scratch.resize(location.stored_size);
+    const PackRecordHeader record{hash, location.size, location.stored_size};
+    if (!m_pack.Seek(location.offset, File::SeekOrigin::Begin) ||
+        !m_pack.ReadBytes(m_scratch.data(), location.stored_size) ||
+        !new_pack.WriteArray(&record, 1) ||
+        !new_pack.WriteBytes(m_scratch.data(), location.stored_size))
+    {
+      ERROR_LOG_FMT(CORE, "Failed to copy chunks while collecting {}", m_pack_path);
+      new_pack.Close();
+      File::Delete(temp_path);
+      m_pack.ClearError();
+      return false;
+    }
+
+    const u64 data_offset = new_size + sizeof(PackRecordHeader);
+    new_index.emplace(hash, ChunkLocation{data_offset, location.size, location.stored_size});
+    new_size = data_offset + location.stored_size;
+  }
+
+  if (!new_pack.Close())
+  {
+    File::Delete(temp_path);
+    return false;
+  }
+
+  m_pack.Close();
+  if (!File::RenameSync(temp_path, m_pack_path))
+  {
+    File::Delete(temp_path);
+    return false;
+  }
+
+  if (bytes_freed)
+    *bytes_freed = m_pack_size - new_size;
+
+  // The lock was released along with the old pack. If another process took it in the meantime,
+  // that process now has the only say over the pack.
+  if (!m_pack.Open(m_pack_path, "r+b") || !m_pack.TryLockExclusive())
+  {
+    ERROR_LOG_FMT(CORE, "Failed to reopen savestate chunk pack {}", m_pack_path);
+    m_pack.Close();
+    return false;
+  }
+
+  m_index = std::move(new_index);
+  m_pack_size = new_size;
+  return true;
+}
+
+size_t ChunkStore::GetChunkCount()
+{
+  std::lock_guard lk(m_mutex);
+  return EnsureOpen() ? m_index.size() : 0;
+}
+
+u64 ChunkStore::GetPackSize()
+{
+  std::lock_guard lk(m_mutex);
+  return EnsureOpen() ? m_pack_size : 0;
+}
+}  // namespace State
@@ -0,0 +1,96 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Content-addressed storage for savestate payloads.
+//
+// Savestates of the same game share most of their contents (in particular the large MEM1, MEM2 and
+// ARAM blocks). A ChunkStore splits payloads into content-defined chunks, identifies each chunk by
+// its XXH3-128 hash and stores every distinct chunk only once in a pack file. A savestate using the
+// store then only contains a manifest listing the chunks making up its payload.
+
+#pragma once
+
+#include <compare>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+
+namespace State
+{
+struct ChunkHash
+{
+  u64 low;
+  u64 high;
+
+  auto operator<=>(const ChunkHash&) const = default;
+};
+static_assert(sizeof(ChunkHash) == 16);
+
+// One entry of a chunk manifest. In a state file, the manifest is stored as a u64 entry count
+// followed by that many ChunkReferences.
+struct ChunkReference
+{
+  ChunkHash hash;
+  u64 size;
+};
+static_assert(sizeof(ChunkReference) == 24);
+static_assert(std::is_trivially_copyable_v<ChunkReference>);
+
+// The pack file is locked while a ChunkStore has it open, so only one ChunkStore at a time, in
+// any process, can use a given directory. The others fail to store or load anything.
+class ChunkStore
+{
+public:
+  explicit ChunkStore(std::string directory);
+  ~ChunkStore();
+
+  ChunkStore(const ChunkStore&) = delete;
+  ChunkStore& operator=(const ChunkStore&) = delete;
+
+  // Every directory containing chunk store savestates has its own store in a subdirectory, so that
+  // a directory of states can be moved or garbage collected as a whole.
+  static std::string GetDirectoryForState(const std::string& state_filename);
+
+  // Splits data into content-defined chunks. The returned values are the chunk sizes.
+  static std::vector<size_t> Split(std::span<const u8> data);
+
+  // Adds all chunks of data which aren't in the store yet, and returns the manifest for data.
+  std::optional<std::vector<ChunkReference>> Store(std::span<const u8> data);
+
+  // Reassembles a payload from its manifest.
+  bool Load(std::span<const ChunkReference> manifest, std::vector<u8>& data);
+
+  // Rewrites the pack file, dropping every chunk which isn't in live_chunks.
+  bool Collect(const std::set<ChunkHash>& live_chunks, u64* bytes_freed = nullptr);
+
+  size_t GetChunkCount();
+  u64 GetPackSize();
+
+private:
+  struct ChunkLocation
+  {
+    u64 offset;
+    u32 size;
+    u32 stored_size;
+  };
+
+  bool EnsureOpen();
+  bool ReadChunk(const ChunkHash& hash, const ChunkLocation& location, u8* out);
+
+  std::string m_directory;
+  std::string m_pack_path;
+  File::IOFile m_pack;
+  u64 m_pack_size = 0;
+  std::map<ChunkHash, ChunkLocation> m_index;
+  std::vector<u8> m_scratch;
+  std::mutex m_mutex;
+};
+}  // namespace State
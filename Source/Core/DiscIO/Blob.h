@@ -17,6 +17,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -65,6 +66,10 @@ public:
 
   virtual BlobType GetBlobType() const = 0;
   virtual std::unique_ptr<BlobReader> CopyReader() const = 0;
+  // Like CopyReader, for the readers of a ParallelBlobReader's workers. Each of them decodes
+  // scattered blocks while the blocks around them go to the other workers, so reading ahead or
+  // caching many blocks would be wasted.
+  virtual std::unique_ptr<BlobReader> CopyReaderForWorker() const { return CopyReader(); }
 
   virtual u64 GetRawSize() const = 0;
   virtual u64 GetDataSize() const = 0;
@@ -87,6 +92,10 @@ public:
     return Common::FromBigEndian(temp);
   }
 
+  // Returns the data without copying it if the reader has it in memory, or an empty span if not.
+  // The span stays valid for as long as the reader exists.
+  virtual std::span<const u8> GetSpan(u64 offset, u64 size) { return {}; }
+
   virtual bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const
   {
     return false;
@@ -199,9 +208,15 @@ bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
                   CompressCB callback);
 bool ConvertToPlain(BlobReader* infile, const std::string& infile_path,
                     const std::string& outfile_path, CompressCB callback);
+// If chunk_store_path is set, the data is stored in the chunk store at that path (which is
+// created if it doesn't exist) and can be shared with other RVZ files using the same chunk store.
+// If zstd_dictionary is set (only allowed for RVZ with Zstandard), a dictionary is trained on the
+// disc and stored in the RVZ file, which improves compression for small block sizes. It is not
+// used together with a chunk store, since chunks would then only match within the same file.
 bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
                        const std::string& outfile_path, bool rvz,
                        WIARVZCompressionType compression_type, int compression_level,
-                       int chunk_size, CompressCB callback);
+                       int chunk_size, CompressCB callback,
+                       const std::string& chunk_store_path = {}, bool zstd_dictionary = false);
 
 }  // namespace DiscIO
@@ -9,6 +9,7 @@
 #include <cstring>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -63,13 +64,23 @@ bool ExportData(const Volume& volume, const Partition& partition, u64 offset, u6
     // Limit read size to 128 MB
     const size_t read_size = static_cast<size_t>(std::min<u64>(size, 0x08000000));
 
-    std::vector<u8> buffer(read_size);
+    // Memory-mapped images can be written out without a copy
+    const std::span<const u8> data = volume.GetSpan(offset, read_size, partition);
+    if (!data.empty())
+    {
+      if (!f.WriteBytes(data.data(), read_size))
+        return false;
+    }
+    else
+    {
+      std::vector<u8> buffer(read_size);
 
-    if (!volume.Read(offset, read_size, buffer.data(), partition))
-      return false;
+      if (!volume.Read(offset, read_size, buffer.data(), partition))
+        return false;
 
-    if (!f.WriteBytes(buffer.data(), read_size))
-      return false;
+      if (!f.WriteBytes(buffer.data(), read_size))
+        return false;
+    }
 
     size -= read_size;
     offset += read_size;
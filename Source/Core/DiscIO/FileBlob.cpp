@@ -11,13 +11,33 @@
 
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Core/Config/MainSettings.h"
 
 namespace DiscIO
 {
+// Reads at least this large get hints passed to the OS when the file is mapped into memory.
+constexpr u64 LARGE_READ_SIZE = 0x100000;
+
 PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
 {
   m_size = m_file.GetSize();
+
+  if (Config::Get(Config::MAIN_MAP_DISC_IMAGES) && m_size != 0)
+  {
+    m_mapped_data = static_cast<const u8*>(Common::MapFileReadOnly(m_file.GetHandle(), m_size));
+  }
+
+#ifdef HAVE_IO_URING
+  if (!m_mapped_data)
+    m_io_uring_reader = IOUringReader::Create();
+#endif
+}
+
+PlainFileReader::~PlainFileReader()
+{
+  Common::UnmapFile(m_mapped_data, m_size);
 }
 
 std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
@@ -35,6 +55,21 @@ std::unique_ptr<BlobReader> PlainFileReader::CopyReader() const
 
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  if (m_mapped_data)
+  {
+    const std::span<const u8> data = GetSpan(offset, nbytes);
+    if (data.size() != nbytes)
+      return false;
+
+    std::copy(data.begin(), data.end(), out_ptr);
+    return true;
+  }
+
+#ifdef HAVE_IO_URING
+  if (m_io_uring_reader && m_io_uring_reader->Read(m_file, offset, nbytes, out_ptr))
+    return true;
+#endif
+
   if (m_file.Seek(offset, File::SeekOrigin::Begin) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
@@ -46,6 +81,26 @@ bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
   }
 }
 
+std::span<const u8> PlainFileReader::GetSpan(u64 offset, u64 size)
+{
+  if (!m_mapped_data || offset > m_size || size > m_size - offset)
+    return {};
+
+  AdviseRead(offset, size);
+  return {m_mapped_data + offset, size};
+}
+
+void PlainFileReader::AdviseRead(u64 offset, u64 size)
+{
+  // Small reads are left to the OS's own readahead, since a syscall per read is what mapping
+  // the file avoids in the first place
+  if (size < LARGE_READ_SIZE)
+    return;
+
+  Common::AdviseSequentialAccess(m_mapped_data + offset, size);
+  Common::AdviseWillNeed(m_mapped_data + offset, size);
+}
+
 bool ConvertToPlain(BlobReader* infile, const std::string& infile_path,
                     const std::string& outfile_path, CompressCB callback)
 {
@@ -5,18 +5,24 @@
 
 #include <cstdio>
 #include <memory>
+#include <span>
 #include <string>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
 
+#ifdef HAVE_IO_URING
+#include "DiscIO/IOUringReader.h"
+#endif
+
 namespace DiscIO
 {
 class PlainFileReader : public BlobReader
 {
 public:
   static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  ~PlainFileReader() override;
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
   std::unique_ptr<BlobReader> CopyReader() const override;
@@ -31,12 +37,22 @@ public:
   std::optional<int> GetCompressionLevel() const override { return std::nullopt; }
 
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
+  std::span<const u8> GetSpan(u64 offset, u64 size) override;
 
 private:
   PlainFileReader(File::IOFile file);
 
+  void AdviseRead(u64 offset, u64 size);
+
   File::IOFile m_file;
   u64 m_size;
+
+  // The whole file, if it is mapped into memory
+  const u8* m_mapped_data = nullptr;
+
+#ifdef HAVE_IO_URING
+  std::unique_ptr<IOUringReader> m_io_uring_reader;
+#endif
 };
 
 }  // namespace DiscIO
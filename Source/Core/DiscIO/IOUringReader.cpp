@@ -0,0 +1,207 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DiscIO/IOUringReader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/IOUring.h"
+#include "Common/Logging/Log.h"
+#include "Core/Config/MainSettings.h"
+
+namespace DiscIO
+{
+IOUringReader::IOUringReader(std::unique_ptr<Common::IOUring> ring)
+    : m_ring(std::move(ring)), m_read_ahead_buffer(READ_AHEAD_SIZE)
+{
+}
+
+IOUringReader::~IOUringReader()
+{
+  // The kernel must be done writing to the buffer before it is freed
+  FinishReadAhead();
+}
+
+std::unique_ptr<IOUringReader> IOUringReader::Create()
+{
+  if (!Config::Get(Config::MAIN_IO_URING))
+    return nullptr;
+
+  std::unique_ptr<Common::IOUring> ring = Common::IOUring::Create(QUEUE_DEPTH);
+  if (!ring)
+    return nullptr;
+
+  return std::unique_ptr<IOUringReader>(new IOUringReader(std::move(ring)));
+}
+
+bool IOUringReader::Read(File::IOFile& file, u64 offset, u64 size, u8* out_ptr)
+{
+  FinishReadAhead();
+  if (!m_ring)
+    return false;
+
+  const int fd = fileno(file.GetHandle());
+  const bool sequential = fd == m_last_fd && offset == m_last_end;
+  m_last_fd = fd;
+  m_last_end = offset + size;
+
+  if (fd == m_read_ahead_fd && offset >= m_read_ahead_offset &&
+      offset < m_read_ahead_offset + m_read_ahead_valid)
+  {
+    const u64 offset_in_buffer = offset - m_read_ahead_offset;
+    const u64 bytes_to_copy = std::min(size, m_read_ahead_valid - offset_in_buffer);
+    std::memcpy(out_ptr, m_read_ahead_buffer.data() + offset_in_buffer, bytes_to_copy);
+
+    offset += bytes_to_copy;
+    size -= bytes_to_copy;
+    out_ptr += bytes_to_copy;
+  }
+
+  if (size > 0 && !ReadDirectly(fd, offset, size, out_ptr))
+    return false;
+
+  if (sequential)
+    StartReadAhead(fd, m_last_end);
+
+  return true;
+}
+
+bool IOUringReader::ReadDirectly(int fd, u64 offset, u64 size, u8* out_ptr)
+{
+  m_pending_reads.clear();
+  for (u64 i = 0; i < size; i += CHUNK_SIZE)
+  {
+    m_pending_reads.push_back(
+        {offset + i, static_cast<u32>(std::min<u64>(CHUNK_SIZE, size - i)), out_ptr + i});
+  }
+
+  size_t next = 0;
+  u32 in_flight = 0;
+  bool success = true;
+  while (true)
+  {
+    while (success && next < m_pending_reads.size())
+    {
+      const PendingRead& read = m_pending_reads[next];
+      if (!m_ring->QueueRead(fd, read.offset, read.size, read.out_ptr, next))
+        break;
+
+      ++next;
+      ++in_flight;
+    }
+
+    if (in_flight == 0)
+      break;
+
+    u64 user_data;
+    s32 result;
+    if (!m_ring->Submit() || !m_ring->WaitForCompletion(&user_data, &result))
+    {
+      HandleRingError();
+      return false;
+    }
+    --in_flight;
+
+    // Copied because push_back may reallocate
+    const PendingRead read = m_pending_reads[user_data];
+    if (result <= 0)
+    {
+      success = false;
+    }
+    else if (static_cast<u32>(result) < read.size)
+    {
+      // Short read. Queue the rest of it again
+      m_pending_reads.push_back(
+          {read.offset + result, read.size - result, read.out_ptr + result});
+    }
+  }
+
+  return success && next == m_pending_reads.size();
+}
+
+void IOUringReader::StartReadAhead(int fd, u64 offset)
+{
+  // Keep what has already been read ahead of the new offset
+  u64 kept = 0;
+  if (fd == m_read_ahead_fd && offset >= m_read_ahead_offset &&
+      offset < m_read_ahead_offset + m_read_ahead_valid)
+  {
+    kept = m_read_ahead_offset + m_read_ahead_valid - offset;
+    std::memmove(m_read_ahead_buffer.data(),
+                 m_read_ahead_buffer.data() + (offset - m_read_ahead_offset), kept);
+  }
+
+  m_read_ahead_fd = fd;
+  m_read_ahead_offset = offset;
+  m_read_ahead_valid = kept;
+  m_read_ahead_results.fill(0);
+
+  for (u64 i = kept; i < READ_AHEAD_SIZE; i += CHUNK_SIZE)
+  {
+    const u32 size = static_cast<u32>(std::min<u64>(CHUNK_SIZE, READ_AHEAD_SIZE - i));
+    if (!m_ring->QueueRead(fd, offset + i, size, m_read_ahead_buffer.data() + i,
+                           READ_AHEAD_FLAG | m_read_ahead_in_flight))
+    {
+      break;
+    }
+    ++m_read_ahead_in_flight;
+  }
+
+  if (!m_ring->Submit())
+    HandleRingError();
+}
+
+void IOUringReader::FinishReadAhead()
+{
+  if (m_read_ahead_in_flight == 0)
+    return;
+
+  for (u32 i = 0; i < m_read_ahead_in_flight; ++i)
+  {
+    u64 user_data;
+    s32 result;
+    if (!m_ring->WaitForCompletion(&user_data, &result))
+    {
+      HandleRingError();
+      return;
+    }
+    m_read_ahead_results[user_data & ~READ_AHEAD_FLAG] = result;
+  }
+
+  // Only data up to the first chunk that wasn't read completely can be used
+  for (u32 i = 0; i < m_read_ahead_in_flight; ++i)
+  {
+    const u64 expected_size = std::min<u64>(CHUNK_SIZE, READ_AHEAD_SIZE - m_read_ahead_valid);
+    const s32 result = m_read_ahead_results[i];
+    if (result > 0)
+      m_read_ahead_valid += result;
+    if (result < 0 || static_cast<u64>(result) != expected_size)
+      break;
+  }
+
+  m_read_ahead_in_flight = 0;
+}
+
+void IOUringReader::HandleRingError()
+{
+  WARN_LOG_FMT(DISCIO, "Falling back to synchronous reads after an io_uring error");
+
+  // Wait for whatever the kernel is still writing to our buffers
+  u64 user_data;
+  s32 result;
+  while (m_ring->GetInFlightCount() > 0 && m_ring->WaitForCompletion(&user_data, &result))
+  {
+  }
+
+  m_ring.reset();
+  m_read_ahead_fd = -1;
+  m_read_ahead_valid = 0;
+  m_read_ahead_in_flight = 0;
+}
+}  // namespace DiscIO
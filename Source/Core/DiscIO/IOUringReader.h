@@ -0,0 +1,75 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOUring.h"
+
+namespace File
+{
+class IOFile;
+}
+
+namespace DiscIO
+{
+// Reads files through io_uring on Linux. Large reads are split into chunks that are read in
+// parallel, and after sequential reads the data that follows is read in the background so that
+// the disk is kept busy while the caller is working on the data it already has.
+//
+// Used by the readers for uncompressed files when enabled in the config.
+class IOUringReader final
+{
+public:
+  // Returns nullptr if disabled in the config or if io_uring can't be used.
+  static std::unique_ptr<IOUringReader> Create();
+  ~IOUringReader();
+
+  // Returns false if the read failed, in which case the caller should fall back to reading
+  // the file on its own.
+  bool Read(File::IOFile& file, u64 offset, u64 size, u8* out_ptr);
+
+private:
+  static constexpr u32 QUEUE_DEPTH = 8;
+  static constexpr u32 CHUNK_SIZE = 0x40000;
+  static constexpr u32 READ_AHEAD_CHUNKS = 4;
+  static constexpr u64 READ_AHEAD_SIZE = u64(CHUNK_SIZE) * READ_AHEAD_CHUNKS;
+
+  // Set in the user_data of read-ahead requests, whose lower bits are the chunk index
+  static constexpr u64 READ_AHEAD_FLAG = u64(1) << 63;
+
+  struct PendingRead
+  {
+    u64 offset;
+    u32 size;
+    u8* out_ptr;
+  };
+
+  explicit IOUringReader(std::unique_ptr<Common::IOUring> ring);
+
+  bool ReadDirectly(int fd, u64 offset, u64 size, u8* out_ptr);
+  void StartReadAhead(int fd, u64 offset);
+  void FinishReadAhead();
+  void HandleRingError();
+
+  std::unique_ptr<Common::IOUring> m_ring;
+  std::vector<PendingRead> m_pending_reads;
+
+  // Where the previous read ended. A read starting there is considered sequential.
+  int m_last_fd = -1;
+  u64 m_last_end = 0;
+
+  // m_read_ahead_valid bytes starting at m_read_ahead_offset are in m_read_ahead_buffer, and
+  // m_read_ahead_in_flight chunks after that are still being read.
+  int m_read_ahead_fd = -1;
+  u64 m_read_ahead_offset = 0;
+  u64 m_read_ahead_valid = 0;
+  u32 m_read_ahead_in_flight = 0;
+  std::array<s32, READ_AHEAD_CHUNKS> m_read_ahead_results{};
+  std::vector<u8> m_read_ahead_buffer;
+};
+}  // namespace DiscIO
@@ -0,0 +1,233 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DiscIO/ParallelBlob.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/Align.h"
+#include "Common/CommonTypes.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/VolumeWii.h"
+
+namespace DiscIO
+{
+// Blocks are made at least this large so that the overhead of handing them to workers is small.
+constexpr u64 MIN_PIPELINE_BLOCK_SIZE = 0x100000;
+
+// How many blocks each worker has queued at most.
+constexpr size_t BLOCKS_PER_WORKER = 2;
+
+ParallelBlobReader::ParallelBlobReader(std::unique_ptr<BlobReader> blob_reader,
+                                       std::vector<std::unique_ptr<BlobReader>> worker_blob_readers)
+    : m_blob_reader(std::move(blob_reader))
+{
+  for (size_t i = 0; i < worker_blob_readers.size(); ++i)
+  {
+    auto worker = std::make_unique<Worker>();
+    worker->blob_reader = std::move(worker_blob_readers[i]);
+    worker->thread.Reset(fmt::format("Blob Reader {}", i),
+                         [this, blob_reader = worker->blob_reader.get()](
+                             std::shared_ptr<Block> block) { RunBlock(blob_reader, block.get()); });
+    m_workers.push_back(std::move(worker));
+  }
+}
+
+ParallelBlobReader::~ParallelBlobReader()
+{
+  for (std::unique_ptr<Worker>& worker : m_workers)
+    worker->thread.Shutdown(true);
+}
+
+std::unique_ptr<BlobReader> ParallelBlobReader::Create(std::unique_ptr<BlobReader> blob_reader,
+                                                       unsigned int thread_count)
+{
+  if (!blob_reader || thread_count <= 1)
+    return blob_reader;
+
+  // Only formats which need to be decoded benefit from this.
+  switch (blob_reader->GetBlobType())
+  {
+  case BlobType::GCZ:
+  case BlobType::WIA:
+  case BlobType::RVZ:
+  case BlobType::NFS:
+    break;
+  default:
+    return blob_reader;
+  }
+
+  std::vector<std::unique_ptr<BlobReader>> worker_blob_readers;
+  for (unsigned int i = 0; i < thread_count; ++i)
+  {
+    std::unique_ptr<BlobReader> copy = blob_reader->CopyReaderForWorker();
+    if (!copy)
+      return blob_reader;
+    worker_blob_readers.push_back(std::move(copy));
+  }
+
+  return std::unique_ptr<ParallelBlobReader>(
+      new ParallelBlobReader(std::move(blob_reader), std::move(worker_blob_readers)));
+}
+
+std::unique_ptr<BlobReader> ParallelBlobReader::CopyReader() const
+{
+  return Create(m_blob_reader->CopyReader(), static_cast<unsigned int>(m_workers.size()));
+}
+
+bool ParallelBlobReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  return ReadStream(RAW_STREAM, offset, size, out_ptr);
+}
+
+bool ParallelBlobReader::ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr,
+                                          u64 partition_data_offset)
+{
+  return ReadStream(partition_data_offset, offset, size, out_ptr);
+}
+
+bool ParallelBlobReader::ReadStream(u64 stream, u64 offset, u64 size, u8* out_ptr)
+{
+  if (size == 0)
+    return true;
+
+  const bool in_pipeline = stream == m_stream && !m_blocks.empty() &&
+                           offset / m_block_size >= m_blocks.front()->offset / m_block_size &&
+                           offset / m_block_size < m_next_block_index;
+  const bool sequential = stream == m_last_stream && offset == m_last_offset;
+
+  m_last_stream = stream;
+  m_last_offset = offset + size;
+
+  if (!in_pipeline)
+  {
+    if (!sequential)
+      return ReadDirectly(stream, offset, size, out_ptr);
+
+    StartPipeline(stream, offset / GetPipelineBlockSize(stream));
+  }
+
+  while (size > 0)
+  {
+    const Block* block = GetBlock(offset / m_block_size);
+    if (!block || !block->success || offset - block->offset >= block->data.size())
+    {
+      // Let the wrapped reader handle errors and reads past the end of the stream
+      m_blocks.clear();
+      return ReadDirectly(stream, offset, size, out_ptr);
+    }
+
+    const u64 offset_in_block = offset - block->offset;
+    const u64 bytes_to_copy = std::min(block->data.size() - offset_in_block, size);
+    std::memcpy(out_ptr, block->data.data() + offset_in_block, bytes_to_copy);
+
+    offset += bytes_to_copy;
+    size -= bytes_to_copy;
+    out_ptr += bytes_to_copy;
+  }
+
+  return true;
+}
+
+bool ParallelBlobReader::ReadDirectly(u64 stream, u64 offset, u64 size, u8* out_ptr)
+{
+  if (stream == RAW_STREAM)
+    return m_blob_reader->Read(offset, size, out_ptr);
+  else
+    return m_blob_reader->ReadWiiDecrypted(offset, size, out_ptr, stream);
+}
+
+void ParallelBlobReader::StartPipeline(u64 stream, u64 block_index)
+{
+  // Blocks still being worked on stay alive until their worker is done with them
+  m_blocks.clear();
+
+  m_stream = stream;
+  m_block_size = GetPipelineBlockSize(stream);
+  m_next_block_index = block_index;
+
+  QueueBlocks();
+}
+
+const ParallelBlobReader::Block* ParallelBlobReader::GetBlock(u64 block_index)
+{
+  while (!m_blocks.empty() && m_blocks.front()->offset / m_block_size < block_index)
+    m_blocks.pop_front();
+
+  if (m_blocks.empty())
+    m_next_block_index = block_index;
+
+  QueueBlocks();
+  if (m_blocks.empty())
+    return nullptr;
+
+  const Block* block = m_blocks.front().get();
+  std::unique_lock lk(m_mutex);
+  m_block_done.wait(lk, [block] { return block->done; });
+  return block;
+}
+
+void ParallelBlobReader::QueueBlocks()
+{
+  const u64 end = m_blob_reader->GetDataSize();
+  const size_t max_blocks = m_workers.size() * BLOCKS_PER_WORKER;
+
+  while (m_blocks.size() < max_blocks && m_next_block_index * m_block_size < end)
+  {
+    auto block = std::make_shared<Block>();
+    block->stream = m_stream;
+    block->offset = m_next_block_index * m_block_size;
+    block->data.resize(std::min(m_block_size, end - block->offset));
+
+    m_blocks.push_back(block);
+    m_workers[m_next_block_index % m_workers.size()]->thread.Push(std::move(block));
+    ++m_next_block_index;
+  }
+}
+
+void ParallelBlobReader::RunBlock(BlobReader* blob_reader, Block* block)
+{
+  bool success;
+  if (block->stream == RAW_STREAM)
+  {
+    success = blob_reader->Read(block->offset, block->data.size(), block->data.data());
+  }
+  else
+  {
+    success = blob_reader->ReadWiiDecrypted(block->offset, block->data.size(), block->data.data(),
+                                            block->stream);
+  }
+
+  std::lock_guard lk(m_mutex);
+  block->success = success;
+  block->done = true;
+  m_block_done.notify_all();
+}
+
+u64 ParallelBlobReader::GetPipelineBlockSize(u64 stream) const
+{
+  // Make blocks line up with the blocks of the wrapped reader, so that no block of the wrapped
+  // reader has to be decoded by more than one worker.
+  u64 unit = m_blob_reader->GetBlockSize();
+  if (stream != RAW_STREAM)
+  {
+    if (unit % VolumeWii::BLOCK_TOTAL_SIZE == 0)
+      unit = unit / VolumeWii::BLOCK_TOTAL_SIZE * VolumeWii::BLOCK_DATA_SIZE;
+    else
+      unit = 0;
+  }
+
+  if (unit == 0)
+    return MIN_PIPELINE_BLOCK_SIZE;
+
+  return Common::AlignUp(MIN_PIPELINE_BLOCK_SIZE, unit);
+}
+
+}  // namespace DiscIO
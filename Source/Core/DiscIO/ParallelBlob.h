@@ -0,0 +1,112 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/WorkQueueThread.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+// This class wraps another BlobReader and speeds up sequential reading of compressed formats by
+// decoding the next few blocks in parallel, each worker thread using its own copy of the reader.
+// Reads which aren't sequential are passed through to the wrapped reader.
+//
+// Intended for consumers which read a whole disc image from start to end, like verification,
+// extraction and conversion. Reads made through ReadWiiDecrypted are pipelined separately.
+class ParallelBlobReader final : public BlobReader
+{
+public:
+  // Returns blob_reader itself if it wouldn't benefit from being wrapped.
+  static std::unique_ptr<BlobReader> Create(std::unique_ptr<BlobReader> blob_reader,
+                                            unsigned int thread_count);
+  ~ParallelBlobReader() override;
+
+  BlobType GetBlobType() const override { return m_blob_reader->GetBlobType(); }
+  std::unique_ptr<BlobReader> CopyReader() const override;
+
+  u64 GetRawSize() const override { return m_blob_reader->GetRawSize(); }
+  u64 GetDataSize() const override { return m_blob_reader->GetDataSize(); }
+  DataSizeType GetDataSizeType() const override { return m_blob_reader->GetDataSizeType(); }
+
+  u64 GetBlockSize() const override { return m_blob_reader->GetBlockSize(); }
+  bool HasFastRandomAccessInBlock() const override
+  {
+    return m_blob_reader->HasFastRandomAccessInBlock();
+  }
+  std::string GetCompressionMethod() const override
+  {
+    return m_blob_reader->GetCompressionMethod();
+  }
+  std::optional<int> GetCompressionLevel() const override
+  {
+    return m_blob_reader->GetCompressionLevel();
+  }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
+  bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const override
+  {
+    return m_blob_reader->SupportsReadWiiDecrypted(offset, size, partition_data_offset);
+  }
+  bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset) override;
+
+private:
+  // The stream used by Read. Other streams are identified by their partition_data_offset.
+  static constexpr u64 RAW_STREAM = std::numeric_limits<u64>::max();
+
+  struct Block
+  {
+    u64 stream;
+    u64 offset;
+    std::vector<u8> data;
+    bool done = false;
+    bool success = false;
+  };
+
+  struct Worker
+  {
+    std::unique_ptr<BlobReader> blob_reader;
+    Common::WorkQueueThread<std::shared_ptr<Block>> thread;
+  };
+
+  ParallelBlobReader(std::unique_ptr<BlobReader> blob_reader,
+                     std::vector<std::unique_ptr<BlobReader>> worker_blob_readers);
+
+  bool ReadStream(u64 stream, u64 offset, u64 size, u8* out_ptr);
+  bool ReadDirectly(u64 stream, u64 offset, u64 size, u8* out_ptr);
+  void StartPipeline(u64 stream, u64 block_index);
+  const Block* GetBlock(u64 block_index);
+  void QueueBlocks();
+  void RunBlock(BlobReader* blob_reader, Block* block);
+
+  u64 GetPipelineBlockSize(u64 stream) const;
+
+  std::unique_ptr<BlobReader> m_blob_reader;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+
+  // Blocks that have been queued, in order. m_blocks.front() is the block being read from.
+  std::deque<std::shared_ptr<Block>> m_blocks;
+  u64 m_stream = RAW_STREAM;
+  u64 m_block_size = 0;
+  u64 m_next_block_index = 0;
+
+  // Where the previous read ended. A read starting there is considered sequential.
+  u64 m_last_stream = RAW_STREAM;
+  u64 m_last_offset = std::numeric_limits<u64>::max();
+
+  std::mutex m_mutex;
+  std::condition_variable m_block_done;
+};
+
+}  // namespace DiscIO
@@ -0,0 +1,217 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DiscIO/RVZChunkStore.h"
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/Align.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/Random.h"
+#include "Common/Swap.h"
+#include "DiscIO/VolumeWii.h"
+
+namespace DiscIO
+{
+// The lower bits of data_size in rvz_group_t, which contain the size of the stored data
+static constexpr u32 DATA_SIZE_MASK = 0x3FFFFFFF;
+
+RVZChunkStore::RVZChunkStore(File::IOFile file) : m_file(std::move(file))
+{
+}
+
+std::unique_ptr<RVZChunkStore> RVZChunkStore::OpenForWriting(const std::string& path,
+                                                             const Parameters& parameters)
+{
+  // Opening with "ab" first creates the file without truncating one that another conversion
+  // might be writing to
+  File::IOFile(path, "ab").Close();
+  File::IOFile file(path, "r+b");
+  if (!file)
+  {
+    ERROR_LOG_FMT(DISCIO, "Failed to open chunk store {}", path);
+    return nullptr;
+  }
+
+  if (!file.TryLockExclusive())
+  {
+    ERROR_LOG_FMT(DISCIO, "Chunk store {} is being written to by another conversion", path);
+    return nullptr;
+  }
+
+  const bool is_new = file.GetSize() == 0;
+  std::unique_ptr<RVZChunkStore> store(new RVZChunkStore(std::move(file)));
+  if (!(is_new ? store->Create(parameters) : store->Load(parameters)))
+  {
+    ERROR_LOG_FMT(DISCIO, "{} is not a chunk store that can be used with these settings", path);
+    return nullptr;
+  }
+
+  return store;
+}
+
+bool RVZChunkStore::Create(const Parameters& parameters)
+{
+  Common::Random::Generate(m_id.data(), m_id.size());
+
+  StoreHeader header{};
+  header.magic = MAGIC;
+  header.version = Common::swap32(VERSION);
+  header.id = m_id;
+  header.compression_type = Common::swap32(parameters.compression_type);
+  header.chunk_size = Common::swap32(parameters.chunk_size);
+  header.compressor_data_size = parameters.compressor_data_size;
+  header.compressor_data = parameters.compressor_data;
+
+  std::array<u8, RECORD_ALIGNMENT> buffer{};
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  if (!m_file.WriteArray(buffer.data(), buffer.size()))
+    return false;
+
+  m_end_offset = RECORD_ALIGNMENT;
+  return true;
+}
+
+bool RVZChunkStore::Load(const Parameters& parameters)
+{
+  Parameters store_parameters;
+  if (!ReadHeader(&m_file, &m_id, &store_parameters) || store_parameters != parameters)
+    return false;
+
+  const u64 file_size = m_file.GetSize();
+  u64 offset = RECORD_ALIGNMENT;
+  bool truncated_record = false;
+  while (offset < file_size)
+  {
+    // A record which doesn't fit in the file was being added by a conversion that was
+    // interrupted. It can only be the last one, and no RVZ file can be referring to it.
+    if (offset + sizeof(RecordHeader) > file_size)
+    {
+      truncated_record = true;
+      break;
+    }
+
+    RecordHeader header;
+    if (!m_file.Seek(offset, File::SeekOrigin::Begin) || !m_file.ReadArray(&header, 1))
+      return false;
+
+    // Anything else that isn't a record means the file is damaged. It is left alone, since
+    // discarding it could lose data that RVZ files are referring to.
+    if (header.magic != RECORD_MAGIC)
+    {
+      ERROR_LOG_FMT(DISCIO, "Chunk store has an invalid record at offset {:#x}", offset);
+      return false;
+    }
+
+    const u32 data_size = Common::swap32(header.data_size) & DATA_SIZE_MASK;
+    const u64 end = offset + sizeof(RecordHeader) + data_size;
+    if (end > file_size)
+    {
+      truncated_record = true;
+      break;
+    }
+
+    m_records.emplace(header.key, static_cast<u32>(offset / RECORD_ALIGNMENT));
+    offset = Common::AlignUp(end, RECORD_ALIGNMENT);
+  }
+
+  if (truncated_record)
+  {
+    WARN_LOG_FMT(DISCIO, "Discarding an incomplete record at the end of the chunk store");
+    if (!m_file.Resize(offset))
+      return false;
+  }
+
+  m_end_offset = offset;
+  return true;
+}
+
+bool RVZChunkStore::ReadHeader(File::IOFile* file, StoreID* id, Parameters* parameters)
+{
+  StoreHeader header;
+  if (!file->Seek(0, File::SeekOrigin::Begin) || !file->ReadArray(&header, 1))
+    return false;
+
+  if (header.magic != MAGIC || Common::swap32(header.version) != VERSION)
+    return false;
+
+  *id = header.id;
+  parameters->compression_type = Common::swap32(header.compression_type);
+  parameters->chunk_size = Common::swap32(header.chunk_size);
+  parameters->compressor_data_size = header.compressor_data_size;
+  parameters->compressor_data = header.compressor_data;
+  return true;
+}
+
+u64 RVZChunkStore::GetDataOffset(u32 reference)
+{
+  return reference * RECORD_ALIGNMENT + sizeof(RecordHeader);
+}
+
+Common::SHA1::Digest RVZChunkStore::CalculateKey(const ChunkInfo& info,
+                                                 const std::vector<u8>& exception_lists,
+                                                 const std::vector<u8>& main_data)
+{
+  // Junk data is generated differently depending on where in a 32 KiB block it starts
+  const u32 offset_in_block =
+      info.rvz_packed_size == 0 ? 0 :
+                                  static_cast<u32>(info.data_offset % VolumeWii::BLOCK_TOTAL_SIZE);
+
+  const std::array<u32, 4> description{
+      Common::swap32(info.data_size), Common::swap32(info.rvz_packed_size),
+      Common::swap32(offset_in_block), Common::swap32(info.has_exception_lists ? 1 : 0)};
+
+  const auto context = Common::SHA1::CreateContext();
+  context->Update(reinterpret_cast<const u8*>(description.data()), sizeof(description));
+  context->Update(exception_lists);
+  context->Update(main_data);
+  return context->Finish();
+}
+
+std::optional<u32> RVZChunkStore::AddChunk(const ChunkInfo& info,
+                                           const std::vector<u8>& exception_lists,
+                                           const std::vector<u8>& main_data)
+{
+  const Common::SHA1::Digest key = CalculateKey(info, exception_lists, main_data);
+  if (const auto it = m_records.find(key); it != m_records.end())
+    return it->second;
+
+  const u64 reference = m_end_offset / RECORD_ALIGNMENT;
+  if (reference > std::numeric_limits<u32>::max())
+  {
+    ERROR_LOG_FMT(DISCIO, "Chunk store is full");
+    return std::nullopt;
+  }
+
+  const RecordHeader header{RECORD_MAGIC, Common::swap32(info.data_size),
+                            Common::swap32(info.rvz_packed_size), key};
+
+  if (!m_file.Seek(m_end_offset, File::SeekOrigin::Begin) || !m_file.WriteArray(&header, 1) ||
+      !m_file.WriteArray(exception_lists.data(), exception_lists.size()) ||
+      !m_file.WriteArray(main_data.data(), main_data.size()))
+  {
+    return std::nullopt;
+  }
+
+  const u64 end = m_end_offset + sizeof(header) + exception_lists.size() + main_data.size();
+  m_end_offset = Common::AlignUp(end, RECORD_ALIGNMENT);
+
+  static constexpr std::array<u8, RECORD_ALIGNMENT> padding{};
+  if (!m_file.WriteArray(padding.data(), m_end_offset - end))
+    return std::nullopt;
+
+  m_records.emplace(key, static_cast<u32>(reference));
+  return static_cast<u32>(reference);
+}
+}  // namespace DiscIO
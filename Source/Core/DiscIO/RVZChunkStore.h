@@ -0,0 +1,120 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/IOFile.h"
+
+namespace DiscIO
+{
+// A file which stores the data of RVZ groups on behalf of any number of RVZ files. When the
+// regional variants and revisions of a game are converted using the same chunk store, groups that
+// are identical across the discs only take up space once.
+//
+// Groups are identified by a hash of their data as stored, so a group in the store decodes to
+// exactly what the RVZ file referring to it would have stored itself.
+// See docs/WiaAndRvz.md for details about the format.
+class RVZChunkStore final
+{
+public:
+  using StoreID = std::array<u8, 16>;
+
+  // Everything that has to match between a chunk store and the RVZ files that refer to it.
+  struct Parameters
+  {
+    u32 compression_type;
+    u32 chunk_size;
+    u8 compressor_data_size;
+    std::array<u8, 7> compressor_data;
+
+    bool operator==(const Parameters&) const = default;
+  };
+
+  // What is needed to decode the data of a group, in addition to the data itself.
+  struct ChunkInfo
+  {
+    u32 data_size;  // As in rvz_group_t
+    u32 rvz_packed_size;
+    u64 data_offset;  // Only matters if rvz_packed_size != 0
+    bool has_exception_lists;
+  };
+
+  static constexpr u32 MAGIC = 0x535A5652;         // "RVZS" (byteswapped to little endian)
+  static constexpr u32 RECORD_MAGIC = 0x435A5652;  // "RVZC" (byteswapped to little endian)
+  static constexpr u32 VERSION = 0x01000000;
+
+  // Set in the data_size of an rvz_group_t whose data is in the chunk store.
+  // data_off4 is then a reference to a record as returned by AddChunk.
+  static constexpr u32 GROUP_IN_STORE_FLAG = 0x40000000;
+
+  static constexpr u64 RECORD_ALIGNMENT = 0x100;
+
+  // Opens a chunk store for adding data to it, creating it if it doesn't exist. Returns nullptr if
+  // the file can't be opened, isn't a chunk store, was created with other parameters or is damaged.
+  // Only one conversion at a time may write to a chunk store, so this also returns nullptr if
+  // another one is using it.
+  static std::unique_ptr<RVZChunkStore> OpenForWriting(const std::string& path,
+                                                       const Parameters& parameters);
+
+  // Returns false if the file isn't a chunk store.
+  static bool ReadHeader(File::IOFile* file, StoreID* id, Parameters* parameters);
+
+  // Returns the offset in the chunk store of the data of the referenced record.
+  static u64 GetDataOffset(u32 reference);
+
+  const StoreID& GetID() const { return m_id; }
+
+  // Returns a reference to a record containing the given data, adding a record if there is none.
+  std::optional<u32> AddChunk(const ChunkInfo& info, const std::vector<u8>& exception_lists,
+                              const std::vector<u8>& main_data);
+
+private:
+#pragma pack(push, 1)
+  struct StoreHeader
+  {
+    u32 magic;
+    u32 version;
+    StoreID id;
+    u32 compression_type;
+    u32 chunk_size;
+    u8 compressor_data_size;
+    std::array<u8, 7> compressor_data;
+  };
+  static_assert(sizeof(StoreHeader) == 0x28, "Wrong size for RVZ chunk store header");
+
+  struct RecordHeader
+  {
+    u32 magic;
+    u32 data_size;
+    u32 rvz_packed_size;
+    Common::SHA1::Digest key;
+  };
+  static_assert(sizeof(RecordHeader) == 0x20, "Wrong size for RVZ chunk store record header");
+#pragma pack(pop)
+
+  explicit RVZChunkStore(File::IOFile file);
+
+  bool Create(const Parameters& parameters);
+  bool Load(const Parameters& parameters);
+
+  static Common::SHA1::Digest CalculateKey(const ChunkInfo& info,
+                                           const std::vector<u8>& exception_lists,
+                                           const std::vector<u8>& main_data);
+
+  File::IOFile m_file;
+  StoreID m_id{};
+  u64 m_end_offset = 0;
+
+  // Maps keys to references
+  std::map<Common::SHA1::Digest, u32> m_records;
+};
+}  // namespace DiscIO
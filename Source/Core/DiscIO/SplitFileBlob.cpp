@@ -23,6 +23,10 @@ SplitPlainFileReader::SplitPlainFileReader(std::vector<SingleFile> files)
   m_size = 0;
   for (const auto& f : m_files)
     m_size += f.size;
+
+#ifdef HAVE_IO_URING
+  m_io_uring_reader = IOUringReader::Create();
+#endif
 }
 
 std::unique_ptr<SplitPlainFileReader> SplitPlainFileReader::Create(std::string_view first_file_path)
@@ -82,7 +86,13 @@ bool SplitPlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
       auto& f = file.file;
       const u64 seek_offset = current_offset - file.offset;
       const u64 current_read = std::min(file.size - seek_offset, rest);
-      if (!f.Seek(seek_offset, File::SeekOrigin::Begin) || !f.ReadBytes(out, current_read))
+      bool read_done = false;
+#ifdef HAVE_IO_URING
+      read_done =
+          m_io_uring_reader && m_io_uring_reader->Read(f, seek_offset, current_read, out);
+#endif
+      if (!read_done &&
+          (!f.Seek(seek_offset, File::SeekOrigin::Begin) || !f.ReadBytes(out, current_read)))
       {
         f.ClearError();
         return false;
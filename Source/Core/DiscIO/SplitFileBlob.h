@@ -13,6 +13,10 @@
 #include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
 
+#ifdef HAVE_IO_URING
+#include "DiscIO/IOUringReader.h"
+#endif
+
 namespace DiscIO
 {
 class SplitPlainFileReader final : public BlobReader
@@ -46,6 +50,10 @@ private:
 
   std::vector<SingleFile> m_files;
   u64 m_size;
+
+#ifdef HAVE_IO_URING
+  std::unique_ptr<IOUringReader> m_io_uring_reader;
+#endif
 };
 
 }  // namespace DiscIO
@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,11 @@ public:
   Volume() {}
   virtual ~Volume() {}
   virtual bool Read(u64 offset, u64 length, u8* buffer, const Partition& partition) const = 0;
+  // Returns the data without copying it if possible, or an empty span if not. See BlobReader.
+  virtual std::span<const u8> GetSpan(u64 offset, u64 length, const Partition& partition) const
+  {
+    return {};
+  }
   template <typename T>
   std::optional<T> ReadSwapped(u64 offset, const Partition& partition) const
   {
@@ -76,4 +76,12 @@ bool VolumeFileBlobReader::Read(u64 offset, u64 length, u8* out_ptr)
 
   return m_volume.Read(m_file_info->GetOffset() + offset, length, out_ptr, m_partition);
 }
+
+std::span<const u8> VolumeFileBlobReader::GetSpan(u64 offset, u64 length)
+{
+  if (offset + length > m_file_info->GetSize())
+    return {};
+
+  return m_volume.GetSpan(m_file_info->GetOffset() + offset, length, m_partition);
+}
 }  // namespace DiscIO
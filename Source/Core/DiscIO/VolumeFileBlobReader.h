@@ -4,6 +4,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <string_view>
 
 #include "Common/CommonTypes.h"
@@ -34,6 +35,7 @@ public:
   std::optional<int> GetCompressionLevel() const override;
 
   bool Read(u64 offset, u64 length, u8* out_ptr) override;
+  std::span<const u8> GetSpan(u64 offset, u64 length) override;
 
 private:
   VolumeFileBlobReader(const Volume& volume, const Partition& partition,
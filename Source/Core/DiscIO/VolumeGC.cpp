@@ -53,6 +53,14 @@ bool VolumeGC::Read(u64 offset, u64 length, u8* buffer, const Partition& partiti
   return m_reader->Read(offset, length, buffer);
 }
 
+std::span<const u8> VolumeGC::GetSpan(u64 offset, u64 length, const Partition& partition) const
+{
+  if (partition != PARTITION_NONE)
+    return {};
+
+  return m_reader->GetSpan(offset, length);
+}
+
 const FileSystem* VolumeGC::GetFileSystem(const Partition& partition) const
 {
   return m_file_system->get();
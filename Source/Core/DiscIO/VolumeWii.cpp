@@ -240,6 +240,22 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
   return true;
 }
 
+std::span<const u8> VolumeWii::GetSpan(u64 offset, u64 length, const Partition& partition) const
+{
+  if (partition == PARTITION_NONE)
+    return m_reader->GetSpan(offset, length);
+
+  // Data in partitions with hashes is split up by the hashes, so it can't be returned directly
+  if (m_has_hashes)
+    return {};
+
+  auto it = m_partitions.find(partition);
+  if (it == m_partitions.end())
+    return {};
+
+  return m_reader->GetSpan(partition.offset + *it->second.data_offset + offset, length);
+}
+
 bool VolumeWii::HasWiiHashes() const
 {
   return m_has_hashes;
@@ -468,14 +484,10 @@ bool VolumeWii::CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
     cluster_data = encrypted_data + BLOCK_HEADER_SIZE;
   }
 
-  for (u32 hash_index = 0; hash_index < 31; ++hash_index)
-  {
-    if (Common::SHA1::CalculateDigest(&cluster_data[hash_index * 0x400], 0x400) !=
-        hashes.h0[hash_index])
-    {
-      return false;
-    }
-  }
+  std::array<Common::SHA1::Digest, 31> h0;
+  Common::SHA1::CalculateDigests(cluster_data, 0x400, h0.size(), h0.data());
+  if (h0 != hashes.h0)
+    return false;
 
   if (Common::SHA1::CalculateDigest(hashes.h0) != hashes.h1[block_index % 8])
     return false;
@@ -526,8 +538,7 @@ bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GR
       if (success)
       {
         // H0 hashes
-        for (size_t j = 0; j < 31; ++j)
-          out[i].h0[j] = Common::SHA1::CalculateDigest(in[i].data() + j * 0x400, 0x400);
+        Common::SHA1::CalculateDigests(in[i].data(), 0x400, out[i].h0.size(), out[i].h0.data());
 
         // H0 padding
         out[i].padding_0 = {};
@@ -583,36 +594,52 @@ bool VolumeWii::EncryptGroup(
     u64 offset, u64 partition_data_offset, u64 partition_data_decrypted_size,
     const std::array<u8, AES_KEY_SIZE>& key, BlobReader* blob,
     std::array<u8, GROUP_TOTAL_SIZE>* out,
-    const std::function<void(HashBlock hash_blocks[BLOCKS_PER_GROUP])>& hash_exception_callback)
+    const std::function<void(HashBlock hash_blocks[BLOCKS_PER_GROUP])>& hash_exception_callback,
+    const KnownHashesCallback& known_hashes_callback)
 {
   std::vector<std::array<u8, BLOCK_DATA_SIZE>> unencrypted_data(BLOCKS_PER_GROUP);
   std::vector<HashBlock> unencrypted_hashes(BLOCKS_PER_GROUP);
 
-  const bool success =
-      HashGroup(unencrypted_data.data(), unencrypted_hashes.data(), [&](size_t block) {
-        if (offset + (block + 1) * BLOCK_DATA_SIZE <= partition_data_decrypted_size)
-        {
-          if (!blob->ReadWiiDecrypted(offset + block * BLOCK_DATA_SIZE, BLOCK_DATA_SIZE,
-                                      unencrypted_data[block].data(), partition_data_offset))
-          {
-            return false;
-          }
-        }
-        else
-        {
-          unencrypted_data[block].fill(0);
-        }
-        return true;
-      });
+  const auto read_block = [&](size_t block) {
+    if (offset + (block + 1) * BLOCK_DATA_SIZE <= partition_data_decrypted_size)
+    {
+      if (!blob->ReadWiiDecrypted(offset + block * BLOCK_DATA_SIZE, BLOCK_DATA_SIZE,
+                                  unencrypted_data[block].data(), partition_data_offset))
+      {
+        return false;
+      }
+    }
+    else
+    {
+      unencrypted_data[block].fill(0);
+    }
+    return true;
+  };
+
+  if (known_hashes_callback)
+  {
+    for (size_t i = 0; i < BLOCKS_PER_GROUP; ++i)
+    {
+      if (!read_block(i))
+        return false;
+    }
 
-  if (!success)
+    if (!known_hashes_callback(unencrypted_data.data(), unencrypted_hashes.data()))
+      HashGroup(unencrypted_data.data(), unencrypted_hashes.data());
+  }
+  else if (!HashGroup(unencrypted_data.data(), unencrypted_hashes.data(), read_block))
+  {
     return false;
+  }
 
   if (hash_exception_callback)
     hash_exception_callback(unencrypted_hashes.data());
 
-  const unsigned int threads =
-      std::min(BLOCKS_PER_GROUP, std::max<unsigned int>(1, std::thread::hardware_concurrency()));
+  // Each thread gets enough blocks for EncryptBlocks to be able to interleave them
+  constexpr size_t MIN_BLOCKS_PER_THREAD = 8;
+  const size_t threads =
+      std::min(BLOCKS_PER_GROUP / MIN_BLOCKS_PER_THREAD,
+               std::max<size_t>(1, std::thread::hardware_concurrency()));
 
   std::vector<std::future<void>> encryption_futures(threads);
 
@@ -623,16 +650,8 @@ bool VolumeWii::EncryptGroup(
     encryption_futures[i] = std::async(
         std::launch::async,
         [&unencrypted_data, &unencrypted_hashes, &aes_context, &out](size_t start, size_t end) {
-          for (size_t j = start; j < end; ++j)
-          {
-            u8* out_ptr = out->data() + j * BLOCK_TOTAL_SIZE;
-
-            aes_context->CryptIvZero(reinterpret_cast<u8*>(&unencrypted_hashes[j]), out_ptr,
-                                     BLOCK_HEADER_SIZE);
-
-            aes_context->Crypt(out_ptr + 0x3D0, unencrypted_data[j].data(),
-                               out_ptr + BLOCK_HEADER_SIZE, BLOCK_DATA_SIZE);
-          }
+          EncryptBlocks(&unencrypted_hashes[start], &unencrypted_data[start],
+                        out->data() + start * BLOCK_TOTAL_SIZE, end - start, aes_context.get());
         },
         i * BLOCKS_PER_GROUP / threads, (i + 1) * BLOCKS_PER_GROUP / threads);
   }
@@ -653,4 +672,45 @@ void VolumeWii::DecryptBlockData(const u8* in, u8* out, Common::AES::Context* ae
   aes_context->Crypt(&in[0x3d0], &in[sizeof(HashBlock)], out, BLOCK_DATA_SIZE);
 }
 
+void VolumeWii::EncryptBlocks(const HashBlock* hashes, const std::array<u8, BLOCK_DATA_SIZE>* data,
+                              u8* out, size_t count, Common::AES::Context* aes_context)
+{
+  std::vector<const u8*> hashes_in(count);
+  std::vector<u8*> hashes_out(count);
+  std::vector<const u8*> ivs(count);
+  std::vector<const u8*> data_in(count);
+  std::vector<u8*> data_out(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    u8* out_ptr = out + i * BLOCK_TOTAL_SIZE;
+    hashes_in[i] = reinterpret_cast<const u8*>(&hashes[i]);
+    hashes_out[i] = out_ptr;
+    ivs[i] = out_ptr + 0x3D0;
+    data_in[i] = data[i].data();
+    data_out[i] = out_ptr + BLOCK_HEADER_SIZE;
+  }
+
+  // The hashes go first, since the data is encrypted using part of the encrypted hashes as the IV
+  aes_context->CryptMultiple(nullptr, hashes_in.data(), hashes_out.data(), count,
+                             BLOCK_HEADER_SIZE);
+  aes_context->CryptMultiple(ivs.data(), data_in.data(), data_out.data(), count, BLOCK_DATA_SIZE);
+}
+
+void VolumeWii::DecryptBlocksData(const u8* in, std::array<u8, BLOCK_DATA_SIZE>* out, size_t count,
+                                  Common::AES::Context* aes_context)
+{
+  std::vector<const u8*> ivs(count);
+  std::vector<const u8*> data_in(count);
+  std::vector<u8*> data_out(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const u8* in_ptr = in + i * BLOCK_TOTAL_SIZE;
+    ivs[i] = in_ptr + 0x3D0;
+    data_in[i] = in_ptr + BLOCK_HEADER_SIZE;
+    data_out[i] = out[i].data();
+  }
+
+  aes_context->CryptMultiple(ivs.data(), data_in.data(), data_out.data(), count, BLOCK_DATA_SIZE);
+}
+
 }  // namespace DiscIO
@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -60,6 +61,7 @@ public:
   VolumeWii(std::unique_ptr<BlobReader> reader);
   ~VolumeWii();
   bool Read(u64 offset, u64 length, u8* buffer, const Partition& partition) const override;
+  std::span<const u8> GetSpan(u64 offset, u64 length, const Partition& partition) const override;
   bool HasWiiHashes() const override;
   bool HasWiiEncryption() const override;
   std::vector<Partition> GetPartitions() const override;
@@ -100,15 +102,30 @@ public:
                         HashBlock out[BLOCKS_PER_GROUP],
                         const std::function<bool(size_t block)>& read_function = {});
 
+  // Called with the decrypted data of a group once all of it has been read. Returns true if it
+  // filled in the hashes of the group, which are then used instead of being calculated.
+  using KnownHashesCallback =
+      std::function<bool(const std::array<u8, BLOCK_DATA_SIZE> data[BLOCKS_PER_GROUP],
+                         HashBlock hash_blocks[BLOCKS_PER_GROUP])>;
+
+  // hash_exception_callback is called whether the hashes were calculated or known.
   static bool EncryptGroup(u64 offset, u64 partition_data_offset, u64 partition_data_decrypted_size,
                            const std::array<u8, AES_KEY_SIZE>& key, BlobReader* blob,
                            std::array<u8, GROUP_TOTAL_SIZE>* out,
                            const std::function<void(HashBlock hash_blocks[BLOCKS_PER_GROUP])>&
-                               hash_exception_callback = {});
+                               hash_exception_callback = {},
+                           const KnownHashesCallback& known_hashes_callback = {});
 
   static void DecryptBlockHashes(const u8* in, HashBlock* out, Common::AES::Context* aes_context);
   static void DecryptBlockData(const u8* in, u8* out, Common::AES::Context* aes_context);
 
+  // Batched versions of the above. Processing many blocks at once is considerably faster,
+  // since the encryption of several blocks can be interleaved.
+  static void EncryptBlocks(const HashBlock* hashes, const std::array<u8, BLOCK_DATA_SIZE>* data,
+                            u8* out, size_t count, Common::AES::Context* aes_context);
+  static void DecryptBlocksData(const u8* in, std::array<u8, BLOCK_DATA_SIZE>* out, size_t count,
+                                Common::AES::Context* aes_context);
+
 protected:
   u32 GetOffsetShift() const override { return 2; }
 
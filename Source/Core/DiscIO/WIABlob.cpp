@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <filesystem>
 #include <limits>
 #include <map>
 #include <memory>
@@ -20,19 +21,24 @@
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Crypto/SHA1.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/ScopeGuard.h"
+#include "Common/StringUtil.h"
 #include "Common/Swap.h"
 
+#include "Core/Config/MainSettings.h"
+
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscUtils.h"
 #include "DiscIO/Filesystem.h"
 #include "DiscIO/LaggedFibonacciGenerator.h"
 #include "DiscIO/MultithreadedCompressor.h"
+#include "DiscIO/RVZChunkStore.h"
 #include "DiscIO/Volume.h"
 #include "DiscIO/VolumeWii.h"
 #include "DiscIO/WIACompression.h"
@@ -79,13 +85,18 @@ std::pair<int, int> GetAllowedCompressionLevels(WIARVZCompressionType compressio
 
 template <bool RVZ>
 WIARVZFileReader<RVZ>::WIARVZFileReader(File::IOFile file, const std::string& path)
-    : m_file(std::move(file)), m_path(path), m_encryption_cache(this)
+    : m_file(std::move(file)), m_path(path),
+      m_max_cached_chunks(std::max(1, Config::Get(Config::MAIN_WIA_CHUNK_CACHE_SIZE))),
+      m_read_ahead_enabled(Config::Get(Config::MAIN_WIA_READ_AHEAD)), m_encryption_cache(this)
 {
   m_valid = Initialize(path);
 }
 
 template <bool RVZ>
-WIARVZFileReader<RVZ>::~WIARVZFileReader() = default;
+WIARVZFileReader<RVZ>::~WIARVZFileReader()
+{
+  m_read_ahead_thread.Shutdown();
+}
 
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
@@ -141,6 +152,15 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
     return false;
   }
 
+  if (RVZ && header_2_size > sizeof(WIAHeader2))
+  {
+    if (!ReadHeader2Extensions(header_2.data() + sizeof(WIAHeader2),
+                               header_2_size - sizeof(WIAHeader2), path))
+    {
+      return false;
+    }
+  }
+
   const u32 chunk_size = Common::swap32(m_header_2.chunk_size);
   const auto is_power_of_two = [](u32 x) { return (x & (x - 1)) == 0; };
   if ((!RVZ || chunk_size < VolumeWii::BLOCK_TOTAL_SIZE || !is_power_of_two(chunk_size)) &&
@@ -230,9 +250,140 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   if (!group_entries.ReadAll(&m_group_entries))
     return false;
 
+  if constexpr (RVZ)
+  {
+    const bool uses_chunk_store = std::ranges::any_of(m_group_entries, [](const GroupEntry& group) {
+      return (Common::swap32(group.data_size) & RVZChunkStore::GROUP_IN_STORE_FLAG) != 0;
+    });
+    if (uses_chunk_store && !m_chunk_store_file)
+      return false;
+  }
+
   if (HasDataOverlap())
     return false;
 
+  if (Config::Get(Config::MAIN_WII_HASH_CACHE))
+  {
+    // Header 2 covers the disc header and the partition entries, and the group entries cover the
+    // size of every group, so this identifies the contents of the file rather than just the game.
+    // The hash cache also checks the decrypted data of every group against what it was stored for.
+    auto context = Common::SHA1::CreateContext();
+    context->Update(m_header_1.header_2_hash);
+    context->Update(reinterpret_cast<const u8*>(m_group_entries.data()),
+                    m_group_entries.size() * sizeof(GroupEntry));
+    m_encryption_cache.EnableHashCache(context->Finish());
+  }
+
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::ReadHeader2Extensions(const u8* data, size_t size,
+                                                  const std::string& path)
+{
+  while (size != 0)
+  {
+    u32 magic;
+    if (size < sizeof(magic))
+      return false;
+    std::memcpy(&magic, data, sizeof(magic));
+
+    size_t extension_size;
+    if (magic == RVZChunkStore::MAGIC)
+    {
+      if (!OpenChunkStore(data, size, path, &extension_size))
+        return false;
+    }
+    else if (magic == ZSTD_DICTIONARY_MAGIC)
+    {
+      if (!LoadZstdDictionary(data, size, &extension_size))
+        return false;
+    }
+    else
+    {
+      ERROR_LOG_FMT(DISCIO, "Unknown header extension in {}", path);
+      return false;
+    }
+
+    data += extension_size;
+    size -= extension_size;
+  }
+
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::OpenChunkStore(const u8* reference, size_t size,
+                                           const std::string& path, size_t* reference_size)
+{
+  RVZChunkStoreReference header;
+  if (size < sizeof(header))
+    return false;
+  std::memcpy(&header, reference, sizeof(header));
+
+  const u16 path_size = Common::swap16(header.path_size);
+  if (header.magic != RVZChunkStore::MAGIC || size < sizeof(header) + path_size)
+    return false;
+
+  const std::string relative_path(reinterpret_cast<const char*>(reference) + sizeof(header),
+                                  path_size);
+  const std::string chunk_store_path =
+      PathToString(StringToPath(path).parent_path() / StringToPath(relative_path));
+
+  m_chunk_store_file.Open(chunk_store_path, "rb");
+  if (!m_chunk_store_file)
+  {
+    ERROR_LOG_FMT(DISCIO, "Failed to open the chunk store {} used by {}", chunk_store_path, path);
+    return false;
+  }
+
+  const RVZChunkStore::Parameters parameters{
+      Common::swap32(m_header_2.compression_type), Common::swap32(m_header_2.chunk_size),
+      m_header_2.compressor_data_size, std::to_array(m_header_2.compressor_data)};
+
+  RVZChunkStore::StoreID store_id;
+  RVZChunkStore::Parameters store_parameters;
+  if (!RVZChunkStore::ReadHeader(&m_chunk_store_file, &store_id, &store_parameters) ||
+      store_id != header.store_id || store_parameters != parameters)
+  {
+    ERROR_LOG_FMT(DISCIO, "{} is not the chunk store used by {}", chunk_store_path, path);
+    m_chunk_store_file.Close();
+    return false;
+  }
+
+  *reference_size = sizeof(header) + path_size;
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::LoadZstdDictionary(const u8* reference, size_t size,
+                                               size_t* reference_size)
+{
+  RVZZstdDictionaryReference header;
+  if (size < sizeof(header))
+    return false;
+  std::memcpy(&header, reference, sizeof(header));
+
+  if (m_zstd_dictionary ||
+      Common::swap32(m_header_2.compression_type) !=
+          static_cast<u32>(WIARVZCompressionType::Zstd))
+  {
+    return false;
+  }
+
+  std::vector<u8> dictionary(Common::swap32(header.dictionary_size));
+  if (!m_file.Seek(Common::swap64(header.dictionary_offset), File::SeekOrigin::Begin) ||
+      !m_file.ReadBytes(dictionary.data(), dictionary.size()) ||
+      Common::SHA1::CalculateDigest(dictionary) != header.dictionary_hash)
+  {
+    return false;
+  }
+
+  m_zstd_dictionary = CreateZstdDDict(dictionary);
+  if (!m_zstd_dictionary)
+    return false;
+
+  *reference_size = sizeof(header);
   return true;
 }
 
@@ -292,6 +443,19 @@ std::unique_ptr<BlobReader> WIARVZFileReader<RVZ>::CopyReader() const
   return Create(m_file.Duplicate("rb"), m_path);
 }
 
+template <bool RVZ>
+std::unique_ptr<BlobReader> WIARVZFileReader<RVZ>::CopyReaderForWorker() const
+{
+  std::unique_ptr<WIARVZFileReader> copy = Create(m_file.Duplicate("rb"), m_path);
+  if (copy)
+  {
+    // Keeping the last two chunks is enough for reads which cross the end of a chunk.
+    copy->m_read_ahead_enabled = false;
+    copy->m_max_cached_chunks = 2;
+  }
+  return copy;
+}
+
 template <bool RVZ>
 std::string WIARVZFileReader<RVZ>::GetCompressionMethod() const
 {
@@ -514,35 +678,20 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
     chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
 
     const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
-    u32 group_data_size = Common::swap32(group.data_size);
-
-    WIARVZCompressionType compression_type = m_compression_type;
-    u32 rvz_packed_size = 0;
-    if constexpr (RVZ)
-    {
-      if ((group_data_size & 0x80000000) == 0)
-        compression_type = WIARVZCompressionType::None;
-
-      group_data_size &= 0x7FFFFFFF;
 
-      rvz_packed_size = Common::swap32(group.rvz_packed_size);
-    }
-
-    if (group_data_size == 0)
+    ChunkLocation location;
+    if (!GetGroupChunkLocation(group, chunk_size, group_offset_in_data, exception_lists,
+                               &location))
     {
       std::memset(*out_ptr, 0, bytes_to_read);
     }
     else
     {
-      const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
-
-      Chunk& chunk =
-          ReadCompressedData(group_offset_in_file, group_data_size, chunk_size, compression_type,
-                             exception_lists, rvz_packed_size, group_offset_in_data);
+      Chunk& chunk = ReadCompressedData(location);
 
       if (!chunk.Read(offset_in_group, bytes_to_read, *out_ptr))
       {
-        m_cached_chunk_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
+        RemoveCachedChunk(location.offset_in_file);
         return false;
       }
 
@@ -557,6 +706,24 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
       }
     }
 
+    if (m_read_ahead_enabled)
+    {
+      // When moving on to the next group, the one after it is likely to be needed soon as well.
+      const u64 next_group_offset_in_data = group_offset_in_data + chunk_size;
+      if (total_group_index == m_last_group_index + 1 && i + 1 < number_of_groups &&
+          total_group_index + 1 < m_group_entries.size() && next_group_offset_in_data < data_size)
+      {
+        ChunkLocation next_location;
+        if (GetGroupChunkLocation(m_group_entries[total_group_index + 1],
+                                  std::min(chunk_size, data_size - next_group_offset_in_data),
+                                  next_group_offset_in_data, exception_lists, &next_location))
+        {
+          ReadAhead(next_location);
+        }
+      }
+      m_last_group_index = total_group_index;
+    }
+
     *offset += bytes_to_read;
     *size -= bytes_to_read;
     *out_ptr += bytes_to_read;
@@ -565,6 +732,49 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
   return true;
 }
 
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::GetGroupChunkLocation(const GroupEntry& group, u64 chunk_size,
+                                                  u64 group_offset_in_data, u32 exception_lists,
+                                                  ChunkLocation* location) const
+{
+  u32 group_data_size = Common::swap32(group.data_size);
+
+  WIARVZCompressionType compression_type = m_compression_type;
+  u32 rvz_packed_size = 0;
+  bool in_chunk_store = false;
+  if constexpr (RVZ)
+  {
+    if ((group_data_size & 0x80000000) == 0)
+      compression_type = WIARVZCompressionType::None;
+
+    in_chunk_store = (group_data_size & RVZChunkStore::GROUP_IN_STORE_FLAG) != 0;
+    group_data_size &= 0x3FFFFFFF;
+
+    rvz_packed_size = Common::swap32(group.rvz_packed_size);
+  }
+
+  // A group without data only contains zeroes.
+  if (group_data_size == 0)
+    return false;
+
+  if (in_chunk_store)
+  {
+    location->offset_in_file =
+        CHUNK_STORE_OFFSET_FLAG | RVZChunkStore::GetDataOffset(Common::swap32(group.data_offset));
+  }
+  else
+  {
+    location->offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+  }
+  location->compressed_size = group_data_size;
+  location->decompressed_size = chunk_size;
+  location->compression_type = compression_type;
+  location->exception_lists = exception_lists;
+  location->rvz_packed_size = rvz_packed_size;
+  location->data_offset = group_offset_in_data;
+  return true;
+}
+
 template <bool RVZ>
 typename WIARVZFileReader<RVZ>::Chunk&
 WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_size,
@@ -572,18 +782,50 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
                                           WIARVZCompressionType compression_type,
                                           u32 exception_lists, u32 rvz_packed_size, u64 data_offset)
 {
-  if (offset_in_file == m_cached_chunk_offset)
-    return m_cached_chunk;
+  return ReadCompressedData(ChunkLocation{offset_in_file, compressed_size, decompressed_size,
+                                         compression_type, exception_lists, rvz_packed_size,
+                                         data_offset});
+}
+
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk&
+WIARVZFileReader<RVZ>::ReadCompressedData(const ChunkLocation& location)
+{
+  if (Chunk* chunk = FindCachedChunk(location.offset_in_file))
+    return *chunk;
+
+  if (std::optional<Chunk> chunk = TakeReadAheadChunk(location.offset_in_file))
+  {
+    const bool in_chunk_store = (location.offset_in_file & CHUNK_STORE_OFFSET_FLAG) != 0;
+    chunk->SetFile(in_chunk_store ? &m_chunk_store_file : &m_file);
+    return AddCachedChunk(location.offset_in_file, std::move(*chunk));
+  }
+
+  return AddCachedChunk(location.offset_in_file,
+                        CreateChunk(&m_file, &m_chunk_store_file, location));
+}
+
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk
+WIARVZFileReader<RVZ>::CreateChunk(File::IOFile* file, File::IOFile* chunk_store_file,
+                                   const ChunkLocation& location) const
+{
+  u64 offset_in_file = location.offset_in_file;
+  if (offset_in_file & CHUNK_STORE_OFFSET_FLAG)
+  {
+    file = chunk_store_file;
+    offset_in_file &= ~CHUNK_STORE_OFFSET_FLAG;
+  }
 
   std::unique_ptr<Decompressor> decompressor;
-  switch (compression_type)
+  switch (location.compression_type)
   {
   case WIARVZCompressionType::None:
     decompressor = std::make_unique<NoneDecompressor>();
     break;
   case WIARVZCompressionType::Purge:
-    decompressor = std::make_unique<PurgeDecompressor>(rvz_packed_size == 0 ? decompressed_size :
-                                                                              rvz_packed_size);
+    decompressor = std::make_unique<PurgeDecompressor>(
+        location.rvz_packed_size == 0 ? location.decompressed_size : location.rvz_packed_size);
     break;
   case WIARVZCompressionType::Bzip2:
     decompressor = std::make_unique<Bzip2Decompressor>();
@@ -597,17 +839,111 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
                                                       m_header_2.compressor_data_size);
     break;
   case WIARVZCompressionType::Zstd:
-    decompressor = std::make_unique<ZstdDecompressor>();
+    decompressor = std::make_unique<ZstdDecompressor>(m_zstd_dictionary);
     break;
   }
 
-  const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
+  const bool compressed_exception_lists =
+      location.compression_type > WIARVZCompressionType::Purge;
 
-  m_cached_chunk =
-      Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
-            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor));
-  m_cached_chunk_offset = offset_in_file;
-  return m_cached_chunk;
+  return Chunk(file, offset_in_file, location.compressed_size, location.decompressed_size,
+               location.exception_lists, compressed_exception_lists, location.rvz_packed_size,
+               location.data_offset, std::move(decompressor));
+}
+
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk* WIARVZFileReader<RVZ>::FindCachedChunk(u64 offset_in_file)
+{
+  const auto it = std::ranges::find_if(m_cached_chunks, [&](const CachedChunk& cached_chunk) {
+    return cached_chunk.offset_in_file == offset_in_file;
+  });
+  if (it == m_cached_chunks.end())
+    return nullptr;
+
+  // Move it to the front to mark it as the most recently used chunk.
+  m_cached_chunks.splice(m_cached_chunks.begin(), m_cached_chunks, it);
+  return &it->chunk;
+}
+
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk& WIARVZFileReader<RVZ>::AddCachedChunk(u64 offset_in_file,
+                                                                             Chunk chunk)
+{
+  m_cached_chunks.push_front(CachedChunk{offset_in_file, std::move(chunk)});
+  while (m_cached_chunks.size() > m_max_cached_chunks)
+    m_cached_chunks.pop_back();
+
+  return m_cached_chunks.front().chunk;
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::RemoveCachedChunk(u64 offset_in_file)
+{
+  std::erase_if(m_cached_chunks, [&](const CachedChunk& cached_chunk) {
+    return cached_chunk.offset_in_file == offset_in_file;
+  });
+}
+
+template <bool RVZ>
+std::optional<typename WIARVZFileReader<RVZ>::Chunk>
+WIARVZFileReader<RVZ>::TakeReadAheadChunk(u64 offset_in_file)
+{
+  std::unique_lock lk(m_read_ahead_mutex);
+  if (m_read_ahead_offset != offset_in_file)
+    return std::nullopt;
+
+  // The worker has most likely made progress already, so waiting for it beats starting over.
+  m_read_ahead_done.wait(lk, [this] { return !m_read_ahead_pending; });
+  m_read_ahead_offset = std::numeric_limits<u64>::max();
+  return std::exchange(m_read_ahead_chunk, std::nullopt);
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::ReadAhead(const ChunkLocation& location)
+{
+  const bool is_cached = std::ranges::any_of(m_cached_chunks, [&](const CachedChunk& cached_chunk) {
+    return cached_chunk.offset_in_file == location.offset_in_file;
+  });
+  if (is_cached)
+    return;
+
+  std::lock_guard lk(m_read_ahead_mutex);
+  if (m_read_ahead_pending || m_read_ahead_offset == location.offset_in_file)
+    return;
+
+  // Most readers never read sequentially, so only start the thread once it's needed.
+  if (!m_read_ahead_file)
+  {
+    m_read_ahead_file = m_file.Duplicate("rb");
+    if (m_chunk_store_file)
+      m_read_ahead_chunk_store_file = m_chunk_store_file.Duplicate("rb");
+    if (!m_read_ahead_file || (m_chunk_store_file && !m_read_ahead_chunk_store_file))
+    {
+      m_read_ahead_enabled = false;
+      return;
+    }
+
+    m_read_ahead_thread.Reset("WIA/RVZ Read Ahead",
+                              [this](ChunkLocation next_location) { RunReadAhead(next_location); });
+  }
+
+  m_read_ahead_offset = location.offset_in_file;
+  m_read_ahead_pending = true;
+  m_read_ahead_chunk.reset();
+  m_read_ahead_thread.Push(location);
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::RunReadAhead(const ChunkLocation& location)
+{
+  Chunk chunk = CreateChunk(&m_read_ahead_file, &m_read_ahead_chunk_store_file, location);
+  const bool success = chunk.ReadAll();
+
+  std::lock_guard lk(m_read_ahead_mutex);
+  if (success)
+    m_read_ahead_chunk = std::move(chunk);
+  m_read_ahead_pending = false;
+  m_read_ahead_done.notify_all();
 }
 
 template <bool RVZ>
@@ -651,16 +987,32 @@ WIARVZFileReader<RVZ>::Chunk::Chunk(File::IOFile* file, u64 offset_in_file, u64
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 {
-  if (!m_decompressor || !m_file ||
-      offset + size > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
-  {
+  if (offset + size > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
+    return false;
+
+  if (!DecompressUpTo(offset + size))
     return false;
-  }
 
-  while (offset + size > GetOutBytesWrittenExcludingExceptions())
+  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::ReadAll()
+{
+  return DecompressUpTo(m_out.data.size() - m_out_bytes_allocated_for_exceptions);
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressUpTo(u64 end)
+{
+  if (!m_decompressor || !m_file)
+    return false;
+
+  while (end > GetOutBytesWrittenExcludingExceptions())
   {
     u64 bytes_to_read;
-    if (offset + size == m_out.data.size())
+    if (end == m_out.data.size())
     {
       // Read all the remaining data.
       bytes_to_read = m_in.data.size() - m_in.bytes_written;
@@ -673,7 +1025,7 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 
       // The compressed data is probably not much bigger than the decompressed data.
       // Add a few bytes for possible compression overhead and for any hash exceptions.
-      bytes_to_read = offset + size - GetOutBytesWrittenExcludingExceptions() + 0x100;
+      bytes_to_read = end - GetOutBytesWrittenExcludingExceptions() + 0x100;
 
       // Align the access in an attempt to gain speed. But we don't actually know the
       // block size of the underlying storage device, so we just use the Wii block size.
@@ -753,7 +1105,6 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
     }
   }
 
-  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
   return true;
 }
 
@@ -1068,7 +1419,8 @@ std::optional<std::vector<u8>> WIARVZFileReader<RVZ>::Compress(Compressor* compr
 template <bool RVZ>
 void WIARVZFileReader<RVZ>::SetUpCompressor(std::unique_ptr<Compressor>* compressor,
                                             WIARVZCompressionType compression_type,
-                                            int compression_level, WIAHeader2* header_2)
+                                            int compression_level, WIAHeader2* header_2,
+                                            std::shared_ptr<const ZSTD_CDict> zstd_dictionary)
 {
   switch (compression_type)
   {
@@ -1099,7 +1451,7 @@ void WIARVZFileReader<RVZ>::SetUpCompressor(std::unique_ptr<Compressor>* compres
     break;
   }
   case WIARVZCompressionType::Zstd:
-    *compressor = std::make_unique<ZstdCompressor>(compression_level);
+    *compressor = std::make_unique<ZstdCompressor>(compression_level, std::move(zstd_dictionary));
     break;
   }
 }
@@ -1319,6 +1671,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
 
     if constexpr (RVZ)
     {
+      entry.data_offset = parameters.data_offset;
       RVZPack(data.data(), output_entries.data(), data.size(), parameters.data_offset, true,
               compression, file_system);
     }
@@ -1364,6 +1717,12 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
       OutputParametersEntry& entry = output_entries.emplace_back();
       std::optional<ReuseID>& reuse_id = entry.reuse_id;
 
+      if constexpr (RVZ)
+      {
+        entry.data_offset = parameters.data_offset + i * out_data_per_chunk;
+        entry.in_partition = true;
+      }
+
       // Set this chunk as reusable if the encrypted data is AllSame
       const u8* data = parameters.data.data() + block_index * VolumeWii::BLOCK_TOTAL_SIZE;
       if (AllSame(data, std::min(parameters_data_end, data + in_data_per_chunk)))
@@ -1394,19 +1753,11 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
         const u64 blocks_in_this_group =
             std::min<u64>(VolumeWii::BLOCKS_PER_GROUP, blocks - i * VolumeWii::BLOCKS_PER_GROUP);
 
-        for (u32 j = 0; j < VolumeWii::BLOCKS_PER_GROUP; ++j)
-        {
-          if (j < blocks_in_this_group)
-          {
-            const u64 offset_of_block = offset_of_group + j * VolumeWii::BLOCK_TOTAL_SIZE;
-            VolumeWii::DecryptBlockData(parameters.data.data() + offset_of_block,
-                                        state->decryption_buffer[j].data(), aes_context.get());
-          }
-          else
-          {
-            state->decryption_buffer[j].fill(0);
-          }
-        }
+        VolumeWii::DecryptBlocksData(parameters.data.data() + offset_of_group,
+                                     state->decryption_buffer.data(), blocks_in_this_group,
+                                     aes_context.get());
+        for (u64 j = blocks_in_this_group; j < VolumeWii::BLOCKS_PER_GROUP; ++j)
+          state->decryption_buffer[j].fill(0);
 
         VolumeWii::HashGroup(state->decryption_buffer.data(), state->hash_buffer.data());
 
@@ -1648,6 +1999,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
 template <bool RVZ>
 ConversionResultCode WIARVZFileReader<RVZ>::Output(std::vector<OutputParametersEntry>* entries,
                                                    File::IOFile* outfile,
+                                                   RVZChunkStore* chunk_store,
                                                    std::map<ReuseID, GroupEntry>* reusable_groups,
                                                    std::mutex* reusable_groups_mutex,
                                                    GroupEntry* group_entry, u64* bytes_written)
@@ -1662,20 +2014,43 @@ ConversionResultCode WIARVZFileReader<RVZ>::Output(std::vector<OutputParametersE
       continue;
     }
 
-    if (*bytes_written >> 2 > std::numeric_limits<u32>::max())
-      return ConversionResultCode::InternalError;
-
-    ASSERT((*bytes_written & 3) == 0);
-    group_entry->data_offset = Common::swap32(static_cast<u32>(*bytes_written >> 2));
-
     u32 data_size = static_cast<u32>(entry.exception_lists.size() + entry.main_data.size());
     if constexpr (RVZ)
     {
       data_size = (data_size & 0x7FFFFFFF) | (static_cast<u32>(entry.compressed) << 31);
       group_entry->rvz_packed_size = Common::swap32(static_cast<u32>(entry.rvz_packed_size));
+
+      // Groups without data are stored as such in the RVZ file even when using a chunk store
+      if (chunk_store && data_size != 0)
+      {
+        const RVZChunkStore::ChunkInfo info{data_size, static_cast<u32>(entry.rvz_packed_size),
+                                            entry.data_offset, entry.in_partition};
+        const std::optional<u32> reference =
+            chunk_store->AddChunk(info, entry.exception_lists, entry.main_data);
+        if (!reference)
+          return ConversionResultCode::WriteFailed;
+
+        group_entry->data_offset = Common::swap32(*reference);
+        group_entry->data_size = Common::swap32(data_size | RVZChunkStore::GROUP_IN_STORE_FLAG);
+
+        if (entry.reuse_id)
+        {
+          std::lock_guard guard(*reusable_groups_mutex);
+          reusable_groups->emplace(*entry.reuse_id, *group_entry);
+        }
+
+        ++group_entry;
+        continue;
+      }
     }
     group_entry->data_size = Common::swap32(data_size);
 
+    if (*bytes_written >> 2 > std::numeric_limits<u32>::max())
+      return ConversionResultCode::InternalError;
+
+    ASSERT((*bytes_written & 3) == 0);
+    group_entry->data_offset = Common::swap32(static_cast<u32>(*bytes_written >> 2));
+
     if (!outfile->WriteArray(entry.exception_lists.data(), entry.exception_lists.size()))
       return ConversionResultCode::WriteFailed;
     if (!outfile->WriteArray(entry.main_data.data(), entry.main_data.size()))
@@ -1738,23 +2113,39 @@ bool WIARVZFileReader<RVZ>::WriteHeader(File::IOFile* file, const u8* data, size
   return PadTo4(file, bytes_written);
 }
 
+template <bool RVZ>
+RVZChunkStore::Parameters
+WIARVZFileReader<RVZ>::GetChunkStoreParameters(WIARVZCompressionType compression_type,
+                                               int compression_level, int chunk_size)
+{
+  WIAHeader2 header_2{};
+  std::unique_ptr<Compressor> compressor;
+  SetUpCompressor(&compressor, compression_type, compression_level, &header_2);
+
+  return {static_cast<u32>(compression_type), static_cast<u32>(chunk_size),
+          header_2.compressor_data_size, std::to_array(header_2.compressor_data)};
+}
+
 template <bool RVZ>
 ConversionResultCode
 WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volume,
                                File::IOFile* outfile, WIARVZCompressionType compression_type,
-                               int compression_level, int chunk_size, CompressCB callback)
+                               int compression_level, int chunk_size, CompressCB callback,
+                               RVZChunkStore* chunk_store, const std::string& chunk_store_path,
+                               bool train_zstd_dictionary)
 {
   ASSERT(infile->GetDataSizeType() == DataSizeType::Accurate);
   ASSERT(chunk_size > 0);
+  ASSERT(RVZ || !chunk_store);
+  ASSERT(!train_zstd_dictionary || (RVZ && compression_type == WIARVZCompressionType::Zstd));
 
   const u64 iso_size = infile->GetDataSize();
   const u64 chunks_per_wii_group = std::max<u64>(1, VolumeWii::GROUP_TOTAL_SIZE / chunk_size);
   const u64 exception_lists_per_chunk = std::max<u64>(1, chunk_size / VolumeWii::GROUP_TOTAL_SIZE);
   const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
+  const bool compression = compression_type != WIARVZCompressionType::None;
 
-  u64 bytes_read = 0;
   u64 bytes_written = 0;
-  size_t groups_processed = 0;
 
   WIAHeader1 header_1{};
   WIAHeader2 header_2{};
@@ -1778,17 +2169,191 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
 
   group_entries.resize(total_groups);
 
+  // Splits the input into the parts that are compressed together (one or more groups each) and
+  // calls f(data_entry, offset, size, data_offset_in_partition, group_index) for each of them
+  const auto for_each_input_part = [&](const auto& f) {
+    u64 bytes_read = 0;
+    size_t groups_processed = 0;
+
+    for (const DataEntry& data_entry : data_entries)
+    {
+      u32 first_group;
+      u32 last_group;
+
+      u64 data_offset;
+      u64 data_size;
+
+      u64 data_offset_in_partition;
+
+      if (data_entry.is_partition)
+      {
+        const PartitionEntry& partition_entry = partition_entries[data_entry.index];
+        const PartitionDataEntry& partition_data_entry =
+            partition_entry.data_entries[data_entry.partition_data_index];
+
+        first_group = Common::swap32(partition_data_entry.group_index);
+        last_group = first_group + Common::swap32(partition_data_entry.number_of_groups);
+
+        const u32 first_sector = Common::swap32(partition_data_entry.first_sector);
+        data_offset = first_sector * VolumeWii::BLOCK_TOTAL_SIZE;
+        data_size =
+            Common::swap32(partition_data_entry.number_of_sectors) * VolumeWii::BLOCK_TOTAL_SIZE;
+
+        const u32 block_in_partition =
+            first_sector - Common::swap32(partition_entry.data_entries[0].first_sector);
+        data_offset_in_partition = block_in_partition * VolumeWii::BLOCK_DATA_SIZE;
+      }
+      else
+      {
+        const RawDataEntry& raw_data_entry = raw_data_entries[data_entry.index];
+
+        first_group = Common::swap32(raw_data_entry.group_index);
+        last_group = first_group + Common::swap32(raw_data_entry.number_of_groups);
+
+        data_offset = Common::swap64(raw_data_entry.data_offset);
+        data_size = Common::swap64(raw_data_entry.data_size);
+
+        const u64 skipped_data = data_offset % VolumeWii::BLOCK_TOTAL_SIZE;
+        data_offset -= skipped_data;
+        data_size += skipped_data;
+
+        data_offset_in_partition = data_offset;
+      }
+
+      ASSERT(groups_processed == first_group);
+      ASSERT(bytes_read == data_offset);
+
+      while (groups_processed < last_group)
+      {
+        u64 bytes_to_read = chunk_size;
+        if (data_entry.is_partition)
+          bytes_to_read = std::max<u64>(bytes_to_read, VolumeWii::GROUP_TOTAL_SIZE);
+        bytes_to_read = std::min<u64>(bytes_to_read, data_offset + data_size - bytes_read);
+
+        const ConversionResultCode result =
+            f(data_entry, bytes_read, bytes_to_read, data_offset_in_partition, groups_processed);
+        if (result != ConversionResultCode::Success)
+          return result;
+        bytes_read += bytes_to_read;
+
+        data_offset += bytes_to_read;
+        data_size -= bytes_to_read;
+
+        if (data_entry.is_partition)
+        {
+          data_offset_in_partition +=
+              bytes_to_read / VolumeWii::BLOCK_TOTAL_SIZE * VolumeWii::BLOCK_DATA_SIZE;
+        }
+        else
+        {
+          data_offset_in_partition += bytes_to_read;
+        }
+
+        groups_processed += Common::AlignUp(bytes_to_read, chunk_size) / chunk_size;
+      }
+
+      ASSERT(data_size == 0);
+    }
+
+    ASSERT(groups_processed == total_groups);
+    ASSERT(bytes_read == iso_size);
+
+    return ConversionResultCode::Success;
+  };
+
+  const auto get_file_system = [&](const DataEntry& data_entry) {
+    return data_entry.is_partition ? partition_file_systems[data_entry.index] :
+                                     non_partition_file_system;
+  };
+
+  std::map<ReuseID, GroupEntry> reusable_groups;
+  std::mutex reusable_groups_mutex;
+
+  std::vector<u8> buffer;
+
+  std::vector<u8> zstd_dictionary;
+  std::shared_ptr<const ZSTD_CDict> zstd_cdict;
+  if (train_zstd_dictionary)
+  {
+    // Process evenly spaced parts of the input without compressing them, which results in exactly
+    // the data that the compressor would get for them
+    const u64 sample_interval = std::max<u64>(1, iso_size / ZSTD_DICTIONARY_SAMPLES_SIZE);
+    u64 part_index = 0;
+    CompressThreadState state;
+    std::vector<std::vector<u8>> samples;
+
+    const ConversionResultCode sample_result =
+        for_each_input_part([&](const DataEntry& data_entry, u64 offset, u64 size,
+                                u64 data_offset_in_partition, size_t group_index) {
+          if (part_index++ % sample_interval != 0)
+            return ConversionResultCode::Success;
+
+          buffer.resize(size);
+          if (!infile->Read(offset, size, buffer.data()))
+            return ConversionResultCode::ReadFailed;
+
+          // Nothing has been added to reusable_groups yet, so this doesn't affect the conversion
+          ConversionResult<OutputParameters> result = ProcessAndCompress(
+              &state, CompressParameters{buffer, &data_entry, data_offset_in_partition,
+                                         offset + size, group_index},
+              partition_entries, data_entries, get_file_system(data_entry), &reusable_groups,
+              &reusable_groups_mutex, chunks_per_wii_group, exception_lists_per_chunk,
+              compressed_exception_lists, compression);
+          if (!result)
+            return result.Error();
+
+          for (OutputParametersEntry& entry : result->entries)
+          {
+            std::vector<u8> sample = std::move(entry.exception_lists);
+            sample.insert(sample.end(), entry.main_data.begin(), entry.main_data.end());
+            if (!entry.reused_group && !sample.empty())
+              samples.push_back(std::move(sample));
+          }
+
+          return ConversionResultCode::Success;
+        });
+    if (sample_result != ConversionResultCode::Success)
+      return sample_result;
+
+    zstd_dictionary = TrainZstdDictionary(samples, ZSTD_DICTIONARY_SIZE);
+    if (!zstd_dictionary.empty())
+      zstd_cdict = CreateZstdCDict(zstd_dictionary, compression_level);
+    if (!zstd_cdict)
+    {
+      WARN_LOG_FMT(DISCIO, "Failed to train a Zstandard dictionary, not using one");
+      zstd_dictionary.clear();
+    }
+  }
+
   const size_t partition_entries_size = partition_entries.size() * sizeof(PartitionEntry);
   const size_t raw_data_entries_size = raw_data_entries.size() * sizeof(RawDataEntry);
   const size_t group_entries_size = group_entries.size() * sizeof(GroupEntry);
 
+  std::vector<u8> chunk_store_reference;
+  if (chunk_store)
+  {
+    if (chunk_store_path.size() > std::numeric_limits<u16>::max())
+      return ConversionResultCode::InternalError;
+
+    const u16 path_size = static_cast<u16>(chunk_store_path.size());
+    const RVZChunkStoreReference reference{RVZChunkStore::MAGIC, chunk_store->GetID(),
+                                           Common::swap16(path_size)};
+    PushBack(&chunk_store_reference, reference);
+    PushBack(&chunk_store_reference, reinterpret_cast<const u8*>(chunk_store_path.data()),
+             reinterpret_cast<const u8*>(chunk_store_path.data() + chunk_store_path.size()));
+  }
+  const size_t zstd_dictionary_reference_size =
+      zstd_dictionary.empty() ? 0 : sizeof(RVZZstdDictionaryReference);
+  const size_t header_2_size =
+      sizeof(WIAHeader2) + chunk_store_reference.size() + zstd_dictionary_reference_size;
+
   // An estimate for how much space will be taken up by headers.
   // We will reserve this much space at the beginning of the file, and if the headers don't
   // fit in that space, we will need to write them at the end of the file instead.
   const u64 headers_size_upper_bound = [&] {
     // 0x100 is added to account for compression overhead (in particular for Purge).
-    u64 upper_bound = sizeof(WIAHeader1) + sizeof(WIAHeader2) + partition_entries_size +
-                      raw_data_entries_size + 0x100;
+    u64 upper_bound = sizeof(WIAHeader1) + header_2_size + partition_entries_size +
+                      raw_data_entries_size + zstd_dictionary.size() + 0x100;
 
     // Compared to WIA, RVZ adds an extra member to the GroupEntry struct. This added data usually
     // compresses well, so we'll assume the compression ratio for RVZ GroupEntries is 9 / 16 or
@@ -1804,8 +2369,6 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
     return Common::AlignUp(upper_bound, VolumeWii::BLOCK_TOTAL_SIZE);
   }();
 
-  std::vector<u8> buffer;
-
   buffer.resize(headers_size_upper_bound);
   outfile->WriteBytes(buffer.data(), buffer.size());
   bytes_written = headers_size_upper_bound;
@@ -1814,21 +2377,13 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
     return ConversionResultCode::ReadFailed;
   // We intentionally do not increment bytes_read here, since these bytes will be read again
 
-  std::map<ReuseID, GroupEntry> reusable_groups;
-  std::mutex reusable_groups_mutex;
-
   const auto set_up_compress_thread_state = [&](CompressThreadState* state) {
-    SetUpCompressor(&state->compressor, compression_type, compression_level, nullptr);
+    SetUpCompressor(&state->compressor, compression_type, compression_level, nullptr, zstd_cdict);
     return ConversionResultCode::Success;
   };
 
   const auto process_and_compress = [&](CompressThreadState* state, CompressParameters parameters) {
-    const DataEntry& data_entry = *parameters.data_entry;
-    const FileSystem* file_system = data_entry.is_partition ?
-                                        partition_file_systems[data_entry.index] :
-                                        non_partition_file_system;
-
-    const bool compression = compression_type != WIARVZCompressionType::None;
+    const FileSystem* file_system = get_file_system(*parameters.data_entry);
 
     return ProcessAndCompress(state, std::move(parameters), partition_entries, data_entries,
                               file_system, &reusable_groups, &reusable_groups_mutex,
@@ -1838,7 +2393,7 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
 
   const auto output = [&](OutputParameters parameters) {
     const ConversionResultCode result =
-        Output(&parameters.entries, outfile, &reusable_groups, &reusable_groups_mutex,
+        Output(&parameters.entries, outfile, chunk_store, &reusable_groups, &reusable_groups_mutex,
                &group_entries[parameters.group_index], &bytes_written);
 
     if (result != ConversionResultCode::Success)
@@ -1851,94 +2406,24 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   MultithreadedCompressor<CompressThreadState, CompressParameters, OutputParameters> mt_compressor(
       set_up_compress_thread_state, process_and_compress, output);
 
-  for (const DataEntry& data_entry : data_entries)
-  {
-    u32 first_group;
-    u32 last_group;
+  const ConversionResultCode read_result =
+      for_each_input_part([&](const DataEntry& data_entry, u64 offset, u64 size,
+                              u64 data_offset_in_partition, size_t group_index) {
+        const ConversionResultCode status = mt_compressor.GetStatus();
+        if (status != ConversionResultCode::Success)
+          return status;
 
-    u64 data_offset;
-    u64 data_size;
+        buffer.resize(size);
+        if (!infile->Read(offset, size, buffer.data()))
+          return ConversionResultCode::ReadFailed;
 
-    u64 data_offset_in_partition;
-
-    if (data_entry.is_partition)
-    {
-      const PartitionEntry& partition_entry = partition_entries[data_entry.index];
-      const PartitionDataEntry& partition_data_entry =
-          partition_entry.data_entries[data_entry.partition_data_index];
+        mt_compressor.CompressAndWrite(CompressParameters{
+            buffer, &data_entry, data_offset_in_partition, offset + size, group_index});
 
-      first_group = Common::swap32(partition_data_entry.group_index);
-      last_group = first_group + Common::swap32(partition_data_entry.number_of_groups);
-
-      const u32 first_sector = Common::swap32(partition_data_entry.first_sector);
-      data_offset = first_sector * VolumeWii::BLOCK_TOTAL_SIZE;
-      data_size =
-          Common::swap32(partition_data_entry.number_of_sectors) * VolumeWii::BLOCK_TOTAL_SIZE;
-
-      const u32 block_in_partition =
-          first_sector - Common::swap32(partition_entry.data_entries[0].first_sector);
-      data_offset_in_partition = block_in_partition * VolumeWii::BLOCK_DATA_SIZE;
-    }
-    else
-    {
-      const RawDataEntry& raw_data_entry = raw_data_entries[data_entry.index];
-
-      first_group = Common::swap32(raw_data_entry.group_index);
-      last_group = first_group + Common::swap32(raw_data_entry.number_of_groups);
-
-      data_offset = Common::swap64(raw_data_entry.data_offset);
-      data_size = Common::swap64(raw_data_entry.data_size);
-
-      const u64 skipped_data = data_offset % VolumeWii::BLOCK_TOTAL_SIZE;
-      data_offset -= skipped_data;
-      data_size += skipped_data;
-
-      data_offset_in_partition = data_offset;
-    }
-
-    ASSERT(groups_processed == first_group);
-    ASSERT(bytes_read == data_offset);
-
-    while (groups_processed < last_group)
-    {
-      const ConversionResultCode status = mt_compressor.GetStatus();
-      if (status != ConversionResultCode::Success)
-        return status;
-
-      u64 bytes_to_read = chunk_size;
-      if (data_entry.is_partition)
-        bytes_to_read = std::max<u64>(bytes_to_read, VolumeWii::GROUP_TOTAL_SIZE);
-      bytes_to_read = std::min<u64>(bytes_to_read, data_offset + data_size - bytes_read);
-
-      buffer.resize(bytes_to_read);
-      if (!infile->Read(bytes_read, bytes_to_read, buffer.data()))
-        return ConversionResultCode::ReadFailed;
-      bytes_read += bytes_to_read;
-
-      mt_compressor.CompressAndWrite(CompressParameters{
-          buffer, &data_entry, data_offset_in_partition, bytes_read, groups_processed});
-
-      data_offset += bytes_to_read;
-      data_size -= bytes_to_read;
-
-      if (data_entry.is_partition)
-      {
-        data_offset_in_partition +=
-            bytes_to_read / VolumeWii::BLOCK_TOTAL_SIZE * VolumeWii::BLOCK_DATA_SIZE;
-      }
-      else
-      {
-        data_offset_in_partition += bytes_to_read;
-      }
-
-      groups_processed += Common::AlignUp(bytes_to_read, chunk_size) / chunk_size;
-    }
-
-    ASSERT(data_size == 0);
-  }
-
-  ASSERT(groups_processed == total_groups);
-  ASSERT(bytes_read == iso_size);
+        return ConversionResultCode::Success;
+      });
+  if (read_result != ConversionResultCode::Success)
+    return read_result;
 
   mt_compressor.Shutdown();
 
@@ -1947,7 +2432,7 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
     return status;
 
   std::unique_ptr<Compressor> compressor;
-  SetUpCompressor(&compressor, compression_type, compression_level, &header_2);
+  SetUpCompressor(&compressor, compression_type, compression_level, &header_2, zstd_cdict);
 
   const std::optional<std::vector<u8>> compressed_raw_data_entries = Compress(
       compressor.get(), reinterpret_cast<u8*>(raw_data_entries.data()), raw_data_entries_size);
@@ -1959,8 +2444,8 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   if (!compressed_group_entries)
     return ConversionResultCode::InternalError;
 
-  bytes_written = sizeof(WIAHeader1) + sizeof(WIAHeader2);
-  if (!outfile->Seek(sizeof(WIAHeader1) + sizeof(WIAHeader2), File::SeekOrigin::Begin))
+  bytes_written = sizeof(WIAHeader1) + header_2_size;
+  if (!outfile->Seek(sizeof(WIAHeader1) + header_2_size, File::SeekOrigin::Begin))
     return ConversionResultCode::WriteFailed;
 
   u64 partition_entries_offset;
@@ -1985,6 +2470,14 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
     return ConversionResultCode::WriteFailed;
   }
 
+  u64 zstd_dictionary_offset = 0;
+  if (!zstd_dictionary.empty() &&
+      !WriteHeader(outfile, zstd_dictionary.data(), zstd_dictionary.size(),
+                   headers_size_upper_bound, &bytes_written, &zstd_dictionary_offset))
+  {
+    return ConversionResultCode::WriteFailed;
+  }
+
   u32 disc_type = 0;
   if (infile_volume)
   {
@@ -2015,13 +2508,28 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   header_2.group_entries_offset = Common::swap64(group_entries_offset);
   header_2.group_entries_size = Common::swap32(static_cast<u32>(compressed_group_entries->size()));
 
+  std::vector<u8> header_2_data;
+  PushBack(&header_2_data, header_2);
+  PushBack(&header_2_data, chunk_store_reference.data(),
+           chunk_store_reference.data() + chunk_store_reference.size());
+  if (!zstd_dictionary.empty())
+  {
+    const RVZZstdDictionaryReference reference{
+        ZSTD_DICTIONARY_MAGIC, Common::swap64(zstd_dictionary_offset),
+        Common::swap32(static_cast<u32>(zstd_dictionary.size())),
+        Common::SHA1::CalculateDigest(zstd_dictionary)};
+    PushBack(&header_2_data, reference);
+  }
+
+  u32 version_compatible = RVZ ? RVZ_VERSION_WRITE_COMPATIBLE : WIA_VERSION_WRITE_COMPATIBLE;
+  if (chunk_store || !zstd_dictionary.empty())
+    version_compatible = RVZ_VERSION_WRITE_COMPATIBLE_EXTENSIONS;
+
   header_1.magic = RVZ ? RVZ_MAGIC : WIA_MAGIC;
   header_1.version = Common::swap32(RVZ ? RVZ_VERSION : WIA_VERSION);
-  header_1.version_compatible =
-      Common::swap32(RVZ ? RVZ_VERSION_WRITE_COMPATIBLE : WIA_VERSION_WRITE_COMPATIBLE);
-  header_1.header_2_size = Common::swap32(sizeof(WIAHeader2));
-  header_1.header_2_hash =
-      Common::SHA1::CalculateDigest(reinterpret_cast<const u8*>(&header_2), sizeof(header_2));
+  header_1.version_compatible = Common::swap32(version_compatible);
+  header_1.header_2_size = Common::swap32(static_cast<u32>(header_2_data.size()));
+  header_1.header_2_hash = Common::SHA1::CalculateDigest(header_2_data);
   header_1.iso_file_size = Common::swap64(infile->GetDataSize());
   header_1.wia_file_size = Common::swap64(outfile->GetSize());
   header_1.header_1_hash = Common::SHA1::CalculateDigest(reinterpret_cast<const u8*>(&header_1),
@@ -2032,7 +2540,7 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
 
   if (!outfile->WriteArray(&header_1, 1))
     return ConversionResultCode::WriteFailed;
-  if (!outfile->WriteArray(&header_2, 1))
+  if (!outfile->WriteArray(header_2_data.data(), header_2_data.size()))
     return ConversionResultCode::WriteFailed;
 
   return ConversionResultCode::Success;
@@ -2041,8 +2549,45 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
 bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
                        const std::string& outfile_path, bool rvz,
                        WIARVZCompressionType compression_type, int compression_level,
-                       int chunk_size, CompressCB callback)
+                       int chunk_size, CompressCB callback, const std::string& chunk_store_path,
+                       bool zstd_dictionary)
 {
+  ASSERT(rvz || chunk_store_path.empty());
+  ASSERT(!zstd_dictionary || (rvz && compression_type == WIARVZCompressionType::Zstd));
+
+  std::unique_ptr<RVZChunkStore> chunk_store;
+  std::string chunk_store_relative_path;
+  if (!chunk_store_path.empty())
+  {
+    chunk_store = RVZChunkStore::OpenForWriting(
+        chunk_store_path,
+        RVZFileReader::GetChunkStoreParameters(compression_type, compression_level, chunk_size));
+    if (!chunk_store)
+    {
+      PanicAlertFmtT("Failed to open the chunk store \"{0}\".\n"
+                     "A chunk store can only be shared by files that use the same compression "
+                     "settings and block size, and only one conversion can use it at a time.",
+                     chunk_store_path);
+      return false;
+    }
+
+    // The path is stored relative to the RVZ file so that they can be moved together
+    std::error_code error;
+    const std::filesystem::path relative_path =
+        std::filesystem::relative(StringToPath(chunk_store_path),
+                                  StringToPath(outfile_path).parent_path(), error);
+    if (error || relative_path.empty())
+    {
+      chunk_store_relative_path =
+          PathToString(std::filesystem::absolute(StringToPath(chunk_store_path), error));
+    }
+    else
+    {
+      const std::u8string generic_path = relative_path.generic_u8string();
+      chunk_store_relative_path.assign(generic_path.begin(), generic_path.end());
+    }
+  }
+
   File::IOFile outfile(outfile_path, "wb");
   if (!outfile)
   {
@@ -2059,7 +2604,8 @@ bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
   const auto convert = rvz ? RVZFileReader::Convert : WIAFileReader::Convert;
   const ConversionResultCode result =
       convert(infile, infile_volume.get(), &outfile, compression_type, compression_level,
-              chunk_size, callback);
+              chunk_size, callback, chunk_store.get(), chunk_store_relative_path,
+              zstd_dictionary && !chunk_store);
 
   if (result == ConversionResultCode::ReadFailed)
     PanicAlertFmtT("Failed to read from the input file \"{0}\".", infile_path);
@@ -4,10 +4,13 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
@@ -15,8 +18,10 @@
 #include "Common/Crypto/SHA1.h"
 #include "Common/IOFile.h"
 #include "Common/Swap.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/MultithreadedCompressor.h"
+#include "DiscIO/RVZChunkStore.h"
 #include "DiscIO/WIACompression.h"
 #include "DiscIO/WiiEncryptionCache.h"
 
@@ -50,6 +55,7 @@ public:
 
   BlobType GetBlobType() const override;
   std::unique_ptr<BlobReader> CopyReader() const override;
+  std::unique_ptr<BlobReader> CopyReaderForWorker() const override;
 
   u64 GetRawSize() const override { return Common::swap64(m_header_1.wia_file_size); }
   u64 GetDataSize() const override { return Common::swap64(m_header_1.iso_file_size); }
@@ -67,9 +73,18 @@ public:
   bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const override;
   bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset) override;
 
+  // If chunk_store is set, the data is written there instead of to outfile, and the RVZ file
+  // refers to the chunk store using chunk_store_path, which is relative to the RVZ file.
+  // If train_zstd_dictionary is set, Zstandard is primed with a dictionary trained on the input.
   static ConversionResultCode Convert(BlobReader* infile, const VolumeDisc* infile_volume,
                                       File::IOFile* outfile, WIARVZCompressionType compression_type,
-                                      int compression_level, int chunk_size, CompressCB callback);
+                                      int compression_level, int chunk_size, CompressCB callback,
+                                      RVZChunkStore* chunk_store,
+                                      const std::string& chunk_store_path,
+                                      bool train_zstd_dictionary);
+
+  static RVZChunkStore::Parameters GetChunkStoreParameters(WIARVZCompressionType compression_type,
+                                                           int compression_level, int chunk_size);
 
 private:
   using WiiKey = std::array<u8, 16>;
@@ -159,6 +174,28 @@ private:
 
   using GroupEntry = std::conditional_t<RVZ, RVZGroupEntry, WIAGroupEntry>;
 
+  // Stored after WIAHeader2 (and included in header_2_size) in RVZ files whose group data is in
+  // a chunk store. Followed by the path of the chunk store relative to the RVZ file.
+  struct RVZChunkStoreReference
+  {
+    u32 magic;
+    RVZChunkStore::StoreID store_id;
+    u16 path_size;
+  };
+  static_assert(sizeof(RVZChunkStoreReference) == 0x16, "Wrong size for RVZ chunk store reference");
+
+  // Stored after WIAHeader2 (and included in header_2_size) in RVZ files where all Zstandard data
+  // is compressed using a dictionary. The dictionary itself is stored uncompressed.
+  struct RVZZstdDictionaryReference
+  {
+    u32 magic;
+    u64 dictionary_offset;
+    u32 dictionary_size;
+    Common::SHA1::Digest dictionary_hash;
+  };
+  static_assert(sizeof(RVZZstdDictionaryReference) == 0x24,
+                "Wrong size for RVZ Zstandard dictionary reference");
+
   struct HashExceptionEntry
   {
     u16 offset;
@@ -194,6 +231,11 @@ private:
 
     bool Read(u64 offset, u64 size, u8* out_ptr);
 
+    // Decompresses the whole chunk, so that later reads don't need to access the file.
+    bool ReadAll();
+
+    void SetFile(File::IOFile* file) { m_file = file; }
+
     // This can only be called once at least one byte of data has been read
     void GetHashExceptions(std::vector<HashExceptionEntry>* exception_list,
                            u64 exception_list_index, u16 additional_offset) const;
@@ -205,6 +247,7 @@ private:
     }
 
   private:
+    bool DecompressUpTo(u64 end);
     bool Decompress();
     bool HandleExceptions(const u8* data, size_t bytes_allocated, size_t bytes_written,
                           size_t* bytes_used, bool align);
@@ -228,8 +271,30 @@ private:
     u64 m_data_offset = 0;
   };
 
+  // Everything needed to find and decompress a chunk.
+  struct ChunkLocation
+  {
+    u64 offset_in_file;
+    u64 compressed_size;
+    u64 decompressed_size;
+    WIARVZCompressionType compression_type;
+    u32 exception_lists;
+    u32 rvz_packed_size;
+    u64 data_offset;
+  };
+
+  struct CachedChunk
+  {
+    u64 offset_in_file;
+    Chunk chunk;
+  };
+
   explicit WIARVZFileReader(File::IOFile file, const std::string& path);
   bool Initialize(const std::string& path);
+  bool ReadHeader2Extensions(const u8* data, size_t size, const std::string& path);
+  bool OpenChunkStore(const u8* reference, size_t size, const std::string& path,
+                      size_t* reference_size);
+  bool LoadZstdDictionary(const u8* reference, size_t size, size_t* reference_size);
   bool HasDataOverlap() const;
 
   const PartitionEntry* GetPartition(u64 partition_data_offset, u32* partition_first_sector) const;
@@ -240,6 +305,17 @@ private:
   Chunk& ReadCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
                             WIARVZCompressionType compression_type, u32 exception_lists = 0,
                             u32 rvz_packed_size = 0, u64 data_offset = 0);
+  Chunk& ReadCompressedData(const ChunkLocation& location);
+  bool GetGroupChunkLocation(const GroupEntry& group, u64 chunk_size, u64 group_offset_in_data,
+                             u32 exception_lists, ChunkLocation* location) const;
+  Chunk CreateChunk(File::IOFile* file, File::IOFile* chunk_store_file,
+                    const ChunkLocation& location) const;
+  Chunk* FindCachedChunk(u64 offset_in_file);
+  Chunk& AddCachedChunk(u64 offset_in_file, Chunk chunk);
+  void RemoveCachedChunk(u64 offset_in_file);
+  std::optional<Chunk> TakeReadAheadChunk(u64 offset_in_file);
+  void ReadAhead(const ChunkLocation& location);
+  void RunReadAhead(const ChunkLocation& location);
 
   static bool ApplyHashExceptions(const std::vector<HashExceptionEntry>& exception_list,
                                   VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
@@ -311,6 +387,8 @@ private:
     std::optional<GroupEntry> reused_group;
     size_t rvz_packed_size = 0;
     bool compressed = false;
+    u64 data_offset = 0;
+    bool in_partition = false;
   };
 
   using OutputParametersEntry =
@@ -342,7 +420,8 @@ private:
 
   static void SetUpCompressor(std::unique_ptr<Compressor>* compressor,
                               WIARVZCompressionType compression_type, int compression_level,
-                              WIAHeader2* header_2);
+                              WIAHeader2* header_2,
+                              std::shared_ptr<const ZSTD_CDict> zstd_dictionary = nullptr);
   static bool TryReuse(std::map<ReuseID, GroupEntry>* reusable_groups,
                        std::mutex* reusable_groups_mutex, OutputParametersEntry* entry);
   static ConversionResult<OutputParameters>
@@ -354,7 +433,7 @@ private:
                      u64 exception_lists_per_chunk, bool compressed_exception_lists,
                      bool compression);
   static ConversionResultCode Output(std::vector<OutputParametersEntry>* entries,
-                                     File::IOFile* outfile,
+                                     File::IOFile* outfile, RVZChunkStore* chunk_store,
                                      std::map<ReuseID, GroupEntry>* reusable_groups,
                                      std::mutex* reusable_groups_mutex, GroupEntry* group_entry,
                                      u64* bytes_written);
@@ -366,8 +445,41 @@ private:
 
   File::IOFile m_file;
   std::string m_path;
-  Chunk m_cached_chunk;
-  u64 m_cached_chunk_offset = std::numeric_limits<u64>::max();
+
+  // Only open for RVZ files whose group data is in a chunk store
+  File::IOFile m_chunk_store_file;
+
+  // Set in ChunkLocation::offset_in_file for chunks in the chunk store. This keeps them apart from
+  // chunks in the RVZ file itself in the chunk cache.
+  static constexpr u64 CHUNK_STORE_OFFSET_FLAG = u64(1) << 63;
+
+  // Only set for RVZ files which were compressed using a Zstandard dictionary
+  std::shared_ptr<const ZSTD_DDict> m_zstd_dictionary;
+
+  static constexpr u32 ZSTD_DICTIONARY_MAGIC = 0x445A5652;  // "RVZD" (byteswapped to little endian)
+
+  // How much data the Zstandard dictionary is trained on, spread out evenly over the input, and
+  // the size of the dictionary
+  static constexpr u64 ZSTD_DICTIONARY_SAMPLES_SIZE = 0x1000000;
+  static constexpr size_t ZSTD_DICTIONARY_SIZE = 0x10000;
+
+  // Recently used chunks, most recently used first.
+  std::list<CachedChunk> m_cached_chunks;
+  size_t m_max_cached_chunks;
+
+  // When groups are read sequentially, the next one is decompressed on a worker thread, using its
+  // own file handle. Only one chunk is read ahead at a time.
+  bool m_read_ahead_enabled;
+  u64 m_last_group_index = std::numeric_limits<u64>::max();
+  File::IOFile m_read_ahead_file;
+  File::IOFile m_read_ahead_chunk_store_file;
+  std::mutex m_read_ahead_mutex;
+  std::condition_variable m_read_ahead_done;
+  u64 m_read_ahead_offset = std::numeric_limits<u64>::max();
+  bool m_read_ahead_pending = false;
+  std::optional<Chunk> m_read_ahead_chunk;
+  Common::WorkQueueThread<ChunkLocation> m_read_ahead_thread;
+
   WiiEncryptionCache m_encryption_cache;
 
   std::vector<HashExceptionEntry> m_exception_list;
@@ -390,9 +502,12 @@ private:
   static constexpr u32 WIA_VERSION_WRITE_COMPATIBLE = 0x01000000;
   static constexpr u32 WIA_VERSION_READ_COMPATIBLE = 0x00080000;
 
-  static constexpr u32 RVZ_VERSION = 0x01000000;
+  static constexpr u32 RVZ_VERSION = 0x01010000;
   static constexpr u32 RVZ_VERSION_WRITE_COMPATIBLE = 0x00030000;
   static constexpr u32 RVZ_VERSION_READ_COMPATIBLE = 0x00030000;
+
+  // Older versions can't read files which use a chunk store or a Zstandard dictionary
+  static constexpr u32 RVZ_VERSION_WRITE_COMPATIBLE_EXTENSIONS = 0x01010000;
 };
 
 using WIAFileReader = WIARVZFileReader<false>;
@@ -4,11 +4,14 @@
 #include "DiscIO/WIACompression.h"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <queue>
+#include <utility>
 #include <vector>
 
 #include <bzlib.h>
@@ -256,9 +259,16 @@ bool LZMADecompressor::Decompress(const DecompressionBuffer& in, DecompressionBu
   return result == LZMA_OK || result == LZMA_STREAM_END;
 }
 
-ZstdDecompressor::ZstdDecompressor()
+ZstdDecompressor::ZstdDecompressor(std::shared_ptr<const ZSTD_DDict> dictionary)
+    : m_dictionary(std::move(dictionary))
 {
   m_stream = ZSTD_createDStream();
+
+  if (m_stream && m_dictionary && ZSTD_isError(ZSTD_DCtx_refDDict(m_stream, m_dictionary.get())))
+  {
+    ZSTD_freeDStream(m_stream);
+    m_stream = nullptr;
+  }
 }
 
 ZstdDecompressor::~ZstdDecompressor()
@@ -733,13 +743,19 @@ size_t LZMACompressor::GetSize() const
   return static_cast<size_t>(m_stream.next_out - m_buffer.data());
 }
 
-ZstdCompressor::ZstdCompressor(int compression_level)
+ZstdCompressor::ZstdCompressor(int compression_level,
+                               std::shared_ptr<const ZSTD_CDict> dictionary)
+    : m_dictionary(std::move(dictionary))
 {
   m_stream = ZSTD_createCStream();
 
+  // A referenced dictionary stays in use after ZSTD_CCtx_reset(ZSTD_reset_session_only).
+  // Note that the compression level of the dictionary takes precedence over compression_level
   if (ZSTD_isError(ZSTD_CCtx_setParameter(m_stream, ZSTD_c_compressionLevel, compression_level)) ||
-      ZSTD_isError(ZSTD_CCtx_setParameter(m_stream, ZSTD_c_contentSizeFlag, 0)))
+      ZSTD_isError(ZSTD_CCtx_setParameter(m_stream, ZSTD_c_contentSizeFlag, 0)) ||
+      (m_dictionary && ZSTD_isError(ZSTD_CCtx_refCDict(m_stream, m_dictionary.get()))))
   {
+    ZSTD_freeCStream(m_stream);
     m_stream = nullptr;
   }
 }
@@ -810,4 +826,144 @@ void ZstdCompressor::ExpandBuffer(size_t bytes_to_add)
   m_out_buffer.size = m_buffer.size();
 }
 
+// The length of the substrings that TrainZstdDictionary counts, and the length of the parts of the
+// samples that it puts in the dictionary
+static constexpr size_t DICTIONARY_DMER_SIZE = 8;
+static constexpr size_t DICTIONARY_SEGMENT_SIZE = 0x400;
+static constexpr u32 DICTIONARY_HASH_BITS = 20;
+
+static u32 HashDmer(const u8* data)
+{
+  static_assert(DICTIONARY_DMER_SIZE == sizeof(u64));
+  u64 dmer;
+  std::memcpy(&dmer, data, sizeof(dmer));
+  return static_cast<u32>((dmer * 0x9E3779B97F4A7C15) >> (64 - DICTIONARY_HASH_BITS));
+}
+
+std::vector<u8> TrainZstdDictionary(const std::vector<std::vector<u8>>& samples, size_t max_size)
+{
+  // For each substring (or rather, each hash of a substring), count how many samples contain it.
+  // Substrings which only repeat within a single sample can be found by zstd without a dictionary.
+  std::vector<u32> frequencies(size_t(1) << DICTIONARY_HASH_BITS);
+  std::vector<u32> stamps(frequencies.size(), std::numeric_limits<u32>::max());
+  for (u32 i = 0; i < samples.size(); ++i)
+  {
+    const std::vector<u8>& sample = samples[i];
+    for (size_t j = 0; j + DICTIONARY_DMER_SIZE <= sample.size(); ++j)
+    {
+      const u32 hash = HashDmer(sample.data() + j);
+      if (stamps[hash] != i)
+      {
+        stamps[hash] = i;
+        ++frequencies[hash];
+      }
+    }
+  }
+
+  struct Segment
+  {
+    const u8* data;
+    size_t size;
+  };
+
+  std::vector<Segment> segments;
+  for (const std::vector<u8>& sample : samples)
+  {
+    for (size_t i = 0; i + DICTIONARY_DMER_SIZE <= sample.size(); i += DICTIONARY_SEGMENT_SIZE)
+      segments.push_back({sample.data() + i, std::min(DICTIONARY_SEGMENT_SIZE, sample.size() - i)});
+  }
+
+  // The score of a segment is the sum of the frequencies of the distinct substrings it contains
+  u32 stamp = static_cast<u32>(samples.size());
+  const auto calculate_score = [&](const Segment& segment) {
+    ++stamp;
+    u64 score = 0;
+    for (size_t i = 0; i + DICTIONARY_DMER_SIZE <= segment.size; ++i)
+    {
+      const u32 hash = HashDmer(segment.data + i);
+      if (stamps[hash] != stamp)
+      {
+        stamps[hash] = stamp;
+        if (frequencies[hash] > 1)
+          score += frequencies[hash];
+      }
+    }
+    return score;
+  };
+
+  std::priority_queue<std::pair<u64, size_t>> queue;
+  for (size_t i = 0; i < segments.size(); ++i)
+  {
+    const u64 score = calculate_score(segments[i]);
+    if (score != 0)
+      queue.emplace(score, i);
+  }
+
+  // Greedily pick the segment with the highest score, and then stop counting the substrings in it
+  // so that other segments containing the same substrings aren't picked too. Scores only decrease
+  // as segments are picked, so the score in the queue is an upper bound that only needs to be
+  // recalculated for the segment at the top.
+  std::vector<Segment> picked_segments;
+  size_t dictionary_size = 0;
+  while (!queue.empty() && dictionary_size < max_size)
+  {
+    const size_t index = queue.top().second;
+    queue.pop();
+
+    const u64 score = calculate_score(segments[index]);
+    if (score == 0)
+      continue;
+
+    if (!queue.empty() && score < queue.top().first)
+    {
+      queue.emplace(score, index);
+      continue;
+    }
+
+    Segment segment = segments[index];
+    segment.size = std::min(segment.size, max_size - dictionary_size);
+    for (size_t i = 0; i + DICTIONARY_DMER_SIZE <= segment.size; ++i)
+      frequencies[HashDmer(segment.data + i)] = 0;
+
+    picked_segments.push_back(segment);
+    dictionary_size += segment.size;
+  }
+
+  // zstd can use the end of the dictionary with shorter offsets, so the best segments go last
+  std::vector<u8> dictionary;
+  dictionary.reserve(dictionary_size);
+  for (auto it = picked_segments.rbegin(); it != picked_segments.rend(); ++it)
+    dictionary.insert(dictionary.end(), it->data, it->data + it->size);
+
+  // zstd would interpret a dictionary starting with this magic number as a formatted dictionary
+  static constexpr std::array<u8, 4> DICTIONARY_MAGIC{0x37, 0xA4, 0x30, 0xEC};
+  static_assert(ZSTD_MAGIC_DICTIONARY == 0xEC30A437);
+  if (dictionary.size() >= DICTIONARY_MAGIC.size() &&
+      std::equal(DICTIONARY_MAGIC.begin(), DICTIONARY_MAGIC.end(), dictionary.begin()))
+  {
+    dictionary.erase(dictionary.begin());
+  }
+
+  return dictionary;
+}
+
+std::shared_ptr<const ZSTD_CDict> CreateZstdCDict(const std::vector<u8>& dictionary,
+                                                  int compression_level)
+{
+  ZSTD_CDict* cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), compression_level);
+  if (!cdict)
+    return nullptr;
+
+  return std::shared_ptr<const ZSTD_CDict>(cdict, ZSTD_freeCDict);
+}
+
+std::shared_ptr<const ZSTD_DDict> CreateZstdDDict(const std::vector<u8>& dictionary)
+{
+  ZSTD_DDict* ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+  if (!ddict)
+    return nullptr;
+
+  return std::shared_ptr<const ZSTD_DDict>(ddict, ZSTD_freeDDict);
+}
+
 }  // namespace DiscIO
@@ -105,7 +105,7 @@ private:
 class ZstdDecompressor final : public Decompressor
 {
 public:
-  ZstdDecompressor();
+  explicit ZstdDecompressor(std::shared_ptr<const ZSTD_DDict> dictionary = nullptr);
   ~ZstdDecompressor();
 
   bool Decompress(const DecompressionBuffer& in, DecompressionBuffer* out,
@@ -113,6 +113,7 @@ public:
 
 private:
   ZSTD_DStream* m_stream;
+  std::shared_ptr<const ZSTD_DDict> m_dictionary;
 };
 
 class RVZPackDecompressor final : public Decompressor
@@ -228,7 +229,8 @@ private:
 class ZstdCompressor final : public Compressor
 {
 public:
-  ZstdCompressor(int compression_level);
+  explicit ZstdCompressor(int compression_level,
+                          std::shared_ptr<const ZSTD_CDict> dictionary = nullptr);
   ~ZstdCompressor();
 
   bool Start(std::optional<u64> size) override;
@@ -244,6 +246,19 @@ private:
   ZSTD_CStream* m_stream;
   ZSTD_outBuffer m_out_buffer{};
   std::vector<u8> m_buffer;
+  std::shared_ptr<const ZSTD_CDict> m_dictionary;
 };
 
+// Builds a raw content dictionary for Zstandard out of the parts of the samples that contain the
+// substrings which occur in the most samples, similar to the COVER algorithm of zstd's dictionary
+// builder (which isn't part of the zstd library we ship). Returns an empty vector if the samples
+// have nothing in common.
+std::vector<u8> TrainZstdDictionary(const std::vector<std::vector<u8>>& samples, size_t max_size);
+
+// The returned objects can be shared by any number of compressors or decompressors.
+// Returns nullptr on failure.
+std::shared_ptr<const ZSTD_CDict> CreateZstdCDict(const std::vector<u8>& dictionary,
+                                                  int compression_level);
+std::shared_ptr<const ZSTD_DDict> CreateZstdDDict(const std::vector<u8>& dictionary);
+
 }  // namespace DiscIO
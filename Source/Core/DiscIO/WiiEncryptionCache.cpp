@@ -3,18 +3,107 @@
 
 #include "DiscIO/WiiEncryptionCache.h"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
-#include <limits>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <xxhash.h>
 
 #include "Common/Align.h"
+#include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/VolumeWii.h"
 
 namespace DiscIO
 {
+constexpr size_t MAX_CACHED_GROUPS = 8;
+
+constexpr u32 HASH_CACHE_MAGIC = 0x31434857;  // "WHC1"
+constexpr u32 HASH_CACHE_VERSION = 2;
+constexpr u32 HASH_CACHE_RECORD_MAGIC = 0x44524857;  // "WHRD"
+
+// The least recently used files are deleted when starting a new one would exceed this. Each group
+// takes 64 KiB, so this is enough for a few whole discs.
+constexpr u64 MAX_HASH_CACHE_SIZE = 1024 * 1024 * 1024;
+
+struct HashCacheHeader
+{
+  u32 magic;
+  u32 version;
+  u64 partition_data_decrypted_size;
+  Common::SHA1::Digest content_id;
+  u32 padding;
+};
+
+// Each group has a record consisting of a HashCacheRecordHeader followed by the hashes of the
+// group's blocks, before any hash exceptions are applied. Records that haven't been written yet
+// are holes in the file and read as zeroes.
+struct HashCacheRecordHeader
+{
+  u32 magic;
+  u32 checksum;   // Adler-32 of the hashes, which catches partially written records
+  u64 data_hash;  // XXH3-64 of the decrypted data of the group which the hashes are for
+};
+
+constexpr u64 HASH_CACHE_HASHES_SIZE = VolumeWii::BLOCKS_PER_GROUP * sizeof(VolumeWii::HashBlock);
+constexpr u64 HASH_CACHE_RECORD_SIZE = sizeof(HashCacheRecordHeader) + HASH_CACHE_HASHES_SIZE;
+
+static u64 GetHashCacheRecordOffset(u64 group_index)
+{
+  return sizeof(HashCacheHeader) + group_index * HASH_CACHE_RECORD_SIZE;
+}
+
+static std::string GetHashCacheDirectory()
+{
+  return File::GetUserPath(D_CACHE_IDX) + "WiiHashes/";
+}
+
+// Deletes the least recently used files other than keep_name until the rest fit in
+// MAX_HASH_CACHE_SIZE
+static void TrimHashCache(const std::string& keep_name)
+{
+  struct CacheFile
+  {
+    u64 modification_time;
+    u64 size;
+    std::string path;
+  };
+
+  const File::FSTEntry directory = File::ScanDirectoryTree(GetHashCacheDirectory(), false);
+  std::vector<CacheFile> files;
+  u64 total_size = 0;
+  for (const File::FSTEntry& entry : directory.children)
+  {
+    if (entry.isDirectory || entry.virtualName == keep_name)
+      continue;
+
+    const u64 modification_time = File::GetModificationTime(entry.physicalName);
+    files.push_back({modification_time, entry.size, entry.physicalName});
+    total_size += entry.size;
+  }
+
+  std::ranges::sort(files, {}, &CacheFile::modification_time);
+  for (const CacheFile& file : files)
+  {
+    if (total_size <= MAX_HASH_CACHE_SIZE)
+      break;
+
+    if (File::Delete(file.path, File::IfAbsentBehavior::NoConsoleWarning))
+      total_size -= file.size;
+  }
+}
+
 WiiEncryptionCache::WiiEncryptionCache(BlobReader* blob) : m_blob(blob)
 {
 }
@@ -26,43 +115,62 @@ WiiEncryptionCache::EncryptGroup(u64 offset, u64 partition_data_offset,
                                  u64 partition_data_decrypted_size, const Key& key,
                                  const HashExceptionCallback& hash_exception_callback)
 {
-  // Only allocate memory if this function actually ends up getting called
-  if (!m_cache)
-  {
-    m_cache = std::make_unique<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>>();
-    m_cached_offset = std::numeric_limits<u64>::max();
-  }
-
   ASSERT(offset % VolumeWii::GROUP_TOTAL_SIZE == 0);
-  const u64 group_offset_in_partition =
-      offset / VolumeWii::GROUP_TOTAL_SIZE * VolumeWii::GROUP_DATA_SIZE;
+  const u64 group_index = offset / VolumeWii::GROUP_TOTAL_SIZE;
+  const u64 group_offset_in_partition = group_index * VolumeWii::GROUP_DATA_SIZE;
   const u64 group_offset_on_disc = partition_data_offset + offset;
 
-  if (m_cached_offset != group_offset_on_disc)
+  if (Group* group = FindCachedGroup(group_offset_on_disc))
+    return group;
+
+  u64 data_hash = 0;
+  bool store_hashes = false;
+  VolumeWii::KnownHashesCallback known_hashes_callback;
+  if (m_hash_cache_enabled)
   {
-    std::function<void(VolumeWii::HashBlock * hash_blocks)> hash_exception_callback_2;
+    known_hashes_callback =
+        [&](const std::array<u8, VolumeWii::BLOCK_DATA_SIZE> data[VolumeWii::BLOCKS_PER_GROUP],
+            VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]) {
+          data_hash = XXH3_64bits(data, VolumeWii::BLOCKS_PER_GROUP * VolumeWii::BLOCK_DATA_SIZE);
+          if (LoadHashes(partition_data_offset, partition_data_decrypted_size, group_index,
+                         data_hash, hash_blocks))
+          {
+            return true;
+          }
 
-    if (hash_exception_callback)
-    {
-      hash_exception_callback_2 =
-          [offset, &hash_exception_callback](
-              VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]) {
-            return hash_exception_callback(hash_blocks, offset);
-          };
-    }
+          store_hashes = true;
+          return false;
+        };
+  }
 
-    if (!VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
-                                 partition_data_decrypted_size, key, m_blob, m_cache.get(),
-                                 hash_exception_callback_2))
-    {
-      m_cached_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
-      return nullptr;
-    }
+  std::function<void(VolumeWii::HashBlock * hash_blocks)> hash_exception_callback_2;
+
+  if (hash_exception_callback || m_hash_cache_enabled)
+  {
+    hash_exception_callback_2 =
+        [&, offset](VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]) {
+          // The exceptions are applied afterwards each time, so store the hashes without them
+          if (store_hashes)
+          {
+            StoreHashes(partition_data_offset, partition_data_decrypted_size, group_index,
+                        data_hash, hash_blocks);
+          }
 
-    m_cached_offset = group_offset_on_disc;
+          if (hash_exception_callback)
+            hash_exception_callback(hash_blocks, offset);
+        };
   }
 
-  return m_cache.get();
+  Group* group = GetEmptyCachedGroup(group_offset_on_disc);
+  if (!VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
+                               partition_data_decrypted_size, key, m_blob, group,
+                               hash_exception_callback_2, known_hashes_callback))
+  {
+    RemoveCachedGroup(group_offset_on_disc);
+    return nullptr;
+  }
+
+  return group;
 }
 
 bool WiiEncryptionCache::EncryptGroups(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset,
@@ -90,4 +198,140 @@ bool WiiEncryptionCache::EncryptGroups(u64 offset, u64 size, u8* out_ptr, u64 pa
   return true;
 }
 
+void WiiEncryptionCache::EnableHashCache(const Common::SHA1::Digest& content_id)
+{
+  m_hash_cache_enabled = true;
+  m_hash_cache_content_id = content_id;
+  m_hash_cache_files.clear();
+}
+
+WiiEncryptionCache::Group* WiiEncryptionCache::FindCachedGroup(u64 offset)
+{
+  const auto it = std::ranges::find_if(
+      m_cache, [offset](const CachedGroup& cached_group) { return cached_group.offset == offset; });
+  if (it == m_cache.end())
+    return nullptr;
+
+  m_cache.splice(m_cache.begin(), m_cache, it);
+  return it->data.get();
+}
+
+WiiEncryptionCache::Group* WiiEncryptionCache::GetEmptyCachedGroup(u64 offset)
+{
+  // Only allocate memory if groups actually end up getting encrypted
+  if (m_cache.size() < MAX_CACHED_GROUPS)
+  {
+    m_cache.push_front(CachedGroup{offset, std::make_unique<Group>()});
+  }
+  else
+  {
+    // Reuse the least recently used group
+    m_cache.splice(m_cache.begin(), m_cache, std::prev(m_cache.end()));
+    m_cache.front().offset = offset;
+  }
+
+  return m_cache.front().data.get();
+}
+
+void WiiEncryptionCache::RemoveCachedGroup(u64 offset)
+{
+  std::erase_if(m_cache, [offset](const CachedGroup& cached_group) {
+    return cached_group.offset == offset;
+  });
+}
+
+File::IOFile* WiiEncryptionCache::GetHashCacheFile(u64 partition_data_offset,
+                                                   u64 partition_data_decrypted_size)
+{
+  auto it = m_hash_cache_files.find(partition_data_offset);
+  if (it == m_hash_cache_files.end())
+  {
+    const std::string name =
+        fmt::format("{}_{:x}.bin", Common::SHA1::DigestToString(m_hash_cache_content_id),
+                    partition_data_offset);
+    const std::string path = GetHashCacheDirectory() + name;
+    File::CreateFullPath(path);
+
+    // Create the file if it's missing, but don't truncate it before it has been locked
+    File::IOFile(path, "ab").Close();
+    File::IOFile file(path, "r+b");
+    if (!file.TryLockExclusive())
+    {
+      // Another reader, maybe in another process, is using it. Do without the cache rather than
+      // overwriting each other's records.
+      file.Close();
+    }
+    else
+    {
+      HashCacheHeader header;
+      if (!file.ReadArray(&header, 1) || header.magic != HASH_CACHE_MAGIC ||
+          header.version != HASH_CACHE_VERSION ||
+          header.partition_data_decrypted_size != partition_data_decrypted_size ||
+          header.content_id != m_hash_cache_content_id)
+      {
+        // The file is new or outdated, so start over
+        file.ClearError();
+        TrimHashCache(name);
+        header = {HASH_CACHE_MAGIC, HASH_CACHE_VERSION, partition_data_decrypted_size,
+                  m_hash_cache_content_id, 0};
+        if (!file.Resize(0))
+          file.Close();
+      }
+
+      // Writing the header even if it's unchanged marks the file as recently used
+      if (!file.Seek(0, File::SeekOrigin::Begin) || !file.WriteArray(&header, 1) || !file.Flush())
+        file.Close();
+    }
+
+    it = m_hash_cache_files.emplace(partition_data_offset, std::move(file)).first;
+  }
+
+  return it->second.IsOpen() ? &it->second : nullptr;
+}
+
+bool WiiEncryptionCache::LoadHashes(u64 partition_data_offset, u64 partition_data_decrypted_size,
+                                    u64 group_index, u64 data_hash,
+                                    VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP])
+{
+  File::IOFile* file = GetHashCacheFile(partition_data_offset, partition_data_decrypted_size);
+  if (!file)
+    return false;
+
+  HashCacheRecordHeader record_header;
+  if (!file->Seek(GetHashCacheRecordOffset(group_index), File::SeekOrigin::Begin) ||
+      !file->ReadArray(&record_header, 1) || record_header.magic != HASH_CACHE_RECORD_MAGIC ||
+      !file->ReadArray(hash_blocks, VolumeWii::BLOCKS_PER_GROUP))
+  {
+    // Most likely, the group just hasn't been stored yet
+    file->ClearError();
+    return false;
+  }
+
+  // The hashes are only valid for the data they were calculated from
+  return record_header.data_hash == data_hash &&
+         Common::HashAdler32(reinterpret_cast<const u8*>(hash_blocks), HASH_CACHE_HASHES_SIZE) ==
+             record_header.checksum;
+}
+
+void WiiEncryptionCache::StoreHashes(
+    u64 partition_data_offset, u64 partition_data_decrypted_size, u64 group_index, u64 data_hash,
+    const VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP])
+{
+  File::IOFile* file = GetHashCacheFile(partition_data_offset, partition_data_decrypted_size);
+  if (!file)
+    return;
+
+  const HashCacheRecordHeader record_header{
+      HASH_CACHE_RECORD_MAGIC,
+      Common::HashAdler32(reinterpret_cast<const u8*>(hash_blocks), HASH_CACHE_HASHES_SIZE),
+      data_hash};
+
+  if (!file->Seek(GetHashCacheRecordOffset(group_index), File::SeekOrigin::Begin) ||
+      !file->WriteArray(&record_header, 1) ||
+      !file->WriteArray(hash_blocks, VolumeWii::BLOCKS_PER_GROUP))
+  {
+    file->ClearError();
+  }
+}
+
 }  // namespace DiscIO
@@ -4,10 +4,14 @@
 #pragma once
 
 #include <array>
-#include <limits>
+#include <list>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/IOFile.h"
 #include "DiscIO/VolumeWii.h"
 
 namespace DiscIO
@@ -37,6 +41,7 @@ public:
   // If the returned pointer is nullptr, reading from the blob failed.
   // If the returned pointer is not nullptr, it is guaranteed to be valid until
   // the next call of this function or the destruction of this object.
+  // The most recently encrypted groups are kept, so switching between a few groups is cheap.
   const std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>*
   EncryptGroup(u64 offset, u64 partition_data_offset, u64 partition_data_decrypted_size,
                const Key& key, const HashExceptionCallback& hash_exception_callback = {});
@@ -47,10 +52,41 @@ public:
                      u64 partition_data_decrypted_size, const Key& key,
                      const HashExceptionCallback& hash_exception_callback = {});
 
+  // Stores the hashes generated for each group in the user's cache directory, so that they
+  // don't have to be calculated again when the same group is encrypted later, even in another
+  // session. content_id should identify the contents of the blob. Stored hashes are only used if
+  // the decrypted data of the group is the same as when they were stored.
+  void EnableHashCache(const Common::SHA1::Digest& content_id);
+
 private:
+  using Group = std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>;
+
+  struct CachedGroup
+  {
+    u64 offset;
+    std::unique_ptr<Group> data;
+  };
+
+  Group* FindCachedGroup(u64 offset);
+  Group* GetEmptyCachedGroup(u64 offset);
+  void RemoveCachedGroup(u64 offset);
+
+  File::IOFile* GetHashCacheFile(u64 partition_data_offset, u64 partition_data_decrypted_size);
+  bool LoadHashes(u64 partition_data_offset, u64 partition_data_decrypted_size, u64 group_index,
+                  u64 data_hash, VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
+  void StoreHashes(u64 partition_data_offset, u64 partition_data_decrypted_size, u64 group_index,
+                   u64 data_hash,
+                   const VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
+
   BlobReader* m_blob;
-  std::unique_ptr<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>> m_cache;
-  u64 m_cached_offset = 0;
+
+  // Most recently used first
+  std::list<CachedGroup> m_cache;
+
+  bool m_hash_cache_enabled = false;
+  Common::SHA1::Digest m_hash_cache_content_id{};
+  // One file per partition, indexed by partition_data_offset. Closed if another reader is using it.
+  std::map<u64, File::IOFile> m_hash_cache_files;
 };
 
 }  // namespace DiscIO
@@ -389,7 +389,8 @@ void AdvancedWidget::AddDescriptions()
   static const char TR_BACKEND_MULTITHREADING_DESCRIPTION[] =
       QT_TR_NOOP("Enables multithreaded command submission in backends where supported. Enabling "
                  "this option may result in a performance improvement on systems with more than "
-                 "two CPU cores. Currently, this is limited to the Vulkan backend.<br><br>"
+                 "two CPU cores. Currently, this is limited to the Vulkan backend and the software "
+                 "renderer, which uses it to draw triangles on several threads.<br><br>"
                  "<dolphin_emphasis>If unsure, leave this checked.</dolphin_emphasis>");
   static const char TR_PREFER_VS_FOR_POINT_LINE_EXPANSION_DESCRIPTION[] =
       QT_TR_NOOP("On backends that support both using the geometry shader and the vertex shader "
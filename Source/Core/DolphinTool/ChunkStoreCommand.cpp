@@ -0,0 +1,140 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/ChunkStoreCommand.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/FileUtil.h"
+#include "Core/State.h"
+
+namespace DolphinTool
+{
+// Converts every state in the directory stored as from_type to to_type. from_type may be nullopt to
+// convert every state that isn't already stored as to_type.
+static bool ConvertStates(const std::string& directory,
+                          std::optional<State::CompressionType> from_type,
+                          State::CompressionType to_type)
+{
+  size_t converted = 0;
+  size_t failed = 0;
+
+  for (const File::FSTEntry& entry : File::ScanDirectoryTree(directory, false).children)
+  {
+    if (entry.isDirectory)
+      continue;
+
+    const std::optional<State::CompressionType> type =
+        State::GetCompressionTypeOfStateFile(entry.physicalName);
+    if (!type || *type == to_type || (from_type && *type != *from_type))
+      continue;
+
+    if (State::ConvertStateFile(entry.physicalName, entry.physicalName, to_type))
+    {
+      ++converted;
+    }
+    else
+    {
+      fmt::print(std::cerr, "Error: Failed to convert {}\n", entry.physicalName);
+      ++failed;
+    }
+  }
+
+  fmt::print(std::cout, "Converted {} states\n", converted);
+  return failed == 0;
+}
+
+int ChunkStoreCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: chunkstore [options]...");
+
+  parser.add_option("-d", "--directory")
+      .type("string")
+      .action("store")
+      .help("Path to a directory of savestates. Its chunk store is the ChunkStore subdirectory.")
+      .metavar("DIR");
+
+  parser.add_option("-m", "--migrate")
+      .action("store_true")
+      .help("Move the payload of every savestate in the directory into the chunk store.");
+
+  parser.add_option("-e", "--expand")
+      .action("store_true")
+      .help("Turn every chunk store savestate in the directory back into a self-contained, "
+            "LZ4 compressed savestate.");
+
+  parser.add_option("-g", "--gc")
+      .action("store_true")
+      .help("Remove chunks which aren't referenced by any savestate in the directory. Runs after "
+            "--migrate or --expand if combined with them.");
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  // Validate options
+  const std::string& directory = options["directory"];
+  if (directory.empty())
+  {
+    fmt::print(std::cerr, "Error: No directory set\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!File::IsDirectory(directory))
+  {
+    fmt::print(std::cerr, "Error: {} is not a directory\n", directory);
+    return EXIT_FAILURE;
+  }
+
+  const bool migrate = options.is_set_by_user("migrate");
+  const bool expand = options.is_set_by_user("expand");
+  const bool gc = options.is_set_by_user("gc");
+
+  if (migrate && expand)
+  {
+    fmt::print(std::cerr, "Error: --migrate and --expand are mutually exclusive\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!migrate && !expand && !gc)
+  {
+    fmt::print(std::cerr, "Error: No operation selected\n");
+    return EXIT_FAILURE;
+  }
+
+  bool success = true;
+
+  if (migrate)
+    success &= ConvertStates(directory, std::nullopt, State::CompressionType::ChunkManifest);
+
+  if (expand)
+  {
+    success &= ConvertStates(directory, State::CompressionType::ChunkManifest,
+                             State::CompressionType::LZ4);
+  }
+
+  if (gc)
+  {
+    u64 bytes_freed = 0;
+    if (State::CollectChunkStore(directory, &bytes_freed))
+    {
+      fmt::print(std::cout, "Freed {} bytes\n", bytes_freed);
+    }
+    else
+    {
+      fmt::print(std::cerr, "Error: Failed to collect the chunk store\n");
+      success = false;
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}  // namespace DolphinTool
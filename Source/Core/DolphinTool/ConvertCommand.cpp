@@ -8,6 +8,7 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <OptionParser.h>
@@ -17,6 +18,7 @@
 #include "Common/CommonTypes.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscUtils.h"
+#include "DiscIO/ParallelBlob.h"
 #include "DiscIO/ScrubbedBlob.h"
 #include "DiscIO/Volume.h"
 #include "DiscIO/VolumeDisc.h"
@@ -110,6 +112,19 @@ int ConvertCommand(const std::vector<std::string>& args)
       .help("Level of compression for the selected method. Ignored if 'none'. Suggested value for "
             "zstd: 5");
 
+  parser.add_option("--chunk_store")
+      .type("string")
+      .action("store")
+      .help("Store the data of an RVZ file in the chunk store FILE, which is created if it doesn't "
+            "exist. Data that is identical in several RVZ files using the same chunk store is "
+            "only stored once.")
+      .metavar("FILE");
+
+  parser.add_option("--zstd_dictionary")
+      .action("store_true")
+      .help("Train a Zstandard dictionary on the disc and store it in the RVZ file. Improves "
+            "compression for small block sizes. Only for RVZ with zstd, without a chunk store.");
+
   const optparse::Values& options = parser.parse_args(args);
 
   // Initialize the dolphin user directory, required for temporary processing files
@@ -186,6 +201,10 @@ int ConvertCommand(const std::vector<std::string>& args)
     }
   }
 
+  // Decode the input on all cores while the output is being compressed
+  blob_reader = DiscIO::ParallelBlobReader::Create(std::move(blob_reader),
+                                                   std::thread::hardware_concurrency());
+
   if (scrub && format == DiscIO::BlobType::RVZ)
   {
     fmt::print(std::cerr, "Warning: Scrubbing an RVZ container does not offer significant space "
@@ -296,6 +315,26 @@ int ConvertCommand(const std::vector<std::string>& args)
     }
   }
 
+  // --chunk_store
+  const std::string& chunk_store_path = options["chunk_store"];
+  if (!chunk_store_path.empty() && format != DiscIO::BlobType::RVZ)
+  {
+    fmt::print(std::cerr, "Error: Chunk stores are only supported for RVZ\n");
+    return EXIT_FAILURE;
+  }
+
+  // --zstd_dictionary
+  const bool zstd_dictionary = static_cast<bool>(options.get("zstd_dictionary"));
+  if (zstd_dictionary && (format != DiscIO::BlobType::RVZ ||
+                          compression_o != DiscIO::WIARVZCompressionType::Zstd ||
+                          !chunk_store_path.empty()))
+  {
+    fmt::print(std::cerr,
+               "Error: Zstandard dictionaries are only supported for RVZ with zstd compression "
+               "and without a chunk store\n");
+    return EXIT_FAILURE;
+  }
+
   // Perform the conversion
   const auto NOOP_STATUS_CALLBACK = [](const std::string& text, float percent) { return true; };
 
@@ -331,7 +370,7 @@ int ConvertCommand(const std::vector<std::string>& args)
     success = DiscIO::ConvertToWIAOrRVZ(blob_reader.get(), input_file_path, output_file_path,
                                         format == DiscIO::BlobType::RVZ, compression_o.value(),
                                         compression_level_o.value(), block_size_o.value(),
-                                        NOOP_STATUS_CALLBACK);
+                                        NOOP_STATUS_CALLBACK, chunk_store_path, zstd_dictionary);
     break;
   }
 
@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <future>
 #include <iostream>
+#include <thread>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -14,9 +15,11 @@
 
 #include "Common/FileUtil.h"
 
+#include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
 #include "DiscIO/DiscUtils.h"
 #include "DiscIO/Filesystem.h"
+#include "DiscIO/ParallelBlob.h"
 #include "DiscIO/Volume.h"
 
 namespace DolphinTool
@@ -279,7 +282,9 @@ int Extract(const std::vector<std::string>& args)
     return EXIT_FAILURE;
   }
 
-  const std::unique_ptr<DiscIO::Volume> disc_volume = DiscIO::CreateVolume(input_file_path);
+  const std::unique_ptr<DiscIO::Volume> disc_volume =
+      DiscIO::CreateVolume(DiscIO::ParallelBlobReader::Create(
+          DiscIO::CreateBlobReader(input_file_path), std::thread::hardware_concurrency()));
 
   if (!disc_volume)
   {
@@ -0,0 +1,393 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/StateCommand.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/StringUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/State.h"
+
+namespace DolphinTool
+{
+namespace
+{
+struct StateRequest
+{
+  bool registers = false;
+  std::string section;
+  u64 offset = 0;
+  std::optional<u64> length;
+  // Where to write the extracted section to. If empty, it is written to stdout.
+  std::string output_path;
+};
+
+struct StateResult
+{
+  bool success = true;
+  std::string text;
+  std::string errors;
+};
+}  // namespace
+
+static const char* GetCompressionName(u16 compression_type)
+{
+  switch (compression_type)
+  {
+  case State::CompressionType::Uncompressed:
+    return "None";
+  case State::CompressionType::LZ4:
+    return "LZ4";
+  case State::CompressionType::ChunkManifest:
+    return "Chunk store";
+  default:
+    return "Unknown";
+  }
+}
+
+static void PrintHeader(const State::StateHeader& header,
+                        const State::StateExtendedHeader& extended_header, std::string* text)
+{
+  const State::StateExtendedBaseHeader& base_header = extended_header.base_header;
+
+  const auto& game_id = header.legacy_header.game_id;
+  *text += fmt::format("Game ID: {}\n",
+                       std::string_view(game_id, strnlen(game_id, std::size(game_id))));
+  *text += fmt::format("Dolphin Version: {}\n", header.version_string);
+
+  const std::time_t seconds = static_cast<std::time_t>(State::GetUnixTime(header) / 1000);
+  if (const std::optional<std::tm> local_time = Common::Localtime(seconds))
+    *text += fmt::format("Created: {:%Y-%m-%d %H:%M:%S}\n", *local_time);
+
+  *text += fmt::format("Compression: {}\n", GetCompressionName(base_header.compression_type));
+  *text += fmt::format("Payload Size: {}\n", base_header.uncompressed_size);
+
+  if (extended_header.sections.empty())
+  {
+    *text += "Sections: None\n";
+    return;
+  }
+
+  *text += "Sections:\n";
+  for (const State::StateSectionIndexEntry& section : extended_header.sections)
+  {
+    const std::string_view name(section.name, strnlen(section.name, std::size(section.name)));
+    *text += fmt::format("  {:<20} Offset: 0x{:08x} Size: 0x{:08x}\n", name, section.offset,
+                         section.size);
+  }
+}
+
+static bool PrintRegisters(const std::string& path,
+                           const State::StateExtendedHeader& extended_header, std::string* text,
+                           std::string* errors)
+{
+  const State::StateSectionIndexEntry* section =
+      State::FindSection(extended_header, "PowerPCRegisters");
+  if (!section)
+  {
+    *errors += fmt::format("Error: {} has no PowerPCRegisters section\n", path);
+    return false;
+  }
+
+  std::vector<u8> data;
+  if (!State::ReadStatePayloadRange(path, section->offset, section->size, data))
+  {
+    *errors += fmt::format("Error: Unable to read the registers of {}\n", path);
+    return false;
+  }
+
+  // PowerPCState is too large to comfortably put on the stack.
+  auto ppc_state = std::make_unique<PowerPC::PowerPCState>();
+  u8* ptr = data.data();
+  PointerWrap p(&ptr, data.size(), PointerWrap::Mode::Read);
+  PowerPC::DoRegisterState(*ppc_state, p);
+  if (!p.IsReadMode())
+  {
+    *errors += fmt::format("Error: The registers of {} are corrupted\n", path);
+    return false;
+  }
+
+  *text += fmt::format("PC: {:08x} NPC: {:08x} MSR: {:08x} CR: {:08x}\n", ppc_state->pc,
+                       ppc_state->npc, ppc_state->msr.Hex, ppc_state->cr.Get());
+  *text += fmt::format("LR: {:08x} CTR: {:08x} XER: {:08x}\n", LR(*ppc_state),
+                       CTR(*ppc_state), ppc_state->GetXER().Hex);
+  for (size_t i = 0; i < std::size(ppc_state->gpr); i += 4)
+  {
+    *text += fmt::format("r{:<2}: {:08x} r{:<2}: {:08x} r{:<2}: {:08x} r{:<2}: {:08x}\n", i,
+                         ppc_state->gpr[i], i + 1, ppc_state->gpr[i + 1], i + 2,
+                         ppc_state->gpr[i + 2], i + 3, ppc_state->gpr[i + 3]);
+  }
+
+  return true;
+}
+
+static bool ExtractSection(const std::string& path,
+                           const State::StateExtendedHeader& extended_header,
+                           const StateRequest& request, std::string* errors)
+{
+  const State::StateSectionIndexEntry* section =
+      State::FindSection(extended_header, request.section);
+  if (!section)
+  {
+    *errors += fmt::format("Error: {} has no {} section\n", path, request.section);
+    return false;
+  }
+
+  if (request.offset > section->size)
+  {
+    *errors += fmt::format("Error: Offset is outside of the {} section of {}\n", request.section,
+                           path);
+    return false;
+  }
+  const u64 length =
+      std::min(request.length.value_or(section->size), section->size - request.offset);
+
+  std::vector<u8> data;
+  if (!State::ReadStatePayloadRange(path, section->offset + request.offset, length, data))
+  {
+    *errors += fmt::format("Error: Unable to read the {} section of {}\n", request.section, path);
+    return false;
+  }
+
+  if (request.output_path.empty())
+  {
+    if (std::fwrite(data.data(), 1, data.size(), stdout) != data.size())
+    {
+      *errors += "Error: Unable to write to stdout\n";
+      return false;
+    }
+    return true;
+  }
+
+  File::IOFile output(request.output_path, "wb");
+  if (!output.WriteBytes(data.data(), data.size()))
+  {
+    *errors += fmt::format("Error: Unable to write {}\n", request.output_path);
+    return false;
+  }
+
+  return true;
+}
+
+static StateResult ProcessState(const std::string& path, const StateRequest& request)
+{
+  StateResult result;
+
+  State::StateHeader header;
+  State::StateExtendedHeader extended_header;
+  if (!State::ReadStateFileHeaders(path, header, extended_header))
+  {
+    result.errors = fmt::format("Error: Unable to read the headers of {}\n", path);
+    result.success = false;
+    return result;
+  }
+
+  if (request.registers)
+    result.success &= PrintRegisters(path, extended_header, &result.text, &result.errors);
+
+  if (!request.section.empty())
+    result.success &= ExtractSection(path, extended_header, request, &result.errors);
+
+  if (!request.registers && request.section.empty())
+    PrintHeader(header, extended_header, &result.text);
+
+  return result;
+}
+
+// Runs ProcessState on every state in the directory, spread across thread_count threads. The
+// results are printed in directory order once everything is done, so the output is deterministic.
+static bool ProcessDirectory(const std::string& directory, const StateRequest& request,
+                             unsigned int thread_count)
+{
+  std::vector<File::FSTEntry> states;
+  for (File::FSTEntry& entry : File::ScanDirectoryTree(directory, false).children)
+  {
+    if (!entry.isDirectory && State::GetCompressionTypeOfStateFile(entry.physicalName))
+      states.push_back(std::move(entry));
+  }
+
+  std::vector<StateResult> results(states.size());
+  std::atomic<size_t> next_state = 0;
+
+  const auto worker = [&] {
+    for (size_t i = next_state++; i < states.size(); i = next_state++)
+    {
+      StateRequest state_request = request;
+      if (!request.section.empty())
+      {
+        state_request.output_path =
+            fmt::format("{}/{}.{}.bin", request.output_path, states[i].virtualName,
+                        request.section);
+      }
+      results[i] = ProcessState(states[i].physicalName, state_request);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  thread_count = std::min<unsigned int>(thread_count, static_cast<unsigned int>(states.size()));
+  for (unsigned int i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  bool success = true;
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    if (!results[i].text.empty())
+      fmt::print(std::cout, "File: {}\n{}\n", states[i].physicalName, results[i].text);
+    fmt::print(std::cerr, "{}", results[i].errors);
+    success &= results[i].success;
+  }
+
+  fmt::print(std::cerr, "Processed {} states\n", states.size());
+  return success;
+}
+
+int StateCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: state [options]...");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to a savestate FILE.")
+      .metavar("FILE");
+
+  parser.add_option("-d", "--directory")
+      .type("string")
+      .action("store")
+      .help("Process every savestate in DIR instead of a single one, in parallel.")
+      .metavar("DIR");
+
+  parser.add_option("-s", "--section")
+      .type("string")
+      .action("store")
+      .help("Optional. Extract the raw contents of the section NAME, e.g. MEM1, MEM2 or ARAM. "
+            "Prints the header and the list of sections if neither this nor --registers is set.")
+      .metavar("NAME");
+
+  parser.add_option("--offset")
+      .type("string")
+      .action("store")
+      .help("Optional. Offset within the section to start extracting at.")
+      .set_default("0");
+
+  parser.add_option("--length")
+      .type("string")
+      .action("store")
+      .help("Optional. Number of bytes to extract. Defaults to the rest of the section.");
+
+  parser.add_option("-r", "--registers")
+      .action("store_true")
+      .help("Optional. Print the PowerPC registers.");
+
+  parser.add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Optional. Path to write the extracted section to, or with --directory, the FOLDER to "
+            "write one file per savestate to. Writes to stdout if not set for a single savestate.")
+      .metavar("PATH");
+
+  parser.add_option("-t", "--threads")
+      .type("int")
+      .action("store")
+      .help("Optional. Number of threads to use with --directory. Defaults to one per core.")
+      .set_default(0);
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  // Validate options
+  const std::string& input_file_path = options["input"];
+  const std::string& directory = options["directory"];
+  if (input_file_path.empty() == directory.empty())
+  {
+    fmt::print(std::cerr, "Error: Exactly one of --input and --directory must be set\n");
+    return EXIT_FAILURE;
+  }
+
+  StateRequest request;
+  request.registers = options.is_set_by_user("registers");
+  request.section = options["section"];
+  request.output_path = options["output"];
+
+  if (!TryParse(options["offset"], &request.offset))
+  {
+    fmt::print(std::cerr, "Error: Invalid offset\n");
+    return EXIT_FAILURE;
+  }
+
+  if (options.is_set_by_user("length"))
+  {
+    u64 length;
+    if (!TryParse(options["length"], &length))
+    {
+      fmt::print(std::cerr, "Error: Invalid length\n");
+      return EXIT_FAILURE;
+    }
+    request.length = length;
+  }
+
+  if (!input_file_path.empty())
+  {
+    if (request.registers && !request.section.empty() && request.output_path.empty())
+    {
+      fmt::print(std::cerr, "Error: --registers and --section without --output would both be "
+                            "printed to stdout\n");
+      return EXIT_FAILURE;
+    }
+
+    const StateResult result = ProcessState(input_file_path, request);
+    fmt::print(std::cout, "{}", result.text);
+    fmt::print(std::cerr, "{}", result.errors);
+    return result.success ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if (!File::IsDirectory(directory))
+  {
+    fmt::print(std::cerr, "Error: {} is not a directory\n", directory);
+    return EXIT_FAILURE;
+  }
+
+  if (!request.section.empty())
+  {
+    if (request.output_path.empty())
+    {
+      fmt::print(std::cerr, "Error: --section with --directory requires an output folder\n");
+      return EXIT_FAILURE;
+    }
+    File::CreateDirs(request.output_path);
+  }
+
+  const int threads = static_cast<int>(options.get("threads"));
+  const unsigned int thread_count =
+      threads > 0 ? threads : std::max(1U, std::thread::hardware_concurrency());
+
+  return ProcessDirectory(directory, request, thread_count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}  // namespace DolphinTool
@@ -14,16 +14,19 @@
 #include "Common/StringUtil.h"
 #include "Core/Core.h"
 
+#include "DolphinTool/ChunkStoreCommand.h"
 #include "DolphinTool/ConvertCommand.h"
 #include "DolphinTool/ExtractCommand.h"
 #include "DolphinTool/HeaderCommand.h"
+#include "DolphinTool/StateCommand.h"
 #include "DolphinTool/VerifyCommand.h"
 
 static void PrintUsage()
 {
-  fmt::print(std::cerr, "usage: dolphin-tool COMMAND -h\n"
-                        "\n"
-                        "commands supported: [convert, verify, header, extract]\n");
+  fmt::print(std::cerr,
+             "usage: dolphin-tool COMMAND -h\n"
+             "\n"
+             "commands supported: [convert, verify, header, extract, chunkstore, state]\n");
 }
 
 #ifdef _WIN32
@@ -52,6 +55,10 @@ int main(int argc, char* argv[])
     return DolphinTool::HeaderCommand(args);
   else if (command_str == "extract")
     return DolphinTool::Extract(args);
+  else if (command_str == "chunkstore")
+    return DolphinTool::ChunkStoreCommand(args);
+  else if (command_str == "state")
+    return DolphinTool::StateCommand(args);
   PrintUsage();
   return EXIT_FAILURE;
 }
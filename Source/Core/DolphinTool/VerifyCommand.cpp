@@ -5,6 +5,7 @@
 
 #include <cstdlib>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <OptionParser.h>
@@ -13,6 +14,8 @@
 
 #include "Common/StringUtil.h"
 #include "Core/AchievementManager.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/ParallelBlob.h"
 #include "DiscIO/Volume.h"
 #include "DiscIO/VolumeVerifier.h"
 #include "UICommon/UICommon.h"
@@ -148,7 +151,9 @@ int VerifyCommand(const std::vector<std::string>& args)
   }
 
   // Open the volume
-  const std::unique_ptr<DiscIO::Volume> volume = DiscIO::CreateVolume(input_file_path);
+  const std::unique_ptr<DiscIO::Volume> volume =
+      DiscIO::CreateVolume(DiscIO::ParallelBlobReader::Create(
+          DiscIO::CreateBlobReader(input_file_path), std::thread::hardware_concurrency()));
   if (!volume)
   {
     fmt::print(std::cerr, "Error: Unable to open input file\n");
@@ -4,6 +4,9 @@
 
 #include "Scripting/Python/Modules/savestatemodule.h"
 
+#include <array>
+#include <cstring>
+
 #include "Common/Logging/Log.h"
 #include "Core/State.h"
 #include "Scripting/Python/Utils/module.h"
@@ -71,6 +74,33 @@ static PyObject* LoadFromFile(PyObject* self, PyObject* args)
   Py_RETURN_NONE;
 }
 
+static PyObject* PrefetchSlot(PyObject* self, PyObject* args)
+{
+  SavestateModuleState* state = Py::GetState<SavestateModuleState>(self);
+  auto slot_opt = Py::ParseTuple<u32>(args);
+  if (!slot_opt.has_value())
+    return nullptr;
+  u32 slot = std::get<0>(slot_opt.value());
+  if (slot > 99)
+  {
+    PyErr_SetString(PyExc_ValueError, "slot number must be between 0 and 99");
+    return nullptr;
+  }
+  State::PrefetchState(*state->system, slot);
+  Py_RETURN_NONE;
+}
+
+static PyObject* PrefetchFile(PyObject* self, PyObject* args)
+{
+  SavestateModuleState* state = Py::GetState<SavestateModuleState>(self);
+  auto filename_opt = Py::ParseTuple<const char*>(args);
+  if (!filename_opt.has_value())
+    return nullptr;
+  const char* filename = std::get<0>(filename_opt.value());
+  State::PrefetchState(*state->system, std::string(filename));
+  Py_RETURN_NONE;
+}
+
 static PyObject* SaveToBytes(PyObject* self, PyObject* args)
 {
   SavestateModuleState* state = Py::GetState<SavestateModuleState>(self);
@@ -106,6 +136,16 @@ static PyObject* LoadFromBytes(PyObject* self, PyObject* args)
   Py_RETURN_NONE;
 }
 
+static PyObject* ComputeHash(PyObject* self, PyObject* args)
+{
+  SavestateModuleState* state = Py::GetState<SavestateModuleState>(self);
+  const State::StateHash hash = State::GetStateHash(*state->system);
+  std::array<u8, 16> bytes;
+  std::memcpy(bytes.data(), &hash.low, sizeof(hash.low));
+  std::memcpy(bytes.data() + sizeof(hash.low), &hash.high, sizeof(hash.high));
+  return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
 static void SetupSavestateModule(PyObject* module, SavestateModuleState* state)
 {
   Core::System* system = PyScripting::PyScriptingBackend::GetCurrent()->GetSystem();
@@ -121,6 +161,9 @@ PyMODINIT_FUNC PyInit_savestate()
       {"load_from_slot", LoadFromSlot, METH_VARARGS, ""},
       {"load_from_file", LoadFromFile, METH_VARARGS, ""},
       {"load_from_bytes", LoadFromBytes, METH_VARARGS, ""},
+      {"prefetch_slot", PrefetchSlot, METH_VARARGS, ""},
+      {"prefetch_file", PrefetchFile, METH_VARARGS, ""},
+      {"compute_hash", ComputeHash, METH_NOARGS, ""},
 
       {nullptr, nullptr, 0, nullptr}  // Sentinel
   };
@@ -10,6 +10,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -104,6 +105,8 @@ GameFile::GameFile() = default;
 GameFile::GameFile(std::string path) : m_file_path(std::move(path))
 {
   m_file_name = PathToFileName(m_file_path);
+  m_file_size_on_disk = File::GetSize(m_file_path);
+  m_file_modification_time = File::GetModificationTime(m_file_path);
 
   {
     std::unique_ptr<DiscIO::Volume> volume(DiscIO::CreateVolume(m_file_path));
@@ -225,6 +228,12 @@ bool GameFile::CustomCoverChanged()
   return success;
 }
 
+bool GameFile::FileChangedOnDisk() const
+{
+  return File::GetSize(m_file_path) != m_file_size_on_disk ||
+         File::GetModificationTime(m_file_path) != m_file_modification_time;
+}
+
 void GameFile::DownloadDefaultCover()
 {
   if (!m_default_cover.buffer.empty() || !UseGameCovers() || m_gametdb_id.empty())
@@ -240,6 +249,11 @@ void GameFile::DownloadDefaultCover()
   const std::string region_code =
       SConfig::GetInstance().GetGameTDBImageRegionCode(DiscIO::IsWii(GetPlatform()), m_region);
 
+  // The game list updates its games in parallel, but the covers are downloaded one at a time so
+  // that a big library doesn't flood GameTDB with requests
+  static std::mutex download_mutex;
+  std::lock_guard lk(download_mutex);
+
   Common::HttpRequest request;
   static constexpr char cover_url[] = "https://art.gametdb.com/wii/cover/{}/{}.png";
   const auto response = request.Get(fmt::format(cover_url, region_code, m_gametdb_id));
@@ -298,6 +312,8 @@ void GameFile::DoState(PointerWrap& p)
   p.Do(m_file_name);
 
   p.Do(m_file_size);
+  p.Do(m_file_size_on_disk);
+  p.Do(m_file_modification_time);
   p.Do(m_volume_size);
   p.Do(m_volume_size_type);
   p.Do(m_is_datel_disc);
@@ -104,6 +104,8 @@ public:
   bool ShouldAllowConversion() const;
   const std::string& GetApploaderDate() const { return m_apploader_date; }
   u64 GetFileSize() const { return m_file_size; }
+  // Returns true if the file was modified or replaced since this GameFile was created.
+  bool FileChangedOnDisk() const;
   u64 GetVolumeSize() const { return m_volume_size; }
   DiscIO::DataSizeType GetVolumeSizeType() const { return m_volume_size_type; }
   bool IsDatelDisc() const { return m_is_datel_disc; }
@@ -146,6 +148,9 @@ private:
   std::string m_file_name;
 
   u64 m_file_size{};
+  // As reported by the file system, used for noticing changes to the file
+  u64 m_file_size_on_disk{};
+  u64 m_file_modification_time{};
   u64 m_volume_size{};
   DiscIO::DataSizeType m_volume_size_type{};
   bool m_is_datel_disc{};
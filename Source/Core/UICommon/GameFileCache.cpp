@@ -4,12 +4,15 @@
 #include "UICommon/GameFileCache.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -19,6 +22,7 @@
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/Thread.h"
 
 #include "DiscIO/DirectoryBlob.h"
 
@@ -26,7 +30,75 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 25;  // Last changed in PR 12702
+static constexpr u32 CACHE_REVISION = 26;  // Last changed when adding file modification times
+
+// Scanning is mostly waiting on storage, so more threads than cores can be worthwhile.
+static constexpr unsigned int MIN_SCAN_THREADS = 4;
+static constexpr unsigned int MAX_SCAN_THREADS = 16;
+
+// Calls produce(i) for every i below count using a number of threads, and calls consume(i) on the
+// calling thread as soon as produce(i) has returned, so that results can be used right away.
+// Stops starting new work once processing_halted is set.
+static void ProcessInParallel(size_t count, const std::atomic_bool& processing_halted,
+                              const std::function<void(size_t)>& produce,
+                              const std::function<void(size_t)>& consume)
+{
+  if (count == 0)
+    return;
+
+  const size_t thread_count = std::min<size_t>(
+      count, std::clamp(std::thread::hardware_concurrency(), MIN_SCAN_THREADS, MAX_SCAN_THREADS));
+
+  std::atomic<size_t> next_index = 0;
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  std::vector<size_t> done;
+  size_t threads_running = thread_count;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i)
+  {
+    threads.emplace_back([&] {
+      Common::SetCurrentThreadName("Game list scan");
+
+      while (!processing_halted)
+      {
+        const size_t index = next_index++;
+        if (index >= count)
+          break;
+
+        produce(index);
+
+        std::lock_guard lk(mutex);
+        done.push_back(index);
+        done_cv.notify_one();
+      }
+
+      std::lock_guard lk(mutex);
+      --threads_running;
+      done_cv.notify_one();
+    });
+  }
+
+  std::vector<size_t> to_consume;
+  while (true)
+  {
+    {
+      std::unique_lock lk(mutex);
+      done_cv.wait(lk, [&] { return !done.empty() || threads_running == 0; });
+      if (done.empty())
+        break;
+      std::swap(done, to_consume);
+    }
+
+    for (size_t index : to_consume)
+      consume(index);
+    to_consume.clear();
+  }
+
+  for (std::thread& thread : threads)
+    thread.join();
+}
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
@@ -129,24 +201,51 @@ bool GameFileCache::Update(std::span<const std::string> all_game_paths,
     m_cached_files.erase(it, m_cached_files.end());
   }
 
-  // Now that the previous loop has run, game_paths only contains paths that
-  // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
+  // Files that have been modified since they were cached get scanned again like new files.
+  std::vector<std::string> paths_to_scan(game_paths.begin(), game_paths.end());
   {
-    if (processing_halted)
-      break;
+    std::vector<char> changed(m_cached_files.size());
+    ProcessInParallel(
+        m_cached_files.size(), processing_halted,
+        [&](size_t i) { changed[i] = m_cached_files[i]->FileChangedOnDisk(); }, [](size_t) {});
 
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
+    size_t kept = 0;
+    for (size_t i = 0; i < m_cached_files.size(); ++i)
     {
-      if (game_added_to_cache)
-        game_added_to_cache(file);
+      if (changed[i])
+      {
+        if (game_removed_from_cache)
+          game_removed_from_cache(m_cached_files[i]->GetFilePath());
 
-      cache_changed = true;
-      m_cached_files.push_back(std::move(file));
+        cache_changed = true;
+        paths_to_scan.push_back(m_cached_files[i]->GetFilePath());
+      }
+      else
+      {
+        m_cached_files[kept++] = std::move(m_cached_files[i]);
+      }
     }
+    m_cached_files.resize(kept);
   }
 
+  // Now that the previous loops have run, paths_to_scan only contains paths that
+  // aren't in m_cached_files, so we simply add all of them to m_cached_files.
+  // Opening the files is what takes time, so it's done in parallel.
+  std::vector<std::shared_ptr<GameFile>> new_files(paths_to_scan.size());
+  ProcessInParallel(
+      paths_to_scan.size(), processing_halted,
+      [&](size_t i) { new_files[i] = std::make_shared<GameFile>(paths_to_scan[i]); },
+      [&](size_t i) {
+        if (!new_files[i]->IsValid())
+          return;
+
+        if (game_added_to_cache)
+          game_added_to_cache(new_files[i]);
+
+        cache_changed = true;
+        m_cached_files.push_back(std::move(new_files[i]));
+      });
+
   return cache_changed;
 }
 
@@ -155,16 +254,20 @@ bool GameFileCache::UpdateAdditionalMetadata(const GameUpdatedFn& game_updated,
 {
   bool cache_changed = false;
 
-  for (std::shared_ptr<GameFile>& file : m_cached_files)
-  {
-    if (processing_halted)
-      break;
+  // Each thread only replaces its own elements of m_cached_files, so the vector itself is safe
+  // to share
+  std::vector<char> updated(m_cached_files.size());
+  ProcessInParallel(
+      m_cached_files.size(), processing_halted,
+      [&](size_t i) { updated[i] = UpdateAdditionalMetadata(&m_cached_files[i]); },
+      [&](size_t i) {
+        if (!updated[i])
+          return;
 
-    const bool updated = UpdateAdditionalMetadata(&file);
-    cache_changed |= updated;
-    if (game_updated && updated)
-      game_updated(file);
-  }
+        cache_changed = true;
+        if (game_updated)
+          game_updated(m_cached_files[i]);
+      });
 
   return cache_changed;
 }
@@ -6,6 +6,11 @@
 // This backend tries not to do anything in the backend,
 // but everything in VideoCommon.
 
+// With GFX.Settings.NullNoRender, VideoCommon skips most of its work too: the GX commands are only
+// parsed to keep the state and interrupts right, vertices are never loaded, textures and the XFB
+// are never decoded, and EFB copies only fill the memory they cover with a placeholder, the same
+// one used when copies to RAM are disabled (fuchsia for XFB copies).
+
 #include "VideoBackends/Null/VideoBackend.h"
 
 #include "Common/Common.h"
@@ -63,6 +68,7 @@ void VideoBackend::InitBackendInfo(const WindowSystemInfo& wsi)
   g_Config.backend_info.bSupportsSettingObjectNames = false;
   g_Config.backend_info.bSupportsPartialMultisampleResolve = true;
   g_Config.backend_info.bSupportsDynamicVertexLoader = false;
+  g_Config.backend_info.bSupportsNoRender = true;
 
   // aamodes: We only support 1 sample, so no MSAA
   g_Config.backend_info.Adapters.clear();
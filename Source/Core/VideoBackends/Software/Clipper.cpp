@@ -36,6 +36,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "VideoBackends/Software/Clipper.h"
 
+#include <array>
+
 #include "Common/Assert.h"
 
 #include "VideoBackends/Software/NativeVertexFormat.h"
@@ -53,14 +55,14 @@ enum
   NUM_INDICES = NUM_CLIPPED_VERTICES + 3
 };
 
-static OutputVertexData ClippedVertices[NUM_CLIPPED_VERTICES];
-static OutputVertexData* Vertices[NUM_INDICES];
-
-void Init()
-{
+// Primitives are clipped on several threads, so each of them has its own vertices to work with
+static thread_local OutputVertexData ClippedVertices[NUM_CLIPPED_VERTICES];
+static thread_local std::array<OutputVertexData*, NUM_INDICES> Vertices = [] {
+  std::array<OutputVertexData*, NUM_INDICES> vertices{};
   for (int i = 0; i < NUM_CLIPPED_VERTICES; ++i)
-    Vertices[i + 3] = &ClippedVertices[i];
-}
+    vertices[i + 3] = &ClippedVertices[i];
+  return vertices;
+}();
 
 enum
 {
@@ -220,7 +222,7 @@ static void ClipTriangle(int* indices, int* numIndices)
       POLY_CLIP(CLIP_POS_Z_BIT, 0, 0, 0, 1);
       POLY_CLIP(CLIP_NEG_Z_BIT, 0, 0, 1, 1);
 
-      INCSTAT(g_stats.this_frame.num_triangles_clipped);
+      INCSTAT(Rasterizer::GetSetupStatistics().num_triangles_clipped);
 
       // transform the poly in inlist into triangles
       indices[0] = inlist[0];
@@ -287,11 +289,11 @@ static void ClipLine(int* indices)
 
 void ProcessTriangle(OutputVertexData* v0, OutputVertexData* v1, OutputVertexData* v2)
 {
-  INCSTAT(g_stats.this_frame.num_triangles_in);
+  INCSTAT(Rasterizer::GetSetupStatistics().num_triangles_in);
 
   if (IsTriviallyRejected(v0, v1, v2))
   {
-    INCSTAT(g_stats.this_frame.num_triangles_rejected);
+    INCSTAT(Rasterizer::GetSetupStatistics().num_triangles_rejected);
     // NOTE: The slope used by zfreeze shouldn't be updated if the triangle is
     // trivially rejected during clipping
     return;
@@ -308,7 +310,7 @@ void ProcessTriangle(OutputVertexData* v0, OutputVertexData* v1, OutputVertexDat
       PerspectiveDivide(v1);
       PerspectiveDivide(v2);
       Rasterizer::UpdateZSlope(v0, v1, v2, bpmem.scissorOffset.x * 2, bpmem.scissorOffset.y * 2);
-      INCSTAT(g_stats.this_frame.num_triangles_culled);
+      INCSTAT(Rasterizer::GetSetupStatistics().num_triangles_culled);
       return;
     }
   }
@@ -321,7 +323,7 @@ void ProcessTriangle(OutputVertexData* v0, OutputVertexData* v1, OutputVertexDat
       PerspectiveDivide(v2);
       PerspectiveDivide(v1);
       Rasterizer::UpdateZSlope(v0, v2, v1, bpmem.scissorOffset.x * 2, bpmem.scissorOffset.y * 2);
-      INCSTAT(g_stats.this_frame.num_triangles_culled);
+      INCSTAT(Rasterizer::GetSetupStatistics().num_triangles_culled);
       return;
     }
   }
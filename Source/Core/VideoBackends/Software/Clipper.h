@@ -7,8 +7,6 @@ struct OutputVertexData;
 
 namespace Clipper
 {
-void Init();
-
 void ProcessTriangle(OutputVertexData* v0, OutputVertexData* v1, OutputVertexData* v2);
 
 void ProcessLine(OutputVertexData* v0, OutputVertexData* v1);
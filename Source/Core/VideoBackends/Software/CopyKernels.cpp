@@ -0,0 +1,525 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoBackends/Software/CopyKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/LookUpTables.h"
+
+namespace CopyKernels
+{
+using EfbInterface::yuv444;
+
+// Like the rest of the EFB code, this reads 4 bytes and ignores the last one
+static u32 ReadPixel(const u8* src)
+{
+  u32 value;
+  std::memcpy(&value, src, sizeof(value));
+  return value & 0xffffff;
+}
+
+static u8 RGB8ToI(u8 r, u8 g, u8 b)
+{
+  // values multiplied by 256 to keep math integer
+  const u16 val = 4096 + 66 * r + 129 * g + 25 * b;
+  return val >> 8;
+}
+
+void EncodeRGBA8RowScalar(const u8* src, u8* dst, bool rgba6)
+{
+  for (int i = 0; i < 4; ++i, src += 3, dst += 2)
+  {
+    if (rgba6)
+    {
+      const u32 color = ReadPixel(src);
+      dst[0] = Convert6To8(color & 0x3f);
+      dst[1] = Convert6To8((color >> 18) & 0x3f);
+      dst[32] = Convert6To8((color >> 12) & 0x3f);
+      dst[33] = Convert6To8((color >> 6) & 0x3f);
+    }
+    else
+    {
+      dst[0] = 0xff;
+      dst[1] = src[2];
+      dst[32] = src[1];
+      dst[33] = src[0];
+    }
+  }
+}
+
+void EncodeRGB565RowScalar(const u8* src, u8* dst, bool rgba6)
+{
+  for (int i = 0; i < 4; ++i, src += 3, dst += 2)
+  {
+    u16 val;
+    if (rgba6)
+    {
+      const u32 color = ReadPixel(src);
+      val = ((color >> 8) & 0xf800) | ((color >> 7) & 0x07e0) | ((color >> 7) & 0x001f);
+    }
+    else
+    {
+      val = ((src[2] << 8) & 0xf800) | ((src[1] << 3) & 0x07e0) | ((src[0] >> 3) & 0x001f);
+    }
+
+    dst[0] = static_cast<u8>(val >> 8);
+    dst[1] = static_cast<u8>(val);
+  }
+}
+
+void EncodeI8RowScalar(const u8* src, u8* dst, bool rgba6)
+{
+  for (int i = 0; i < 8; ++i, src += 3)
+  {
+    if (rgba6)
+    {
+      const u32 color = ReadPixel(src);
+      dst[i] = RGB8ToI(Convert6To8((color >> 18) & 0x3f), Convert6To8((color >> 12) & 0x3f),
+                       Convert6To8((color >> 6) & 0x3f));
+    }
+    else
+    {
+      dst[i] = RGB8ToI(src[2], src[1], src[0]);
+    }
+  }
+}
+
+void FilterRowToYUVScalar(const u32* above, const u32* row, const u32* below, u32 count,
+                          const std::array<u8, 7>& coefficients,
+                          const std::array<u8, 256>* gamma_lut, yuv444* dst)
+{
+  // All Coefficients should sum to 64, otherwise the total brightness will change, which many games
+  // do on purpose to implement a brightness filter across the whole copy.
+  // TODO: implement support for multisampling.
+  // In non-multisampling mode:
+  //   * Coefficients 2, 3 and 4 sample from the current pixel.
+  //   * Coefficients 0 and 1 sample from the pixel above this one
+  //   * Coefficients 5 and 6 sample from the pixel below this one
+  const int weight_above = coefficients[0] + coefficients[1];
+  const int weight_row = coefficients[2] + coefficients[3] + coefficients[4];
+  const int weight_below = coefficients[5] + coefficients[6];
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    u8 rgb[3];
+    for (int channel = 0; channel < 3; ++channel)
+    {
+      // Red, green and blue are in the upper three bytes
+      const int shift = 24 - channel * 8;
+      const int sum = ((above[i] >> shift) & 0xff) * weight_above +
+                      ((row[i] >> shift) & 0xff) * weight_row +
+                      ((below[i] >> shift) & 0xff) * weight_below;
+
+      // TODO: this clamping behavior appears to be correct, but isn't confirmed on hardware.
+      rgb[channel] = static_cast<u8>(std::min(255, sum >> 6));
+      if (gamma_lut)
+        rgb[channel] = (*gamma_lut)[rgb[channel]];
+    }
+
+    // GameCube/Wii uses the BT.601 standard algorithm for converting to YCbCr; see
+    // http://www.equasys.de/colorconversion.html#YCbCr-RGBColorFormatConversion
+    // These numbers were determined by hardware testing
+    const u16 y = +66 * rgb[0] + 129 * rgb[1] + +25 * rgb[2];
+    const s16 u = -38 * rgb[0] + -74 * rgb[1] + 112 * rgb[2];
+    const s16 v = 112 * rgb[0] + -94 * rgb[1] + -18 * rgb[2];
+    dst[i].Y = static_cast<u8>((y >> 8) + ((y >> 7) & 1));
+    dst[i].U = static_cast<s8>((u >> 8) + ((u >> 7) & 1));
+    dst[i].V = static_cast<s8>((v >> 8) + ((v >> 7) & 1));
+  }
+}
+
+#if defined(_M_X86) || defined(_M_X86_64) || defined(_M_ARM_64)
+// The texture kernels work on four pixels at a time, with one 32-bit lane per pixel
+#if defined(_M_X86) || defined(_M_X86_64)
+using Vector = __m128i;
+
+static Vector Splat(u32 value)
+{
+  return _mm_set1_epi32(value);
+}
+
+static Vector And(Vector a, u32 mask)
+{
+  return _mm_and_si128(a, _mm_set1_epi32(mask));
+}
+
+static Vector Or(Vector a, Vector b)
+{
+  return _mm_or_si128(a, b);
+}
+
+static Vector Add(Vector a, Vector b)
+{
+  return _mm_add_epi32(a, b);
+}
+
+template <int shift>
+static Vector ShiftLeft(Vector a)
+{
+  return _mm_slli_epi32(a, shift);
+}
+
+template <int shift>
+static Vector ShiftRight(Vector a)
+{
+  return _mm_srli_epi32(a, shift);
+}
+
+// The lanes and products must fit in 16 bits
+static Vector MultiplySmall(Vector a, u16 factor)
+{
+  return _mm_mullo_epi16(a, _mm_set1_epi32(factor));
+}
+
+// Stores the lanes of a and then b as bytes. The lanes must fit in 8 bits.
+static void StoreU8(u8* dst, Vector a, Vector b)
+{
+  const __m128i packed = _mm_packs_epi32(a, b);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(packed, packed));
+}
+
+// Stores the lanes of a as 16-bit values. The lanes must fit in 16 bits.
+static void StoreU16(u8* dst, Vector a)
+{
+  // Sign extended so that the signed saturation keeps the lower bits
+  const __m128i sign_extended = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+  const __m128i packed = _mm_packs_epi32(sign_extended, sign_extended);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), packed);
+}
+
+static Vector LoadPixels(const u8* src)
+{
+  // Like ReadPixel, this doesn't read further than the byte after the last pixel
+  const __m128i low = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+  const __m128i high = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 5));
+  const __m128i first = _mm_unpacklo_epi32(low, _mm_srli_si128(low, 3));
+  const __m128i second = _mm_unpacklo_epi32(_mm_srli_si128(high, 1), _mm_srli_si128(high, 4));
+  return And(_mm_unpacklo_epi64(first, second), 0xffffff);
+}
+#else
+using Vector = uint32x4_t;
+
+static Vector Splat(u32 value)
+{
+  return vdupq_n_u32(value);
+}
+
+static Vector And(Vector a, u32 mask)
+{
+  return vandq_u32(a, vdupq_n_u32(mask));
+}
+
+static Vector Or(Vector a, Vector b)
+{
+  return vorrq_u32(a, b);
+}
+
+static Vector Add(Vector a, Vector b)
+{
+  return vaddq_u32(a, b);
+}
+
+template <int shift>
+static Vector ShiftLeft(Vector a)
+{
+  return vshlq_n_u32(a, shift);
+}
+
+template <int shift>
+static Vector ShiftRight(Vector a)
+{
+  return vshrq_n_u32(a, shift);
+}
+
+static Vector MultiplySmall(Vector a, u16 factor)
+{
+  return vmulq_n_u32(a, factor);
+}
+
+static void StoreU8(u8* dst, Vector a, Vector b)
+{
+  vst1_u8(dst, vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))));
+}
+
+static void StoreU16(u8* dst, Vector a)
+{
+  vst1_u8(dst, vreinterpret_u8_u16(vmovn_u32(a)));
+}
+
+static Vector LoadPixels(const u8* src)
+{
+  const u32 pixels[4] = {ReadPixel(src), ReadPixel(src + 3), ReadPixel(src + 6),
+                         ReadPixel(src + 9)};
+  return vld1q_u32(pixels);
+}
+#endif
+
+static Vector Convert6To8(Vector a)
+{
+  return Or(ShiftLeft<2>(a), ShiftRight<4>(a));
+}
+
+// Splits pixels read from the EFB into 8-bit channels
+static void UnpackPixels(Vector pixels, bool rgba6, Vector* r, Vector* g, Vector* b, Vector* a)
+{
+  if (rgba6)
+  {
+    *r = Convert6To8(And(ShiftRight<18>(pixels), 0x3f));
+    *g = Convert6To8(And(ShiftRight<12>(pixels), 0x3f));
+    *b = Convert6To8(And(ShiftRight<6>(pixels), 0x3f));
+    *a = Convert6To8(And(pixels, 0x3f));
+  }
+  else
+  {
+    *r = ShiftRight<16>(pixels);
+    *g = And(ShiftRight<8>(pixels), 0xff);
+    *b = And(pixels, 0xff);
+    *a = Splat(0xff);
+  }
+}
+
+void EncodeRGBA8Row(const u8* src, u8* dst, bool rgba6)
+{
+  Vector r, g, b, a;
+  UnpackPixels(LoadPixels(src), rgba6, &r, &g, &b, &a);
+
+  StoreU16(dst, Or(a, ShiftLeft<8>(r)));
+  StoreU16(dst + 32, Or(g, ShiftLeft<8>(b)));
+}
+
+void EncodeRGB565Row(const u8* src, u8* dst, bool rgba6)
+{
+  const Vector pixels = LoadPixels(src);
+
+  Vector val;
+  if (rgba6)
+  {
+    val = Or(And(ShiftRight<8>(pixels), 0xf800), And(ShiftRight<7>(pixels), 0x07ff));
+  }
+  else
+  {
+    val = Or(Or(And(ShiftRight<8>(pixels), 0xf800), And(ShiftRight<5>(pixels), 0x07e0)),
+             And(ShiftRight<3>(pixels), 0x001f));
+  }
+
+  // Big endian
+  StoreU16(dst, Or(ShiftRight<8>(val), And(ShiftLeft<8>(val), 0xff00)));
+}
+
+static Vector PixelsToI(const u8* src, bool rgba6)
+{
+  Vector r, g, b, a;
+  UnpackPixels(LoadPixels(src), rgba6, &r, &g, &b, &a);
+
+  Vector val = Add(Splat(4096), MultiplySmall(r, 66));
+  val = Add(val, MultiplySmall(g, 129));
+  val = Add(val, MultiplySmall(b, 25));
+  return ShiftRight<8>(val);
+}
+
+void EncodeI8Row(const u8* src, u8* dst, bool rgba6)
+{
+  StoreU8(dst, PixelsToI(src, rgba6), PixelsToI(src + 12, rgba6));
+}
+
+// The XFB kernel works on eight pixels at a time, with one 16-bit lane per channel. The products
+// of the vertical filter fit in 16 bits, and since every sum from 255 << 6 up is clamped to 255,
+// the sums can saturate. The YUV values fit in 16 bits, so those can wrap around.
+#if defined(_M_X86) || defined(_M_X86_64)
+static __m128i FilterChannels(__m128i above, __m128i row, __m128i below, __m128i weight_above,
+                              __m128i weight_row, __m128i weight_below)
+{
+  __m128i sum =
+      _mm_adds_epu16(_mm_mullo_epi16(above, weight_above), _mm_mullo_epi16(row, weight_row));
+  sum = _mm_adds_epu16(sum, _mm_mullo_epi16(below, weight_below));
+  return _mm_min_epi16(_mm_srli_epi16(sum, 6), _mm_set1_epi16(255));
+}
+
+// Moves the Y, U and V of each 32-bit lane next to each other in the first 12 bytes
+static __m128i PackYUV(__m128i pixels)
+{
+  const __m128i first = _mm_and_si128(pixels, _mm_setr_epi32(-1, 0, 0, 0));
+  const __m128i second = _mm_and_si128(pixels, _mm_setr_epi32(0, -1, 0, 0));
+  const __m128i third = _mm_and_si128(pixels, _mm_setr_epi32(0, 0, -1, 0));
+  const __m128i fourth = _mm_and_si128(pixels, _mm_setr_epi32(0, 0, 0, -1));
+  return _mm_or_si128(_mm_or_si128(first, _mm_srli_si128(second, 1)),
+                      _mm_or_si128(_mm_srli_si128(third, 2), _mm_srli_si128(fourth, 3)));
+}
+
+void FilterRowToYUV(const u32* above, const u32* row, const u32* below, u32 count,
+                    const std::array<u8, 7>& coefficients, const std::array<u8, 256>* gamma_lut,
+                    yuv444* dst)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i weight_above = _mm_set1_epi16(coefficients[0] + coefficients[1]);
+  const __m128i weight_row = _mm_set1_epi16(coefficients[2] + coefficients[3] + coefficients[4]);
+  const __m128i weight_below = _mm_set1_epi16(coefficients[5] + coefficients[6]);
+
+  // Filters four pixels, which are returned in the same layout as the colors
+  const auto filter = [&](u32 offset) {
+    const auto load = [offset](const u32* colors) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + offset));
+    };
+    const __m128i above_colors = load(above);
+    const __m128i row_colors = load(row);
+    const __m128i below_colors = load(below);
+
+    const __m128i low = FilterChannels(
+        _mm_unpacklo_epi8(above_colors, zero), _mm_unpacklo_epi8(row_colors, zero),
+        _mm_unpacklo_epi8(below_colors, zero), weight_above, weight_row, weight_below);
+    const __m128i high = FilterChannels(
+        _mm_unpackhi_epi8(above_colors, zero), _mm_unpackhi_epi8(row_colors, zero),
+        _mm_unpackhi_epi8(below_colors, zero), weight_above, weight_row, weight_below);
+    return _mm_packus_epi16(low, high);
+  };
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i colors[2] = {filter(i), filter(i + 4)};
+    if (gamma_lut)
+    {
+      alignas(16) u8 bytes[32];
+      _mm_store_si128(reinterpret_cast<__m128i*>(bytes), colors[0]);
+      _mm_store_si128(reinterpret_cast<__m128i*>(bytes + 16), colors[1]);
+      for (u8& byte : bytes)
+        byte = (*gamma_lut)[byte];
+      colors[0] = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+      colors[1] = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes + 16));
+    }
+
+    const __m128i red =
+        _mm_packs_epi32(_mm_srli_epi32(colors[0], 24), _mm_srli_epi32(colors[1], 24));
+    const __m128i green = _mm_packs_epi32(_mm_srli_epi32(_mm_slli_epi32(colors[0], 8), 24),
+                                          _mm_srli_epi32(_mm_slli_epi32(colors[1], 8), 24));
+    const __m128i blue = _mm_packs_epi32(_mm_srli_epi32(_mm_slli_epi32(colors[0], 16), 24),
+                                         _mm_srli_epi32(_mm_slli_epi32(colors[1], 16), 24));
+
+    const auto convert = [&](s16 r_factor, s16 g_factor, s16 b_factor) {
+      const __m128i sum = _mm_add_epi16(_mm_mullo_epi16(red, _mm_set1_epi16(r_factor)),
+                                        _mm_mullo_epi16(green, _mm_set1_epi16(g_factor)));
+      return _mm_add_epi16(sum, _mm_mullo_epi16(blue, _mm_set1_epi16(b_factor)));
+    };
+    const __m128i y = convert(66, 129, 25);
+    const __m128i u = convert(-38, -74, 112);
+    const __m128i v = convert(112, -94, -18);
+
+    const __m128i y_round =
+        _mm_add_epi16(_mm_srli_epi16(y, 8), _mm_and_si128(_mm_srli_epi16(y, 7), one));
+    const __m128i u_round =
+        _mm_add_epi16(_mm_srai_epi16(u, 8), _mm_and_si128(_mm_srai_epi16(u, 7), one));
+    const __m128i v_round =
+        _mm_add_epi16(_mm_srai_epi16(v, 8), _mm_and_si128(_mm_srai_epi16(v, 7), one));
+
+    const __m128i yu = _mm_unpacklo_epi8(_mm_packus_epi16(y_round, y_round),
+                                         _mm_packs_epi16(u_round, u_round));
+    const __m128i v_zero = _mm_unpacklo_epi8(_mm_packs_epi16(v_round, v_round), zero);
+    const __m128i first = PackYUV(_mm_unpacklo_epi16(yu, v_zero));
+    const __m128i second = PackYUV(_mm_unpackhi_epi16(yu, v_zero));
+
+    u8* out = reinterpret_cast<u8*>(dst + i);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), first);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8),
+                     _mm_or_si128(_mm_srli_si128(first, 8), _mm_slli_si128(second, 4)));
+  }
+
+  FilterRowToYUVScalar(above + i, row + i, below + i, count - i, coefficients, gamma_lut, dst + i);
+}
+#else
+void FilterRowToYUV(const u32* above, const u32* row, const u32* below, u32 count,
+                    const std::array<u8, 7>& coefficients, const std::array<u8, 256>* gamma_lut,
+                    yuv444* dst)
+{
+  const uint8x8_t weight_above = vdup_n_u8(coefficients[0] + coefficients[1]);
+  const uint8x8_t weight_row = vdup_n_u8(coefficients[2] + coefficients[3] + coefficients[4]);
+  const uint8x8_t weight_below = vdup_n_u8(coefficients[5] + coefficients[6]);
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // The channels are alpha, blue, green and red
+    const uint8x8x4_t above_colors = vld4_u8(reinterpret_cast<const u8*>(above + i));
+    const uint8x8x4_t row_colors = vld4_u8(reinterpret_cast<const u8*>(row + i));
+    const uint8x8x4_t below_colors = vld4_u8(reinterpret_cast<const u8*>(below + i));
+
+    // Red, green and blue
+    uint8x8_t rgb[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      uint16x8_t sum = vqaddq_u16(vmull_u8(above_colors.val[3 - c], weight_above),
+                                  vmull_u8(row_colors.val[3 - c], weight_row));
+      sum = vqaddq_u16(sum, vmull_u8(below_colors.val[3 - c], weight_below));
+      rgb[c] = vqmovn_u16(vshrq_n_u16(sum, 6));
+    }
+
+    if (gamma_lut)
+    {
+      for (uint8x8_t& channel : rgb)
+      {
+        u8 bytes[8];
+        vst1_u8(bytes, channel);
+        for (u8& byte : bytes)
+          byte = (*gamma_lut)[byte];
+        channel = vld1_u8(bytes);
+      }
+    }
+
+    const int16x8_t red = vreinterpretq_s16_u16(vmovl_u8(rgb[0]));
+    const int16x8_t green = vreinterpretq_s16_u16(vmovl_u8(rgb[1]));
+    const int16x8_t blue = vreinterpretq_s16_u16(vmovl_u8(rgb[2]));
+    const auto convert = [&](s16 r_factor, s16 g_factor, s16 b_factor) {
+      return vmlaq_n_s16(vmlaq_n_s16(vmulq_n_s16(red, r_factor), green, g_factor), blue,
+                         b_factor);
+    };
+    const uint16x8_t y = vreinterpretq_u16_s16(convert(66, 129, 25));
+    const int16x8_t u = convert(-38, -74, 112);
+    const int16x8_t v = convert(112, -94, -18);
+
+    uint8x8x3_t yuv;
+    yuv.val[0] =
+        vmovn_u16(vaddq_u16(vshrq_n_u16(y, 8), vandq_u16(vshrq_n_u16(y, 7), vdupq_n_u16(1))));
+    yuv.val[1] = vreinterpret_u8_s8(
+        vmovn_s16(vaddq_s16(vshrq_n_s16(u, 8), vandq_s16(vshrq_n_s16(u, 7), vdupq_n_s16(1)))));
+    yuv.val[2] = vreinterpret_u8_s8(
+        vmovn_s16(vaddq_s16(vshrq_n_s16(v, 8), vandq_s16(vshrq_n_s16(v, 7), vdupq_n_s16(1)))));
+    vst3_u8(reinterpret_cast<u8*>(dst + i), yuv);
+  }
+
+  FilterRowToYUVScalar(above + i, row + i, below + i, count - i, coefficients, gamma_lut, dst + i);
+}
+#endif
+#else
+void EncodeRGBA8Row(const u8* src, u8* dst, bool rgba6)
+{
+  EncodeRGBA8RowScalar(src, dst, rgba6);
+}
+
+void EncodeRGB565Row(const u8* src, u8* dst, bool rgba6)
+{
+  EncodeRGB565RowScalar(src, dst, rgba6);
+}
+
+void EncodeI8Row(const u8* src, u8* dst, bool rgba6)
+{
+  EncodeI8RowScalar(src, dst, rgba6);
+}
+
+void FilterRowToYUV(const u32* above, const u32* row, const u32* below, u32 count,
+                    const std::array<u8, 7>& coefficients, const std::array<u8, 256>* gamma_lut,
+                    yuv444* dst)
+{
+  FilterRowToYUVScalar(above, row, below, count, coefficients, gamma_lut, dst);
+}
+#endif
+}  // namespace CopyKernels
@@ -0,0 +1,39 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/EfbInterface.h"
+
+// Conversions of rows of the EFB for EFB copies, which use SIMD where available. The EFB stores
+// each pixel in 3 bytes, either as RGBA6 or as RGB8 in blue, green, red order. The Scalar
+// versions of the functions convert one pixel at a time, and are the reference that the others
+// must match.
+namespace CopyKernels
+{
+// Encodes a row of 4 pixels of a block of the RGBA8 texture format. Alpha and red are written to
+// dst, and green and blue to dst + 32.
+void EncodeRGBA8Row(const u8* src, u8* dst, bool rgba6);
+void EncodeRGBA8RowScalar(const u8* src, u8* dst, bool rgba6);
+
+// Encodes a row of 4 pixels of a block of the RGB565 texture format
+void EncodeRGB565Row(const u8* src, u8* dst, bool rgba6);
+void EncodeRGB565RowScalar(const u8* src, u8* dst, bool rgba6);
+
+// Encodes a row of 8 pixels of a block of the I8 texture format
+void EncodeI8Row(const u8* src, u8* dst, bool rgba6);
+void EncodeI8RowScalar(const u8* src, u8* dst, bool rgba6);
+
+// Applies the vertical filter of an XFB copy to count pixels of row, using the pixels of the rows
+// above and below it, then the gamma correction in gamma_lut (if any), and converts them to YUV.
+// The colors are as returned by EfbInterface::GetColor, and the coefficients are 6 bits each.
+void FilterRowToYUV(const u32* above, const u32* row, const u32* below, u32 count,
+                    const std::array<u8, 7>& coefficients, const std::array<u8, 256>* gamma_lut,
+                    EfbInterface::yuv444* dst);
+void FilterRowToYUVScalar(const u32* above, const u32* row, const u32* below, u32 count,
+                          const std::array<u8, 7>& coefficients,
+                          const std::array<u8, 256>* gamma_lut, EfbInterface::yuv444* dst);
+}  // namespace CopyKernels
@@ -5,13 +5,17 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <mutex>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Inline.h"
 #include "Common/Logging/Log.h"
 
+#include "VideoBackends/Software/CopyKernels.h"
 #include "VideoBackends/Software/CopyRegion.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/LookUpTables.h"
@@ -23,6 +27,11 @@ namespace EfbInterface
 static std::array<u8, EFB_WIDTH * EFB_HEIGHT * 6> efb;
 
 static std::array<u32, PQ_NUM_MEMBERS> perf_values;
+static std::array<u32, PQ_NUM_MEMBERS> perf_quad_counts;
+static std::mutex perf_mutex;
+
+// The rasterizer draws on several threads, so each thread counts on its own
+static thread_local std::array<u32, PQ_NUM_MEMBERS> perf_pending_counts;
 
 static inline u32 GetColorOffset(u16 x, u16 y)
 {
@@ -36,9 +45,9 @@ static inline u32 GetDepthOffset(u16 x, u16 y)
   return (x + y * EFB_WIDTH) * 3 + depth_buffer_start;
 }
 
-static void SetPixelAlphaOnly(u32 offset, u8 a)
+DOLPHIN_FORCE_INLINE static void SetPixelAlphaOnly(PixelFormat format, u32 offset, u8 a)
 {
-  switch (bpmem.zcontrol.pixel_format)
+  switch (format)
   {
   case PixelFormat::RGB8_Z24:
   case PixelFormat::Z24:
@@ -55,14 +64,14 @@ static void SetPixelAlphaOnly(u32 offset, u8 a)
   }
   break;
   default:
-    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", bpmem.zcontrol.pixel_format);
+    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", format);
     break;
   }
 }
 
-static void SetPixelColorOnly(u32 offset, u8* rgb)
+DOLPHIN_FORCE_INLINE static void SetPixelColorOnly(PixelFormat format, u32 offset, u8* rgb)
 {
-  switch (bpmem.zcontrol.pixel_format)
+  switch (format)
   {
   case PixelFormat::RGB8_Z24:
   case PixelFormat::Z24:
@@ -96,14 +105,14 @@ static void SetPixelColorOnly(u32 offset, u8* rgb)
   }
   break;
   default:
-    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", bpmem.zcontrol.pixel_format);
+    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", format);
     break;
   }
 }
 
-static void SetPixelAlphaColor(u32 offset, u8* color)
+DOLPHIN_FORCE_INLINE static void SetPixelAlphaColor(PixelFormat format, u32 offset, u8* color)
 {
-  switch (bpmem.zcontrol.pixel_format)
+  switch (format)
   {
   case PixelFormat::RGB8_Z24:
   case PixelFormat::Z24:
@@ -138,17 +147,17 @@ static void SetPixelAlphaColor(u32 offset, u8* color)
   }
   break;
   default:
-    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", bpmem.zcontrol.pixel_format);
+    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", format);
     break;
   }
 }
 
-static u32 GetPixelColor(u32 offset)
+DOLPHIN_FORCE_INLINE static u32 GetPixelColor(PixelFormat format, u32 offset)
 {
   u32 src;
   std::memcpy(&src, &efb[offset], sizeof(u32));
 
-  switch (bpmem.zcontrol.pixel_format)
+  switch (format)
   {
   case PixelFormat::RGB8_Z24:
   case PixelFormat::Z24:
@@ -165,14 +174,14 @@ static u32 GetPixelColor(u32 offset)
     return 0xff | ((src & 0x00ffffff) << 8);
 
   default:
-    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", bpmem.zcontrol.pixel_format);
+    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", format);
     return 0;
   }
 }
 
-static void SetPixelDepth(u32 offset, u32 depth)
+DOLPHIN_FORCE_INLINE static void SetPixelDepth(PixelFormat format, u32 offset, u32 depth)
 {
-  switch (bpmem.zcontrol.pixel_format)
+  switch (format)
   {
   case PixelFormat::RGB8_Z24:
   case PixelFormat::RGBA6_Z24:
@@ -194,16 +203,16 @@ static void SetPixelDepth(u32 offset, u32 depth)
   }
   break;
   default:
-    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", bpmem.zcontrol.pixel_format);
+    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", format);
     break;
   }
 }
 
-static u32 GetPixelDepth(u32 offset)
+DOLPHIN_FORCE_INLINE static u32 GetPixelDepth(PixelFormat format, u32 offset)
 {
   u32 depth = 0;
 
-  switch (bpmem.zcontrol.pixel_format)
+  switch (format)
   {
   case PixelFormat::RGB8_Z24:
   case PixelFormat::RGBA6_Z24:
@@ -219,7 +228,7 @@ static u32 GetPixelDepth(u32 offset)
   }
   break;
   default:
-    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", bpmem.zcontrol.pixel_format);
+    ERROR_LOG_FMT(VIDEO, "Unsupported pixel format: {}", format);
     break;
   }
 
@@ -394,10 +403,10 @@ static void SubtractBlend(u8* srcClr, u8* dstClr)
   }
 }
 
-static void Dither(u16 x, u16 y, u8* color)
+DOLPHIN_FORCE_INLINE static void Dither(PixelFormat format, u16 x, u16 y, u8* color)
 {
   // No blending for RGB8 mode
-  if (!bpmem.blendmode.dither || bpmem.zcontrol.pixel_format != PixelFormat::RGBA6_Z24)
+  if (!bpmem.blendmode.dither || format != PixelFormat::RGBA6_Z24)
     return;
 
   // Flipper uses a standard 2x2 Bayer Matrix for 6 bit dithering
@@ -408,147 +417,138 @@ static void Dither(u16 x, u16 y, u8* color)
     color[i] = ((color[i] - (color[i] >> 6)) + dither[y & 1][x & 1]) & 0xfc;
 }
 
-void BlendTev(u16 x, u16 y, u8* color)
+enum class BlendType
+{
+  None,
+  Blend,
+  Subtract,
+  Logic,
+};
+
+DOLPHIN_FORCE_INLINE static void BlendTev(PixelFormat format, BlendType type, u16 x, u16 y,
+                                          u8* color)
 {
   const u32 offset = GetColorOffset(x, y);
-  u32 dstClr = GetPixelColor(offset);
+  u32 dstClr = GetPixelColor(format, offset);
 
   u8* dstClrPtr = (u8*)&dstClr;
 
-  if (bpmem.blendmode.blendenable)
-  {
-    if (bpmem.blendmode.subtract)
-      SubtractBlend(color, dstClrPtr);
-    else
-      BlendColor(color, dstClrPtr);
-  }
-  else if (bpmem.blendmode.logicopenable)
-  {
+  if (type == BlendType::Subtract)
+    SubtractBlend(color, dstClrPtr);
+  else if (type == BlendType::Blend)
+    BlendColor(color, dstClrPtr);
+  else if (type == BlendType::Logic)
     LogicBlend(*((u32*)color), &dstClr, bpmem.blendmode.logicmode);
-  }
   else
-  {
     dstClrPtr = color;
-  }
 
   if (bpmem.dstalpha.enable)
     dstClrPtr[ALP_C] = bpmem.dstalpha.alpha;
 
   if (bpmem.blendmode.colorupdate)
   {
-    Dither(x, y, dstClrPtr);
+    Dither(format, x, y, dstClrPtr);
     if (bpmem.blendmode.alphaupdate)
-      SetPixelAlphaColor(offset, dstClrPtr);
+      SetPixelAlphaColor(format, offset, dstClrPtr);
     else
-      SetPixelColorOnly(offset, dstClrPtr);
+      SetPixelColorOnly(format, offset, dstClrPtr);
   }
   else if (bpmem.blendmode.alphaupdate)
   {
-    SetPixelAlphaOnly(offset, dstClrPtr[ALP_C]);
+    SetPixelAlphaOnly(format, offset, dstClrPtr[ALP_C]);
   }
 }
 
-void SetColor(u16 x, u16 y, u8* color)
+static BlendType GetBlendType()
 {
-  u32 offset = GetColorOffset(x, y);
-  if (bpmem.blendmode.colorupdate)
-  {
-    if (bpmem.blendmode.alphaupdate)
-      SetPixelAlphaColor(offset, color);
-    else
-      SetPixelColorOnly(offset, color);
-  }
-  else if (bpmem.blendmode.alphaupdate)
-  {
-    SetPixelAlphaOnly(offset, color[ALP_C]);
-  }
+  if (bpmem.blendmode.blendenable)
+    return bpmem.blendmode.subtract ? BlendType::Subtract : BlendType::Blend;
+  if (bpmem.blendmode.logicopenable)
+    return BlendType::Logic;
+  return BlendType::None;
 }
 
-void SetDepth(u16 x, u16 y, u32 depth)
+void BlendTev(u16 x, u16 y, u8* color)
 {
-  if (bpmem.zmode.updateenable)
-    SetPixelDepth(GetDepthOffset(x, y), depth);
+  BlendTev(bpmem.zcontrol.pixel_format, GetBlendType(), x, y, color);
 }
 
-u32 GetColor(u16 x, u16 y)
+template <PixelFormat format, BlendType type>
+static void BlendTev(u16 x, u16 y, u8* color)
 {
-  u32 offset = GetColorOffset(x, y);
-  return GetPixelColor(offset);
+  BlendTev(format, type, x, y, color);
 }
 
-static u32 VerticalFilter(const std::array<u32, 3>& colors,
-                          const std::array<u8, 7>& filterCoefficients)
+template <PixelFormat format>
+static BlendTevFunction GetBlendTevFunction(BlendType type)
 {
-  u8 in_colors[3][4];
-  std::memcpy(&in_colors, colors.data(), sizeof(in_colors));
+  switch (type)
+  {
+  case BlendType::None:
+    return BlendTev<format, BlendType::None>;
+  case BlendType::Blend:
+    return BlendTev<format, BlendType::Blend>;
+  case BlendType::Subtract:
+    return BlendTev<format, BlendType::Subtract>;
+  case BlendType::Logic:
+    return BlendTev<format, BlendType::Logic>;
+  }
+  return BlendTev;
+}
 
-  // Alpha channel is not used
-  u8 out_color[4];
-  out_color[ALP_C] = 0;
+BlendTevFunction GetBlendTevFunction()
+{
+  const BlendType type = GetBlendType();
 
-  // All Coefficients should sum to 64, otherwise the total brightness will change, which many games
-  // do on purpose to implement a brightness filter across the whole copy.
-  for (int i = BLU_C; i <= RED_C; i++)
+  switch (bpmem.zcontrol.pixel_format)
   {
-    // TODO: implement support for multisampling.
-    // In non-multisampling mode:
-    //   * Coefficients 2, 3 and 4 sample from the current pixel.
-    //   * Coefficients 0 and 1 sample from the pixel above this one
-    //   * Coefficients 5 and 6 sample from the pixel below this one
-    int sum =
-        in_colors[0][i] * (filterCoefficients[0] + filterCoefficients[1]) +
-        in_colors[1][i] * (filterCoefficients[2] + filterCoefficients[3] + filterCoefficients[4]) +
-        in_colors[2][i] * (filterCoefficients[5] + filterCoefficients[6]);
-
-    // TODO: this clamping behavior appears to be correct, but isn't confirmed on hardware.
-    out_color[i] = std::min(255, sum >> 6);  // clamp larger values to 255
+  case PixelFormat::RGB8_Z24:
+    return GetBlendTevFunction<PixelFormat::RGB8_Z24>(type);
+  case PixelFormat::RGBA6_Z24:
+    return GetBlendTevFunction<PixelFormat::RGBA6_Z24>(type);
+  case PixelFormat::RGB565_Z16:
+    return GetBlendTevFunction<PixelFormat::RGB565_Z16>(type);
+  case PixelFormat::Z24:
+    return GetBlendTevFunction<PixelFormat::Z24>(type);
+  default:
+    // Unsupported formats log an error for every pixel, so there's nothing to gain
+    return BlendTev;
   }
-
-  u32 out_color32;
-  std::memcpy(&out_color32, out_color, sizeof(out_color32));
-  return out_color32;
 }
 
-static u32 GammaCorrection(u32 color, const float gamma_rcp)
+void SetColor(u16 x, u16 y, u8* color)
 {
-  u8 in_colors[4];
-  std::memcpy(&in_colors, &color, sizeof(in_colors));
-
-  u8 out_color[4];
-  for (int i = BLU_C; i <= RED_C; i++)
+  const PixelFormat format = bpmem.zcontrol.pixel_format;
+  u32 offset = GetColorOffset(x, y);
+  if (bpmem.blendmode.colorupdate)
   {
-    out_color[i] = static_cast<u8>(
-        std::clamp(std::pow(in_colors[i] / 255.0f, gamma_rcp) * 255.0f, 0.0f, 255.0f));
+    if (bpmem.blendmode.alphaupdate)
+      SetPixelAlphaColor(format, offset, color);
+    else
+      SetPixelColorOnly(format, offset, color);
+  }
+  else if (bpmem.blendmode.alphaupdate)
+  {
+    SetPixelAlphaOnly(format, offset, color[ALP_C]);
   }
-
-  u32 out_color32;
-  std::memcpy(&out_color32, out_color, sizeof(out_color32));
-  return out_color32;
 }
 
-// For internal used only, return a non-normalized value, which saves work later.
-static yuv444 ConvertColorToYUV(u32 color)
+void SetDepth(u16 x, u16 y, u32 depth)
 {
-  const u8 red = static_cast<u8>(color >> 24);
-  const u8 green = static_cast<u8>(color >> 16);
-  const u8 blue = static_cast<u8>(color >> 8);
+  if (bpmem.zmode.updateenable)
+    SetPixelDepth(bpmem.zcontrol.pixel_format, GetDepthOffset(x, y), depth);
+}
 
-  // GameCube/Wii uses the BT.601 standard algorithm for converting to YCbCr; see
-  // http://www.equasys.de/colorconversion.html#YCbCr-RGBColorFormatConversion
-  // These numbers were determined by hardware testing
-  const u16 y = +66 * red + 129 * green + +25 * blue;
-  const s16 u = -38 * red + -74 * green + 112 * blue;
-  const s16 v = 112 * red + -94 * green + -18 * blue;
-  const u8 y_round = static_cast<u8>((y >> 8) + ((y >> 7) & 1));
-  const s8 u_round = static_cast<s8>((u >> 8) + ((u >> 7) & 1));
-  const s8 v_round = static_cast<s8>((v >> 8) + ((v >> 7) & 1));
-  return {y_round, u_round, v_round};
+u32 GetColor(u16 x, u16 y)
+{
+  u32 offset = GetColorOffset(x, y);
+  return GetPixelColor(bpmem.zcontrol.pixel_format, offset);
 }
 
 u32 GetDepth(u16 x, u16 y)
 {
   u32 offset = GetDepthOffset(x, y);
-  return GetPixelDepth(offset);
+  return GetPixelDepth(bpmem.zcontrol.pixel_format, offset);
 }
 
 u8* GetPixelPointer(u16 x, u16 y, bool depth)
@@ -582,6 +582,37 @@ void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>
     // this will show up as wrongly encoded
   }
 
+  // Gamma correction is the same for every pixel of the copy, so it is done with a lookup table
+  std::array<u8, 256> gamma_lut;
+  bool gamma_is_identity = true;
+  for (u32 i = 0; i < gamma_lut.size(); i++)
+  {
+    gamma_lut[i] = static_cast<u8>(
+        std::clamp(std::pow(i / 255.0f, gamma_rcp) * 255.0f, 0.0f, 255.0f));
+    gamma_is_identity &= gamma_lut[i] == i;
+  }
+
+  // Clamping behavior
+  //   NOTE: when the clamp bits aren't set, the hardware will happily read beyond the EFB,
+  //         which returns random garbage from the empty bus (confirmed by hardware tests).
+  //
+  //         In our implementation, the garbage just so happens to be the top or bottom row.
+  //         Statistically, that could happen.
+  const int first_row = std::max(clamp_top ? source_rect.top : 0, source_rect.top - 1);
+  const int last_row =
+      std::min<int>((clamp_bottom ? source_rect.bottom : EFB_HEIGHT) - 1, source_rect.bottom);
+  const int width = std::max(right - left, 0);
+
+  // Every row is used by up to three rows of the copy, so they are only read from the EFB once
+  static std::vector<u32> colors;
+  colors.resize(std::max(last_row - first_row + 1, 0) * width);
+  for (int y = first_row; y <= last_row; y++)
+  {
+    u32* row = colors.data() + (y - first_row) * width;
+    for (int x = left; x < right; x++)
+      row[x - left] = GetColor(x, y);
+  }
+
   // Scanline buffer, leave room for borders
   yuv444 scanline[EFB_WIDTH + 2];
 
@@ -591,34 +622,20 @@ void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>
 
   for (int y = source_rect.top; y < source_rect.bottom; y++)
   {
-    // Clamping behavior
-    //   NOTE: when the clamp bits aren't set, the hardware will happily read beyond the EFB,
-    //         which returns random garbage from the empty bus (confirmed by hardware tests).
-    //
-    //         In our implementation, the garbage just so happens to be the top or bottom row.
-    //         Statistically, that could happen.
-    const u16 y_prev = static_cast<u16>(std::max(clamp_top ? source_rect.top : 0, y - 1));
-    const u16 y_next = static_cast<u16>(
-        std::min<int>((clamp_bottom ? source_rect.bottom : EFB_HEIGHT) - 1, y + 1));
-
-    // Get a scanline of YUV pixels in 4:4:4 format
-    for (int i = 1, x = left; x < right; i++, x++)
-    {
-      // Get RGB colors
-      std::array<u32, 3> colors = {{GetColor(x, y_prev), GetColor(x, y), GetColor(x, y_next)}};
-
-      // Vertical Filter (Multisampling resolve, deflicker, brightness)
-      u32 filtered = VerticalFilter(colors, filter_coefficients);
+    const int y_prev = std::max(first_row, y - 1);
+    const int y_next = std::min(last_row, y + 1);
 
-      // Gamma correction happens here.
-      filtered = GammaCorrection(filtered, gamma_rcp);
-
-      scanline[i] = ConvertColorToYUV(filtered);
-    }
+    // Get a scanline of YUV pixels in 4:4:4 format. The vertical filter does the multisampling
+    // resolve, deflicker and brightness, and is followed by gamma correction.
+    CopyKernels::FilterRowToYUV(colors.data() + (y_prev - first_row) * width,
+                                colors.data() + (y - first_row) * width,
+                                colors.data() + (y_next - first_row) * width, width,
+                                filter_coefficients, gamma_is_identity ? nullptr : &gamma_lut,
+                                &scanline[1]);
 
     // Flipper clamps the border colors
     scanline[0] = scanline[1];
-    scanline[right + 1] = scanline[right];
+    scanline[width + 1] = scanline[width];
 
     // And Downsample them to 4:2:2
     for (int i = 1, x = left; x < right; i += 2, x += 2)
@@ -647,14 +664,15 @@ void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>
                  dst_width, dst_height);
 }
 
-bool ZCompare(u16 x, u16 y, u32 z)
+DOLPHIN_FORCE_INLINE static bool ZCompare(PixelFormat format, CompareMode func, u16 x, u16 y,
+                                          u32 z)
 {
   u32 offset = GetDepthOffset(x, y);
-  u32 depth = GetPixelDepth(offset);
+  u32 depth = GetPixelDepth(format, offset);
 
   bool pass;
 
-  switch (bpmem.zmode.func)
+  switch (func)
   {
   case CompareMode::Never:
     pass = false;
@@ -682,18 +700,73 @@ bool ZCompare(u16 x, u16 y, u32 z)
     break;
   default:
     pass = false;
-    ERROR_LOG_FMT(VIDEO, "Bad Z compare mode {}", bpmem.zmode.func);
+    ERROR_LOG_FMT(VIDEO, "Bad Z compare mode {}", func);
     break;
   }
 
   if (pass && bpmem.zmode.updateenable)
   {
-    SetPixelDepth(offset, z);
+    SetPixelDepth(format, offset, z);
   }
 
   return pass;
 }
 
+bool ZCompare(u16 x, u16 y, u32 z)
+{
+  return ZCompare(bpmem.zcontrol.pixel_format, bpmem.zmode.func, x, y, z);
+}
+
+template <PixelFormat format, CompareMode func>
+static bool ZCompare(u16 x, u16 y, u32 z)
+{
+  return ZCompare(format, func, x, y, z);
+}
+
+template <PixelFormat format>
+static ZCompareFunction GetZCompareFunction(CompareMode func)
+{
+  switch (func)
+  {
+  case CompareMode::Never:
+    return ZCompare<format, CompareMode::Never>;
+  case CompareMode::Less:
+    return ZCompare<format, CompareMode::Less>;
+  case CompareMode::Equal:
+    return ZCompare<format, CompareMode::Equal>;
+  case CompareMode::LEqual:
+    return ZCompare<format, CompareMode::LEqual>;
+  case CompareMode::Greater:
+    return ZCompare<format, CompareMode::Greater>;
+  case CompareMode::NEqual:
+    return ZCompare<format, CompareMode::NEqual>;
+  case CompareMode::GEqual:
+    return ZCompare<format, CompareMode::GEqual>;
+  case CompareMode::Always:
+    return ZCompare<format, CompareMode::Always>;
+  }
+  return ZCompare;
+}
+
+ZCompareFunction GetZCompareFunction()
+{
+  const CompareMode func = bpmem.zmode.func;
+
+  switch (bpmem.zcontrol.pixel_format)
+  {
+  case PixelFormat::RGB8_Z24:
+    return GetZCompareFunction<PixelFormat::RGB8_Z24>(func);
+  case PixelFormat::RGBA6_Z24:
+    return GetZCompareFunction<PixelFormat::RGBA6_Z24>(func);
+  case PixelFormat::RGB565_Z16:
+    return GetZCompareFunction<PixelFormat::RGB565_Z16>(func);
+  case PixelFormat::Z24:
+    return GetZCompareFunction<PixelFormat::Z24>(func);
+  default:
+    return ZCompare;
+  }
+}
+
 u32 GetPerfQueryResult(PerfQueryType type)
 {
   return perf_values[type];
@@ -706,14 +779,23 @@ void ResetPerfQuery()
 
 void IncPerfCounterQuadCount(PerfQueryType type)
 {
-  // NOTE: hardware doesn't process individual pixels but quads instead.
-  // Current software renderer architecture works on pixels though, so
-  // we have this "quad" hack here to only increment the registers on
-  // every fourth rendered pixel
-  static u32 quad[PQ_NUM_MEMBERS];
-  if (++quad[type] != 3)
-    return;
-  quad[type] = 0;
-  ++perf_values[type];
+  ++perf_pending_counts[type];
+}
+
+void FlushPerfCounters()
+{
+  std::lock_guard lk(perf_mutex);
+
+  for (size_t i = 0; i < PQ_NUM_MEMBERS; ++i)
+  {
+    // NOTE: hardware doesn't process individual pixels but quads instead.
+    // Current software renderer architecture works on pixels though, so
+    // we have this "quad" hack here to only increment the registers on
+    // every fourth rendered pixel
+    const u32 count = perf_quad_counts[i] + perf_pending_counts[i];
+    perf_values[i] += count / 3;
+    perf_quad_counts[i] = count % 3;
+    perf_pending_counts[i] = 0;
+  }
 }
 }  // namespace EfbInterface
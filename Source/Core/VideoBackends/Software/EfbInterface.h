@@ -44,6 +44,14 @@ void BlendTev(u16 x, u16 y, u8* color);
 // returns result of compare.
 bool ZCompare(u16 x, u16 y, u32 z);
 
+// Versions of BlendTev and ZCompare which are specialized for the pixel format, blend mode and
+// depth function currently set in bpmem, so that they don't have to branch on them for every pixel.
+// They must be looked up again when bpmem changes.
+using BlendTevFunction = void (*)(u16 x, u16 y, u8* color);
+using ZCompareFunction = bool (*)(u16 x, u16 y, u32 z);
+BlendTevFunction GetBlendTevFunction();
+ZCompareFunction GetZCompareFunction();
+
 // sets the color and alpha
 void SetColor(u16 x, u16 y, u8* color);
 void SetDepth(u16 x, u16 y, u32 depth);
@@ -58,5 +66,8 @@ void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>
 
 u32 GetPerfQueryResult(PerfQueryType type);
 void ResetPerfQuery();
+// Adds what has been counted on this thread by IncPerfCounterQuadCount to the results.
+// Must be called by every thread drawing pixels when it's done drawing.
+void FlushPerfCounters();
 void IncPerfCounterQuadCount(PerfQueryType type);
 }  // namespace EfbInterface
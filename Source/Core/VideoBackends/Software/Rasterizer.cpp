@@ -4,15 +4,24 @@
 #include "VideoBackends/Software/Rasterizer.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
 #include <vector>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/WorkerPool.h"
 
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/SWBoundingBox.h"
 #include "VideoBackends/Software/Tev.h"
+#include "VideoBackends/Software/TextureSampler.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/PerfQueryBase.h"
@@ -96,21 +105,108 @@ struct Slope
   }
 };
 
-static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
+// A triangle that has been set up for one scissor rectangle and is waiting to be drawn
+struct Triangle
+{
+  // Half-edge constants and deltas, in 28.4 fixed point
+  s32 C1;
+  s32 C2;
+  s32 C3;
+  s32 DX12;
+  s32 DX23;
+  s32 DX31;
+  s32 DY12;
+  s32 DY23;
+  s32 DY31;
+
+  // Bounding rectangle, limited to the scissor rectangle
+  s32 minx;
+  s32 maxx;
+  s32 miny;
+  s32 maxy;
+
+  Slope ZSlope;
+  Slope WSlope;
+  Slope ColorSlopes[2][4];
+  Slope TexSlopes[8][3];
+};
+
+// The state of a thread which is drawing triangles
+struct DrawContext
+{
+  Tev tev;
+  RasterBlock rasterBlock;
+  EfbInterface::ZCompareFunction z_compare = nullptr;
+  u32 rasterized_pixels = 0;
+};
+
+// Triangles are binned into tiles of the EFB, which are then drawn in parallel. Each tile draws its
+// triangles in the order they were submitted, and every pixel belongs to exactly one tile, so the
+// result is identical to drawing the triangles one at a time.
+static constexpr s32 TILE_SIZE = 32;
+static constexpr s32 TILES_X = (static_cast<s32>(EFB_WIDTH) + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr s32 TILES_Y = (static_cast<s32>(EFB_HEIGHT) + TILE_SIZE - 1) / TILE_SIZE;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0);
+
+// To limit memory usage, binned triangles are drawn once this many have been submitted
+static constexpr size_t MAX_BINNED_TRIANGLES = 0x1000;
 
-static Tev tev;
-static RasterBlock rasterBlock;
+// What was done while processing a range for RunInParallel, which is submitted once the ranges
+// before it have been
+struct RangeOutput
+{
+  std::vector<Triangle> triangles;
+  std::optional<Slope> z_slope;  // Set if the range updated the slope used by zfreeze
+  SetupStatistics statistics;
+};
+
+// RunInParallel processes this many ranges per thread before binning their triangles, which limits
+// how many set up triangles are held at a time
+static constexpr size_t RANGES_PER_THREAD = 4;
+
+// Only updated when drawing, for zfreeze
+static Slope ZSlope;
 
 static std::vector<BPFunctions::ScissorRect> scissors;
 
+static std::vector<Triangle> s_triangles;
+static std::array<std::vector<u32>, TILES_X * TILES_Y> s_tile_triangles;
+static std::vector<u32> s_active_tiles;
+static std::atomic<size_t> s_next_active_tile;
+
+static std::vector<RangeOutput> s_ranges;
+static std::atomic<size_t> s_next_range;
+static size_t s_range_count = 0;
+static u32 s_ranges_begin = 0;
+static u32 s_ranges_end = 0;
+static u32 s_range_size = 0;
+static const std::function<void(u32, u32)>* s_range_function = nullptr;
+static thread_local RangeOutput* s_current_range = nullptr;
+
+// s_contexts[0] is used by the thread submitting triangles, and the others by s_workers
+static std::vector<std::unique_ptr<DrawContext>> s_contexts;
+static Common::WorkerPool s_workers("SW Rasterizer");
+
+static void SetThreadCount(size_t thread_count);
+
 void Init()
 {
   // The other slopes are set each for each primitive drawn, but zfreeze means that the z slope
   // needs to be set to an (untested) default value.
   ZSlope = Slope();
+
+  SetThreadCount(1);
+}
+
+void Shutdown()
+{
+  SetThreadCount(1);
+
+  s_triangles.clear();
+  s_active_tiles.clear();
+  for (std::vector<u32>& tile_triangles : s_tile_triangles)
+    tile_triangles.clear();
+  s_ranges.clear();
 }
 
 void ScissorChanged()
@@ -142,14 +238,15 @@ static inline int iround(float x)
 
 void SetTevKonstColors()
 {
-  tev.SetKonstColors();
+  for (const std::unique_ptr<DrawContext>& context : s_contexts)
+    context->tev.SetKonstColors();
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static void Draw(const Triangle& triangle, DrawContext* context, s32 x, s32 y, s32 xi, s32 yi)
 {
-  INCSTAT(g_stats.this_frame.rasterized_pixels);
+  ++context->rasterized_pixels;
 
-  s32 z = (s32)std::clamp<float>(ZSlope.GetValue(x, y), 0.0f, 16777215.0f);
+  s32 z = (s32)std::clamp<float>(triangle.ZSlope.GetValue(x, y), 0.0f, 16777215.0f);
 
   if (bpmem.GetEmulatedZ() == EmulatedZ::Early)
   {
@@ -158,13 +255,15 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
     if (bpmem.zmode.testenable)
     {
       // early z
-      if (!EfbInterface::ZCompare(x, y, z))
+      if (!context->z_compare(x, y, z))
         return;
     }
     EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
   }
 
-  RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+  Tev& tev = context->tev;
+  const RasterBlock& rasterBlock = context->rasterBlock;
+  const RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
   tev.Position[0] = x;
   tev.Position[1] = y;
@@ -175,7 +274,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   {
     for (int comp = 0; comp < 4; comp++)
     {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(x, y);
+      u16 color = (u16)triangle.ColorSlopes[i][comp].GetValue(x, y);
 
       // clamp color value to 0
       u16 mask = ~(color >> 8);
@@ -207,7 +306,8 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   tev.Draw();
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear,
+                                u32 texmap, u32 texcoord)
 {
   auto texUnit = bpmem.tex.GetUnit(texmap);
 
@@ -218,9 +318,9 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
 
   float sDelta, tDelta;
 
-  float* uv00 = rasterBlock.Pixel[0][0].Uv[texcoord];
-  float* uv10 = rasterBlock.Pixel[1][0].Uv[texcoord];
-  float* uv01 = rasterBlock.Pixel[0][1].Uv[texcoord];
+  const float* uv00 = rasterBlock.Pixel[0][0].Uv[texcoord];
+  const float* uv10 = rasterBlock.Pixel[1][0].Uv[texcoord];
+  const float* uv01 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
   float dudx = fabsf(uv00[0] - uv10[0]);
   float dvdx = fabsf(uv00[1] - uv10[1]);
@@ -258,7 +358,7 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(const Triangle& triangle, RasterBlock& rasterBlock, s32 blockX, s32 blockY)
 {
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
@@ -269,19 +369,19 @@ static void BuildBlock(s32 blockX, s32 blockY)
       s32 x = xi + blockX;
       s32 y = yi + blockY;
 
-      float invW = 1.0f / WSlope.GetValue(x, y);
+      float invW = 1.0f / triangle.WSlope.GetValue(x, y);
       pixel.InvW = invW;
 
       // tex coords
       for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
       {
         float projection = invW;
-        float q = TexSlopes[i][2].GetValue(x, y) * invW;
+        float q = triangle.TexSlopes[i][2].GetValue(x, y) * invW;
         if (q != 0.0f)
           projection = invW / q;
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(x, y) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(x, y) * projection;
+        pixel.Uv[i][0] = triangle.TexSlopes[i][0].GetValue(x, y) * projection;
+        pixel.Uv[i][1] = triangle.TexSlopes[i][1].GetValue(x, y) * projection;
       }
     }
   }
@@ -291,7 +391,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texmap = bpmem.tevindref.getTexMap(i);
     u32 texcoord = bpmem.tevindref.getTexCoord(i);
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap,
+                 texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -303,7 +404,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap,
+                   texcoord);
     }
   }
 }
@@ -316,38 +418,37 @@ void UpdateZSlope(const OutputVertexData* v0, const OutputVertexData* v1,
     const s32 X1 = iround(16.0f * (v0->screenPosition.x - x_off)) - 9;
     const s32 Y1 = iround(16.0f * (v0->screenPosition.y - y_off)) - 9;
     const SlopeContext ctx(v0, v1, v2, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4, x_off, y_off);
-    ZSlope = Slope(v0->screenPosition.z, v1->screenPosition.z, v2->screenPosition.z, ctx);
+    s_current_range->z_slope =
+        Slope(v0->screenPosition.z, v1->screenPosition.z, v2->screenPosition.z, ctx);
   }
 }
 
-static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
-                                  const OutputVertexData* v2,
-                                  const BPFunctions::ScissorRect& scissor)
+SetupStatistics& GetSetupStatistics()
 {
-  // The zslope should be updated now, even if the triangle is rejected by the scissor test, as
-  // zfreeze depends on it
-  UpdateZSlope(v0, v1, v2, scissor.x_off, scissor.y_off);
-
-  // adapted from http://devmaster.net/posts/6145/advanced-rasterization
+  return s_current_range->statistics;
+}
 
-  // 28.4 fixed-point coordinates. rounded to nearest and adjusted to match hardware output
-  // could also take floor and adjust -8
-  const s32 Y1 = iround(16.0f * (v0->screenPosition.y - scissor.y_off)) - 9;
-  const s32 Y2 = iround(16.0f * (v1->screenPosition.y - scissor.y_off)) - 9;
-  const s32 Y3 = iround(16.0f * (v2->screenPosition.y - scissor.y_off)) - 9;
+// Draws the part of the triangle which is within the given rectangle of the EFB. The edges of the
+// rectangle must be aligned to blocks.
+static void DrawTriangle(const Triangle& triangle, DrawContext* context, s32 left, s32 top,
+                         s32 right, s32 bottom)
+{
+  const s32 minx = std::max(triangle.minx, left);
+  const s32 maxx = std::min(triangle.maxx, right);
+  const s32 miny = std::max(triangle.miny, top);
+  const s32 maxy = std::min(triangle.maxy, bottom);
 
-  const s32 X1 = iround(16.0f * (v0->screenPosition.x - scissor.x_off)) - 9;
-  const s32 X2 = iround(16.0f * (v1->screenPosition.x - scissor.x_off)) - 9;
-  const s32 X3 = iround(16.0f * (v2->screenPosition.x - scissor.x_off)) - 9;
+  const s32 C1 = triangle.C1;
+  const s32 C2 = triangle.C2;
+  const s32 C3 = triangle.C3;
 
-  // Deltas
-  const s32 DX12 = X1 - X2;
-  const s32 DX23 = X2 - X3;
-  const s32 DX31 = X3 - X1;
+  const s32 DX12 = triangle.DX12;
+  const s32 DX23 = triangle.DX23;
+  const s32 DX31 = triangle.DX31;
 
-  const s32 DY12 = Y1 - Y2;
-  const s32 DY23 = Y2 - Y3;
-  const s32 DY31 = Y3 - Y1;
+  const s32 DY12 = triangle.DY12;
+  const s32 DY23 = triangle.DY23;
+  const s32 DY31 = triangle.DY31;
 
   // Fixed-point deltas
   const s32 FDX12 = DX12 * 16;
@@ -358,62 +459,6 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
   const s32 FDY23 = DY23 * 16;
   const s32 FDY31 = DY31 * 16;
 
-  // Bounding rectangle
-  s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
-  s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
-  s32 miny = (std::min(std::min(Y1, Y2), Y3) + 0xF) >> 4;
-  s32 maxy = (std::max(std::max(Y1, Y2), Y3) + 0xF) >> 4;
-
-  // scissor
-  ASSERT(scissor.rect.left >= 0);
-  ASSERT(scissor.rect.right <= static_cast<int>(EFB_WIDTH));
-  ASSERT(scissor.rect.top >= 0);
-  ASSERT(scissor.rect.bottom <= static_cast<int>(EFB_HEIGHT));
-
-  minx = std::max(minx, scissor.rect.left);
-  maxx = std::min(maxx, scissor.rect.right);
-  miny = std::max(miny, scissor.rect.top);
-  maxy = std::min(maxy, scissor.rect.bottom);
-
-  if (minx >= maxx || miny >= maxy)
-    return;
-
-  // Set up the remaining slopes
-  const SlopeContext ctx(v0, v1, v2, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4, scissor.x_off,
-                         scissor.y_off);
-
-  float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
-                1.0f / v2->projectedPosition.w};
-  WSlope = Slope(w[0], w[1], w[2], ctx);
-
-  for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
-  {
-    for (int comp = 0; comp < 4; comp++)
-      ColorSlopes[i][comp] = Slope(v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], ctx);
-  }
-
-  for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
-  {
-    for (int comp = 0; comp < 3; comp++)
-    {
-      TexSlopes[i][comp] = Slope(v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
-                                 v2->texCoords[i][comp] * w[2], ctx);
-    }
-  }
-
-  // Half-edge constants
-  s32 C1 = DY12 * X1 - DX12 * Y1;
-  s32 C2 = DY23 * X2 - DX23 * Y2;
-  s32 C3 = DY31 * X3 - DX31 * Y3;
-
-  // Correct for fill convention
-  if (DY12 < 0 || (DY12 == 0 && DX12 > 0))
-    C1++;
-  if (DY23 < 0 || (DY23 == 0 && DX23 > 0))
-    C2++;
-  if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
-    C3++;
-
   // Start in corner of 2x2 block
   s32 block_minx = minx & ~(BLOCK_SIZE - 1);
   s32 block_miny = miny & ~(BLOCK_SIZE - 1);
@@ -455,7 +500,7 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
       if (a == 0x0 || b == 0x0 || c == 0x0)
         continue;
 
-      BuildBlock(x, y);
+      BuildBlock(triangle, context->rasterBlock, x, y);
 
       // Accept whole block when totally covered
       // We still need to check min/max x/y because of the scissor
@@ -465,7 +510,7 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
         {
           for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
           {
-            Draw(x + ix, y + iy, ix, iy);
+            Draw(triangle, context, x + ix, y + iy, ix, iy);
           }
         }
       }
@@ -488,7 +533,7 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
               // This check enforces the scissor rectangle, since it might not be aligned with the
               // blocks
               if (x + ix >= minx && x + ix < maxx && y + iy >= miny && y + iy < maxy)
-                Draw(x + ix, y + iy, ix, iy);
+                Draw(triangle, context, x + ix, y + iy, ix, iy);
             }
 
             CX1 -= FDY12;
@@ -505,10 +550,322 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
   }
 }
 
+static void DrawTile(u32 tile, DrawContext* context)
+{
+  const s32 left = static_cast<s32>(tile % TILES_X) * TILE_SIZE;
+  const s32 top = static_cast<s32>(tile / TILES_X) * TILE_SIZE;
+
+  for (const u32 index : s_tile_triangles[tile])
+    DrawTriangle(s_triangles[index], context, left, top, left + TILE_SIZE, top + TILE_SIZE);
+}
+
+static void DrawActiveTiles(DrawContext* context)
+{
+  // The render state doesn't change while there are binned triangles
+  context->tev.SetUpPipeline();
+  context->z_compare = EfbInterface::GetZCompareFunction();
+  TextureSampler::InvalidateCache();
+
+  while (true)
+  {
+    const size_t i = s_next_active_tile.fetch_add(1, std::memory_order_relaxed);
+    if (i >= s_active_tiles.size())
+      break;
+
+    DrawTile(s_active_tiles[i], context);
+  }
+
+  EfbInterface::FlushPerfCounters();
+  BBoxManager::FlushUpdates();
+}
+
+static void ProcessRanges(DrawContext*)
+{
+  while (true)
+  {
+    const size_t i = s_next_range.fetch_add(1, std::memory_order_relaxed);
+    if (i >= s_range_count)
+      break;
+
+    const u32 begin = s_ranges_begin + static_cast<u32>(i) * s_range_size;
+    const u32 end = std::min(begin + s_range_size, s_ranges_end);
+    s_current_range = &s_ranges[i];
+    (*s_range_function)(begin, end);
+  }
+
+  s_current_range = nullptr;
+}
+
+static void SetThreadCount(size_t thread_count)
+{
+  s_workers.SetThreadCount(thread_count);
+
+  s_contexts.resize(std::min(s_contexts.size(), thread_count));
+  while (s_contexts.size() < thread_count)
+  {
+    s_contexts.push_back(std::make_unique<DrawContext>());
+    s_contexts.back()->tev.SetKonstColors();
+  }
+}
+
+static size_t GetWantedThreadCount()
+{
+  if (!g_ActiveConfig.bBackendMultithreading)
+    return 1;
+
+  return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, TILES_X * TILES_Y);
+}
+
+static void UpdateWorkers()
+{
+  const size_t thread_count = GetWantedThreadCount();
+  if (thread_count != s_contexts.size())
+    SetThreadCount(thread_count);
+}
+
+// Runs job on this thread and the workers, and waits for all of them to finish. job must split up
+// the work between the threads, of which there are task_count pieces.
+static void RunOnAllThreads(void (*job)(DrawContext* context), size_t task_count)
+{
+  // Waking up the workers isn't worth it if there's only one piece of work
+  if (task_count <= 1)
+  {
+    job(s_contexts[0].get());
+    return;
+  }
+
+  s_workers.Run([job](size_t thread_index) { job(s_contexts[thread_index].get()); });
+}
+
+void Flush()
+{
+  if (s_triangles.empty())
+    return;
+
+  UpdateWorkers();
+
+  s_next_active_tile = 0;
+  RunOnAllThreads(DrawActiveTiles, s_active_tiles.size());
+
+  for (const std::unique_ptr<DrawContext>& context : s_contexts)
+  {
+    ADDSTAT(g_stats.this_frame.rasterized_pixels, context->rasterized_pixels);
+    ADDSTAT(g_stats.this_frame.tev_pixels_in, context->tev.PixelsIn);
+    ADDSTAT(g_stats.this_frame.tev_pixels_out, context->tev.PixelsOut);
+    context->rasterized_pixels = 0;
+    context->tev.PixelsIn = 0;
+    context->tev.PixelsOut = 0;
+  }
+
+  for (const u32 tile : s_active_tiles)
+    s_tile_triangles[tile].clear();
+  s_active_tiles.clear();
+  s_triangles.clear();
+}
+
+// Returns whether any pixel within the rectangle could be inside all edges of the triangle
+static bool MayCoverRectangle(const Triangle& triangle, s32 left, s32 top, s32 right, s32 bottom)
+{
+  // Evaluates a half-space function at the pixel of the rectangle where it is the largest
+  const auto max_in_rectangle = [&](s32 C, s32 DX, s32 DY) {
+    const s32 x = DY > 0 ? left : right - 1;
+    const s32 y = DX > 0 ? bottom - 1 : top;
+    return C + DX * (y << 4) - DY * (x << 4);
+  };
+
+  return max_in_rectangle(triangle.C1, triangle.DX12, triangle.DY12) > 0 &&
+         max_in_rectangle(triangle.C2, triangle.DX23, triangle.DY23) > 0 &&
+         max_in_rectangle(triangle.C3, triangle.DX31, triangle.DY31) > 0;
+}
+
+static void BinTriangle(const Triangle& triangle)
+{
+  const u32 index = static_cast<u32>(s_triangles.size());
+  s_triangles.push_back(triangle);
+
+  for (s32 tile_y = triangle.miny / TILE_SIZE; tile_y * TILE_SIZE < triangle.maxy; ++tile_y)
+  {
+    for (s32 tile_x = triangle.minx / TILE_SIZE; tile_x * TILE_SIZE < triangle.maxx; ++tile_x)
+    {
+      const s32 left = std::max(tile_x * TILE_SIZE, triangle.minx);
+      const s32 top = std::max(tile_y * TILE_SIZE, triangle.miny);
+      const s32 right = std::min((tile_x + 1) * TILE_SIZE, triangle.maxx);
+      const s32 bottom = std::min((tile_y + 1) * TILE_SIZE, triangle.maxy);
+      if (!MayCoverRectangle(triangle, left, top, right, bottom))
+        continue;
+
+      std::vector<u32>& tile_triangles = s_tile_triangles[tile_y * TILES_X + tile_x];
+      if (tile_triangles.empty())
+        s_active_tiles.push_back(static_cast<u32>(tile_y * TILES_X + tile_x));
+      tile_triangles.push_back(index);
+    }
+  }
+
+  if (s_triangles.size() >= MAX_BINNED_TRIANGLES)
+    Flush();
+}
+
+static void SubmitRange(RangeOutput* range)
+{
+  for (const Triangle& triangle : range->triangles)
+    BinTriangle(triangle);
+
+  if (range->z_slope)
+    ZSlope = *range->z_slope;
+
+  const SetupStatistics& statistics = range->statistics;
+  ADDSTAT(g_stats.this_frame.num_triangles_in, statistics.num_triangles_in);
+  ADDSTAT(g_stats.this_frame.num_triangles_rejected, statistics.num_triangles_rejected);
+  ADDSTAT(g_stats.this_frame.num_triangles_culled, statistics.num_triangles_culled);
+  ADDSTAT(g_stats.this_frame.num_triangles_clipped, statistics.num_triangles_clipped);
+  ADDSTAT(g_stats.this_frame.num_triangles_drawn, statistics.num_triangles_drawn);
+
+  range->triangles.clear();
+  range->z_slope.reset();
+  range->statistics = {};
+}
+
+void RunInParallel(u32 count, u32 range_size, const std::function<void(u32, u32)>& function)
+{
+  UpdateWorkers();
+
+  const size_t max_ranges = s_contexts.size() * RANGES_PER_THREAD;
+  if (s_ranges.size() < max_ranges)
+    s_ranges.resize(max_ranges);
+
+  s_range_function = &function;
+  s_range_size = range_size;
+
+  u32 begin = 0;
+  while (begin < count)
+  {
+    const u32 end = static_cast<u32>(std::min<u64>(count, begin + u64{range_size} * max_ranges));
+    s_ranges_begin = begin;
+    s_ranges_end = end;
+    s_range_count = (end - begin + range_size - 1) / range_size;
+    s_next_range = 0;
+
+    RunOnAllThreads(ProcessRanges, s_range_count);
+
+    // The workers are done, so binning the triangles can flush them
+    for (size_t i = 0; i < s_range_count; ++i)
+      SubmitRange(&s_ranges[i]);
+
+    begin = end;
+  }
+
+  s_range_function = nullptr;
+}
+
+static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
+                                  const OutputVertexData* v2,
+                                  const BPFunctions::ScissorRect& scissor)
+{
+  // The zslope should be updated now, even if the triangle is rejected by the scissor test, as
+  // zfreeze depends on it
+  UpdateZSlope(v0, v1, v2, scissor.x_off, scissor.y_off);
+
+  // adapted from http://devmaster.net/posts/6145/advanced-rasterization
+
+  // 28.4 fixed-point coordinates. rounded to nearest and adjusted to match hardware output
+  // could also take floor and adjust -8
+  const s32 Y1 = iround(16.0f * (v0->screenPosition.y - scissor.y_off)) - 9;
+  const s32 Y2 = iround(16.0f * (v1->screenPosition.y - scissor.y_off)) - 9;
+  const s32 Y3 = iround(16.0f * (v2->screenPosition.y - scissor.y_off)) - 9;
+
+  const s32 X1 = iround(16.0f * (v0->screenPosition.x - scissor.x_off)) - 9;
+  const s32 X2 = iround(16.0f * (v1->screenPosition.x - scissor.x_off)) - 9;
+  const s32 X3 = iround(16.0f * (v2->screenPosition.x - scissor.x_off)) - 9;
+
+  Triangle triangle;
+
+  // Deltas
+  const s32 DX12 = triangle.DX12 = X1 - X2;
+  const s32 DX23 = triangle.DX23 = X2 - X3;
+  const s32 DX31 = triangle.DX31 = X3 - X1;
+
+  const s32 DY12 = triangle.DY12 = Y1 - Y2;
+  const s32 DY23 = triangle.DY23 = Y2 - Y3;
+  const s32 DY31 = triangle.DY31 = Y3 - Y1;
+
+  // Bounding rectangle
+  s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
+  s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
+  s32 miny = (std::min(std::min(Y1, Y2), Y3) + 0xF) >> 4;
+  s32 maxy = (std::max(std::max(Y1, Y2), Y3) + 0xF) >> 4;
+
+  // scissor
+  ASSERT(scissor.rect.left >= 0);
+  ASSERT(scissor.rect.right <= static_cast<int>(EFB_WIDTH));
+  ASSERT(scissor.rect.top >= 0);
+  ASSERT(scissor.rect.bottom <= static_cast<int>(EFB_HEIGHT));
+
+  minx = std::max(minx, scissor.rect.left);
+  maxx = std::min(maxx, scissor.rect.right);
+  miny = std::max(miny, scissor.rect.top);
+  maxy = std::min(maxy, scissor.rect.bottom);
+
+  if (minx >= maxx || miny >= maxy)
+    return;
+
+  triangle.minx = minx;
+  triangle.maxx = maxx;
+  triangle.miny = miny;
+  triangle.maxy = maxy;
+
+  // Set up the remaining slopes
+  const SlopeContext ctx(v0, v1, v2, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4, scissor.x_off,
+                         scissor.y_off);
+
+  triangle.ZSlope = s_current_range->z_slope.value_or(ZSlope);
+
+  float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
+                1.0f / v2->projectedPosition.w};
+  triangle.WSlope = Slope(w[0], w[1], w[2], ctx);
+
+  for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
+  {
+    for (int comp = 0; comp < 4; comp++)
+    {
+      triangle.ColorSlopes[i][comp] =
+          Slope(v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], ctx);
+    }
+  }
+
+  for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
+  {
+    for (int comp = 0; comp < 3; comp++)
+    {
+      triangle.TexSlopes[i][comp] =
+          Slope(v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
+                v2->texCoords[i][comp] * w[2], ctx);
+    }
+  }
+
+  // Half-edge constants
+  s32 C1 = DY12 * X1 - DX12 * Y1;
+  s32 C2 = DY23 * X2 - DX23 * Y2;
+  s32 C3 = DY31 * X3 - DX31 * Y3;
+
+  // Correct for fill convention
+  if (DY12 < 0 || (DY12 == 0 && DX12 > 0))
+    C1++;
+  if (DY23 < 0 || (DY23 == 0 && DX23 > 0))
+    C2++;
+  if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
+    C3++;
+
+  triangle.C1 = C1;
+  triangle.C2 = C2;
+  triangle.C3 = C3;
+
+  s_current_range->triangles.push_back(triangle);
+}
+
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2)
 {
-  INCSTAT(g_stats.this_frame.num_triangles_drawn);
+  INCSTAT(s_current_range->statistics.num_triangles_drawn);
 
   for (const auto& scissor : scissors)
     DrawTriangleFrontFace(v0, v1, v2, scissor);
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "Common/CommonTypes.h"
 
 struct OutputVertexData;
@@ -10,13 +12,36 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 void ScissorChanged();
 
+// Calls function on consecutive ranges of [0, count), each at most range_size long, using all of
+// the threads which draw triangles. The triangles which function draws for a range are binned
+// after those of the ranges before it, so the result is the same as if the ranges had been
+// processed in order on one thread.
+void RunInParallel(u32 count, u32 range_size, const std::function<void(u32, u32)>& function);
+
+// Statistics of the primitives which are set up in a range
+struct SetupStatistics
+{
+  int num_triangles_in = 0;
+  int num_triangles_rejected = 0;
+  int num_triangles_culled = 0;
+  int num_triangles_clipped = 0;
+  int num_triangles_drawn = 0;
+};
+
+// These may only be called from a function passed to RunInParallel
+SetupStatistics& GetSetupStatistics();
 void UpdateZSlope(const OutputVertexData* v0, const OutputVertexData* v1,
                   const OutputVertexData* v2, s32 x_off, s32 y_off);
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
 
+// Draws the triangles which have been submitted. Must be called before the render state changes
+// and before anything else accesses the EFB.
+void Flush();
+
 void SetTevKonstColors();
 
 struct RasterBlockPixel
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <array>
+#include <mutex>
 
 #include "Common/CommonTypes.h"
 
@@ -14,6 +15,12 @@ namespace
 {
 // Current bounding box coordinates.
 std::array<u16, 4> s_coordinates{};
+std::mutex s_mutex;
+
+constexpr std::array<u16, 4> NO_UPDATES{0xFFFF, 0, 0xFFFF, 0};
+
+// The rasterizer draws on several threads, so each thread collects updates on its own
+thread_local std::array<u16, 4> s_pending_coordinates = NO_UPDATES;
 }  // Anonymous namespace
 
 u16 GetCoordinate(Coordinate coordinate)
@@ -28,15 +35,32 @@ void SetCoordinate(Coordinate coordinate, u16 value)
 
 void Update(u16 left, u16 right, u16 top, u16 bottom)
 {
-  const u16 new_left = std::min(left, GetCoordinate(Coordinate::Left));
-  const u16 new_right = std::max(right, GetCoordinate(Coordinate::Right));
-  const u16 new_top = std::min(top, GetCoordinate(Coordinate::Top));
-  const u16 new_bottom = std::max(bottom, GetCoordinate(Coordinate::Bottom));
-
-  SetCoordinate(Coordinate::Left, new_left);
-  SetCoordinate(Coordinate::Right, new_right);
-  SetCoordinate(Coordinate::Top, new_top);
-  SetCoordinate(Coordinate::Bottom, new_bottom);
+  s_pending_coordinates[0] = std::min(left, s_pending_coordinates[0]);
+  s_pending_coordinates[1] = std::max(right, s_pending_coordinates[1]);
+  s_pending_coordinates[2] = std::min(top, s_pending_coordinates[2]);
+  s_pending_coordinates[3] = std::max(bottom, s_pending_coordinates[3]);
+}
+
+void FlushUpdates()
+{
+  if (s_pending_coordinates == NO_UPDATES)
+    return;
+
+  {
+    std::lock_guard lk(s_mutex);
+
+    const u16 new_left = std::min(s_pending_coordinates[0], GetCoordinate(Coordinate::Left));
+    const u16 new_right = std::max(s_pending_coordinates[1], GetCoordinate(Coordinate::Right));
+    const u16 new_top = std::min(s_pending_coordinates[2], GetCoordinate(Coordinate::Top));
+    const u16 new_bottom = std::max(s_pending_coordinates[3], GetCoordinate(Coordinate::Bottom));
+
+    SetCoordinate(Coordinate::Left, new_left);
+    SetCoordinate(Coordinate::Right, new_right);
+    SetCoordinate(Coordinate::Top, new_top);
+    SetCoordinate(Coordinate::Bottom, new_bottom);
+  }
+
+  s_pending_coordinates = NO_UPDATES;
 }
 
 }  // namespace BBoxManager
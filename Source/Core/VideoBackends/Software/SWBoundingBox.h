@@ -26,6 +26,10 @@ void SetCoordinate(Coordinate coordinate, u16 value);
 
 // Updates all bounding box coordinates.
 void Update(u16 left, u16 right, u16 top, u16 bottom);
+
+// Applies the updates made on this thread. Must be called by every thread drawing pixels when it's
+// done drawing.
+void FlushUpdates();
 }  // namespace BBoxManager
 
 namespace SW
@@ -26,7 +26,7 @@ SWGfx::~SWGfx() = default;
 
 bool SWGfx::IsHeadless() const
 {
-  return m_window->IsHeadless();
+  return !m_window || m_window->IsHeadless();
 }
 
 bool SWGfx::SupportsUtilityDrawing() const
@@ -57,6 +57,10 @@ SWGfx::CreateFramebuffer(AbstractTexture* color_attachment, AbstractTexture* dep
 
 bool SWGfx::BindBackbuffer(const ClearColor& clear_color)
 {
+  // Without a window, there is nothing to present to
+  if (!m_window)
+    return false;
+
   // Look for framebuffer resizes
   if (!g_presenter->SurfaceResizedTestAndClear())
     return true;
@@ -135,6 +139,9 @@ void SWGfx::SetScissorRect(const MathUtil::Rectangle<int>& rc)
 
 SurfaceInfo SWGfx::GetSurfaceInfo() const
 {
+  if (!m_window)
+    return {1, 1, 1.0f, AbstractTextureFormat::RGBA8};
+
   GLContext* context = m_window->GetContext();
   return {std::max(context->GetBackBufferWidth(), 1u), std::max(context->GetBackBufferHeight(), 1u),
           1.0f, AbstractTextureFormat::RGBA8};
@@ -12,6 +12,7 @@ namespace SW
 class SWGfx final : public AbstractGfx
 {
 public:
+  // window is null when there is nothing to present to
   explicit SWGfx(std::unique_ptr<SWOGLWindow> window);
   ~SWGfx() override;
 
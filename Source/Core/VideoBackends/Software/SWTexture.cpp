@@ -133,6 +133,23 @@ void SWStagingTexture::CopyFromTexture(const AbstractTexture* src,
   m_needs_flush = true;
 }
 
+bool SWStagingTexture::CopyFromTextureScaled(const AbstractTexture* src,
+                                             const MathUtil::Rectangle<int>& src_rect,
+                                             u32 src_layer, u32 src_level,
+                                             const MathUtil::Rectangle<int>& dst_rect)
+{
+  if (src->GetFormat() != m_config.format || m_texel_size != sizeof(Pixel))
+    return false;
+
+  const MathUtil::Rectangle<int> src_level_rect = src->GetConfig().GetMipRect(src_level);
+  CopyRegion(reinterpret_cast<const Pixel*>(
+                 static_cast<const SWTexture*>(src)->GetData(src_layer, src_level)),
+             src_rect, src_level_rect.GetWidth(), src_level_rect.GetHeight(),
+             reinterpret_cast<Pixel*>(m_data.data()), dst_rect, m_config.width, m_config.height);
+  m_needs_flush = true;
+  return true;
+}
+
 void SWStagingTexture::CopyToTexture(const MathUtil::Rectangle<int>& src_rect, AbstractTexture* dst,
                                      const MathUtil::Rectangle<int>& dst_rect, u32 dst_layer,
                                      u32 dst_level)
@@ -45,6 +45,9 @@ public:
   void CopyFromTexture(const AbstractTexture* src, const MathUtil::Rectangle<int>& src_rect,
                        u32 src_layer, u32 src_level,
                        const MathUtil::Rectangle<int>& dst_rect) override;
+  bool CopyFromTextureScaled(const AbstractTexture* src, const MathUtil::Rectangle<int>& src_rect,
+                             u32 src_layer, u32 src_level,
+                             const MathUtil::Rectangle<int>& dst_rect) override;
   void CopyToTexture(const MathUtil::Rectangle<int>& src_rect, AbstractTexture* dst,
                      const MathUtil::Rectangle<int>& dst_rect, u32 dst_layer,
                      u32 dst_level) override;
@@ -3,6 +3,8 @@
 
 #include "VideoBackends/Software/SWVertexLoader.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <limits>
 
@@ -15,6 +17,7 @@
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Rasterizer.h"
 #include "VideoBackends/Software/SWRenderer.h"
+#include "VideoBackends/Software/SetupUnit.h"
 #include "VideoBackends/Software/Tev.h"
 #include "VideoBackends/Software/TransformUnit.h"
 
@@ -66,45 +69,95 @@ void SWVertexLoader::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 base_
   if (g_bounding_box->IsEnabled())
     g_bounding_box->Flush();
 
-  m_setup_unit.Init(primitive_type);
   Rasterizer::SetTevKonstColors();
 
-  for (u32 i = 0; i < m_index_generator.GetIndexLen(); i++)
-  {
-    const u16 index = m_cpu_index_buffer[i];
-    memset(static_cast<void*>(&m_vertex), 0, sizeof(m_vertex));
+  TransformVertices();
+  SetUpPrimitives(primitive_type);
 
-    // parse the videocommon format to our own struct format (m_vertex)
-    SetFormat();
-    ParseVertex(VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration(), index);
+  ADDSTAT(g_stats.this_frame.num_vertices_loaded, m_index_generator.GetIndexLen());
 
-    // transform this vertex so that it can be used for rasterization (outVertex)
-    OutputVertexData* outVertex = m_setup_unit.GetVertex();
-    TransformUnit::TransformPosition(&m_vertex, outVertex);
-    TransformUnit::TransformNormal(&m_vertex, outVertex);
-    TransformUnit::TransformColor(&m_vertex, outVertex);
-    TransformUnit::TransformTexCoord(&m_vertex, outVertex);
+  // The render state may change after this batch, so draw its triangles now
+  Rasterizer::Flush();
 
-    // assemble and rasterize the primitive
-    m_setup_unit.SetupVertex();
+  INCSTAT(g_stats.this_frame.num_drawn_objects);
+}
 
-    INCSTAT(g_stats.this_frame.num_vertices_loaded);
-  }
+void SWVertexLoader::TransformVertices()
+{
+  const u32 num_vertices = m_index_generator.GetNumVerts();
+  if (m_transformed_vertices.size() < num_vertices)
+    m_transformed_vertices.resize(num_vertices);
+
+  InputVertexData format{};
+  SetFormat(&format);
+  const PortableVertexDeclaration& vdec =
+      VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration();
+
+  Rasterizer::RunInParallel(num_vertices, VERTICES_PER_RANGE, [&](u32 begin, u32 end) {
+    // parse the videocommon format to our own struct format
+    std::array<InputVertexData, VERTICES_PER_RANGE> input;
+    for (u32 i = begin; i < end; ++i)
+    {
+      input[i - begin] = format;
+      ParseVertex(vdec, i, &input[i - begin]);
+    }
 
-  INCSTAT(g_stats.this_frame.num_drawn_objects);
+    // transform the vertices so that they can be used for rasterization
+    OutputVertexData* output = &m_transformed_vertices[begin];
+    const u32 count = end - begin;
+    std::fill_n(output, count, OutputVertexData{});
+
+    TransformUnit::TransformPositions(input.data(), output, count);
+    for (u32 i = 0; i < count; ++i)
+    {
+      TransformUnit::TransformNormal(&input[i], &output[i]);
+      TransformUnit::TransformColor(&input[i], &output[i]);
+      TransformUnit::TransformTexCoord(&input[i], &output[i]);
+    }
+  });
+}
+
+void SWVertexLoader::SetUpPrimitives(OpcodeDecoder::Primitive primitive_type)
+{
+  using OpcodeDecoder::Primitive;
+
+  // Every range is set up by a SetupUnit of its own, so it has to start with a new primitive.
+  // Strips can't be split up, but the index generator only produces them with primitive restart,
+  // which isn't supported.
+  const u32 num_indices = m_index_generator.GetIndexLen();
+  u32 indices_per_primitive = std::max(num_indices, 1u);
+  if (primitive_type == Primitive::GX_DRAW_POINTS)
+    indices_per_primitive = 1;
+  else if (primitive_type == Primitive::GX_DRAW_LINES)
+    indices_per_primitive = 2;
+  else if (primitive_type == Primitive::GX_DRAW_TRIANGLES)
+    indices_per_primitive = 3;
+
+  const u32 num_primitives = num_indices / indices_per_primitive;
+  Rasterizer::RunInParallel(num_primitives, PRIMITIVES_PER_RANGE, [&](u32 begin, u32 end) {
+    SetupUnit setup_unit;
+    setup_unit.Init(primitive_type);
+
+    // assemble and rasterize the primitives
+    for (u32 i = begin * indices_per_primitive; i < end * indices_per_primitive; ++i)
+    {
+      *setup_unit.GetVertex() = m_transformed_vertices[m_cpu_index_buffer[i]];
+      setup_unit.SetupVertex();
+    }
+  });
 }
 
-void SWVertexLoader::SetFormat()
+void SWVertexLoader::SetFormat(InputVertexData* vertex)
 {
-  m_vertex.posMtx = xfmem.MatrixIndexA.PosNormalMtxIdx;
-  m_vertex.texMtx[0] = xfmem.MatrixIndexA.Tex0MtxIdx;
-  m_vertex.texMtx[1] = xfmem.MatrixIndexA.Tex1MtxIdx;
-  m_vertex.texMtx[2] = xfmem.MatrixIndexA.Tex2MtxIdx;
-  m_vertex.texMtx[3] = xfmem.MatrixIndexA.Tex3MtxIdx;
-  m_vertex.texMtx[4] = xfmem.MatrixIndexB.Tex4MtxIdx;
-  m_vertex.texMtx[5] = xfmem.MatrixIndexB.Tex5MtxIdx;
-  m_vertex.texMtx[6] = xfmem.MatrixIndexB.Tex6MtxIdx;
-  m_vertex.texMtx[7] = xfmem.MatrixIndexB.Tex7MtxIdx;
+  vertex->posMtx = xfmem.MatrixIndexA.PosNormalMtxIdx;
+  vertex->texMtx[0] = xfmem.MatrixIndexA.Tex0MtxIdx;
+  vertex->texMtx[1] = xfmem.MatrixIndexA.Tex1MtxIdx;
+  vertex->texMtx[2] = xfmem.MatrixIndexA.Tex2MtxIdx;
+  vertex->texMtx[3] = xfmem.MatrixIndexA.Tex3MtxIdx;
+  vertex->texMtx[4] = xfmem.MatrixIndexB.Tex4MtxIdx;
+  vertex->texMtx[5] = xfmem.MatrixIndexB.Tex5MtxIdx;
+  vertex->texMtx[6] = xfmem.MatrixIndexB.Tex6MtxIdx;
+  vertex->texMtx[7] = xfmem.MatrixIndexB.Tex7MtxIdx;
 }
 
 template <typename T, typename I>
@@ -195,55 +248,56 @@ static void ParseColorAttributes(InputVertexData* dst, DataReader& src,
   }
 }
 
-void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec, int index)
+void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec, int index,
+                                 InputVertexData* vertex)
 {
   DataReader src(m_cpu_vertex_buffer.data(),
                  m_cpu_vertex_buffer.data() + m_cpu_vertex_buffer.size());
   src.Skip(index * vdec.stride);
 
-  ReadVertexAttribute<float>(&m_vertex.position[0], src, vdec.position, 0, 3, false);
+  ReadVertexAttribute<float>(&vertex->position[0], src, vdec.position, 0, 3, false);
 
-  for (std::size_t i = 0; i < m_vertex.normal.size(); i++)
+  for (std::size_t i = 0; i < vertex->normal.size(); i++)
   {
-    ReadVertexAttribute<float>(&m_vertex.normal[i][0], src, vdec.normals[i], 0, 3, false);
+    ReadVertexAttribute<float>(&vertex->normal[i][0], src, vdec.normals[i], 0, 3, false);
   }
   if (!vdec.normals[0].enable)
   {
     auto& system = Core::System::GetInstance();
     auto& vertex_shader_manager = system.GetVertexShaderManager();
-    m_vertex.normal[0][0] = vertex_shader_manager.constants.cached_normal[0];
-    m_vertex.normal[0][1] = vertex_shader_manager.constants.cached_normal[1];
-    m_vertex.normal[0][2] = vertex_shader_manager.constants.cached_normal[2];
+    vertex->normal[0][0] = vertex_shader_manager.constants.cached_normal[0];
+    vertex->normal[0][1] = vertex_shader_manager.constants.cached_normal[1];
+    vertex->normal[0][2] = vertex_shader_manager.constants.cached_normal[2];
   }
   if (!vdec.normals[1].enable)
   {
     auto& system = Core::System::GetInstance();
     auto& vertex_shader_manager = system.GetVertexShaderManager();
-    m_vertex.normal[1][0] = vertex_shader_manager.constants.cached_tangent[0];
-    m_vertex.normal[1][1] = vertex_shader_manager.constants.cached_tangent[1];
-    m_vertex.normal[1][2] = vertex_shader_manager.constants.cached_tangent[2];
+    vertex->normal[1][0] = vertex_shader_manager.constants.cached_tangent[0];
+    vertex->normal[1][1] = vertex_shader_manager.constants.cached_tangent[1];
+    vertex->normal[1][2] = vertex_shader_manager.constants.cached_tangent[2];
   }
   if (!vdec.normals[2].enable)
   {
     auto& system = Core::System::GetInstance();
     auto& vertex_shader_manager = system.GetVertexShaderManager();
-    m_vertex.normal[2][0] = vertex_shader_manager.constants.cached_binormal[0];
-    m_vertex.normal[2][1] = vertex_shader_manager.constants.cached_binormal[1];
-    m_vertex.normal[2][2] = vertex_shader_manager.constants.cached_binormal[2];
+    vertex->normal[2][0] = vertex_shader_manager.constants.cached_binormal[0];
+    vertex->normal[2][1] = vertex_shader_manager.constants.cached_binormal[1];
+    vertex->normal[2][2] = vertex_shader_manager.constants.cached_binormal[2];
   }
 
-  ParseColorAttributes(&m_vertex, src, vdec);
+  ParseColorAttributes(vertex, src, vdec);
 
-  for (std::size_t i = 0; i < m_vertex.texCoords.size(); i++)
+  for (std::size_t i = 0; i < vertex->texCoords.size(); i++)
   {
-    ReadVertexAttribute<float>(m_vertex.texCoords[i].data(), src, vdec.texcoords[i], 0, 2, false);
+    ReadVertexAttribute<float>(vertex->texCoords[i].data(), src, vdec.texcoords[i], 0, 2, false);
 
     // the texmtr is stored as third component of the texCoord
     if (vdec.texcoords[i].components >= 3)
     {
-      ReadVertexAttribute<u8>(&m_vertex.texMtx[i], src, vdec.texcoords[i], 2, 1, false);
+      ReadVertexAttribute<u8>(&vertex->texMtx[i], src, vdec.texcoords[i], 2, 1, false);
     }
   }
 
-  ReadVertexAttribute<u8>(&m_vertex.posMtx, src, vdec.posmtx, 0, 1, false);
+  ReadVertexAttribute<u8>(&vertex->posMtx, src, vdec.posmtx, 0, 1, false);
 }
@@ -9,7 +9,6 @@
 #include "Common/CommonTypes.h"
 
 #include "VideoBackends/Software/NativeVertexFormat.h"
-#include "VideoBackends/Software/SetupUnit.h"
 
 #include "VideoCommon/VertexManagerBase.h"
 
@@ -25,9 +24,17 @@ public:
 protected:
   void DrawCurrentBatch(u32 base_index, u32 num_indices, u32 base_vertex) override;
 
-  void SetFormat();
-  void ParseVertex(const PortableVertexDeclaration& vdec, int index);
+  // Vertices are transformed and primitives set up in ranges of these sizes, which are spread
+  // across the threads of the rasterizer
+  static constexpr u32 VERTICES_PER_RANGE = 256;
+  static constexpr u32 PRIMITIVES_PER_RANGE = 128;
 
-  InputVertexData m_vertex{};
-  SetupUnit m_setup_unit;
+  void TransformVertices();
+  void SetUpPrimitives(OpcodeDecoder::Primitive primitive_type);
+
+  static void SetFormat(InputVertexData* vertex);
+  void ParseVertex(const PortableVertexDeclaration& vdec, int index, InputVertexData* vertex);
+
+  // Every vertex of the current batch, transformed once no matter how many primitives use it
+  std::vector<OutputVertexData> m_transformed_vertices;
 };
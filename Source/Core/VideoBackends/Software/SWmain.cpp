@@ -12,8 +12,8 @@
 #include "Common/CommonTypes.h"
 #include "Common/GL/GLContext.h"
 #include "Common/MsgHandler.h"
+#include "Common/WindowSystemInfo.h"
 
-#include "VideoBackends/Software/Clipper.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/Rasterizer.h"
 #include "VideoBackends/Software/SWBoundingBox.h"
@@ -71,7 +71,7 @@ void VideoSoftware::InitBackendInfo(const WindowSystemInfo& wsi)
   g_Config.backend_info.bSupportsDualSourceBlend = true;
   g_Config.backend_info.bSupportsEarlyZ = true;
   g_Config.backend_info.bSupportsPrimitiveRestart = false;
-  g_Config.backend_info.bSupportsMultithreading = false;
+  g_Config.backend_info.bSupportsMultithreading = true;
   g_Config.backend_info.bSupportsComputeShaders = false;
   g_Config.backend_info.bSupportsGPUTextureDecoding = false;
   g_Config.backend_info.bSupportsST3CTextures = false;
@@ -99,11 +99,16 @@ void VideoSoftware::InitBackendInfo(const WindowSystemInfo& wsi)
 
 bool VideoSoftware::Initialize(const WindowSystemInfo& wsi)
 {
-  std::unique_ptr<SWOGLWindow> window = SWOGLWindow::Create(wsi);
-  if (!window)
-    return false;
+  // Headless frames only go to frame dumping, which reads the XFB straight from the CPU-side
+  // texture, so no OpenGL context is needed for them
+  std::unique_ptr<SWOGLWindow> window;
+  if (wsi.type != WindowSystemType::Headless)
+  {
+    window = SWOGLWindow::Create(wsi);
+    if (!window)
+      return false;
+  }
 
-  Clipper::Init();
   Rasterizer::Init();
 
   return InitializeShared(std::make_unique<SWGfx>(std::move(window)),
@@ -114,6 +119,7 @@ bool VideoSoftware::Initialize(const WindowSystemInfo& wsi)
 
 void VideoSoftware::Shutdown()
 {
+  Rasterizer::Shutdown();
   ShutdownShared();
 }
 }  // namespace SW
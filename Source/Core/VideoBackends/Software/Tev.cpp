@@ -4,8 +4,10 @@
 #include "VideoBackends/Software/Tev.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
+#include <utility>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -18,21 +20,10 @@
 
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelShaderManager.h"
-#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
-static inline s16 Clamp255(s16 in)
-{
-  return std::clamp<s16>(in, 0, 255);
-}
-
-static inline s16 Clamp1024(s16 in)
-{
-  return std::clamp<s16>(in, -1024, 1023);
-}
-
 void Tev::SetRasColor(RasColorChan colorChan, u32 swaptable)
 {
   switch (colorChan)
@@ -79,119 +70,6 @@ void Tev::SetRasColor(RasColorChan colorChan, u32 swaptable)
   }
 }
 
-void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
-{
-  for (int i = BLU_C; i <= RED_C; i++)
-  {
-    const InputRegType& InputReg = inputs[i];
-
-    const u16 c = InputReg.c + (InputReg.c >> 7);
-
-    s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-    temp <<= s_ScaleLShiftLUT[cc.scale];
-    temp += (cc.scale == TevScale::Divide2) ? 0 : (cc.op == TevOp::Sub) ? 127 : 128;
-    temp >>= 8;
-    temp = cc.op == TevOp::Sub ? -temp : temp;
-
-    s32 result = ((InputReg.d + s_BiasLUT[cc.bias]) << s_ScaleLShiftLUT[cc.scale]) + temp;
-    result = result >> s_ScaleRShiftLUT[cc.scale];
-
-    Reg[cc.dest][i] = result;
-  }
-}
-
-void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
-{
-  for (int i = BLU_C; i <= RED_C; i++)
-  {
-    u32 a, b;
-    switch (cc.compare_mode)
-    {
-    case TevCompareMode::R8:
-      a = inputs[RED_C].a;
-      b = inputs[RED_C].b;
-      break;
-
-    case TevCompareMode::GR16:
-      a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      break;
-
-    case TevCompareMode::BGR24:
-      a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      break;
-
-    case TevCompareMode::RGB8:
-      a = inputs[i].a;
-      b = inputs[i].b;
-      break;
-
-    default:
-      PanicAlertFmt("Invalid compare mode {}", cc.compare_mode);
-      continue;
-    }
-
-    if (cc.comparison == TevComparison::GT)
-      Reg[cc.dest][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
-    else
-      Reg[cc.dest][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
-  }
-}
-
-void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
-{
-  const InputRegType& InputReg = inputs[ALP_C];
-
-  const u16 c = InputReg.c + (InputReg.c >> 7);
-
-  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-  temp <<= s_ScaleLShiftLUT[ac.scale];
-  temp += (ac.scale == TevScale::Divide2) ? 0 : (ac.op == TevOp::Sub) ? 127 : 128;
-  temp = ac.op == TevOp::Sub ? (-temp >> 8) : (temp >> 8);
-
-  s32 result = ((InputReg.d + s_BiasLUT[ac.bias]) << s_ScaleLShiftLUT[ac.scale]) + temp;
-  result = result >> s_ScaleRShiftLUT[ac.scale];
-
-  Reg[ac.dest].a = result;
-}
-
-void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
-{
-  u32 a, b;
-  switch (ac.compare_mode)
-  {
-  case TevCompareMode::R8:
-    a = inputs[RED_C].a;
-    b = inputs[RED_C].b;
-    break;
-
-  case TevCompareMode::GR16:
-    a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    break;
-
-  case TevCompareMode::BGR24:
-    a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    break;
-
-  case TevCompareMode::A8:
-    a = inputs[ALP_C].a;
-    b = inputs[ALP_C].b;
-    break;
-
-  default:
-    PanicAlertFmt("Invalid compare mode {}", ac.compare_mode);
-    return;
-  }
-
-  if (ac.comparison == TevComparison::GT)
-    Reg[ac.dest].a = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
-  else
-    Reg[ac.dest].a = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
-}
-
 static bool AlphaCompare(int alpha, int ref, CompareMode comp)
 {
   switch (comp)
@@ -391,7 +269,7 @@ void Tev::Draw()
   ASSERT(Position[0] >= 0 && Position[0] < s32(EFB_WIDTH));
   ASSERT(Position[1] >= 0 && Position[1] < s32(EFB_HEIGHT));
 
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
+  ++PixelsIn;
 
   auto& system = Core::System::GetInstance();
   auto& pixel_shader_manager = system.GetPixelShaderManager();
@@ -431,26 +309,12 @@ void Tev::Draw()
 
   for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
   {
-    const int stageNum2 = stageNum >> 1;
-    const int stageOdd = stageNum & 1;
-    const TwoTevStageOrders& order = bpmem.tevorders[stageNum2];
-
-    // stage combiners
-    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
-    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+    const StageState& stage = m_stages[stageNum];
 
-    u32 texcoordSel = order.getTexCoord(stageOdd);
-    const u32 texmap = order.getTexMap(stageOdd);
-
-    // Quirk: when the tex coord is not less than the number of tex gens (i.e. the tex coord does
-    // not exist), then tex coord 0 is used (though sometimes glitchy effects happen on console).
-    if (texcoordSel >= bpmem.genMode.numtexgens)
-      texcoordSel = 0;
-
-    Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
+    Indirect(stageNum, Uv[stage.texcoord].s, Uv[stage.texcoord].t);
 
     // sample texture
-    if (order.getEnable(stageOdd))
+    if (stage.texture_enabled)
     {
       // RGBA
       u8 texel[4];
@@ -458,7 +322,7 @@ void Tev::Draw()
       if (bpmem.genMode.numtexgens > 0)
       {
         TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum],
-                               TextureLinear[stageNum], texmap, texel);
+                               TextureLinear[stageNum], stage.texmap, texel);
       }
       else
       {
@@ -467,70 +331,42 @@ void Tev::Draw()
         std::memset(texel, 0, 4);
       }
 
-      const auto& swap = bpmem.tevksel.GetSwapTable(ac.tswap);
-      TexColor.r = texel[u32(swap[ColorChannel::Red])];
-      TexColor.g = texel[u32(swap[ColorChannel::Green])];
-      TexColor.b = texel[u32(swap[ColorChannel::Blue])];
-      TexColor.a = texel[u32(swap[ColorChannel::Alpha])];
+      TexColor.r = texel[stage.texture_swap[RED_C]];
+      TexColor.g = texel[stage.texture_swap[GRN_C]];
+      TexColor.b = texel[stage.texture_swap[BLU_C]];
+      TexColor.a = texel[stage.texture_swap[ALP_C]];
     }
 
     // set konst for this stage
-    const auto kc = bpmem.tevksel.GetKonstColor(stageNum);
-    const auto ka = bpmem.tevksel.GetKonstAlpha(stageNum);
-    StageKonst.r = m_KonstLUT[kc].r;
-    StageKonst.g = m_KonstLUT[kc].g;
-    StageKonst.b = m_KonstLUT[kc].b;
-    StageKonst.a = m_KonstLUT[ka].a;
+    StageKonst.r = stage.color_konst->r;
+    StageKonst.g = stage.color_konst->g;
+    StageKonst.b = stage.color_konst->b;
+    StageKonst.a = stage.alpha_konst->a;
 
     // set color
-    SetRasColor(order.getColorChan(stageOdd), ac.rswap);
+    SetRasColor(stage.ras_channel, stage.ras_swap);
 
     // combine inputs
-    InputRegType inputs[4];
-    inputs[BLU_C].a = m_ColorInputLUT[cc.a].b;
-    inputs[BLU_C].b = m_ColorInputLUT[cc.b].b;
-    inputs[BLU_C].c = m_ColorInputLUT[cc.c].b;
-    inputs[BLU_C].d = m_ColorInputLUT[cc.d].b;
-    inputs[GRN_C].a = m_ColorInputLUT[cc.a].g;
-    inputs[GRN_C].b = m_ColorInputLUT[cc.b].g;
-    inputs[GRN_C].c = m_ColorInputLUT[cc.c].g;
-    inputs[GRN_C].d = m_ColorInputLUT[cc.d].g;
-    inputs[RED_C].a = m_ColorInputLUT[cc.a].r;
-    inputs[RED_C].b = m_ColorInputLUT[cc.b].r;
-    inputs[RED_C].c = m_ColorInputLUT[cc.c].r;
-    inputs[RED_C].d = m_ColorInputLUT[cc.d].r;
-    inputs[ALP_C].a = m_AlphaInputLUT[ac.a].a;
-    inputs[ALP_C].b = m_AlphaInputLUT[ac.b].a;
-    inputs[ALP_C].c = m_AlphaInputLUT[ac.c].a;
-    inputs[ALP_C].d = m_AlphaInputLUT[ac.d].a;
-
-    if (cc.bias != TevBias::Compare)
-      DrawColorRegular(cc, inputs);
-    else
-      DrawColorCompare(cc, inputs);
-
-    if (cc.clamp)
-    {
-      Reg[cc.dest].r = Clamp255(Reg[cc.dest].r);
-      Reg[cc.dest].g = Clamp255(Reg[cc.dest].g);
-      Reg[cc.dest].b = Clamp255(Reg[cc.dest].b);
-    }
-    else
+    TevCombiner::Inputs inputs;
+    for (int i = ALP_C; i <= RED_C; i++)
     {
-      Reg[cc.dest].r = Clamp1024(Reg[cc.dest].r);
-      Reg[cc.dest].g = Clamp1024(Reg[cc.dest].g);
-      Reg[cc.dest].b = Clamp1024(Reg[cc.dest].b);
+      inputs.a[i] = *stage.inputs[i][0];
+      inputs.b[i] = *stage.inputs[i][1];
+      inputs.c[i] = *stage.inputs[i][2];
+      inputs.d[i] = *stage.inputs[i][3];
     }
 
-    if (ac.bias != TevBias::Compare)
-      DrawAlphaRegular(ac, inputs);
-    else
-      DrawAlphaCompare(ac, inputs);
+    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
 
-    if (ac.clamp)
-      Reg[ac.dest].a = Clamp255(Reg[ac.dest].a);
-    else
-      Reg[ac.dest].a = Clamp1024(Reg[ac.dest].a);
+    const TevCombiner::Channels result = stage.combiner.is_regular ?
+                                             TevCombiner::Combine(stage.combiner, inputs) :
+                                             TevCombiner::CombineScalar(cc, ac, inputs);
+
+    Reg[cc.dest].r = result[RED_C];
+    Reg[cc.dest].g = result[GRN_C];
+    Reg[cc.dest].b = result[BLU_C];
+    Reg[ac.dest].a = result[ALP_C];
   }
 
   // convert to 8 bits per component
@@ -541,11 +377,20 @@ void Tev::Draw()
   u8 output[4] = {(u8)Reg[alpha_index].a, (u8)Reg[color_index].b, (u8)Reg[color_index].g,
                   (u8)Reg[color_index].r};
 
-  if (!TevAlphaTest(output[ALP_C]))
-    return;
+  (this->*m_output_function)(output);
+}
+
+template <bool AlphaTest, bool ZTex, bool Fog, bool LateZ>
+void Tev::DrawOutput(u8* output)
+{
+  if constexpr (AlphaTest)
+  {
+    if (!m_alpha_test_passes[output[ALP_C]])
+      return;
+  }
 
   // z texture
-  if (bpmem.ztex2.op != ZTexOp::Disabled)
+  if constexpr (ZTex)
   {
     u32 ztex = bpmem.ztex1.bias;
     switch (bpmem.ztex2.type)
@@ -570,7 +415,7 @@ void Tev::Draw()
   }
 
   // fog
-  if (bpmem.fog.c_proj_fsel.fsel != FogType::Off)
+  if constexpr (Fog)
   {
     float ze;
 
@@ -657,12 +502,12 @@ void Tev::Draw()
     output[BLU_C] = (output[BLU_C] * invFog + fogInt * bpmem.fog.color.b) >> 8;
   }
 
-  if (bpmem.GetEmulatedZ() == EmulatedZ::Late)
+  if constexpr (LateZ)
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
     EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
 
-    if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
+    if (!m_z_compare(Position[0], Position[1], Position[2]))
       return;
 
     EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
@@ -673,10 +518,83 @@ void Tev::Draw()
   BBoxManager::Update(static_cast<u16>(Position[0] & ~1), static_cast<u16>(Position[0] | 1),
                       static_cast<u16>(Position[1] & ~1), static_cast<u16>(Position[1] | 1));
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
+  ++PixelsOut;
   EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
 
-  EfbInterface::BlendTev(Position[0], Position[1], output);
+  m_blend_tev(Position[0], Position[1], output);
+}
+
+template <size_t... Indices>
+constexpr auto Tev::MakeOutputFunctions(std::index_sequence<Indices...>)
+{
+  return std::array<OutputFunction, sizeof...(Indices)>{
+      &Tev::DrawOutput<(Indices & 1) != 0, (Indices & 2) != 0, (Indices & 4) != 0,
+                       (Indices & 8) != 0>...};
+}
+
+void Tev::SetUpPipeline()
+{
+  bool alpha_test = false;
+  for (u32 alpha = 0; alpha < m_alpha_test_passes.size(); alpha++)
+  {
+    m_alpha_test_passes[alpha] = TevAlphaTest(alpha);
+    alpha_test |= !m_alpha_test_passes[alpha];
+  }
+
+  const bool ztex = bpmem.ztex2.op != ZTexOp::Disabled;
+  const bool fog = bpmem.fog.c_proj_fsel.fsel != FogType::Off;
+  const bool late_z = bpmem.GetEmulatedZ() == EmulatedZ::Late;
+
+  static constexpr auto output_functions = MakeOutputFunctions(std::make_index_sequence<16>());
+  m_output_function = output_functions[alpha_test | ztex << 1 | fog << 2 | late_z << 3];
+  m_blend_tev = EfbInterface::GetBlendTevFunction();
+  m_z_compare = EfbInterface::GetZCompareFunction();
+
+  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
+  {
+    const int stageOdd = stageNum & 1;
+    const TwoTevStageOrders& order = bpmem.tevorders[stageNum >> 1];
+    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+    StageState& stage = m_stages[stageNum];
+
+    stage.combiner = TevCombiner::SetUpStage(cc, ac);
+
+    stage.texcoord = order.getTexCoord(stageOdd);
+    stage.texmap = order.getTexMap(stageOdd);
+
+    // Quirk: when the tex coord is not less than the number of tex gens (i.e. the tex coord does
+    // not exist), then tex coord 0 is used (though sometimes glitchy effects happen on console).
+    if (stage.texcoord >= bpmem.genMode.numtexgens)
+      stage.texcoord = 0;
+
+    stage.texture_enabled = order.getEnable(stageOdd);
+    const auto& swap = bpmem.tevksel.GetSwapTable(ac.tswap);
+    stage.texture_swap[RED_C] = u32(swap[ColorChannel::Red]);
+    stage.texture_swap[GRN_C] = u32(swap[ColorChannel::Green]);
+    stage.texture_swap[BLU_C] = u32(swap[ColorChannel::Blue]);
+    stage.texture_swap[ALP_C] = u32(swap[ColorChannel::Alpha]);
+
+    stage.ras_channel = order.getColorChan(stageOdd);
+    stage.ras_swap = ac.rswap;
+
+    stage.color_konst = &m_KonstLUT[bpmem.tevksel.GetKonstColor(stageNum)];
+    stage.alpha_konst = &m_KonstLUT[bpmem.tevksel.GetKonstAlpha(stageNum)];
+
+    const std::array<const TevColorRef*, 4> color_inputs{
+        &m_ColorInputLUT[cc.a], &m_ColorInputLUT[cc.b], &m_ColorInputLUT[cc.c],
+        &m_ColorInputLUT[cc.d]};
+    const std::array<const TevAlphaRef*, 4> alpha_inputs{
+        &m_AlphaInputLUT[ac.a], &m_AlphaInputLUT[ac.b], &m_AlphaInputLUT[ac.c],
+        &m_AlphaInputLUT[ac.d]};
+    for (size_t i = 0; i < 4; i++)
+    {
+      stage.inputs[ALP_C][i] = &alpha_inputs[i]->a;
+      stage.inputs[BLU_C][i] = &color_inputs[i]->b;
+      stage.inputs[GRN_C][i] = &color_inputs[i]->g;
+      stage.inputs[RED_C][i] = &color_inputs[i]->r;
+    }
+  }
 }
 
 void Tev::SetKonstColors()
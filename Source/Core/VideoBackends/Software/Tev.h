@@ -4,8 +4,11 @@
 #pragma once
 
 #include <array>
+#include <utility>
 
 #include "Common/EnumMap.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/TevCombiner.h"
 #include "VideoCommon/BPMemory.h"
 
 class Tev
@@ -90,14 +93,6 @@ class Tev
     }
   };
 
-  struct InputRegType
-  {
-    unsigned a : 8;
-    unsigned b : 8;
-    unsigned c : 8;
-    signed d : 11;
-  };
-
   struct TextureCoordinateType
   {
     signed s : 24;
@@ -192,9 +187,37 @@ class Tev
       TevKonstRef::Value(KonstantColors[2].a),  // Konst 2 Alpha
       TevKonstRef::Value(KonstantColors[3].a),  // Konst 3 Alpha
   };
-  static constexpr Common::EnumMap<s16, TevBias::Compare> s_BiasLUT{0, 128, -128, 0};
-  static constexpr Common::EnumMap<u8, TevScale::Divide2> s_ScaleLShiftLUT{0, 1, 2, 0};
-  static constexpr Common::EnumMap<u8, TevScale::Divide2> s_ScaleRShiftLUT{0, 0, 0, 1};
+
+  // The configuration of a TEV stage, which is resolved from bpmem once before drawing instead of
+  // for every pixel
+  struct StageState
+  {
+    TevCombiner::Stage combiner;
+    u32 texcoord;
+    u32 texmap;
+    bool texture_enabled;
+    std::array<u32, 4> texture_swap;  // Index into the texel for each channel of TevColor
+    RasColorChan ras_channel;
+    u32 ras_swap;
+    const TevKonstRef* color_konst;
+    const TevKonstRef* alpha_konst;
+    // The values read by the inputs a, b, c and d for each channel of TevColor
+    std::array<std::array<const s16*, 4>, 4> inputs;
+  };
+  std::array<StageState, 16> m_stages{};
+
+  // The work done for each pixel after the TEV stages is specialized for whether the alpha test can
+  // fail and whether z textures, fog and late depth testing are used
+  using OutputFunction = void (Tev::*)(u8* output);
+  template <bool AlphaTest, bool ZTex, bool Fog, bool LateZ>
+  void DrawOutput(u8* output);
+  template <size_t... Indices>
+  static constexpr auto MakeOutputFunctions(std::index_sequence<Indices...>);
+
+  OutputFunction m_output_function = nullptr;
+  std::array<bool, 256> m_alpha_test_passes{};
+  EfbInterface::BlendTevFunction m_blend_tev = nullptr;
+  EfbInterface::ZCompareFunction m_z_compare = nullptr;
 
   enum BufferBase
   {
@@ -205,11 +228,6 @@ class Tev
 
   void SetRasColor(RasColorChan colorChan, u32 swaptable);
 
-  void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
 public:
@@ -221,6 +239,10 @@ public:
   s32 TextureLod[16]{};
   bool TextureLinear[16]{};
 
+  // Statistics, which are counted here since several Tevs can be drawing at the same time
+  u32 PixelsIn = 0;
+  u32 PixelsOut = 0;
+
   enum
   {
     ALP_C,
@@ -230,5 +252,10 @@ public:
   };
 
   void SetKonstColors();
+
+  // Resolves the configuration of the TEV stages and selects the specialized routines for the rest
+  // of the pixel pipeline. Must be called before drawing whenever bpmem may have changed.
+  void SetUpPipeline();
+
   void Draw();
 };
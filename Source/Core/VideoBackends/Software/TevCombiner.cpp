@@ -0,0 +1,349 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoBackends/Software/TevCombiner.h"
+
+#include <algorithm>
+
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
+#include "Common/CommonTypes.h"
+#include "Common/EnumMap.h"
+#include "Common/MsgHandler.h"
+
+namespace TevCombiner
+{
+namespace
+{
+enum
+{
+  ALP_C,
+  BLU_C,
+  GRN_C,
+  RED_C
+};
+
+constexpr Common::EnumMap<s16, TevBias::Compare> s_BiasLUT{0, 128, -128, 0};
+constexpr Common::EnumMap<u8, TevScale::Divide2> s_ScaleLShiftLUT{0, 1, 2, 0};
+constexpr Common::EnumMap<u8, TevScale::Divide2> s_ScaleRShiftLUT{0, 0, 0, 1};
+
+struct InputRegType
+{
+  unsigned a : 8;
+  unsigned b : 8;
+  unsigned c : 8;
+  signed d : 11;
+};
+
+void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                      Channels* out)
+{
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    const InputRegType& InputReg = inputs[i];
+
+    const u16 c = InputReg.c + (InputReg.c >> 7);
+
+    s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
+    temp <<= s_ScaleLShiftLUT[cc.scale];
+    temp += (cc.scale == TevScale::Divide2) ? 0 : (cc.op == TevOp::Sub) ? 127 : 128;
+    temp >>= 8;
+    temp = cc.op == TevOp::Sub ? -temp : temp;
+
+    s32 result = ((InputReg.d + s_BiasLUT[cc.bias]) << s_ScaleLShiftLUT[cc.scale]) + temp;
+    result = result >> s_ScaleRShiftLUT[cc.scale];
+
+    (*out)[i] = result;
+  }
+}
+
+void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                      Channels* out)
+{
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    u32 a, b;
+    switch (cc.compare_mode)
+    {
+    case TevCompareMode::R8:
+      a = inputs[RED_C].a;
+      b = inputs[RED_C].b;
+      break;
+
+    case TevCompareMode::GR16:
+      a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+      b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      break;
+
+    case TevCompareMode::BGR24:
+      a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+      b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      break;
+
+    case TevCompareMode::RGB8:
+      a = inputs[i].a;
+      b = inputs[i].b;
+      break;
+
+    default:
+      PanicAlertFmt("Invalid compare mode {}", cc.compare_mode);
+      continue;
+    }
+
+    if (cc.comparison == TevComparison::GT)
+      (*out)[i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+    else
+      (*out)[i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+  }
+}
+
+void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4],
+                      Channels* out)
+{
+  const InputRegType& InputReg = inputs[ALP_C];
+
+  const u16 c = InputReg.c + (InputReg.c >> 7);
+
+  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
+  temp <<= s_ScaleLShiftLUT[ac.scale];
+  temp += (ac.scale == TevScale::Divide2) ? 0 : (ac.op == TevOp::Sub) ? 127 : 128;
+  temp = ac.op == TevOp::Sub ? (-temp >> 8) : (temp >> 8);
+
+  s32 result = ((InputReg.d + s_BiasLUT[ac.bias]) << s_ScaleLShiftLUT[ac.scale]) + temp;
+  result = result >> s_ScaleRShiftLUT[ac.scale];
+
+  (*out)[ALP_C] = result;
+}
+
+void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4],
+                      Channels* out)
+{
+  u32 a, b;
+  switch (ac.compare_mode)
+  {
+  case TevCompareMode::R8:
+    a = inputs[RED_C].a;
+    b = inputs[RED_C].b;
+    break;
+
+  case TevCompareMode::GR16:
+    a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+    b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    break;
+
+  case TevCompareMode::BGR24:
+    a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+    b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    break;
+
+  case TevCompareMode::A8:
+    a = inputs[ALP_C].a;
+    b = inputs[ALP_C].b;
+    break;
+
+  default:
+    PanicAlertFmt("Invalid compare mode {}", ac.compare_mode);
+    return;
+  }
+
+  if (ac.comparison == TevComparison::GT)
+    (*out)[ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+  else
+    (*out)[ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+}
+
+s16 Clamp255(s16 in)
+{
+  return std::clamp<s16>(in, 0, 255);
+}
+
+s16 Clamp1024(s16 in)
+{
+  return std::clamp<s16>(in, -1024, 1023);
+}
+}  // namespace
+
+Stage SetUpStage(const TevStageCombiner::ColorCombiner& cc,
+                 const TevStageCombiner::AlphaCombiner& ac)
+{
+  Stage stage;
+  stage.is_regular = cc.bias != TevBias::Compare && ac.bias != TevBias::Compare;
+
+  for (int i = ALP_C; i <= RED_C; i++)
+  {
+    const bool is_alpha = i == ALP_C;
+    const TevBias bias = is_alpha ? ac.bias : cc.bias;
+    const TevScale scale = is_alpha ? ac.scale : cc.scale;
+    const TevOp op = is_alpha ? ac.op : cc.op;
+    const bool clamp = is_alpha ? ac.clamp : cc.clamp;
+
+    stage.scale[i] = 1 << s_ScaleLShiftLUT[scale];
+    stage.bias[i] = bias == TevBias::Compare ? 0 : s_BiasLUT[bias];
+    stage.min[i] = clamp ? 0 : -1024;
+    stage.max[i] = clamp ? 255 : 1023;
+    stage.round[i] = scale == TevScale::Divide2 ? 0 : op == TevOp::Sub ? 127 : 128;
+    stage.negate_before[i] = is_alpha && op == TevOp::Sub ? -1 : 0;
+    stage.negate_after[i] = !is_alpha && op == TevOp::Sub ? -1 : 0;
+    stage.divide_by_2[i] = s_ScaleRShiftLUT[scale] ? -1 : 0;
+  }
+
+  return stage;
+}
+
+#if defined(_M_X86) || defined(_M_X86_64)
+
+Channels Combine(const Stage& stage, const Inputs& inputs)
+{
+  // Everything before the final shift fits into 16 bits, except for the lerp, which is calculated
+  // in 32 bits using a multiply-add of a with 256 - c and b with c. SSE2 is all that's needed.
+  const auto load16 = [](const Channels& channels) {
+    return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(channels.data()));
+  };
+  const auto load32 = [](const std::array<s32, 4>& values) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data()));
+  };
+
+  const __m128i mask_8 = _mm_set1_epi16(0xFF);
+  const __m128i scale = load16(stage.scale);
+
+  const __m128i a = _mm_and_si128(load16(inputs.a), mask_8);
+  const __m128i b = _mm_and_si128(load16(inputs.b), mask_8);
+  __m128i c = _mm_and_si128(load16(inputs.c), mask_8);
+  c = _mm_add_epi16(c, _mm_srli_epi16(c, 7));
+  const __m128i inverse_c = _mm_sub_epi16(_mm_set1_epi16(256), c);
+
+  __m128i lerp = _mm_madd_epi16(_mm_unpacklo_epi16(a, b),
+                                _mm_unpacklo_epi16(_mm_mullo_epi16(inverse_c, scale),
+                                                   _mm_mullo_epi16(c, scale)));
+  lerp = _mm_add_epi32(lerp, load32(stage.round));
+  const __m128i negate_before = load32(stage.negate_before);
+  lerp = _mm_sub_epi32(_mm_xor_si128(lerp, negate_before), negate_before);
+  lerp = _mm_srai_epi32(lerp, 8);
+  const __m128i negate_after = load32(stage.negate_after);
+  lerp = _mm_sub_epi32(_mm_xor_si128(lerp, negate_after), negate_after);
+
+  // Sign extend d from 11 bits
+  __m128i d = _mm_srai_epi16(_mm_slli_epi16(load16(inputs.d), 5), 5);
+  d = _mm_mullo_epi16(_mm_add_epi16(d, load16(stage.bias)), scale);
+  d = _mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16);
+
+  __m128i result = _mm_add_epi32(d, lerp);
+  const __m128i divide_by_2 = load32(stage.divide_by_2);
+  result = _mm_or_si128(_mm_andnot_si128(divide_by_2, result),
+                        _mm_and_si128(divide_by_2, _mm_srai_epi32(result, 1)));
+
+  // The registers are 16 bits, so the result is truncated before being clamped
+  result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+  result = _mm_packs_epi32(result, result);
+  result = _mm_max_epi16(result, load16(stage.min));
+  result = _mm_min_epi16(result, load16(stage.max));
+
+  Channels out;
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out.data()), result);
+  return out;
+}
+
+#elif defined(_M_ARM_64)
+
+Channels Combine(const Stage& stage, const Inputs& inputs)
+{
+  const int16x4_t mask_8 = vdup_n_s16(0xFF);
+  const int16x4_t scale = vld1_s16(stage.scale.data());
+
+  const int16x4_t a = vand_s16(vld1_s16(inputs.a.data()), mask_8);
+  const int16x4_t b = vand_s16(vld1_s16(inputs.b.data()), mask_8);
+  int16x4_t c = vand_s16(vld1_s16(inputs.c.data()), mask_8);
+  c = vadd_s16(c, vshr_n_s16(c, 7));
+  const int16x4_t inverse_c = vsub_s16(vdup_n_s16(256), c);
+
+  int32x4_t lerp = vmull_s16(a, vmul_s16(inverse_c, scale));
+  lerp = vmlal_s16(lerp, b, vmul_s16(c, scale));
+  lerp = vaddq_s32(lerp, vld1q_s32(stage.round.data()));
+  const int32x4_t negate_before = vld1q_s32(stage.negate_before.data());
+  lerp = vsubq_s32(veorq_s32(lerp, negate_before), negate_before);
+  lerp = vshrq_n_s32(lerp, 8);
+  const int32x4_t negate_after = vld1q_s32(stage.negate_after.data());
+  lerp = vsubq_s32(veorq_s32(lerp, negate_after), negate_after);
+
+  // Sign extend d from 11 bits
+  int16x4_t d = vshr_n_s16(vshl_n_s16(vld1_s16(inputs.d.data()), 5), 5);
+  d = vmul_s16(vadd_s16(d, vld1_s16(stage.bias.data())), scale);
+
+  int32x4_t result = vaddq_s32(vmovl_s16(d), lerp);
+  result = vbslq_s32(vreinterpretq_u32_s32(vld1q_s32(stage.divide_by_2.data())),
+                     vshrq_n_s32(result, 1), result);
+
+  // The registers are 16 bits, so the result is truncated before being clamped
+  int16x4_t narrowed = vmovn_s32(result);
+  narrowed = vmax_s16(narrowed, vld1_s16(stage.min.data()));
+  narrowed = vmin_s16(narrowed, vld1_s16(stage.max.data()));
+
+  Channels out;
+  vst1_s16(out.data(), narrowed);
+  return out;
+}
+
+#else
+
+Channels Combine(const Stage& stage, const Inputs& inputs)
+{
+  Channels out;
+  for (int i = ALP_C; i <= RED_C; i++)
+  {
+    const s32 a = inputs.a[i] & 0xFF;
+    const s32 b = inputs.b[i] & 0xFF;
+    s32 c = inputs.c[i] & 0xFF;
+    c += c >> 7;
+    const s32 d = static_cast<s16>(inputs.d[i] << 5) >> 5;
+
+    s32 lerp = (a * (256 - c) + b * c) * stage.scale[i] + stage.round[i];
+    lerp = ((lerp ^ stage.negate_before[i]) - stage.negate_before[i]) >> 8;
+    lerp = (lerp ^ stage.negate_after[i]) - stage.negate_after[i];
+
+    s32 result = (d + stage.bias[i]) * stage.scale[i] + lerp;
+    if (stage.divide_by_2[i])
+      result >>= 1;
+
+    out[i] = std::clamp<s16>(static_cast<s16>(result), stage.min[i], stage.max[i]);
+  }
+  return out;
+}
+
+#endif
+
+Channels CombineScalar(const TevStageCombiner::ColorCombiner& cc,
+                       const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs)
+{
+  InputRegType regs[4];
+  for (int i = ALP_C; i <= RED_C; i++)
+  {
+    regs[i].a = inputs.a[i];
+    regs[i].b = inputs.b[i];
+    regs[i].c = inputs.c[i];
+    regs[i].d = inputs.d[i];
+  }
+
+  Channels out{};
+
+  if (cc.bias != TevBias::Compare)
+    DrawColorRegular(cc, regs, &out);
+  else
+    DrawColorCompare(cc, regs, &out);
+
+  for (int i = BLU_C; i <= RED_C; i++)
+    out[i] = cc.clamp ? Clamp255(out[i]) : Clamp1024(out[i]);
+
+  if (ac.bias != TevBias::Compare)
+    DrawAlphaRegular(ac, regs, &out);
+  else
+    DrawAlphaCompare(ac, regs, &out);
+
+  out[ALP_C] = ac.clamp ? Clamp255(out[ALP_C]) : Clamp1024(out[ALP_C]);
+
+  return out;
+}
+}  // namespace TevCombiner
@@ -0,0 +1,58 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+
+// The color and alpha combiners of a TEV stage. All values are in the channel order used by Tev,
+// which is alpha, blue, green, red; the alpha combiner only works on the first channel and the
+// color combiner on the others.
+namespace TevCombiner
+{
+using Channels = std::array<s16, 4>;
+
+// As read from the TEV registers. a, b and c are truncated to 8 bits and d to 11 bits.
+struct Inputs
+{
+  Channels a;
+  Channels b;
+  Channels c;
+  Channels d;
+};
+
+// The parts of the combiner configuration of a stage which don't depend on the pixel, set up so
+// that Combine only needs to do arithmetic.
+struct Stage
+{
+  // Only stages where neither combiner is in compare mode can be drawn using Combine
+  bool is_regular;
+
+  Channels scale;  // 1 << the left shift of the scale
+  Channels bias;   // Added to d
+
+  // Clamping range of the result
+  Channels min;
+  Channels max;
+
+  std::array<s32, 4> round;          // Added to the lerp before it is shifted down
+  std::array<s32, 4> negate_before;  // All bits set for subtraction in the alpha combiner
+  std::array<s32, 4> negate_after;   // All bits set for subtraction in the color combiner
+  std::array<s32, 4> divide_by_2;    // All bits set for TevScale::Divide2
+};
+
+Stage SetUpStage(const TevStageCombiner::ColorCombiner& cc,
+                 const TevStageCombiner::AlphaCombiner& ac);
+
+// Calculates the clamped output of the color and alpha combiners of a stage. Uses SIMD where
+// available. The stage must be regular.
+Channels Combine(const Stage& stage, const Inputs& inputs);
+
+// Calculates the clamped output of the color and alpha combiners of a stage one channel at a time.
+// Supports all modes, and is the reference which Combine must match.
+Channels CombineScalar(const TevStageCombiner::ColorCombiner& cc,
+                       const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs);
+}  // namespace TevCombiner
@@ -10,6 +10,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
 
+#include "VideoBackends/Software/CopyKernels.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/SWTexture.h"
 
@@ -244,6 +245,16 @@ static void SetSpans(int sBlkSize, int tBlkSize, s32* tSpan, s32* sBlkSpan, s32*
       {                                                                                            \
         for (int s = 0; s < sBlkSize; s++)                                                         \
         {
+// Like ENCODE_LOOP_BLOCKS, but the body encodes a whole row of texels of a block at a time
+#define ENCODE_LOOP_BLOCK_ROWS                                                                     \
+  for (int tBlk = 0; tBlk < tBlkCount; tBlk++)                                                     \
+  {                                                                                                \
+    dst = dstBlockStart;                                                                           \
+    for (int sBlk = 0; sBlk < sBlkCount; sBlk++)                                                   \
+    {                                                                                              \
+      for (int t = 0; t < tBlkSize; t++)                                                           \
+      {                                                                                            \
+        {
 #define ENCODE_LOOP_SPANS                                                                          \
   }                                                                                                \
   src += tSpan;                                                                                    \
@@ -317,11 +328,11 @@ static void EncodeRGBA6(u8* dst, const u8* src, EFBCopyFormat format, bool yuv)
     SetSpans(sBlkSize, tBlkSize, &tSpan, &sBlkSpan, &tBlkSpan, &writeStride);
     if (yuv)
     {
-      ENCODE_LOOP_BLOCKS
+      ENCODE_LOOP_BLOCK_ROWS
       {
-        RGBA_to_RGB8(src, &r, &g, &b);
-        src += readStride;
-        *dst++ = RGB8_to_I(r, g, b);
+        CopyKernels::EncodeI8Row(src, dst, true);
+        src += 8 * readStride;
+        dst += 8;
       }
       ENCODE_LOOP_SPANS
     }
@@ -392,15 +403,11 @@ static void EncodeRGBA6(u8* dst, const u8* src, EFBCopyFormat format, bool yuv)
   case EFBCopyFormat::RGB565:
     SetBlockDimensions(2, 2, &sBlkCount, &tBlkCount, &sBlkSize, &tBlkSize);
     SetSpans(sBlkSize, tBlkSize, &tSpan, &sBlkSpan, &tBlkSpan, &writeStride);
-    ENCODE_LOOP_BLOCKS
+    ENCODE_LOOP_BLOCK_ROWS
     {
-      u32 srcColor = *(u32*)src;
-      src += readStride;
-
-      u16 val =
-          ((srcColor >> 8) & 0xf800) | ((srcColor >> 7) & 0x07e0) | ((srcColor >> 7) & 0x001f);
-      *(u16*)dst = Common::swap16(val);
-      dst += 2;
+      CopyKernels::EncodeRGB565Row(src, dst, true);
+      src += 4 * readStride;
+      dst += 8;
     }
     ENCODE_LOOP_SPANS
     break;
@@ -431,11 +438,11 @@ static void EncodeRGBA6(u8* dst, const u8* src, EFBCopyFormat format, bool yuv)
   case EFBCopyFormat::RGBA8:
     SetBlockDimensions(2, 2, &sBlkCount, &tBlkCount, &sBlkSize, &tBlkSize);
     SetSpans(sBlkSize, tBlkSize, &tSpan, &sBlkSpan, &tBlkSpan, &writeStride);
-    ENCODE_LOOP_BLOCKS
+    ENCODE_LOOP_BLOCK_ROWS
     {
-      RGBA_to_RGBA8(src, &dst[1], &dst[32], &dst[33], &dst[0]);
-      src += readStride;
-      dst += 2;
+      CopyKernels::EncodeRGBA8Row(src, dst, true);
+      src += 4 * readStride;
+      dst += 8;
     }
     ENCODE_LOOP_SPANS2
     break;
@@ -795,10 +802,11 @@ static void EncodeRGB8(u8* dst, const u8* src, EFBCopyFormat format, bool yuv)
     SetSpans(sBlkSize, tBlkSize, &tSpan, &sBlkSpan, &tBlkSpan, &writeStride);
     if (yuv)
     {
-      ENCODE_LOOP_BLOCKS
+      ENCODE_LOOP_BLOCK_ROWS
       {
-        *dst++ = RGB8_to_I(src[2], src[1], src[0]);
-        src += readStride;
+        CopyKernels::EncodeI8Row(src, dst, false);
+        src += 8 * readStride;
+        dst += 8;
       }
       ENCODE_LOOP_SPANS
     }
@@ -865,12 +873,11 @@ static void EncodeRGB8(u8* dst, const u8* src, EFBCopyFormat format, bool yuv)
   case EFBCopyFormat::RGB565:
     SetBlockDimensions(2, 2, &sBlkCount, &tBlkCount, &sBlkSize, &tBlkSize);
     SetSpans(sBlkSize, tBlkSize, &tSpan, &sBlkSpan, &tBlkSpan, &writeStride);
-    ENCODE_LOOP_BLOCKS
+    ENCODE_LOOP_BLOCK_ROWS
     {
-      u16 val = ((src[2] << 8) & 0xf800) | ((src[1] << 3) & 0x07e0) | ((src[0] >> 3) & 0x001f);
-      *(u16*)dst = Common::swap16(val);
-      src += readStride;
-      dst += 2;
+      CopyKernels::EncodeRGB565Row(src, dst, false);
+      src += 4 * readStride;
+      dst += 8;
     }
     ENCODE_LOOP_SPANS
     break;
@@ -892,14 +899,11 @@ static void EncodeRGB8(u8* dst, const u8* src, EFBCopyFormat format, bool yuv)
   case EFBCopyFormat::RGBA8:
     SetBlockDimensions(2, 2, &sBlkCount, &tBlkCount, &sBlkSize, &tBlkSize);
     SetSpans(sBlkSize, tBlkSize, &tSpan, &sBlkSpan, &tBlkSpan, &writeStride);
-    ENCODE_LOOP_BLOCKS
+    ENCODE_LOOP_BLOCK_ROWS
     {
-      dst[0] = 0xff;
-      dst[1] = src[2];
-      dst[32] = src[1];
-      dst[33] = src[0];
-      src += readStride;
-      dst += 2;
+      CopyKernels::EncodeRGBA8Row(src, dst, false);
+      src += 4 * readStride;
+      dst += 8;
     }
     ENCODE_LOOP_SPANS2
     break;
@@ -4,8 +4,18 @@
 #include "VideoBackends/Software/TextureSampler.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <memory>
 #include <span>
+#include <vector>
+
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
 
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
@@ -115,23 +125,136 @@ void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8* sample)
   }
 }
 
-void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample)
+// Where the texels of a texture come from, which identifies it within a draw
+struct TextureSource
+{
+  std::span<const u8> image_src;
+  std::span<const u8> image_src_odd;  // Only used for RGBA8 textures in TMEM
+  std::span<const u8> tlut;
+  TextureFormat texfmt;
+  TLUTFormat tlutfmt;
+  bool rgba8_from_tmem;
+  int width;
+  int height;
+
+  bool operator==(const TextureSource& other) const
+  {
+    return image_src.data() == other.image_src.data() &&
+           image_src.size() == other.image_src.size() &&
+           image_src_odd.data() == other.image_src_odd.data() &&
+           tlut.data() == other.tlut.data() && texfmt == other.texfmt &&
+           tlutfmt == other.tlutfmt && rgba8_from_tmem == other.rgba8_from_tmem &&
+           width == other.width && height == other.height;
+  }
+};
+
+// Texels which have been decoded to RGBA8. A texture is decoded in blocks of
+// DECODED_BLOCK_SIZE x DECODED_BLOCK_SIZE texels the first time one of their texels is sampled, so
+// that drawing a small part of a large texture doesn't decode all of it.
+struct DecodedTexture
+{
+  static constexpr int DECODED_BLOCK_SIZE = 8;
+
+  TextureSource source;
+  int stride = 0;
+  int blocks_wide = 0;
+  size_t capacity = 0;
+  std::unique_ptr<u32[]> texels;
+  std::vector<bool> decoded_blocks;
+
+  void Reset(const TextureSource& new_source)
+  {
+    source = new_source;
+    blocks_wide = (source.width + DECODED_BLOCK_SIZE - 1) / DECODED_BLOCK_SIZE;
+    const int blocks_high = (source.height + DECODED_BLOCK_SIZE - 1) / DECODED_BLOCK_SIZE;
+    stride = blocks_wide * DECODED_BLOCK_SIZE;
+
+    const size_t size = size_t(stride) * blocks_high * DECODED_BLOCK_SIZE;
+    if (size > capacity)
+    {
+      texels = std::make_unique_for_overwrite<u32[]>(size);
+      capacity = size;
+    }
+
+    decoded_blocks.assign(size_t(blocks_wide) * blocks_high, false);
+  }
+
+  const u8* GetTexel(int s, int t)
+  {
+    const size_t block = size_t(t / DECODED_BLOCK_SIZE) * blocks_wide + s / DECODED_BLOCK_SIZE;
+    if (!decoded_blocks[block])
+    {
+      DecodeBlock(s - s % DECODED_BLOCK_SIZE, t - t % DECODED_BLOCK_SIZE);
+      decoded_blocks[block] = true;
+    }
+
+    return reinterpret_cast<const u8*>(&texels[size_t(t) * stride + s]);
+  }
+
+  void DecodeBlock(int block_s, int block_t)
+  {
+    const int end_s = std::min(block_s + DECODED_BLOCK_SIZE, source.width);
+    const int end_t = std::min(block_t + DECODED_BLOCK_SIZE, source.height);
+
+    for (int t = block_t; t < end_t; t++)
+    {
+      for (int s = block_s; s < end_s; s++)
+      {
+        u8* dst = reinterpret_cast<u8*>(&texels[size_t(t) * stride + s]);
+        if (source.rgba8_from_tmem)
+        {
+          TexDecoder_DecodeTexelRGBA8FromTmem(dst, source.image_src, source.image_src_odd, s, t,
+                                              source.width - 1);
+        }
+        else
+        {
+          TexDecoder_DecodeTexel(dst, source.image_src, s, t, source.width - 1, source.texfmt,
+                                 source.tlut, source.tlutfmt);
+        }
+      }
+    }
+  }
+};
+
+// The textures decoded by this thread during the current draw. Several threads can be drawing at
+// the same time, so each one decodes on its own.
+struct DecodedTextureCache
+{
+  // The LOD is at most 15.9375, which selects level 16 when rounded up or filtered linearly
+  static constexpr u32 MAX_MIP_LEVELS = 17;
+
+  std::vector<std::unique_ptr<DecodedTexture>> textures;
+  size_t textures_in_use = 0;
+  std::array<std::array<DecodedTexture*, MAX_MIP_LEVELS>, 8> bound{};
+};
+
+static thread_local DecodedTextureCache s_cache;
+
+void InvalidateCache()
+{
+  s_cache.textures_in_use = 0;
+  for (auto& mips : s_cache.bound)
+    mips.fill(nullptr);
+}
+
+static TextureSource GetTextureSource(u8 texmap, s32 mip)
 {
   auto texUnit = bpmem.tex.GetUnit(texmap);
 
-  const TexMode0& tm0 = texUnit.texMode0;
   const TexImage0& ti0 = texUnit.texImage0;
   const TexTLUT& texTlut = texUnit.texTlut;
-  const TextureFormat texfmt = ti0.format;
-  const TLUTFormat tlutfmt = texTlut.tlut_format;
 
-  std::span<const u8> image_src;
-  std::span<const u8> image_src_odd;
+  TextureSource source;
+  source.texfmt = ti0.format;
+  source.tlutfmt = texTlut.tlut_format;
+  source.rgba8_from_tmem =
+      source.texfmt == TextureFormat::RGBA8 && texUnit.texImage1.cache_manually_managed;
+
   if (texUnit.texImage1.cache_manually_managed)
   {
-    image_src = TexDecoder_GetTmemSpan(texUnit.texImage1.tmem_even * TMEM_LINE_SIZE);
-    if (texfmt == TextureFormat::RGBA8)
-      image_src_odd = TexDecoder_GetTmemSpan(texUnit.texImage2.tmem_odd * TMEM_LINE_SIZE);
+    source.image_src = TexDecoder_GetTmemSpan(texUnit.texImage1.tmem_even * TMEM_LINE_SIZE);
+    if (source.texfmt == TextureFormat::RGBA8)
+      source.image_src_odd = TexDecoder_GetTmemSpan(texUnit.texImage2.tmem_odd * TMEM_LINE_SIZE);
   }
   else
   {
@@ -139,30 +262,28 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample)
     auto& memory = system.GetMemory();
 
     const u32 imageBase = texUnit.texImage3.image_base << 5;
-    image_src = memory.GetSpanForAddress(imageBase);
+    source.image_src = memory.GetSpanForAddress(imageBase);
   }
 
   int image_width_minus_1 = ti0.width;
   int image_height_minus_1 = ti0.height;
 
   const int tlutAddress = texTlut.tmem_offset << 9;
-  const std::span<const u8> tlut = TexDecoder_GetTmemSpan(tlutAddress);
+  source.tlut = TexDecoder_GetTmemSpan(tlutAddress);
 
-  // reduce sample location and texture size to mip level
+  // reduce texture size to mip level
   // move texture pointer to mip location
   if (mip)
   {
     int mipWidth = image_width_minus_1 + 1;
     int mipHeight = image_height_minus_1 + 1;
 
-    const int fmtWidth = TexDecoder_GetBlockWidthInTexels(texfmt);
-    const int fmtHeight = TexDecoder_GetBlockHeightInTexels(texfmt);
-    const int fmtDepth = TexDecoder_GetTexelSizeInNibbles(texfmt);
+    const int fmtWidth = TexDecoder_GetBlockWidthInTexels(source.texfmt);
+    const int fmtHeight = TexDecoder_GetBlockHeightInTexels(source.texfmt);
+    const int fmtDepth = TexDecoder_GetTexelSizeInNibbles(source.texfmt);
 
     image_width_minus_1 >>= mip;
     image_height_minus_1 >>= mip;
-    s >>= mip;
-    t >>= mip;
 
     while (mip)
     {
@@ -170,13 +291,107 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample)
       mipHeight = std::max(mipHeight, fmtHeight);
       const u32 size = (mipWidth * mipHeight * fmtDepth) >> 1;
 
-      image_src = Common::SafeSubspan(image_src, size);
+      source.image_src = Common::SafeSubspan(source.image_src, size);
       mipWidth >>= 1;
       mipHeight >>= 1;
       mip--;
     }
   }
 
+  source.width = image_width_minus_1 + 1;
+  source.height = image_height_minus_1 + 1;
+  return source;
+}
+
+static DecodedTexture& GetDecodedTexture(u8 texmap, s32 mip)
+{
+  DecodedTexture*& bound = s_cache.bound[texmap][mip];
+  if (bound)
+    return *bound;
+
+  // Several texture maps can refer to the same texture
+  const TextureSource source = GetTextureSource(texmap, mip);
+  for (size_t i = 0; i < s_cache.textures_in_use; i++)
+  {
+    if (s_cache.textures[i]->source == source)
+    {
+      bound = s_cache.textures[i].get();
+      return *bound;
+    }
+  }
+
+  if (s_cache.textures_in_use == s_cache.textures.size())
+    s_cache.textures.push_back(std::make_unique<DecodedTexture>());
+
+  bound = s_cache.textures[s_cache.textures_in_use++].get();
+  bound->Reset(source);
+  return *bound;
+}
+
+// Bilinear filtering of four RGBA8 texels, with weights that add up to 128 * 128
+static void Bilinear(const u8* texel00, const u8* texel10, const u8* texel01, const u8* texel11,
+                     u32 weight00, u32 weight10, u32 weight01, u32 weight11, u8* sample)
+{
+#if defined(_M_X86) || defined(_M_X86_64)
+  const auto load = [](const u8* texel) {
+    u32 value;
+    std::memcpy(&value, texel, sizeof(value));
+    return _mm_cvtsi32_si128(value);
+  };
+
+  // Interleave the channels of two texels and widen them to 16 bits, so that a multiply-add of
+  // 16-bit weights adds up the two texels for each channel
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi8(load(texel00), load(texel10)), zero);
+  const __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi8(load(texel01), load(texel11)), zero);
+
+  __m128i sum = _mm_madd_epi16(top, _mm_set1_epi32(weight00 | weight10 << 16));
+  sum = _mm_add_epi32(sum, _mm_madd_epi16(bottom, _mm_set1_epi32(weight01 | weight11 << 16)));
+  sum = _mm_srli_epi32(sum, 14);
+  sum = _mm_packus_epi16(_mm_packs_epi32(sum, sum), zero);
+
+  const u32 result = _mm_cvtsi128_si32(sum);
+  std::memcpy(sample, &result, sizeof(result));
+#elif defined(_M_ARM_64)
+  const auto load = [](const u8* texel) {
+    u32 value;
+    std::memcpy(&value, texel, sizeof(value));
+    return vget_low_u16(vmovl_u8(vcreate_u8(value)));
+  };
+
+  uint32x4_t sum = vmull_n_u16(load(texel00), weight00);
+  sum = vmlal_n_u16(sum, load(texel10), weight10);
+  sum = vmlal_n_u16(sum, load(texel01), weight01);
+  sum = vmlal_n_u16(sum, load(texel11), weight11);
+
+  const uint16x4_t narrowed = vshrn_n_u32(sum, 14);
+  const uint8x8_t result = vmovn_u16(vcombine_u16(narrowed, narrowed));
+  vst1_lane_u32(reinterpret_cast<u32*>(sample), vreinterpret_u32_u8(result), 0);
+#else
+  u32 texel[4];
+  SetTexel(texel00, texel, weight00);
+  AddTexel(texel10, texel, weight10);
+  AddTexel(texel01, texel, weight01);
+  AddTexel(texel11, texel, weight11);
+
+  sample[0] = (u8)(texel[0] >> 14);
+  sample[1] = (u8)(texel[1] >> 14);
+  sample[2] = (u8)(texel[2] >> 14);
+  sample[3] = (u8)(texel[3] >> 14);
+#endif
+}
+
+void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample)
+{
+  const TexMode0& tm0 = bpmem.tex.GetUnit(texmap).texMode0;
+  DecodedTexture& texture = GetDecodedTexture(texmap, mip);
+  const int image_width = texture.source.width;
+  const int image_height = texture.source.height;
+
+  // reduce sample location to mip level
+  s >>= mip;
+  t >>= mip;
+
   if (linear)
   {
     // offset linear sampling
@@ -194,55 +409,15 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample)
     int imageTPlus1 = imageT + 1;
     const int fractT = t & 0x7f;
 
-    u8 sampledTex[4];
-    u32 texel[4];
-
-    WrapCoord(&imageS, tm0.wrap_s, image_width_minus_1 + 1);
-    WrapCoord(&imageT, tm0.wrap_t, image_height_minus_1 + 1);
-    WrapCoord(&imageSPlus1, tm0.wrap_s, image_width_minus_1 + 1);
-    WrapCoord(&imageTPlus1, tm0.wrap_t, image_height_minus_1 + 1);
-
-    if (!(texfmt == TextureFormat::RGBA8 && texUnit.texImage1.cache_manually_managed))
-    {
-      TexDecoder_DecodeTexel(sampledTex, image_src, imageS, imageT, image_width_minus_1, texfmt,
-                             tlut, tlutfmt);
-      SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
-
-      TexDecoder_DecodeTexel(sampledTex, image_src, imageSPlus1, imageT, image_width_minus_1,
-                             texfmt, tlut, tlutfmt);
-      AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
-
-      TexDecoder_DecodeTexel(sampledTex, image_src, imageS, imageTPlus1, image_width_minus_1,
-                             texfmt, tlut, tlutfmt);
-      AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
+    WrapCoord(&imageS, tm0.wrap_s, image_width);
+    WrapCoord(&imageT, tm0.wrap_t, image_height);
+    WrapCoord(&imageSPlus1, tm0.wrap_s, image_width);
+    WrapCoord(&imageTPlus1, tm0.wrap_t, image_height);
 
-      TexDecoder_DecodeTexel(sampledTex, image_src, imageSPlus1, imageTPlus1, image_width_minus_1,
-                             texfmt, tlut, tlutfmt);
-      AddTexel(sampledTex, texel, (fractS) * (fractT));
-    }
-    else
-    {
-      TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, image_src, image_src_odd, imageS, imageT,
-                                          image_width_minus_1);
-      SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
-
-      TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, image_src, image_src_odd, imageSPlus1, imageT,
-                                          image_width_minus_1);
-      AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
-
-      TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, image_src, image_src_odd, imageS, imageTPlus1,
-                                          image_width_minus_1);
-      AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
-
-      TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, image_src, image_src_odd, imageSPlus1,
-                                          imageTPlus1, image_width_minus_1);
-      AddTexel(sampledTex, texel, (fractS) * (fractT));
-    }
-
-    sample[0] = (u8)(texel[0] >> 14);
-    sample[1] = (u8)(texel[1] >> 14);
-    sample[2] = (u8)(texel[2] >> 14);
-    sample[3] = (u8)(texel[3] >> 14);
+    Bilinear(texture.GetTexel(imageS, imageT), texture.GetTexel(imageSPlus1, imageT),
+             texture.GetTexel(imageS, imageTPlus1), texture.GetTexel(imageSPlus1, imageTPlus1),
+             (128 - fractS) * (128 - fractT), fractS * (128 - fractT), (128 - fractS) * fractT,
+             fractS * fractT, sample);
   }
   else
   {
@@ -251,19 +426,10 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample)
     int imageT = t >> 7;
 
     // nearest neighbor sampling
-    WrapCoord(&imageS, tm0.wrap_s, image_width_minus_1 + 1);
-    WrapCoord(&imageT, tm0.wrap_t, image_height_minus_1 + 1);
+    WrapCoord(&imageS, tm0.wrap_s, image_width);
+    WrapCoord(&imageT, tm0.wrap_t, image_height);
 
-    if (!(texfmt == TextureFormat::RGBA8 && texUnit.texImage1.cache_manually_managed))
-    {
-      TexDecoder_DecodeTexel(sample, image_src, imageS, imageT, image_width_minus_1, texfmt, tlut,
-                             tlutfmt);
-    }
-    else
-    {
-      TexDecoder_DecodeTexelRGBA8FromTmem(sample, image_src, image_src_odd, imageS, imageT,
-                                          image_width_minus_1);
-    }
+    std::memcpy(sample, texture.GetTexel(imageS, imageT), 4);
   }
 }
 }  // namespace TextureSampler
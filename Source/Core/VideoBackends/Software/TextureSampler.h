@@ -11,6 +11,10 @@ void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8* sample);
 
 void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8* sample);
 
+// Sampled textures are decoded into a cache which is only valid for one draw. This must be called
+// by every thread that samples textures before it starts drawing.
+void InvalidateCache();
+
 enum
 {
   RED_SMP,
@@ -8,6 +8,12 @@
 #include <cmath>
 #include <cstring>
 
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -90,6 +96,118 @@ void TransformPosition(const InputVertexData* src, OutputVertexData* dst)
   }
 }
 
+#if defined(_M_X86) || defined(_M_X86_64) || defined(_M_ARM_64)
+#if defined(_M_X86) || defined(_M_X86_64)
+using Vector = __m128;
+
+static Vector Load(float x, float y, float z, float w)
+{
+  return _mm_setr_ps(x, y, z, w);
+}
+
+static Vector Broadcast(float f)
+{
+  return _mm_set1_ps(f);
+}
+
+static Vector Add(Vector a, Vector b)
+{
+  return _mm_add_ps(a, b);
+}
+
+static Vector Multiply(Vector a, Vector b)
+{
+  return _mm_mul_ps(a, b);
+}
+
+static void Store(float* dst, Vector v)
+{
+  _mm_storeu_ps(dst, v);
+}
+#else
+using Vector = float32x4_t;
+
+static Vector Load(float x, float y, float z, float w)
+{
+  const float values[4] = {x, y, z, w};
+  return vld1q_f32(values);
+}
+
+static Vector Broadcast(float f)
+{
+  return vdupq_n_f32(f);
+}
+
+// Not fused, as the rounding has to match the scalar code
+static Vector Add(Vector a, Vector b)
+{
+  return vaddq_f32(a, b);
+}
+
+static Vector Multiply(Vector a, Vector b)
+{
+  return vmulq_f32(a, b);
+}
+
+static void Store(float* dst, Vector v)
+{
+  vst1q_f32(dst, v);
+}
+#endif
+
+void TransformPositions(const InputVertexData* src, OutputVertexData* dst, u32 count)
+{
+  // The projection is done as (scale * position + offset) * correction, with w filled in
+  // afterwards. For perspective projections, the offsets of x and y depend on the position.
+  const Projection::Raw& proj = xfmem.projection.rawProjection;
+  const bool perspective = xfmem.projection.type == ProjectionType::Perspective;
+  const Vector scale = Load(proj[0], proj[2], proj[4], 0.0f);
+  const Vector ortho_offset = Load(proj[1], proj[3], proj[5], 0.0f);
+  const Vector correction = Load(1.0f, 1.0f, perspective ? 1.0f - (float)1e-7 : 1.0f, 1.0f);
+
+  // The columns of the position matrix, which usually stays the same for many vertices
+  u32 matrix_index = ~0u;
+  Vector columns[4]{};
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    if (src[i].posMtx != matrix_index)
+    {
+      matrix_index = src[i].posMtx;
+      const float* mat = &xfmem.posMatrices[matrix_index * 4];
+      for (int column = 0; column < 4; ++column)
+        columns[column] = Load(mat[column], mat[column + 4], mat[column + 8], 0.0f);
+    }
+
+    // Added up in the same order as MultiplyVec3Mat34
+    const Vec3& position = src[i].position;
+    Vector mv = Multiply(columns[0], Broadcast(position.x));
+    mv = Add(mv, Multiply(columns[1], Broadcast(position.y)));
+    mv = Add(mv, Multiply(columns[2], Broadcast(position.z)));
+    mv = Add(mv, columns[3]);
+
+    float mv_position[4];
+    Store(mv_position, mv);
+
+    const float z = mv_position[2];
+    const Vector offset =
+        perspective ? Load(proj[1] * z, proj[3] * z, proj[5], 0.0f) : ortho_offset;
+
+    float projected[4];
+    Store(projected, Multiply(Add(Multiply(scale, mv), offset), correction));
+
+    dst[i].mvPosition = Vec3(mv_position);
+    dst[i].projectedPosition = {projected[0], projected[1], projected[2], perspective ? -z : 1.0f};
+  }
+}
+#else
+void TransformPositions(const InputVertexData* src, OutputVertexData* dst, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+    TransformPosition(&src[i], &dst[i]);
+}
+#endif
+
 void TransformNormal(const InputVertexData* src, OutputVertexData* dst)
 {
   const float* mat = &xfmem.normalMatrices[(src->posMtx & 31) * 3];
@@ -3,12 +3,16 @@
 
 #pragma once
 
+#include "Common/CommonTypes.h"
+
 struct InputVertexData;
 struct OutputVertexData;
 
 namespace TransformUnit
 {
 void TransformPosition(const InputVertexData* src, OutputVertexData* dst);
+// Gives the same result as calling TransformPosition on each vertex, but uses SIMD where available
+void TransformPositions(const InputVertexData* src, OutputVertexData* dst, u32 count);
 void TransformNormal(const InputVertexData* src, OutputVertexData* dst);
 void TransformColor(const InputVertexData* src, OutputVertexData* dst);
 void TransformTexCoord(const InputVertexData* src, OutputVertexData* dst);
@@ -25,6 +25,14 @@ void AbstractStagingTexture::CopyFromTexture(const AbstractTexture* src, u32 src
   CopyFromTexture(src, src_rect, src_layer, src_level, dst_rect);
 }
 
+bool AbstractStagingTexture::CopyFromTextureScaled(const AbstractTexture* src,
+                                                   const MathUtil::Rectangle<int>& src_rect,
+                                                   u32 src_layer, u32 src_level,
+                                                   const MathUtil::Rectangle<int>& dst_rect)
+{
+  return false;
+}
+
 void AbstractStagingTexture::CopyToTexture(AbstractTexture* dst, u32 dst_layer, u32 dst_level)
 {
   MathUtil::Rectangle<int> src_rect = m_config.GetRect();
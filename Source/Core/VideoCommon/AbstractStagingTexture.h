@@ -42,6 +42,13 @@ public:
   // Assumes that the level of src texture and this texture have the same dimensions.
   void CopyFromTexture(const AbstractTexture* src, u32 src_layer = 0, u32 src_level = 0);
 
+  // Like CopyFromTexture, but scales src_rect to dst_rect with nearest-neighbor sampling. Only
+  // backends which keep textures in CPU memory can do this without drawing; the others return
+  // false without copying anything, and the texture has to be scaled with AbstractGfx instead.
+  virtual bool CopyFromTextureScaled(const AbstractTexture* src,
+                                     const MathUtil::Rectangle<int>& src_rect, u32 src_layer,
+                                     u32 src_level, const MathUtil::Rectangle<int>& dst_rect);
+
   // Copies from this staging texture to a GPU texture.
   // Both src_rect and dst_rect must be with within the bounds of the the specified textures.
   virtual void CopyToTexture(const MathUtil::Rectangle<int>& src_rect, AbstractTexture* dst,
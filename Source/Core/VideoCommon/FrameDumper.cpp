@@ -54,24 +54,28 @@ void FrameDumper::DumpCurrentFrame(const AbstractTexture* src_texture,
   int target_width = target_rect.GetWidth();
   int target_height = target_rect.GetHeight();
 
-  // We only need to render a copy if we need to stretch/scale the XFB copy.
-  MathUtil::Rectangle<int> copy_rect = src_rect;
-  if (source_width != target_width || source_height != target_height)
+  if (!CheckFrameDumpReadbackTexture(target_width, target_height))
+    return;
+
+  // We only need to render a copy if we need to stretch/scale the XFB copy, and the backend can't
+  // scale it while copying it to the readback texture.
+  const MathUtil::Rectangle<int> readback_rect = m_frame_dump_readback_texture->GetRect();
+  if (source_width == target_width && source_height == target_height)
+  {
+    m_frame_dump_readback_texture->CopyFromTexture(src_texture, src_rect, 0, 0, readback_rect);
+  }
+  else if (!m_frame_dump_readback_texture->CopyFromTextureScaled(src_texture, src_rect, 0, 0,
+                                                                  readback_rect))
   {
     if (!CheckFrameDumpRenderTexture(target_width, target_height))
       return;
 
     g_gfx->ScaleTexture(m_frame_dump_render_framebuffer.get(),
                         m_frame_dump_render_framebuffer->GetRect(), src_texture, src_rect);
-    src_texture = m_frame_dump_render_texture.get();
-    copy_rect = src_texture->GetRect();
+    m_frame_dump_readback_texture->CopyFromTexture(m_frame_dump_render_texture.get(),
+                                                   m_frame_dump_render_texture->GetRect(), 0, 0,
+                                                   readback_rect);
   }
-
-  if (!CheckFrameDumpReadbackTexture(target_width, target_height))
-    return;
-
-  m_frame_dump_readback_texture->CopyFromTexture(src_texture, copy_rect, 0, 0,
-                                                 m_frame_dump_readback_texture->GetRect());
   m_last_frame_state = m_ffmpeg_dump.FetchState(ticks, frame_number);
   m_last_frame_duplicate = false;
   m_frame_dump_needs_flush = true;
@@ -1108,6 +1108,12 @@ void FramebufferManager::DoState(PointerWrap& p)
   FlushEFBPokes();
   p.Do(m_prev_efb_format);
 
+  if (p.IsHashMode())
+  {
+    DoHashState(p);
+    return;
+  }
+
   bool save_efb_state = Config::Get(Config::GFX_SAVE_TEXTURE_CACHE_TO_STATE);
   p.Do(save_efb_state);
   if (!save_efb_state)
@@ -1140,6 +1146,39 @@ void FramebufferManager::DoSaveState(PointerWrap& p)
   g_texture_cache->SerializeTexture(depth_texture, depth_texture_config, p);
 }
 
+void FramebufferManager::DoHashState(PointerWrap& p)
+{
+  // The EFB is hashed at native resolution, as the CPU would see it by peeking every pixel, so the
+  // hash doesn't depend on the internal resolution or MSAA.
+  std::vector<u32> texels(EFB_WIDTH * EFB_HEIGHT);
+  for (bool depth : {false, true})
+  {
+    EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
+    for (u32 tile_index = 0; tile_index < data.tiles.size(); ++tile_index)
+    {
+      if (!data.tiles[tile_index].present)
+        PopulateEFBCache(depth, tile_index, true);
+    }
+
+    if (data.needs_flush)
+    {
+      data.readback_texture->Flush();
+      data.needs_flush = false;
+    }
+
+    // Both the color and the depth readback formats have 4 bytes per texel.
+    data.readback_texture->ReadTexels(MathUtil::Rectangle<int>(0, 0, EFB_WIDTH, EFB_HEIGHT),
+                                      texels.data(), EFB_WIDTH * sizeof(u32));
+
+    // Hash the rows from the top, whichever origin the readback texture uses.
+    for (u32 y = 0; y < EFB_HEIGHT; ++y)
+    {
+      const u32 row = g_ActiveConfig.backend_info.bUsesLowerLeftOrigin ? EFB_HEIGHT - 1 - y : y;
+      p.DoArray(&texels[row * EFB_WIDTH], EFB_WIDTH);
+    }
+  }
+}
+
 void FramebufferManager::DoLoadState(PointerWrap& p)
 {
   // Invalidate any peek cache tiles.
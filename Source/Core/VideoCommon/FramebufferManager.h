@@ -193,6 +193,7 @@ protected:
 
   void DoLoadState(PointerWrap& p);
   void DoSaveState(PointerWrap& p);
+  void DoHashState(PointerWrap& p);
 
   float m_efb_scale = 1.0f;
   PixelFormat m_prev_efb_format;
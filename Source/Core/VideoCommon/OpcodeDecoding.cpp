@@ -27,6 +27,7 @@
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 #include "VideoCommon/XFStateManager.h"
 #include "VideoCommon/XFStructs.h"
@@ -130,10 +131,15 @@ public:
     // load vertices
     const u32 size = vertex_size * num_vertices;
 
-    const u32 bytes =
-        VertexLoaderManager::RunVertices<is_preprocess>(vat, primitive, num_vertices, vertex_data);
+    // Nothing would be drawn, and the size of the vertices is already known, so the vertex loader
+    // doesn't need to run at all
+    if (is_preprocess || !g_ActiveConfig.SkipRendering())
+    {
+      const u32 bytes = VertexLoaderManager::RunVertices<is_preprocess>(vat, primitive,
+                                                                        num_vertices, vertex_data);
 
-    ASSERT(bytes == size);
+      ASSERT(bytes == size);
+    }
 
     // 4 GPU ticks per vertex, 3 CPU ticks per GPU tick
     m_cycles += num_vertices * 4 * 3 + 6;
@@ -0,0 +1,88 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/ParallelTextureDecoder.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "VideoCommon/TextureDecoder.h"
+
+namespace VideoCommon
+{
+// Waking up the workers costs more than decoding less than this many texels takes
+constexpr u32 MIN_PARALLEL_TEXELS = 256 * 256;
+
+// Levels are split into pieces of about this many texels
+constexpr u32 PIECE_TEXELS = 128 * 128;
+
+constexpr size_t MAX_THREADS = 16;
+
+ParallelTextureDecoder::ParallelTextureDecoder()
+    : ParallelTextureDecoder(std::thread::hardware_concurrency())
+{
+}
+
+ParallelTextureDecoder::ParallelTextureDecoder(size_t thread_count)
+    : m_thread_count(std::clamp<size_t>(thread_count, 1, MAX_THREADS))
+{
+}
+
+void ParallelTextureDecoder::Add(u8* dst, const u8* src, u32 width, u32 height,
+                                 TextureFormat format, const u8* tlut, TLUTFormat tlut_format)
+{
+  m_levels.push_back({dst, src, width, height, format, tlut, tlut_format});
+}
+
+void ParallelTextureDecoder::Run()
+{
+  u32 total_texels = 0;
+  for (const Level& level : m_levels)
+    total_texels += level.width * level.height;
+
+  if (m_thread_count == 1 || total_texels < MIN_PARALLEL_TEXELS)
+  {
+    for (const Level& level : m_levels)
+    {
+      TexDecoder_Decode(level.dst, level.src, level.width, level.height, level.format, level.tlut,
+                        level.tlut_format);
+    }
+    m_levels.clear();
+    return;
+  }
+
+  for (const Level& level : m_levels)
+  {
+    const u32 block_height = TexDecoder_GetBlockHeightInTexels(level.format);
+    const u32 piece_rows = std::max(PIECE_TEXELS / level.width / block_height, 1u) * block_height;
+    for (u32 row = 0; row < level.height; row += piece_rows)
+      m_pieces.push_back({&level, row, std::min(piece_rows, level.height - row)});
+  }
+
+  m_workers.SetThreadCount(m_thread_count);
+  m_next_piece.store(0, std::memory_order_relaxed);
+  m_workers.Run([this](size_t) { DecodePieces(); });
+
+  // The overlay covers several pieces, so it can only be drawn once they are all done
+  for (const Level& level : m_levels)
+    TexDecoder_DrawOverlay(level.dst, level.width, level.height, level.format);
+
+  m_pieces.clear();
+  m_levels.clear();
+}
+
+void ParallelTextureDecoder::DecodePieces()
+{
+  while (true)
+  {
+    const size_t i = m_next_piece.fetch_add(1, std::memory_order_relaxed);
+    if (i >= m_pieces.size())
+      return;
+
+    const Piece& piece = m_pieces[i];
+    const Level& level = *piece.level;
+    TexDecoder_DecodeRows(level.dst, level.src, level.width, piece.first_row, piece.row_count,
+                          level.format, level.tlut, level.tlut_format);
+  }
+}
+}  // namespace VideoCommon
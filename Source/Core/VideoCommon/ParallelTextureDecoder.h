@@ -0,0 +1,69 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/WorkerPool.h"
+
+enum class TextureFormat;
+enum class TLUTFormat;
+
+namespace VideoCommon
+{
+// Decodes textures on the CPU with a pool of worker threads. The levels of a texture are queued
+// with Add and all decoded at once by Run. Large levels are split into pieces of block rows, so
+// that a single big texture is spread across the threads as well as a mip chain.
+class ParallelTextureDecoder
+{
+public:
+  // Uses one thread per hardware thread
+  ParallelTextureDecoder();
+  // Uses thread_count threads including the one calling Run. 1 decodes everything on that thread.
+  explicit ParallelTextureDecoder(size_t thread_count);
+
+  ParallelTextureDecoder(const ParallelTextureDecoder&) = delete;
+  ParallelTextureDecoder& operator=(const ParallelTextureDecoder&) = delete;
+
+  // Queues a level of width * height texels to be decoded by the next Run, with the same arguments
+  // as TexDecoder_Decode. src, dst and tlut must stay valid until then.
+  void Add(u8* dst, const u8* src, u32 width, u32 height, TextureFormat format, const u8* tlut,
+           TLUTFormat tlut_format);
+
+  // Decodes all the queued levels and waits for them to be done
+  void Run();
+
+private:
+  struct Level
+  {
+    u8* dst;
+    const u8* src;
+    u32 width;
+    u32 height;
+    TextureFormat format;
+    const u8* tlut;
+    TLUTFormat tlut_format;
+  };
+
+  struct Piece
+  {
+    const Level* level;
+    u32 first_row;
+    u32 row_count;
+  };
+
+  void DecodePieces();
+
+  std::vector<Level> m_levels;
+  std::vector<Piece> m_pieces;
+  std::atomic<size_t> m_next_piece{0};
+
+  // The workers are only started by the first Run which needs them
+  size_t m_thread_count;
+  Common::WorkerPool m_workers{"Texture Decoder"};
+};
+}  // namespace VideoCommon
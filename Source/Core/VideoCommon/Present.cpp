@@ -140,6 +140,13 @@ bool Presenter::FetchXFB(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_heigh
     m_xfb_rect = MathUtil::Rectangle<int>();
     m_last_xfb_id = std::numeric_limits<u64>::max();
   }
+  else if (g_ActiveConfig.SkipRendering())
+  {
+    // There is nothing to show, so don't decode the XFB. Every swap counts as a new frame.
+    m_xfb_entry.reset();
+    m_xfb_rect = MathUtil::Rectangle<int>();
+    m_last_xfb_id = old_xfb_id + 1;
+  }
   else
   {
     m_xfb_entry =
@@ -1728,6 +1728,18 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
     // Initialized to null because only software loading uses this buffer
     u8* dst_buffer = nullptr;
 
+    // The levels which are decoded on the CPU. They are all decoded at once, and uploaded after.
+    struct DecodedLevel
+    {
+      u32 level;
+      u32 width;
+      u32 height;
+      u32 row_length;
+      const u8* data;
+      size_t size;
+    };
+    std::vector<DecodedLevel> decoded_levels;
+
     if (!decode_on_gpu ||
         !DecodeTextureOnGPU(
             entry, 0, texture_info.GetData(), texture_info.GetTextureSize(),
@@ -1757,7 +1769,7 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
       dst_buffer = m_temp;
       if (!(texture_info.GetTextureFormat() == TextureFormat::RGBA8 && texture_info.IsFromTmem()))
       {
-        TexDecoder_Decode(dst_buffer, texture_info.GetData(), expanded_width, expanded_height,
+        m_cpu_decoder.Add(dst_buffer, texture_info.GetData(), expanded_width, expanded_height,
                           texture_info.GetTextureFormat(), texture_info.GetTlutAddress(),
                           texture_info.GetTlutFormat());
       }
@@ -1768,9 +1780,8 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
                                        expanded_height);
       }
 
-      entry->texture->Load(0, width, height, expanded_width, dst_buffer, decoded_texture_size);
-
-      arbitrary_mip_detector.AddLevel(width, height, expanded_width, dst_buffer);
+      decoded_levels.push_back(
+          {0, width, height, expanded_width, dst_buffer, decoded_texture_size});
 
       dst_buffer += decoded_texture_size;
     }
@@ -1793,19 +1804,25 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size =
             mip_level->GetExpandedWidth() * sizeof(u32) * mip_level->GetExpandedHeight();
-        TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
+        m_cpu_decoder.Add(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
                           mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
                           texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
-        entry->texture->Load(level, mip_level->GetRawWidth(), mip_level->GetRawHeight(),
-                             mip_level->GetExpandedWidth(), dst_buffer, decoded_mip_size);
-
-        arbitrary_mip_detector.AddLevel(mip_level->GetRawWidth(), mip_level->GetRawHeight(),
-                                        mip_level->GetExpandedWidth(), dst_buffer);
+        decoded_levels.push_back({level, mip_level->GetRawWidth(), mip_level->GetRawHeight(),
+                                  mip_level->GetExpandedWidth(), dst_buffer, decoded_mip_size});
 
         dst_buffer += decoded_mip_size;
       }
     }
 
+    m_cpu_decoder.Run();
+    for (const DecodedLevel& decoded : decoded_levels)
+    {
+      entry->texture->Load(decoded.level, decoded.width, decoded.height, decoded.row_length,
+                           decoded.data, decoded.size);
+      arbitrary_mip_detector.AddLevel(decoded.width, decoded.height, decoded.row_length,
+                                      decoded.data);
+    }
+
     entry->has_arbitrary_mips = arbitrary_mip_detector.HasArbitraryMipmaps(dst_buffer);
 
     if (g_ActiveConfig.bDumpTextures && !skip_texture_dump && texLevels > 0)
@@ -2299,6 +2316,14 @@ void TextureCacheBase::CopyRenderTargetToTexture(
     return;
   }
 
+  if (g_ActiveConfig.SkipRendering())
+  {
+    // Nothing has been drawn, so there is nothing to encode. The memory is filled in the same way
+    // as when copies to RAM are disabled, and overlapping cache entries are still invalidated.
+    copy_to_vram = false;
+    copy_to_ram = false;
+  }
+
   if (g_ActiveConfig.bGraphicMods)
   {
     FBInfo info;
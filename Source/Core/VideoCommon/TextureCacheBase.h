@@ -24,6 +24,7 @@
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/Assets/CustomAsset.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/ParallelTextureDecoder.h"
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/TextureInfo.h"
@@ -448,6 +449,9 @@ private:
   // Decoding texture used for GPU texture decoding.
   std::unique_ptr<AbstractTexture> m_decoding_texture;
 
+  // Decodes the levels of textures which aren't decoded on the GPU into m_temp.
+  VideoCommon::ParallelTextureDecoder m_cpu_decoder;
+
   // Pool of readback textures used for deferred EFB copies.
   std::vector<std::unique_ptr<AbstractStagingTexture>> m_efb_copy_staging_texture_pool;
 
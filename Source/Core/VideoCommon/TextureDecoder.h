@@ -191,6 +191,12 @@ TextureFormat TexDecoder_GetEFBCopyBaseFormat(EFBCopyFormat format);
 
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt);
+// Decodes row_count rows of a texture starting at first_row, both of which must be multiples of the
+// block height, without drawing the format overlay. Disjoint rows can be decoded on several
+// threads at once, followed by TexDecoder_DrawOverlay.
+void TexDecoder_DecodeRows(u8* dst, const u8* src, int width, int first_row, int row_count,
+                           TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+void TexDecoder_DrawOverlay(u8* dst, int width, int height, TextureFormat texformat);
 void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
                                     int height);
 void TexDecoder_DecodeTexel(u8* dst, std::span<const u8> src, int s, int t, int imageWidth,
@@ -4,8 +4,13 @@
 #include "VideoCommon/TextureDecoder.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
+#if defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
@@ -127,33 +132,7 @@ static inline void DecodeBytes_RGBA8(u32* dst, const u16* src, const u16* src2)
 
 static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 {
-  // S3TC Decoder (Note: GCN decodes differently from PC so we can't use native support)
-  // Needs more speed.
-  u16 c1 = Common::swap16(src->color1);
-  u16 c2 = Common::swap16(src->color2);
-  int blue1 = Convert5To8(c1 & 0x1F);
-  int blue2 = Convert5To8(c2 & 0x1F);
-  int green1 = Convert6To8((c1 >> 5) & 0x3F);
-  int green2 = Convert6To8((c2 >> 5) & 0x3F);
-  int red1 = Convert5To8((c1 >> 11) & 0x1F);
-  int red2 = Convert5To8((c2 >> 11) & 0x1F);
-  int colors[4];
-  colors[0] = MakeRGBA(red1, green1, blue1, 255);
-  colors[1] = MakeRGBA(red2, green2, blue2, 255);
-  if (c1 > c2)
-  {
-    colors[2] =
-        MakeRGBA(DXTBlend(red2, red1), DXTBlend(green2, green1), DXTBlend(blue2, blue1), 255);
-    colors[3] =
-        MakeRGBA(DXTBlend(red1, red2), DXTBlend(green1, green2), DXTBlend(blue1, blue2), 255);
-  }
-  else
-  {
-    // color[3] is the same as color[2] (average of both colors), but transparent.
-    // This differs from DXT1 where color[3] is transparent black.
-    colors[2] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 255);
-    colors[3] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 0);
-  }
+  const std::array<u32, 4> colors = GetDXTBlockColors(*src);
 
   for (int y = 0; y < 4; y++)
   {
@@ -167,6 +146,214 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
   }
 }
 
+#if defined(_M_ARM_64)
+// Replicates the high and the low nibble of each byte into a whole byte
+static inline void ExpandNibbles_NEON(uint8x8_t bytes, uint8x8_t* high, uint8x8_t* low)
+{
+  const uint8x8_t hi = vshr_n_u8(bytes, 4);
+  const uint8x8_t lo = vand_u8(bytes, vdup_n_u8(0x0f));
+  *high = vorr_u8(vshl_n_u8(hi, 4), hi);
+  *low = vorr_u8(vshl_n_u8(lo, 4), lo);
+}
+
+// Stores a row of 8 texels from their intensities
+static inline void StoreIntensityRow_NEON(u32* dst, uint8x8_t intensities)
+{
+  vst4_u8(reinterpret_cast<u8*>(dst), uint8x8x4_t{{intensities, intensities, intensities,
+                                                    intensities}});
+}
+
+// Loads two rows of 4 big endian 16-bit texels
+static inline uint16x8_t LoadTexels16_NEON(const u8* src)
+{
+  return vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(src)));
+}
+
+// Stores two rows of 4 texels, from 16-bit lanes holding red and green, and blue and alpha
+static inline void StoreTexels16_NEON(u32* row0, u32* row1, uint16x8_t rg, uint16x8_t ba)
+{
+  const uint16x8x2_t rgba = vzipq_u16(rg, ba);
+  vst1q_u16(reinterpret_cast<u16*>(row0), rgba.val[0]);
+  vst1q_u16(reinterpret_cast<u16*>(row1), rgba.val[1]);
+}
+
+static inline uint16x8_t Convert5To8_NEON(uint16x8_t v)
+{
+  return vorrq_u16(vshlq_n_u16(v, 3), vshrq_n_u16(v, 2));
+}
+
+static inline uint16x8_t Convert4To8_NEON(uint16x8_t v)
+{
+  return vorrq_u16(vshlq_n_u16(v, 4), v);
+}
+
+static void DecodeDXTBlock_NEON(u32* dst, const DXTBlock* src, int pitch)
+{
+  const std::array<u32, 4> colors = GetDXTBlockColors(*src);
+  const uint8x16_t palette = vld1q_u8(reinterpret_cast<const u8*>(colors.data()));
+
+  // Shifts the 2-bit index of each texel of a row to the bottom, the leftmost texel's being on top
+  static constexpr s8 shifts[16] = {-6, -6, -6, -6, -4, -4, -4, -4, -2, -2, -2, -2, 0, 0, 0, 0};
+  // The bytes of each color in the palette
+  static constexpr u8 offsets[16] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
+  const int8x16_t shift = vld1q_s8(shifts);
+  const uint8x16_t offset = vld1q_u8(offsets);
+
+  for (int y = 0; y < 4; y++)
+  {
+    const uint8x16_t indices =
+        vandq_u8(vshlq_u8(vdupq_n_u8(src->lines[y]), shift), vdupq_n_u8(3));
+    const uint8x16_t bytes = vorrq_u8(vshlq_n_u8(indices, 2), offset);
+    vst1q_u8(reinterpret_cast<u8*>(dst), vqtbl1q_u8(palette, bytes));
+    dst += pitch;
+  }
+}
+
+// Decodes the formats which have NEON implementations. Returns false for the others.
+static bool DecodeImpl_NEON(u32* dst, const u8* src, int width, int height,
+                            TextureFormat texformat)
+{
+  switch (texformat)
+  {
+  case TextureFormat::I4:
+    // Two rows of 4 bytes at a time, the high nibble of each byte being the left texel
+    for (int y = 0; y < height; y += 8)
+      for (int x = 0; x < width; x += 8)
+        for (int iy = 0; iy < 8; iy += 2, src += 8)
+        {
+          uint8x8_t high, low;
+          ExpandNibbles_NEON(vld1_u8(src), &high, &low);
+          const uint8x8x2_t rows = vzip_u8(high, low);
+          StoreIntensityRow_NEON(dst + (y + iy) * width + x, rows.val[0]);
+          StoreIntensityRow_NEON(dst + (y + iy + 1) * width + x, rows.val[1]);
+        }
+    return true;
+
+  case TextureFormat::I8:
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 8)
+        for (int iy = 0; iy < 4; iy++, src += 8)
+          StoreIntensityRow_NEON(dst + (y + iy) * width + x, vld1_u8(src));
+    return true;
+
+  case TextureFormat::IA4:
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 8)
+        for (int iy = 0; iy < 4; iy++, src += 8)
+        {
+          uint8x8_t alpha, intensity;
+          ExpandNibbles_NEON(vld1_u8(src), &alpha, &intensity);
+          vst4_u8(reinterpret_cast<u8*>(dst + (y + iy) * width + x),
+                  uint8x8x4_t{{intensity, intensity, intensity, alpha}});
+        }
+    return true;
+
+  case TextureFormat::IA8:
+  {
+    // Expands AI to IIIA, for two rows of 4 texels
+    static constexpr u8 row0[16] = {1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6};
+    static constexpr u8 row1[16] = {9, 9, 9, 8, 11, 11, 11, 10, 13, 13, 13, 12, 15, 15, 15, 14};
+    const uint8x16_t mask_row0 = vld1q_u8(row0);
+    const uint8x16_t mask_row1 = vld1q_u8(row1);
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4)
+        for (int iy = 0; iy < 4; iy += 2, src += 16)
+        {
+          const uint8x16_t rows = vld1q_u8(src);
+          vst1q_u8(reinterpret_cast<u8*>(dst + (y + iy) * width + x), vqtbl1q_u8(rows, mask_row0));
+          vst1q_u8(reinterpret_cast<u8*>(dst + (y + iy + 1) * width + x),
+                   vqtbl1q_u8(rows, mask_row1));
+        }
+    return true;
+  }
+
+  case TextureFormat::RGB565:
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4)
+        for (int iy = 0; iy < 4; iy += 2, src += 16)
+        {
+          const uint16x8_t texels = LoadTexels16_NEON(src);
+          const uint16x8_t r = Convert5To8_NEON(vshrq_n_u16(texels, 11));
+          const uint16x8_t g6 = vandq_u16(vshrq_n_u16(texels, 5), vdupq_n_u16(0x3f));
+          const uint16x8_t g = vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4));
+          const uint16x8_t b = Convert5To8_NEON(vandq_u16(texels, vdupq_n_u16(0x1f)));
+          StoreTexels16_NEON(dst + (y + iy) * width + x, dst + (y + iy + 1) * width + x,
+                             vorrq_u16(r, vshlq_n_u16(g, 8)), vorrq_u16(b, vdupq_n_u16(0xff00)));
+        }
+    return true;
+
+  case TextureFormat::RGB5A3:
+  {
+    const uint16x8_t mask_x1f = vdupq_n_u16(0x1f);
+    const uint16x8_t mask_x0f = vdupq_n_u16(0x0f);
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4)
+        for (int iy = 0; iy < 4; iy += 2, src += 16)
+        {
+          // Both encodings are decoded for every texel, and the top bit selects between them
+          const uint16x8_t texels = LoadTexels16_NEON(src);
+          const uint16x8_t is_rgb555 = vtstq_u16(texels, vdupq_n_u16(0x8000));
+
+          // RGB555 with an alpha of 0xff
+          const uint16x8_t r5 = Convert5To8_NEON(vandq_u16(vshrq_n_u16(texels, 10), mask_x1f));
+          const uint16x8_t g5 = Convert5To8_NEON(vandq_u16(vshrq_n_u16(texels, 5), mask_x1f));
+          const uint16x8_t b5 = Convert5To8_NEON(vandq_u16(texels, mask_x1f));
+
+          // RGBA4443
+          const uint16x8_t r4 = Convert4To8_NEON(vandq_u16(vshrq_n_u16(texels, 8), mask_x0f));
+          const uint16x8_t g4 = Convert4To8_NEON(vandq_u16(vshrq_n_u16(texels, 4), mask_x0f));
+          const uint16x8_t b4 = Convert4To8_NEON(vandq_u16(texels, mask_x0f));
+          const uint16x8_t a3 = vandq_u16(vshrq_n_u16(texels, 12), vdupq_n_u16(0x07));
+          const uint16x8_t a4 =
+              vorrq_u16(vorrq_u16(vshlq_n_u16(a3, 5), vshlq_n_u16(a3, 2)), vshrq_n_u16(a3, 1));
+
+          const uint16x8_t rg = vbslq_u16(is_rgb555, vorrq_u16(r5, vshlq_n_u16(g5, 8)),
+                                          vorrq_u16(r4, vshlq_n_u16(g4, 8)));
+          const uint16x8_t ba = vbslq_u16(is_rgb555, vorrq_u16(b5, vdupq_n_u16(0xff00)),
+                                          vorrq_u16(b4, vshlq_n_u16(a4, 8)));
+          StoreTexels16_NEON(dst + (y + iy) * width + x, dst + (y + iy + 1) * width + x, rg, ba);
+        }
+    return true;
+  }
+
+  case TextureFormat::RGBA8:
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4, src += 64)
+      {
+        // The AR half of the block is followed by the GB half
+        const uint8x16x2_t ar = vld2q_u8(src);
+        const uint8x16x2_t gb = vld2q_u8(src + 32);
+        const uint8x16x2_t rg = vzipq_u8(ar.val[1], gb.val[0]);
+        const uint8x16x2_t ba = vzipq_u8(gb.val[1], ar.val[0]);
+        u32* row = dst + y * width + x;
+        StoreTexels16_NEON(row, row + width, vreinterpretq_u16_u8(rg.val[0]),
+                           vreinterpretq_u16_u8(ba.val[0]));
+        StoreTexels16_NEON(row + 2 * width, row + 3 * width, vreinterpretq_u16_u8(rg.val[1]),
+                           vreinterpretq_u16_u8(ba.val[1]));
+      }
+    return true;
+
+  case TextureFormat::CMPR:
+    for (int y = 0; y < height; y += 8)
+    {
+      for (int x = 0; x < width; x += 8)
+      {
+        const DXTBlock* blocks = reinterpret_cast<const DXTBlock*>(src);
+        DecodeDXTBlock_NEON(dst + y * width + x, &blocks[0], width);
+        DecodeDXTBlock_NEON(dst + y * width + x + 4, &blocks[1], width);
+        DecodeDXTBlock_NEON(dst + (y + 4) * width + x, &blocks[2], width);
+        DecodeDXTBlock_NEON(dst + (y + 4) * width + x + 4, &blocks[3], width);
+        src += 4 * sizeof(DXTBlock);
+      }
+    }
+    return true;
+
+  default:
+    return false;
+  }
+}
+#endif
+
 // JSD 01/06/11:
 // TODO: we really should ensure BOTH the source and destination addresses are aligned to 16-byte
 // boundaries to
@@ -181,6 +368,11 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt)
 {
+#if defined(_M_ARM_64)
+  if (DecodeImpl_NEON(dst, src, width, height, texformat))
+    return;
+#endif
+
   const int Wsteps4 = (width + 3) / 4;
   const int Wsteps8 = (width + 7) / 8;
 
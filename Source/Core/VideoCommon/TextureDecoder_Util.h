@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <array>
+
 #include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "VideoCommon/LookUpTables.h"
 
 struct DXTBlock
 {
@@ -22,3 +26,35 @@ constexpr int DXTBlend(int v1, int v2)
   // 3/8 blend, which is close to 1/3
   return ((v1 * 3 + v2 * 5) >> 3);
 }
+
+// The colors which the 2-bit indices of a DXT block select from
+inline std::array<u32, 4> GetDXTBlockColors(const DXTBlock& block)
+{
+  // S3TC Decoder (Note: GCN decodes differently from PC so we can't use native support)
+  const u16 c1 = Common::swap16(block.color1);
+  const u16 c2 = Common::swap16(block.color2);
+  const int blue1 = Convert5To8(c1 & 0x1F);
+  const int blue2 = Convert5To8(c2 & 0x1F);
+  const int green1 = Convert6To8((c1 >> 5) & 0x3F);
+  const int green2 = Convert6To8((c2 >> 5) & 0x3F);
+  const int red1 = Convert5To8((c1 >> 11) & 0x1F);
+  const int red2 = Convert5To8((c2 >> 11) & 0x1F);
+  std::array<u32, 4> colors;
+  colors[0] = MakeRGBA(red1, green1, blue1, 255);
+  colors[1] = MakeRGBA(red2, green2, blue2, 255);
+  if (c1 > c2)
+  {
+    colors[2] =
+        MakeRGBA(DXTBlend(red2, red1), DXTBlend(green2, green1), DXTBlend(blue2, blue1), 255);
+    colors[3] =
+        MakeRGBA(DXTBlend(red1, red2), DXTBlend(green1, green2), DXTBlend(blue1, blue2), 255);
+  }
+  else
+  {
+    // color[3] is the same as color[2] (average of both colors), but transparent.
+    // This differs from DXT1 where color[3] is transparent black.
+    colors[2] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 255);
+    colors[3] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 0);
+  }
+  return colors;
+}
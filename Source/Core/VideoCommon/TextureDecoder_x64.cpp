@@ -254,6 +254,52 @@ static void TexDecoder_DecodeImpl_C4(u32* dst, const u8* src, int width, int hei
   }
 }
 
+// Expands 16 intensities to two rows of 8 texels each
+FUNCTION_TARGET_AVX2
+static inline void StoreIntensityRows_AVX2(u32* row0, u32* row1, __m128i intensities)
+{
+  const __m256i mask_row0 = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,  //
+                                             4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+  const __m256i mask_row1 = _mm256_add_epi8(mask_row0, _mm256_set1_epi8(8));
+
+  const __m256i both = _mm256_broadcastsi128_si256(intensities);
+  _mm256_storeu_si256((__m256i*)row0, _mm256_shuffle_epi8(both, mask_row0));
+  _mm256_storeu_si256((__m256i*)row1, _mm256_shuffle_epi8(both, mask_row1));
+}
+
+// Replicates the high and the low nibble of each byte into a whole byte
+FUNCTION_TARGET_AVX2
+static inline void ExpandNibbles_AVX2(__m128i bytes, __m128i* high, __m128i* low)
+{
+  const __m128i hi = _mm_and_si128(bytes, _mm_set1_epi8(static_cast<s8>(0xf0)));
+  const __m128i lo = _mm_and_si128(bytes, _mm_set1_epi8(0x0f));
+  *high = _mm_or_si128(hi, _mm_srli_epi16(hi, 4));
+  *low = _mm_or_si128(lo, _mm_slli_epi16(lo, 4));
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 8; iy += 4, xStep += 2)
+      {
+        // Four rows of 8 texels, with the high nibble of each byte being the left texel
+        __m128i high, low;
+        ExpandNibbles_AVX2(_mm_loadu_si128((const __m128i*)(src + 8 * xStep)), &high, &low);
+
+        u32* row = dst + (y + iy) * width + x;
+        StoreIntensityRows_AVX2(row, row + width, _mm_unpacklo_epi8(high, low));
+        StoreIntensityRows_AVX2(row + 2 * width, row + 3 * width, _mm_unpackhi_epi8(high, low));
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_I4_SSSE3(u32* dst, const u8* src, int width, int height,
                                            TextureFormat texformat, const u8* tlut,
@@ -563,6 +609,35 @@ static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA4_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Expands pairs of intensity and alpha to IIIA, the low lane for texels 0-3 and the high lane
+  // for texels 4-7
+  const __m256i mask = _mm256_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7,  //
+                                        8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        // Two rows of 8 texels, with alpha in the high nibble of each byte
+        __m128i alpha, intensity;
+        ExpandNibbles_AVX2(_mm_loadu_si128((const __m128i*)(src + 8 * xStep)), &alpha, &intensity);
+        const __m256i row0 = _mm256_broadcastsi128_si256(_mm_unpacklo_epi8(intensity, alpha));
+        const __m256i row1 = _mm256_broadcastsi128_si256(_mm_unpackhi_epi8(intensity, alpha));
+
+        u32* row = dst + (y + iy) * width + x;
+        _mm256_storeu_si256((__m256i*)row, _mm256_shuffle_epi8(row0, mask));
+        _mm256_storeu_si256((__m256i*)(row + width), _mm256_shuffle_epi8(row1, mask));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int height,
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
@@ -579,6 +654,49 @@ static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int he
   }
 }
 
+// Stores the lanes of two registers which each hold a row of a 4x4 block in the low lane and the
+// row two below it in the high lane
+FUNCTION_TARGET_AVX2
+static inline void StoreBlockRows_AVX2(u32* dst, int width, __m256i rows02, __m256i rows13)
+{
+  _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(rows02));
+  _mm_storeu_si128((__m128i*)(dst + width), _mm256_castsi256_si128(rows13));
+  _mm_storeu_si128((__m128i*)(dst + 2 * width), _mm256_extracti128_si256(rows02, 1));
+  _mm_storeu_si128((__m128i*)(dst + 3 * width), _mm256_extracti128_si256(rows13, 1));
+}
+
+// Shuffle masks which take the 16-bit texels of the first or the second row in each lane of a
+// 4x4 block of them, and move them to the low halves of 32-bit words, byte swapped
+FUNCTION_TARGET_AVX2
+static inline __m256i GetSwapMask_AVX2(int row)
+{
+  const __m256i mask = _mm256_setr_epi8(1, 0, -128, -128, 3, 2, -128, -128, 5, 4, -128, -128, 7,
+                                        6, -128, -128, 1, 0, -128, -128, 3, 2, -128, -128, 5, 4,
+                                        -128, -128, 7, 6, -128, -128);
+  // The zeroing bytes stay negative
+  return _mm256_add_epi8(mask, _mm256_set1_epi8(static_cast<s8>(8 * row)));
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Expands AI to IIIA, for the first or the second row in each lane
+  const __m256i mask_row0 = _mm256_setr_epi8(1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6,  //
+                                             1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6);
+  const __m256i mask_row1 = _mm256_add_epi8(mask_row0, _mm256_set1_epi8(8));
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      const __m256i block = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+      StoreBlockRows_AVX2(dst + y * width + x, width, _mm256_shuffle_epi8(block, mask_row0),
+                          _mm256_shuffle_epi8(block, mask_row1));
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_IA8_SSSE3(u32* dst, const u8* src, int width, int height,
                                             TextureFormat texformat, const u8* tlut,
@@ -703,6 +821,51 @@ static void TexDecoder_DecodeImpl_C14X2(u32* dst, const u8* src, int width, int
   }
 }
 
+// Converts 4 bits per lane to 8 bits by replicating them
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert4To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 4), v);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert5To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 3), _mm256_srli_epi32(v, 2));
+}
+
+// Takes 16-bit RGB565 texels in the low halves of 32-bit words
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeRGB565_AVX2(__m256i texels)
+{
+  const __m256i r = Convert5To8_AVX2(_mm256_srli_epi32(texels, 11));
+  const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(texels, 5), _mm256_set1_epi32(0x3f));
+  const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+  const __m256i b = Convert5To8_AVX2(_mm256_and_si256(texels, _mm256_set1_epi32(0x1f)));
+  return _mm256_or_si256(
+      _mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+      _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_set1_epi32(static_cast<s32>(0xff000000))));
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB565_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i mask_row0 = GetSwapMask_AVX2(0);
+  const __m256i mask_row1 = GetSwapMask_AVX2(1);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      const __m256i block = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+      StoreBlockRows_AVX2(dst + y * width + x, width,
+                          DecodeRGB565_AVX2(_mm256_shuffle_epi8(block, mask_row0)),
+                          DecodeRGB565_AVX2(_mm256_shuffle_epi8(block, mask_row1)));
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int height,
                                          TextureFormat texformat, const u8* tlut,
                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
@@ -774,6 +937,57 @@ static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int
   }
 }
 
+// Takes 16-bit RGB5A3 texels in the low halves of 32-bit words. Both encodings are decoded for
+// every texel, and the top bit selects between them.
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeRGB5A3_AVX2(__m256i texels)
+{
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i mask_x0f = _mm256_set1_epi32(0x0f);
+
+  // RGB555 with an alpha of 0xff
+  const __m256i r5 = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(texels, 10), mask_x1f));
+  const __m256i g5 = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(texels, 5), mask_x1f));
+  const __m256i b5 = Convert5To8_AVX2(_mm256_and_si256(texels, mask_x1f));
+  const __m256i rgb555 = _mm256_or_si256(
+      _mm256_or_si256(r5, _mm256_slli_epi32(g5, 8)),
+      _mm256_or_si256(_mm256_slli_epi32(b5, 16), _mm256_set1_epi32(static_cast<s32>(0xff000000))));
+
+  // RGBA4443
+  const __m256i r4 = Convert4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(texels, 8), mask_x0f));
+  const __m256i g4 = Convert4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(texels, 4), mask_x0f));
+  const __m256i b4 = Convert4To8_AVX2(_mm256_and_si256(texels, mask_x0f));
+  const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(texels, 12), _mm256_set1_epi32(0x07));
+  const __m256i a5 = _mm256_or_si256(_mm256_slli_epi32(a3, 5), _mm256_slli_epi32(a3, 2));
+  const __m256i a = _mm256_or_si256(a5, _mm256_srli_epi32(a3, 1));
+  const __m256i rgba4443 =
+      _mm256_or_si256(_mm256_or_si256(r4, _mm256_slli_epi32(g4, 8)),
+                      _mm256_or_si256(_mm256_slli_epi32(b4, 16), _mm256_slli_epi32(a, 24)));
+
+  // All bits set if bit 15 is
+  const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(texels, 16), 31);
+  return _mm256_blendv_epi8(rgba4443, rgb555, is_rgb555);
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i mask_row0 = GetSwapMask_AVX2(0);
+  const __m256i mask_row1 = GetSwapMask_AVX2(1);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      const __m256i block = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+      StoreBlockRows_AVX2(dst + y * width + x, width,
+                          DecodeRGB5A3_AVX2(_mm256_shuffle_epi8(block, mask_row0)),
+                          DecodeRGB5A3_AVX2(_mm256_shuffle_epi8(block, mask_row1)));
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int width, int height,
                                                TextureFormat texformat, const u8* tlut,
@@ -1001,6 +1215,31 @@ static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGBA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // AGRB to RGBA
+  const __m256i mask = _mm256_setr_epi8(2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12,  //
+                                        2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      // The AR and the GB halves of the block, each with rows 0 and 1 in the low lane and rows 2
+      // and 3 in the high lane
+      const u8* src2 = src + 64 * yStep;
+      const __m256i ar = _mm256_loadu_si256((const __m256i*)src2);
+      const __m256i gb = _mm256_loadu_si256((const __m256i*)src2 + 1);
+
+      StoreBlockRows_AVX2(dst + y * width + x, width,
+                          _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar, gb), mask),
+                          _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar, gb), mask));
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGBA8_SSSE3(u32* dst, const u8* src, int width, int height,
                                               TextureFormat texformat, const u8* tlut,
@@ -1157,6 +1396,87 @@ static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int
   }
 }
 
+// Calculates the palettes of two DXT blocks side by side, the left block's in the low lane
+FUNCTION_TARGET_AVX2
+static inline __m256i GetDXTBlockColors_AVX2(__m128i dxt)
+{
+  // color1 and color2 of both blocks, byteswapped: c1 left, c2 left, c1 right, c2 right
+  const __m128i raw = _mm_shuffle_epi8(
+      dxt, _mm_setr_epi8(1, 0, -1, -1, 3, 2, -1, -1, 9, 8, -1, -1, 11, 10, -1, -1));
+  const __m128i rgb = _mm256_castsi256_si128(DecodeRGB565_AVX2(_mm256_castsi128_si256(raw)));
+
+  // The channels of color1 and color2 of the left block, then of the right block
+  const __m128i color1 = _mm_cvtepu8_epi16(_mm_shuffle_epi32(rgb, _MM_SHUFFLE(2, 0, 2, 0)));
+  const __m128i color2 = _mm_cvtepu8_epi16(_mm_shuffle_epi32(rgb, _MM_SHUFFLE(3, 1, 3, 1)));
+
+  // Blocks where color1 > color2 interpolate color2 and color3, the others use the average and
+  // transparent black.
+  const __m128i greater = _mm_cmpgt_epi32(_mm_shuffle_epi32(raw, _MM_SHUFFLE(2, 0, 2, 0)),
+                                          _mm_shuffle_epi32(raw, _MM_SHUFFLE(3, 1, 3, 1)));
+  const __m128i interpolate = _mm_unpacklo_epi32(greater, greater);
+
+  const __m128i three = _mm_set1_epi16(3);
+  const __m128i five = _mm_set1_epi16(5);
+  const __m128i blend2 = _mm_srli_epi16(
+      _mm_add_epi16(_mm_mullo_epi16(color2, three), _mm_mullo_epi16(color1, five)), 3);
+  const __m128i blend3 = _mm_srli_epi16(
+      _mm_add_epi16(_mm_mullo_epi16(color1, three), _mm_mullo_epi16(color2, five)), 3);
+  const __m128i average = _mm_srli_epi16(_mm_add_epi16(color1, color2), 1);
+  const __m128i no_alpha = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+
+  const __m128i color3 = _mm_blendv_epi8(_mm_and_si128(average, no_alpha), blend3, interpolate);
+  const __m128i blended = _mm_packus_epi16(_mm_blendv_epi8(average, blend2, interpolate), color3);
+
+  // blended holds color2 left, color2 right, color3 left, color3 right
+  const __m128i ordered = _mm_shuffle_epi32(blended, _MM_SHUFFLE(3, 1, 2, 0));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi64(rgb, ordered)),
+                                 _mm_unpackhi_epi64(rgb, ordered), 1);
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Each row of a DXT block is a byte of 2-bit indices, the leftmost texel's in the top bits.
+  // These shift the index of each texel of a row to the bottom.
+  __m256i shifts[4];
+  for (int row = 0; row < 4; ++row)
+  {
+    const __m256i row_shifts = _mm256_setr_epi32(6, 4, 2, 0, 6, 4, 2, 0);
+    shifts[row] = _mm256_add_epi32(row_shifts, _mm256_set1_epi32(8 * row));
+  }
+  // The colors of the right block are in the high lane
+  const __m256i right_block = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      // Two DXT blocks side by side, for the top and the bottom half of the 8x8 block
+      for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+      {
+        const __m128i dxt = _mm_loadu_si128((const __m128i*)(src + sizeof(DXTBlock) * 2 * xStep));
+        const __m256i colors = GetDXTBlockColors_AVX2(dxt);
+
+        // The lines of the left block are in the second word and those of the right in the fourth
+        const __m256i lines = _mm256_permutevar8x32_epi32(
+            _mm256_castsi128_si256(dxt), _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3));
+
+        u32* dst32 = dst + (y + z * 4) * width + x;
+        for (int row = 0; row < 4; ++row)
+        {
+          const __m256i indices = _mm256_or_si256(
+              _mm256_and_si256(_mm256_srlv_epi32(lines, shifts[row]), _mm256_set1_epi32(3)),
+              right_block);
+          _mm256_storeu_si256((__m256i*)(dst32 + row * width),
+                              _mm256_permutevar8x32_epi32(colors, indices));
+        }
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int height,
                                        TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                        int Wsteps4, int Wsteps8)
@@ -1426,7 +1746,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I4:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I4_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1446,11 +1769,19 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::IA4:
-    TexDecoder_DecodeImpl_IA4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else
+      TexDecoder_DecodeImpl_IA4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                Wsteps8);
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1464,12 +1795,19 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGB565:
-    TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                 Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB565_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else
+      TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                   Wsteps8);
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1478,7 +1816,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGBA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGBA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGBA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                         Wsteps8);
     else
@@ -1487,7 +1828,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
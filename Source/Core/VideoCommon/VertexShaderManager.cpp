@@ -482,11 +482,15 @@ void VertexShaderManager::TransformToClipSpace(const float* data, float* out, u3
 
 void VertexShaderManager::DoState(PointerWrap& p)
 {
-  p.DoArray(m_projection_matrix);
-  p.Do(m_viewport_correction);
-  g_freelook_camera.DoState(p);
-
-  p.Do(constants);
+  // The free-look camera only exists on the host, and everything else here is derived from XF
+  // memory together with host settings like free-look, so none of it goes into the state hash.
+  p.DoHostOnly([&] {
+    p.DoArray(m_projection_matrix);
+    p.Do(m_viewport_correction);
+    g_freelook_camera.DoState(p);
+
+    p.Do(constants);
+  });
 
   if (p.IsReadMode())
   {
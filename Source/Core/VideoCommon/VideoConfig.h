@@ -215,6 +215,7 @@ struct VideoConfig final
   bool bBBoxEnable = false;
   bool bForceProgressive = false;
   bool bCPUCull = false;
+  bool bNoRender = false;
 
   bool bEFBEmulateFormatChanges = false;
   bool bSkipEFBCopyToRam = false;
@@ -338,6 +339,7 @@ struct VideoConfig final
     bool bSupportsVSLinePointExpand = false;
     bool bSupportsGLLayerInFS = true;
     bool bSupportsHDROutput = false;
+    bool bSupportsNoRender = false;  // Only the Null backend can do without rendering
   } backend_info;
 
   // Utility
@@ -358,6 +360,10 @@ struct VideoConfig final
   {
     return backend_info.bSupportsGPUTextureDecoding && bEnableGPUTextureDecoding;
   }
+  // Whether vertices, textures and the XFB are left alone, and EFB copies only fill the memory
+  // they cover with a placeholder. The GX state is still kept up to date, for runs which only
+  // care about RAM.
+  bool SkipRendering() const { return backend_info.bSupportsNoRender && bNoRender; }
   bool UseVertexRounding() const { return bVertexRounding && iEFBScale != 1; }
   bool ManualTextureSamplingWithCustomTextureSizes() const
   {
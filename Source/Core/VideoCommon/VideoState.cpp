@@ -90,20 +90,24 @@ void VideoCommon_DoState(PointerWrap& p)
   g_vertex_manager->DoState(p);
   p.DoMarker("VertexManager");
 
+  // The EFB is hashed at native resolution. The texture cache only holds copies of host GPU
+  // resources, which are expensive to read back.
   g_framebuffer_manager->DoState(p);
   p.DoMarker("FramebufferManager");
 
-  g_texture_cache->DoState(p);
+  p.DoHostOnly([&] { g_texture_cache->DoState(p); });
   p.DoMarker("TextureCache");
 
-  g_presenter->DoState(p);
-  g_frame_dumper->DoState(p);
+  p.DoHostOnly([&] {
+    g_presenter->DoState(p);
+    g_frame_dumper->DoState(p);
+  });
   p.DoMarker("Presenter");
 
   g_bounding_box->DoState(p);
   p.DoMarker("Bounding Box");
 
-  g_widescreen->DoState(p);
+  p.DoHostOnly([&] { g_widescreen->DoState(p); });
   p.DoMarker("Widescreen");
 
   system.GetXFStateManager().DoState(p);
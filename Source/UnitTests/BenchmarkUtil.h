@@ -0,0 +1,45 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Timer.h"
+
+// Measures how fast functions get through a fixed amount of work, e.g. pixels or bytes. Each call
+// of a measured function is expected to process amount_per_call of unit.
+class Benchmark
+{
+public:
+  Benchmark(std::string_view unit, double amount_per_call, size_t iterations)
+      : m_unit(unit), m_amount_per_call(amount_per_call), m_iterations(iterations)
+  {
+  }
+
+  // Calls function once to warm up caches and thread pools, then times it over the configured
+  // number of iterations and prints the throughput next to name.
+  void Measure(std::string_view name, const std::function<void()>& function) const
+  {
+    function();
+
+    const u64 start = Common::Timer::NowUs();
+    for (size_t i = 0; i < m_iterations; ++i)
+      function();
+    const u64 elapsed_us = std::max<u64>(1, Common::Timer::NowUs() - start);
+
+    const double amount = m_amount_per_call * m_iterations;
+    fmt::print("{:<32} {:>10.1f} {}/s\n", name, amount * 1000000 / elapsed_us, m_unit);
+  }
+
+private:
+  std::string_view m_unit;
+  double m_amount_per_call;
+  size_t m_iterations;
+};
@@ -0,0 +1,62 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+
+TEST(AES, CryptMultipleMatchesCrypt)
+{
+  constexpr std::array<u8, 16> key{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                   0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+  const auto encrypt = Common::AES::CreateContextEncrypt(key.data());
+  const auto decrypt = Common::AES::CreateContextDecrypt(key.data());
+
+  constexpr size_t LEN = 0x100;
+  constexpr size_t MAX_COUNT = 19;
+
+  std::vector<u8> in(LEN * MAX_COUNT);
+  for (size_t i = 0; i < in.size(); ++i)
+    in[i] = static_cast<u8>(i * 13 + i / 256);
+
+  std::vector<std::array<u8, 16>> ivs(MAX_COUNT);
+  for (size_t i = 0; i < ivs.size(); ++i)
+    ivs[i].fill(static_cast<u8>(i));
+
+  for (size_t count = 0; count <= MAX_COUNT; ++count)
+  {
+    std::vector<u8> expected(LEN * count);
+    std::vector<u8> actual(LEN * count);
+    std::vector<u8> decrypted(LEN * count);
+
+    std::vector<const u8*> iv_ptrs(count);
+    std::vector<const u8*> in_ptrs(count);
+    std::vector<const u8*> actual_ptrs(count);
+    std::vector<u8*> out_ptrs(count);
+    std::vector<u8*> decrypted_ptrs(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Every third buffer uses an IV of zero
+      iv_ptrs[i] = i % 3 == 0 ? nullptr : ivs[i].data();
+      in_ptrs[i] = in.data() + i * LEN;
+      actual_ptrs[i] = actual.data() + i * LEN;
+      out_ptrs[i] = actual.data() + i * LEN;
+      decrypted_ptrs[i] = decrypted.data() + i * LEN;
+
+      ASSERT_TRUE(encrypt->Crypt(iv_ptrs[i], in_ptrs[i], expected.data() + i * LEN, LEN));
+    }
+
+    ASSERT_TRUE(
+        encrypt->CryptMultiple(iv_ptrs.data(), in_ptrs.data(), out_ptrs.data(), count, LEN));
+    EXPECT_EQ(expected, actual) << count << " buffers";
+
+    ASSERT_TRUE(decrypt->CryptMultiple(iv_ptrs.data(), actual_ptrs.data(), decrypted_ptrs.data(),
+                                       count, LEN));
+    EXPECT_TRUE(std::equal(decrypted.begin(), decrypted.end(), in.begin())) << count << " buffers";
+  }
+}
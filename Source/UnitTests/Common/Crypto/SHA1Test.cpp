@@ -1,5 +1,8 @@
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/Crypto/SHA1.h"
 
 // Just a few quick sanity checks
@@ -28,3 +31,31 @@ TEST(SHA1, Vectors)
     EXPECT_EQ(test.expected, actual);
   }
 }
+
+TEST(SHA1, MultipleMessages)
+{
+  std::vector<u8> msgs(0x400 * 9);
+  for (size_t i = 0; i < msgs.size(); ++i)
+    msgs[i] = static_cast<u8>(i * 7 + i / 251);
+
+  // Also cover the path used by CPUs without the SHA instructions
+  const bool has_sha1_instructions = cpu_info.bSHA1;
+  for (const bool use_sha1_instructions : {false, has_sha1_instructions})
+  {
+    cpu_info.bSHA1 = use_sha1_instructions;
+    for (const size_t msg_len : {0, 1, 55, 56, 63, 64, 65, 119, 120, 0x400})
+    {
+      for (size_t count = 0; count <= 9; ++count)
+      {
+        std::vector<Common::SHA1::Digest> digests(count);
+        Common::SHA1::CalculateDigests(msgs.data(), msg_len, count, digests.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+          EXPECT_EQ(Common::SHA1::CalculateDigest(msgs.data() + i * msg_len, msg_len), digests[i])
+              << "length " << msg_len << ", message " << i << " of " << count;
+        }
+      }
+    }
+  }
+  cpu_info.bSHA1 = has_sha1_instructions;
+}
@@ -0,0 +1,79 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+
+namespace
+{
+class RecordingHasher final : public PointerWrap::Hasher
+{
+public:
+  void Update(const void* data, size_t size) override
+  {
+    const u8* bytes = static_cast<const u8*>(data);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+  }
+
+  std::vector<u8> m_data;
+};
+
+struct TestState
+{
+  u32 a = 0x11223344;
+  std::array<u8, 3> b{5, 6, 7};
+  u16 host = 0xBEEF;
+
+  void DoState(PointerWrap& p)
+  {
+    p.DoSection("A", [&] { p.Do(a); });
+    p.DoSection("B", [&] { p.Do(b); });
+    p.DoHostOnly([&] { p.Do(host); });
+  }
+};
+}  // namespace
+
+TEST(PointerWrap, SectionsAreRecordedInWriteMode)
+{
+  TestState state;
+  std::vector<u8> buffer(sizeof(u32) + 3 + sizeof(u16));
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Write);
+  std::vector<PointerWrap::Section> sections;
+  p.SetSectionLog(&sections);
+  state.DoState(p);
+
+  ASSERT_TRUE(p.IsWriteMode());
+  ASSERT_EQ(sections.size(), 2u);
+  EXPECT_EQ(sections[0].name, "A");
+  EXPECT_EQ(sections[0].offset, 0u);
+  EXPECT_EQ(sections[0].size, sizeof(u32));
+  EXPECT_EQ(sections[1].name, "B");
+  EXPECT_EQ(sections[1].offset, sizeof(u32));
+  EXPECT_EQ(sections[1].size, 3u);
+  EXPECT_EQ(p.GetOffset(), buffer.size());
+}
+
+TEST(PointerWrap, HasherSeesSerializedDataExceptHostOnly)
+{
+  TestState state;
+  std::vector<u8> buffer(sizeof(u32) + 3 + sizeof(u16));
+  u8* ptr = buffer.data();
+  PointerWrap write(&ptr, buffer.size(), PointerWrap::Mode::Write);
+  state.DoState(write);
+
+  RecordingHasher hasher;
+  ptr = nullptr;
+  PointerWrap hash(&ptr, 0, PointerWrap::Mode::Measure);
+  hash.SetHasher(&hasher);
+  state.DoState(hash);
+
+  // Everything but the trailing host-only field.
+  EXPECT_EQ(hasher.m_data, std::vector<u8>(buffer.begin(), buffer.end() - sizeof(u16)));
+}
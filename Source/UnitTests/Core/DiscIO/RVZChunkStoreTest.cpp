@@ -0,0 +1,224 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/RVZChunkStore.h"
+#include "DiscIO/WIABlob.h"
+
+#include "../../TestUtil.h"
+
+using DiscIO::RVZChunkStore;
+
+class RVZChunkStoreTest : public TemporaryDirectoryTest
+{
+protected:
+  RVZChunkStoreTest() : m_path(m_directory + "/store.rvzs") {}
+
+  static RVZChunkStore::ChunkInfo MakeInfo(const std::vector<u8>& data, u32 rvz_packed_size = 0,
+                                           u64 data_offset = 0)
+  {
+    return {static_cast<u32>(data.size()) | 0x80000000, rvz_packed_size, data_offset, false};
+  }
+
+  static constexpr RVZChunkStore::Parameters PARAMETERS{5, 0x20000, 0, {}};
+
+  std::string m_path;
+};
+
+TEST_F(RVZChunkStoreTest, IdenticalChunksAreStoredOnce)
+{
+  const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+  ASSERT_TRUE(store);
+
+  const std::vector<u8> a = MakeRandomData(0x1234, 1);
+  const std::vector<u8> b = MakeRandomData(0x1234, 2);
+
+  const std::optional<u32> first = store->AddChunk(MakeInfo(a), {}, a);
+  const std::optional<u32> second = store->AddChunk(MakeInfo(b), {}, b);
+  const std::optional<u32> third = store->AddChunk(MakeInfo(a), {}, a);
+  ASSERT_TRUE(first && second && third);
+
+  EXPECT_NE(*first, *second);
+  EXPECT_EQ(*first, *third);
+}
+
+TEST_F(RVZChunkStoreTest, ChunksDecodedDifferentlyAreKeptApart)
+{
+  const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+  ASSERT_TRUE(store);
+
+  const std::vector<u8> data = MakeRandomData(0x1000, 3);
+
+  // Where junk data starts within a block only matters when RVZ packing is used
+  EXPECT_EQ(store->AddChunk(MakeInfo(data, 0, 0), {}, data),
+            store->AddChunk(MakeInfo(data, 0, 0x4000), {}, data));
+  EXPECT_NE(store->AddChunk(MakeInfo(data, 0x1000, 0), {}, data),
+            store->AddChunk(MakeInfo(data, 0x1000, 0x4000), {}, data));
+  EXPECT_EQ(store->AddChunk(MakeInfo(data, 0x1000, 0), {}, data),
+            store->AddChunk(MakeInfo(data, 0x1000, 0x8000), {}, data));
+
+  RVZChunkStore::ChunkInfo partition_info = MakeInfo(data);
+  partition_info.has_exception_lists = true;
+  EXPECT_NE(store->AddChunk(MakeInfo(data), {}, data),
+            store->AddChunk(partition_info, {}, data));
+}
+
+TEST_F(RVZChunkStoreTest, ReopenedStoreKeepsChunks)
+{
+  const std::vector<u8> exceptions = MakeRandomData(0x20, 4);
+  const std::vector<u8> data = MakeRandomData(0x3456, 5);
+
+  std::optional<u32> reference;
+  RVZChunkStore::StoreID id;
+  {
+    const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+    ASSERT_TRUE(store);
+    reference = store->AddChunk(MakeInfo(data), exceptions, data);
+    ASSERT_TRUE(reference);
+    id = store->GetID();
+  }
+
+  const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+  ASSERT_TRUE(store);
+  EXPECT_EQ(store->GetID(), id);
+  EXPECT_EQ(store->AddChunk(MakeInfo(data), exceptions, data), reference);
+
+  File::IOFile file(m_path, "rb");
+  RVZChunkStore::StoreID read_id;
+  RVZChunkStore::Parameters read_parameters;
+  ASSERT_TRUE(RVZChunkStore::ReadHeader(&file, &read_id, &read_parameters));
+  EXPECT_EQ(read_id, id);
+  EXPECT_EQ(read_parameters, PARAMETERS);
+
+  std::vector<u8> stored(exceptions.size() + data.size());
+  ASSERT_TRUE(file.Seek(RVZChunkStore::GetDataOffset(*reference), File::SeekOrigin::Begin));
+  ASSERT_TRUE(file.ReadBytes(stored.data(), stored.size()));
+  EXPECT_TRUE(std::equal(exceptions.begin(), exceptions.end(), stored.begin()));
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), stored.begin() + exceptions.size()));
+}
+
+TEST_F(RVZChunkStoreTest, IncompleteChunkIsDiscarded)
+{
+  const std::vector<u8> a = MakeRandomData(0x2000, 6);
+  const std::vector<u8> b = MakeRandomData(0x2000, 7);
+
+  std::optional<u32> reference_b;
+  {
+    const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+    ASSERT_TRUE(store);
+    ASSERT_TRUE(store->AddChunk(MakeInfo(a), {}, a));
+    reference_b = store->AddChunk(MakeInfo(b), {}, b);
+    ASSERT_TRUE(reference_b);
+  }
+
+  // Simulate a conversion that was interrupted while writing b
+  {
+    File::IOFile file(m_path, "r+b");
+    ASSERT_TRUE(file.Resize(RVZChunkStore::GetDataOffset(*reference_b) + 0x100));
+  }
+
+  const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+  ASSERT_TRUE(store);
+  EXPECT_EQ(store->AddChunk(MakeInfo(b), {}, b), reference_b);
+}
+
+TEST_F(RVZChunkStoreTest, OtherParametersAreRejected)
+{
+  ASSERT_TRUE(RVZChunkStore::OpenForWriting(m_path, PARAMETERS));
+
+  RVZChunkStore::Parameters parameters = PARAMETERS;
+  parameters.chunk_size *= 2;
+  EXPECT_FALSE(RVZChunkStore::OpenForWriting(m_path, parameters));
+
+  File::IOFile(m_path, "wb").WriteString("Not a chunk store");
+  EXPECT_FALSE(RVZChunkStore::OpenForWriting(m_path, PARAMETERS));
+}
+
+TEST_F(RVZChunkStoreTest, DamagedStoreIsLeftAlone)
+{
+  const std::vector<u8> a = MakeRandomData(0x2000, 8);
+  const std::vector<u8> b = MakeRandomData(0x2000, 9);
+
+  std::optional<u32> reference_a;
+  {
+    const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+    ASSERT_TRUE(store);
+    reference_a = store->AddChunk(MakeInfo(a), {}, a);
+    ASSERT_TRUE(reference_a);
+    ASSERT_TRUE(store->AddChunk(MakeInfo(b), {}, b));
+  }
+
+  const u64 size = File::GetSize(m_path);
+  {
+    File::IOFile file(m_path, "r+b");
+    const u32 bad_magic = 0;
+    ASSERT_TRUE(file.Seek(RVZChunkStore::GetDataOffset(*reference_a) - 0x20,
+                          File::SeekOrigin::Begin));
+    ASSERT_TRUE(file.WriteArray(&bad_magic, 1));
+  }
+
+  EXPECT_FALSE(RVZChunkStore::OpenForWriting(m_path, PARAMETERS));
+  EXPECT_EQ(File::GetSize(m_path), size);
+}
+
+TEST_F(RVZChunkStoreTest, StoreInUseIsRejected)
+{
+  const auto store = RVZChunkStore::OpenForWriting(m_path, PARAMETERS);
+  ASSERT_TRUE(store);
+  EXPECT_FALSE(RVZChunkStore::OpenForWriting(m_path, PARAMETERS));
+}
+
+TEST_F(RVZChunkStoreTest, ConvertedFilesShareStore)
+{
+  // Two images which only differ in their second half, like two revisions of a game
+  constexpr size_t IMAGE_SIZE = 0x100000;
+  const std::vector<u8> first_half = MakeRandomData(IMAGE_SIZE / 2, 10);
+  std::vector<std::vector<u8>> images;
+  for (u32 seed : {11, 12})
+  {
+    std::vector<u8> image = first_half;
+    const std::vector<u8> second_half = MakeRandomData(IMAGE_SIZE / 2, seed);
+    image.insert(image.end(), second_half.begin(), second_half.end());
+    images.push_back(std::move(image));
+  }
+
+  const auto callback = [](const std::string&, float) { return true; };
+  for (size_t i = 0; i < images.size(); ++i)
+  {
+    const std::string iso_path = m_directory + "/" + std::to_string(i) + ".iso";
+    const std::string rvz_path = m_directory + "/" + std::to_string(i) + ".rvz";
+    ASSERT_TRUE(File::IOFile(iso_path, "wb").WriteBytes(images[i].data(), images[i].size()));
+
+    const auto iso = DiscIO::CreateBlobReader(iso_path);
+    ASSERT_TRUE(iso);
+    ASSERT_TRUE(DiscIO::ConvertToWIAOrRVZ(iso.get(), iso_path, rvz_path, true,
+                                          DiscIO::WIARVZCompressionType::Zstd, 5, 0x20000,
+                                          callback, m_path));
+  }
+
+  // The first halves are only stored once
+  EXPECT_LT(File::GetSize(m_path), IMAGE_SIZE * 2);
+
+  for (size_t i = 0; i < images.size(); ++i)
+  {
+    const auto rvz = DiscIO::CreateBlobReader(m_directory + "/" + std::to_string(i) + ".rvz");
+    ASSERT_TRUE(rvz);
+    ASSERT_EQ(rvz->GetBlobType(), DiscIO::BlobType::RVZ);
+    ASSERT_EQ(rvz->GetDataSize(), IMAGE_SIZE);
+
+    std::vector<u8> data(IMAGE_SIZE);
+    ASSERT_TRUE(rvz->Read(0, data.size(), data.data()));
+    EXPECT_EQ(data, images[i]);
+  }
+}
@@ -0,0 +1,74 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "DiscIO/WIACompression.h"
+
+using namespace DiscIO;
+
+// Samples which have a lot in common with each other, but not much within themselves
+static std::vector<u8> MakeSample(const std::vector<u8>& common, std::mt19937* rng)
+{
+  std::vector<u8> sample;
+  for (size_t i = 0; i < common.size(); i += 0x40)
+  {
+    for (size_t j = 0; j < 0x10; ++j)
+      sample.push_back(static_cast<u8>((*rng)()));
+    sample.insert(sample.end(), common.begin() + i, common.begin() + i + 0x40);
+  }
+  return sample;
+}
+
+static std::optional<std::vector<u8>> Compress(const std::vector<u8>& data,
+                                               std::shared_ptr<const ZSTD_CDict> dictionary)
+{
+  ZstdCompressor compressor(5, std::move(dictionary));
+  if (!compressor.Start(data.size()) || !compressor.Compress(data.data(), data.size()) ||
+      !compressor.End())
+  {
+    return std::nullopt;
+  }
+  return std::vector<u8>(compressor.GetData(), compressor.GetData() + compressor.GetSize());
+}
+
+TEST(WIACompression, ZstdDictionary)
+{
+  std::mt19937 rng(0);
+  std::vector<u8> common(0x2000);
+  for (u8& byte : common)
+    byte = static_cast<u8>(rng());
+
+  std::vector<std::vector<u8>> samples;
+  for (int i = 0; i < 64; ++i)
+    samples.push_back(MakeSample(common, &rng));
+
+  constexpr size_t MAX_SIZE = 0x4000;
+  const std::vector<u8> dictionary = TrainZstdDictionary(samples, MAX_SIZE);
+  ASSERT_FALSE(dictionary.empty());
+  EXPECT_LE(dictionary.size(), MAX_SIZE);
+
+  const auto cdict = CreateZstdCDict(dictionary, 5);
+  const auto ddict = CreateZstdDDict(dictionary);
+  ASSERT_TRUE(cdict && ddict);
+
+  const std::vector<u8> data = MakeSample(common, &rng);
+  const std::optional<std::vector<u8>> without_dictionary = Compress(data, nullptr);
+  const std::optional<std::vector<u8>> with_dictionary = Compress(data, cdict);
+  ASSERT_TRUE(without_dictionary && with_dictionary);
+  EXPECT_LT(with_dictionary->size() * 2, without_dictionary->size());
+
+  DecompressionBuffer in{*with_dictionary, with_dictionary->size()};
+  DecompressionBuffer out{std::vector<u8>(data.size())};
+  size_t in_bytes_read = 0;
+  ZstdDecompressor decompressor(ddict);
+  while (!decompressor.Done())
+    ASSERT_TRUE(decompressor.Decompress(in, &out, &in_bytes_read));
+  EXPECT_EQ(out.data, data);
+}
@@ -0,0 +1,115 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Measures the throughput of the Wii partition encryption, decryption and hashing that conversion
+// and verification of Wii disc images are bound by. This is not a test. Build the
+// WiiCryptoBenchmark target and run it to compare the batched functions with the per-block ones.
+
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/Crypto/SHA1.h"
+#include "DiscIO/VolumeWii.h"
+
+#include "../../BenchmarkUtil.h"
+
+using DiscIO::VolumeWii;
+
+constexpr size_t GROUPS = 32;
+constexpr size_t BLOCKS = GROUPS * VolumeWii::BLOCKS_PER_GROUP;
+constexpr size_t ITERATIONS = 4;
+
+int main()
+{
+  fmt::print("AES: {}, SHA-1: {}\n", cpu_info.bAES ? "accelerated" : "generic",
+             cpu_info.bSHA1 ? "accelerated" : "generic");
+
+  const Benchmark benchmark(
+      "MiB", static_cast<double>(GROUPS * VolumeWii::GROUP_DATA_SIZE) / 0x100000, ITERATIONS);
+
+  const std::array<u8, VolumeWii::AES_KEY_SIZE> key{};
+  const auto encrypt = Common::AES::CreateContextEncrypt(key.data());
+  const auto decrypt = Common::AES::CreateContextDecrypt(key.data());
+
+  std::vector<std::array<u8, VolumeWii::BLOCK_DATA_SIZE>> data(BLOCKS);
+  for (size_t i = 0; i < BLOCKS; ++i)
+  {
+    for (size_t j = 0; j < VolumeWii::BLOCK_DATA_SIZE; ++j)
+      data[i][j] = static_cast<u8>(i * 31 + j * 7);
+  }
+  std::vector<VolumeWii::HashBlock> hashes(BLOCKS);
+  std::vector<u8> encrypted(BLOCKS * VolumeWii::BLOCK_TOTAL_SIZE);
+  std::vector<std::array<u8, VolumeWii::BLOCK_DATA_SIZE>> decrypted(BLOCKS);
+
+  benchmark.Measure("Hash (per block)", [&] {
+    for (size_t i = 0; i < BLOCKS; ++i)
+    {
+      for (size_t j = 0; j < hashes[i].h0.size(); ++j)
+        hashes[i].h0[j] = Common::SHA1::CalculateDigest(data[i].data() + j * 0x400, 0x400);
+    }
+  });
+
+  benchmark.Measure("Hash (batched)", [&] {
+    for (size_t i = 0; i < BLOCKS; ++i)
+    {
+      Common::SHA1::CalculateDigests(data[i].data(), 0x400, hashes[i].h0.size(),
+                                     hashes[i].h0.data());
+    }
+  });
+
+  benchmark.Measure("Hash group (multithreaded)", [&] {
+    for (size_t i = 0; i < GROUPS; ++i)
+    {
+      VolumeWii::HashGroup(&data[i * VolumeWii::BLOCKS_PER_GROUP],
+                           &hashes[i * VolumeWii::BLOCKS_PER_GROUP]);
+    }
+  });
+
+  benchmark.Measure("Encrypt (per block)", [&] {
+    for (size_t i = 0; i < BLOCKS; ++i)
+    {
+      u8* out_ptr = encrypted.data() + i * VolumeWii::BLOCK_TOTAL_SIZE;
+      encrypt->CryptIvZero(reinterpret_cast<const u8*>(&hashes[i]), out_ptr,
+                           VolumeWii::BLOCK_HEADER_SIZE);
+      encrypt->Crypt(out_ptr + 0x3D0, data[i].data(), out_ptr + VolumeWii::BLOCK_HEADER_SIZE,
+                     VolumeWii::BLOCK_DATA_SIZE);
+    }
+  });
+
+  benchmark.Measure("Encrypt (batched)", [&] {
+    for (size_t i = 0; i < GROUPS; ++i)
+    {
+      const size_t first_block = i * VolumeWii::BLOCKS_PER_GROUP;
+      VolumeWii::EncryptBlocks(&hashes[first_block], &data[first_block],
+                               encrypted.data() + first_block * VolumeWii::BLOCK_TOTAL_SIZE,
+                               VolumeWii::BLOCKS_PER_GROUP, encrypt.get());
+    }
+  });
+
+  benchmark.Measure("Decrypt (per block)", [&] {
+    for (size_t i = 0; i < BLOCKS; ++i)
+    {
+      VolumeWii::DecryptBlockData(encrypted.data() + i * VolumeWii::BLOCK_TOTAL_SIZE,
+                                  decrypted[i].data(), decrypt.get());
+    }
+  });
+
+  benchmark.Measure("Decrypt (batched)", [&] {
+    VolumeWii::DecryptBlocksData(encrypted.data(), decrypted.data(), BLOCKS, decrypt.get());
+  });
+
+  if (decrypted != data)
+  {
+    fmt::print("Error: Decrypted data doesn't match the original data\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <numeric>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Core/StateChunkStore.h"
+
+#include "../TestUtil.h"
+
+using StateChunkStoreTest = TemporaryDirectoryTest;
+
+TEST_F(StateChunkStoreTest, SplitCoversInput)
+{
+  const std::vector<u8> data = MakeRandomData(0x123456, 1);
+  const std::vector<size_t> sizes = State::ChunkStore::Split(data);
+
+  EXPECT_EQ(std::accumulate(sizes.begin(), sizes.end(), size_t(0)), data.size());
+  for (size_t i = 0; i + 1 < sizes.size(); ++i)
+  {
+    EXPECT_GE(sizes[i], 0x1000u);
+    EXPECT_LE(sizes[i], 0x10000u);
+  }
+}
+
+TEST_F(StateChunkStoreTest, SplitResynchronizesAfterInsertion)
+{
+  const std::vector<u8> data = MakeRandomData(0x100000, 2);
+  std::vector<u8> shifted = MakeRandomData(100, 3);
+  shifted.insert(shifted.end(), data.begin(), data.end());
+
+  State::ChunkStore store(m_directory);
+  const auto manifest = store.Store(data);
+  const auto shifted_manifest = store.Store(shifted);
+  ASSERT_TRUE(manifest && shifted_manifest);
+
+  // Apart from the first few chunks, the inserted bytes shouldn't change the chunking.
+  std::set<State::ChunkHash> hashes;
+  for (const State::ChunkReference& reference : *manifest)
+    hashes.insert(reference.hash);
+  size_t shared = 0;
+  for (const State::ChunkReference& reference : *shifted_manifest)
+    shared += hashes.contains(reference.hash);
+  EXPECT_GE(shared + 2, manifest->size());
+}
+
+TEST_F(StateChunkStoreTest, RoundTrip)
+{
+  std::vector<u8> data = MakeRandomData(0x80000, 4);
+  data.resize(0x100000);  // Zeroed tail, like unused emulated memory
+
+  {
+    State::ChunkStore store(m_directory);
+    const auto manifest = store.Store(data);
+    ASSERT_TRUE(manifest);
+
+    std::vector<u8> loaded;
+    ASSERT_TRUE(store.Load(*manifest, loaded));
+    EXPECT_EQ(loaded, data);
+  }
+
+  // Reopening has to rebuild the index from the pack file.
+  State::ChunkStore store(m_directory);
+  const u64 pack_size = store.GetPackSize();
+  const auto manifest = store.Store(data);
+  ASSERT_TRUE(manifest);
+  EXPECT_EQ(store.GetPackSize(), pack_size);
+
+  std::vector<u8> loaded;
+  ASSERT_TRUE(store.Load(*manifest, loaded));
+  EXPECT_EQ(loaded, data);
+}
+
+TEST_F(StateChunkStoreTest, CollectKeepsLiveChunks)
+{
+  State::ChunkStore store(m_directory);
+  const std::vector<u8> kept_data = MakeRandomData(0x40000, 5);
+  const std::vector<u8> dropped_data = MakeRandomData(0x40000, 6);
+  const auto kept = store.Store(kept_data);
+  const auto dropped = store.Store(dropped_data);
+  ASSERT_TRUE(kept && dropped);
+
+  std::set<State::ChunkHash> live;
+  for (const State::ChunkReference& reference : *kept)
+    live.insert(reference.hash);
+
+  u64 bytes_freed = 0;
+  ASSERT_TRUE(store.Collect(live, &bytes_freed));
+  EXPECT_GE(bytes_freed, dropped_data.size());
+  EXPECT_EQ(store.GetChunkCount(), live.size());
+
+  std::vector<u8> loaded;
+  ASSERT_TRUE(store.Load(*kept, loaded));
+  EXPECT_EQ(loaded, kept_data);
+  EXPECT_FALSE(store.Load(*dropped, loaded));
+}
+
+TEST_F(StateChunkStoreTest, IncompleteRecordIsDiscarded)
+{
+  const std::vector<u8> a = MakeRandomData(0x20000, 7);
+  const std::vector<u8> b = MakeRandomData(0x20000, 8);
+  const std::string pack_path = m_directory + "/chunks.pack";
+
+  std::optional<std::vector<State::ChunkReference>> manifest;
+  u64 pack_size;
+  {
+    State::ChunkStore store(m_directory);
+    manifest = store.Store(a);
+    ASSERT_TRUE(manifest);
+    pack_size = store.GetPackSize();
+    ASSERT_TRUE(store.Store(b));
+  }
+
+  // Simulate Dolphin stopping while b was being written
+  {
+    File::IOFile file(pack_path, "r+b");
+    ASSERT_TRUE(file.Resize(pack_size + 0x100));
+  }
+
+  State::ChunkStore store(m_directory);
+  EXPECT_EQ(store.GetPackSize(), pack_size);
+  EXPECT_EQ(File::GetSize(pack_path), pack_size);
+
+  std::vector<u8> loaded;
+  ASSERT_TRUE(store.Load(*manifest, loaded));
+  EXPECT_EQ(loaded, a);
+}
+
+TEST_F(StateChunkStoreTest, DamagedPackIsLeftAlone)
+{
+  const std::string pack_path = m_directory + "/chunks.pack";
+  {
+    State::ChunkStore store(m_directory);
+    ASSERT_TRUE(store.Store(MakeRandomData(0x20000, 9)));
+  }
+
+  // Make the stored size of the first record larger than its size
+  const u64 size = File::GetSize(pack_path);
+  {
+    File::IOFile file(pack_path, "r+b");
+    const u32 bad_stored_size = 0xFFFFFFFF;
+    ASSERT_TRUE(file.Seek(8 + 20, File::SeekOrigin::Begin));
+    ASSERT_TRUE(file.WriteArray(&bad_stored_size, 1));
+  }
+
+  State::ChunkStore store(m_directory);
+  EXPECT_FALSE(store.Store(MakeRandomData(0x1000, 10)));
+  EXPECT_EQ(File::GetSize(pack_path), size);
+}
+
+TEST_F(StateChunkStoreTest, PackInUseIsRejected)
+{
+  State::ChunkStore store(m_directory);
+  ASSERT_TRUE(store.Store(MakeRandomData(0x1000, 11)));
+
+  State::ChunkStore other_store(m_directory);
+  EXPECT_FALSE(other_store.Store(MakeRandomData(0x1000, 12)));
+}
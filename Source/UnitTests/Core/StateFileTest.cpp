@@ -0,0 +1,156 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Core/State.h"
+
+#include "../TestUtil.h"
+
+namespace
+{
+// Larger than two LZ4 blocks of the current format, so that ranges can span three of them
+constexpr size_t PAYLOAD_SIZE = 0x280000;
+constexpr u64 LZ4_BLOCK_SIZE = 0x100000;
+
+class StateFileTest : public TemporaryDirectoryTest
+{
+protected:
+  StateFileTest()
+      : m_payload(MakeRandomData(PAYLOAD_SIZE, 1)), m_uncompressed_path(m_directory + "/raw.sav"),
+        m_lz4_path(m_directory + "/lz4.sav")
+  {
+  }
+
+  void SetUp() override
+  {
+    TemporaryDirectoryTest::SetUp();
+
+    // Written by hand, as saving a state needs a running game
+    State::StateHeader header{};
+    State::StateExtendedBaseHeader base_header{};
+    base_header.header_version = 2;
+    base_header.compression_type = State::CompressionType::Uncompressed;
+    base_header.payload_offset =
+        sizeof(State::StateSectionIndexHeader) + sizeof(State::StateSectionIndexEntry);
+    base_header.uncompressed_size = m_payload.size();
+    const State::StateSectionIndexHeader section_index_header{1, 0};
+    State::StateSectionIndexEntry section{};
+    std::strcpy(section.name, "MEM1");
+    section.offset = 0x1000;
+    section.size = 0x2000;
+
+    File::IOFile f(m_uncompressed_path, "wb");
+    ASSERT_TRUE(f.WriteArray(&header.legacy_header, 1));
+    ASSERT_TRUE(f.WriteArray(&header.version_header, 1));
+    ASSERT_TRUE(f.WriteArray(&base_header, 1));
+    ASSERT_TRUE(f.WriteArray(&section_index_header, 1));
+    ASSERT_TRUE(f.WriteArray(&section, 1));
+    ASSERT_TRUE(f.WriteBytes(m_payload.data(), m_payload.size()));
+    ASSERT_TRUE(f.Close());
+
+    ASSERT_TRUE(
+        State::ConvertStateFile(m_uncompressed_path, m_lz4_path, State::CompressionType::LZ4));
+  }
+
+  void ExpectRange(const std::string& path, u64 offset, u64 size)
+  {
+    SCOPED_TRACE(testing::Message() << "offset " << offset << ", size " << size);
+    std::vector<u8> data;
+    ASSERT_TRUE(State::ReadStatePayloadRange(path, offset, size, data));
+    ASSERT_EQ(data.size(), size);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), m_payload.begin() + offset));
+  }
+
+  void ExpectRanges(const std::string& path)
+  {
+    // Within the first block
+    ExpectRange(path, 0x123, 0x4567);
+    // Within a later block, not touching its start or end
+    ExpectRange(path, LZ4_BLOCK_SIZE + 0x10, 0x100);
+    // Across the end of one block
+    ExpectRange(path, LZ4_BLOCK_SIZE - 0x80, 0x100);
+    // Across all three blocks
+    ExpectRange(path, 0x10, PAYLOAD_SIZE - 0x20);
+    // The end of the shorter last block
+    ExpectRange(path, PAYLOAD_SIZE - 0x100, 0x100);
+    ExpectRange(path, PAYLOAD_SIZE, 0);
+
+    std::vector<u8> data;
+    EXPECT_FALSE(State::ReadStatePayloadRange(path, PAYLOAD_SIZE - 0x10, 0x11, data));
+  }
+
+  std::vector<u8> m_payload;
+  std::string m_uncompressed_path;
+  std::string m_lz4_path;
+};
+}  // namespace
+
+TEST_F(StateFileTest, SectionIndexIsKept)
+{
+  State::StateHeader header;
+  State::StateExtendedHeader extended_header;
+  ASSERT_TRUE(State::ReadStateFileHeaders(m_lz4_path, header, extended_header));
+  EXPECT_EQ(extended_header.base_header.compression_type, State::CompressionType::LZ4);
+  EXPECT_EQ(extended_header.section_index_header.lz4_block_size, LZ4_BLOCK_SIZE);
+
+  const State::StateSectionIndexEntry* section = State::FindSection(extended_header, "MEM1");
+  ASSERT_NE(section, nullptr);
+  EXPECT_EQ(section->offset, 0x1000u);
+  EXPECT_EQ(section->size, 0x2000u);
+  EXPECT_EQ(State::FindSection(extended_header, "MEM2"), nullptr);
+}
+
+TEST_F(StateFileTest, UncompressedRange)
+{
+  ExpectRanges(m_uncompressed_path);
+}
+
+TEST_F(StateFileTest, LZ4Range)
+{
+  ExpectRanges(m_lz4_path);
+}
+
+TEST_F(StateFileTest, LZ4RangeWithVersion1Header)
+{
+  // Turn the LZ4 state into one with a version 1 extended header, which has no section index and
+  // so no block size. The whole payload then has to be decompressed.
+  std::vector<u8> file;
+  {
+    File::IOFile f(m_lz4_path, "rb");
+    file.resize(f.GetSize());
+    ASSERT_TRUE(f.ReadBytes(file.data(), file.size()));
+  }
+
+  const size_t base_header_offset =
+      sizeof(State::StateHeaderLegacy) + sizeof(State::StateHeaderVersion);
+  State::StateExtendedBaseHeader base_header;
+  std::memcpy(&base_header, file.data() + base_header_offset, sizeof(base_header));
+  const size_t payload_start =
+      base_header_offset + sizeof(base_header) + base_header.payload_offset;
+  base_header.header_version = 1;
+  base_header.payload_offset = 0;
+
+  const std::string v1_path = m_directory + "/v1.sav";
+  {
+    File::IOFile f(v1_path, "wb");
+    ASSERT_TRUE(f.WriteBytes(file.data(), base_header_offset));
+    ASSERT_TRUE(f.WriteArray(&base_header, 1));
+    ASSERT_TRUE(f.WriteBytes(file.data() + payload_start, file.size() - payload_start));
+  }
+
+  State::StateHeader header;
+  State::StateExtendedHeader extended_header;
+  ASSERT_TRUE(State::ReadStateFileHeaders(v1_path, header, extended_header));
+  EXPECT_EQ(extended_header.section_index_header.lz4_block_size, 0u);
+  EXPECT_TRUE(extended_header.sections.empty());
+
+  ExpectRanges(v1_path);
+}
@@ -0,0 +1,46 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+
+// Returns size bytes that are the same for the same seed
+inline std::vector<u8> MakeRandomData(size_t size, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+  return data;
+}
+
+// A fixture for tests which need files. m_directory is an empty directory that is deleted with
+// everything in it after the test.
+class TemporaryDirectoryTest : public testing::Test
+{
+protected:
+  TemporaryDirectoryTest() : m_directory(File::CreateTempDir()) {}
+
+  ~TemporaryDirectoryTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void SetUp() override
+  {
+    if (m_directory.empty())
+      FAIL();
+  }
+
+  std::string m_directory;
+};
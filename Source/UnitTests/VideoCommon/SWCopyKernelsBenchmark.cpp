@@ -0,0 +1,97 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Measures the throughput of the conversions that EFB copies in the software renderer are bound
+// by. This is not a test. Build the SWCopyKernelsBenchmark target and run it to compare the SIMD
+// kernels with the scalar ones.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/CopyKernels.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoCommon/VideoCommon.h"
+
+#include "../BenchmarkUtil.h"
+
+using EfbInterface::yuv444;
+
+constexpr u32 PIXELS = EFB_WIDTH * EFB_HEIGHT;
+constexpr size_t ITERATIONS = 16;
+
+// Encodes the whole EFB into blocks of 4 rows, which is how all the texture formats measured here
+// are laid out. Each row of a block takes 8 bytes.
+static void EncodeRows(void (*encode)(const u8*, u8*, bool), const std::vector<u8>& efb,
+                       std::vector<u8>* dst, u32 pixels_per_row, u32 block_size)
+{
+  for (u32 i = 0; i < PIXELS / pixels_per_row; ++i)
+    encode(&efb[i * pixels_per_row * 3], &(*dst)[i / 4 * block_size + i % 4 * 8], true);
+}
+
+int main()
+{
+  const Benchmark benchmark("Mpixels", PIXELS / 1000000.0, ITERATIONS);
+
+  // One byte of padding, since pixels are read 4 bytes at a time
+  std::vector<u8> efb(PIXELS * 3 + 1);
+  for (size_t i = 0; i < efb.size(); ++i)
+    efb[i] = static_cast<u8>(i * 31 + (i >> 8) * 7);
+
+  std::vector<u32> colors(PIXELS);
+  for (size_t i = 0; i < colors.size(); ++i)
+    colors[i] = static_cast<u32>(i * 2654435761u);
+
+  bool matches = true;
+  const auto compare = [&](const char* name, void (*encode)(const u8*, u8*, bool),
+                           void (*reference)(const u8*, u8*, bool), u32 pixels_per_row,
+                           u32 block_size) {
+    std::vector<u8> expected(PIXELS / pixels_per_row / 4 * block_size);
+    std::vector<u8> actual(expected.size());
+    benchmark.Measure(fmt::format("{} (scalar)", name),
+                      [&] { EncodeRows(reference, efb, &expected, pixels_per_row, block_size); });
+    benchmark.Measure(fmt::format("{} (SIMD)", name),
+                      [&] { EncodeRows(encode, efb, &actual, pixels_per_row, block_size); });
+    matches &= expected == actual;
+  };
+
+  compare("RGBA8", CopyKernels::EncodeRGBA8Row, CopyKernels::EncodeRGBA8RowScalar, 4, 64);
+  compare("RGB565", CopyKernels::EncodeRGB565Row, CopyKernels::EncodeRGB565RowScalar, 4, 32);
+  compare("I8", CopyKernels::EncodeI8Row, CopyKernels::EncodeI8RowScalar, 8, 32);
+
+  // A deflicker filter and a typical gamma
+  const std::array<u8, 7> coefficients{8, 8, 10, 12, 10, 8, 8};
+  std::array<u8, 256> gamma_lut;
+  for (u32 i = 0; i < gamma_lut.size(); ++i)
+    gamma_lut[i] = static_cast<u8>(std::pow(i / 255.0f, 1.0f / 2.2f) * 255.0f);
+
+  std::vector<yuv444> expected(PIXELS);
+  std::vector<yuv444> actual(PIXELS);
+  const auto filter = [&](decltype(&CopyKernels::FilterRowToYUV) function,
+                          std::vector<yuv444>* dst) {
+    for (u32 y = 0; y < EFB_HEIGHT; ++y)
+    {
+      const u32* above = &colors[(std::max<u32>(y, 1) - 1) * EFB_WIDTH];
+      const u32* row = &colors[y * EFB_WIDTH];
+      const u32* below = &colors[std::min<u32>(y + 1, EFB_HEIGHT - 1) * EFB_WIDTH];
+      function(above, row, below, EFB_WIDTH, coefficients, &gamma_lut, &(*dst)[y * EFB_WIDTH]);
+    }
+  };
+  benchmark.Measure("XFB (scalar)", [&] { filter(CopyKernels::FilterRowToYUVScalar, &expected); });
+  benchmark.Measure("XFB (SIMD)", [&] { filter(CopyKernels::FilterRowToYUV, &actual); });
+  matches &= std::memcmp(expected.data(), actual.data(), PIXELS * sizeof(yuv444)) == 0;
+
+  if (!matches)
+  {
+    fmt::print("Error: The SIMD kernels don't match the scalar ones\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/CopyKernels.h"
+#include "VideoBackends/Software/EfbInterface.h"
+
+#include "../TestUtil.h"
+
+using EfbInterface::yuv444;
+
+namespace
+{
+template <size_t pixels, size_t size>
+void ExpectRowsMatch(void (*encode)(const u8*, u8*, bool), void (*reference)(const u8*, u8*, bool))
+{
+  // One byte of padding, since pixels are read 4 bytes at a time
+  const std::vector<u8> efb = MakeRandomData(pixels * 3 * 256 + 1, 1);
+
+  for (bool rgba6 : {true, false})
+  {
+    for (size_t i = 0; i < 256; ++i)
+    {
+      std::array<u8, size> expected{};
+      std::array<u8, size> actual{};
+      reference(&efb[i * pixels * 3], expected.data(), rgba6);
+      encode(&efb[i * pixels * 3], actual.data(), rgba6);
+      ASSERT_EQ(expected, actual) << "row " << i << ", rgba6 " << rgba6;
+    }
+  }
+}
+}  // namespace
+
+TEST(SWCopyKernels, RGBA8MatchesScalar)
+{
+  ExpectRowsMatch<4, 64>(CopyKernels::EncodeRGBA8Row, CopyKernels::EncodeRGBA8RowScalar);
+}
+
+TEST(SWCopyKernels, RGB565MatchesScalar)
+{
+  ExpectRowsMatch<4, 8>(CopyKernels::EncodeRGB565Row, CopyKernels::EncodeRGB565RowScalar);
+}
+
+TEST(SWCopyKernels, I8MatchesScalar)
+{
+  ExpectRowsMatch<8, 8>(CopyKernels::EncodeI8Row, CopyKernels::EncodeI8RowScalar);
+}
+
+TEST(SWCopyKernels, RGB565FromRGBA6)
+{
+  // Red 0x3f, green 0x20, blue 0x01 and alpha 0x3f, stored little endian
+  const std::array<u8, 16> efb = {0x7f, 0x00, 0xfe, 0x7f, 0x00, 0xfe, 0x7f,
+                                  0x00, 0xfe, 0x7f, 0x00, 0xfe, 0x00};
+  std::array<u8, 8> dst{};
+  CopyKernels::EncodeRGB565Row(efb.data(), dst.data(), true);
+  for (size_t i = 0; i < dst.size(); i += 2)
+  {
+    EXPECT_EQ(dst[i], 0xfc);
+    EXPECT_EQ(dst[i + 1], 0x00);
+  }
+}
+
+TEST(SWCopyKernels, FilterRowToYUVMatchesScalar)
+{
+  constexpr u32 WIDTH = 643;
+  std::mt19937 rng(2);
+
+  std::array<std::vector<u32>, 3> rows;
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    const std::vector<u8> data = MakeRandomData(WIDTH * sizeof(u32), static_cast<u32>(i + 3));
+    rows[i].resize(WIDTH);
+    std::memcpy(rows[i].data(), data.data(), data.size());
+  }
+
+  std::array<u8, 256> gamma_lut;
+  for (u32 i = 0; i < gamma_lut.size(); ++i)
+    gamma_lut[i] = static_cast<u8>(std::pow(i / 255.0f, 1.0f / 2.2f) * 255.0f);
+
+  for (int iteration = 0; iteration < 64; ++iteration)
+  {
+    std::array<u8, 7> coefficients;
+    for (u8& coefficient : coefficients)
+      coefficient = static_cast<u8>(rng() & 0x3f);
+    const std::array<u8, 256>* lut = iteration % 2 ? &gamma_lut : nullptr;
+    const u32 count = WIDTH - iteration % 4;
+
+    std::vector<yuv444> expected(count);
+    std::vector<yuv444> actual(count);
+    CopyKernels::FilterRowToYUVScalar(rows[0].data(), rows[1].data(), rows[2].data(), count,
+                                      coefficients, lut, expected.data());
+    CopyKernels::FilterRowToYUV(rows[0].data(), rows[1].data(), rows[2].data(), count,
+                                coefficients, lut, actual.data());
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      ASSERT_EQ(expected[i].Y, actual[i].Y) << "pixel " << i << ", iteration " << iteration;
+      ASSERT_EQ(expected[i].U, actual[i].U) << "pixel " << i << ", iteration " << iteration;
+      ASSERT_EQ(expected[i].V, actual[i].V) << "pixel " << i << ", iteration " << iteration;
+    }
+  }
+}
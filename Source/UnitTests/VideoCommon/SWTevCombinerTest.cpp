@@ -0,0 +1,117 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/TevCombiner.h"
+#include "VideoCommon/BPMemory.h"
+
+using TevCombiner::Channels;
+
+namespace
+{
+// Channel order used by the combiners
+constexpr int ALP_C = 0;
+constexpr int RED_C = 3;
+
+TevCombiner::Inputs MakeInputs(s16 a, s16 b, s16 c, s16 d)
+{
+  return {{a, a, a, a}, {b, b, b, b}, {c, c, c, c}, {d, d, d, d}};
+}
+
+TevStageCombiner::ColorCombiner MakeColorCombiner(u32 bias, u32 op, bool clamp, u32 scale)
+{
+  TevStageCombiner::ColorCombiner cc;
+  cc.hex = 0;
+  cc.bias = static_cast<TevBias>(bias);
+  cc.op = static_cast<TevOp>(op);
+  cc.clamp = clamp;
+  cc.scale = static_cast<TevScale>(scale);
+  return cc;
+}
+
+TevStageCombiner::AlphaCombiner MakeAlphaCombiner(u32 bias, u32 op, bool clamp, u32 scale)
+{
+  TevStageCombiner::AlphaCombiner ac;
+  ac.hex = 0;
+  ac.bias = static_cast<TevBias>(bias);
+  ac.op = static_cast<TevOp>(op);
+  ac.clamp = clamp;
+  ac.scale = static_cast<TevScale>(scale);
+  return ac;
+}
+}  // namespace
+
+TEST(SWTevCombiner, Lerp)
+{
+  const auto cc = MakeColorCombiner(0, 0, true, 0);
+  const auto ac = MakeAlphaCombiner(0, 0, true, 0);
+  const TevCombiner::Stage stage = TevCombiner::SetUpStage(cc, ac);
+  ASSERT_TRUE(stage.is_regular);
+
+  const TevCombiner::Inputs inputs = MakeInputs(0, 255, 128, 0);
+  EXPECT_EQ(TevCombiner::CombineScalar(cc, ac, inputs), (Channels{128, 128, 128, 128}));
+  EXPECT_EQ(TevCombiner::Combine(stage, inputs), (Channels{128, 128, 128, 128}));
+}
+
+TEST(SWTevCombiner, SubtractionRoundsDifferentlyForColorAndAlpha)
+{
+  const auto cc = MakeColorCombiner(0, 1, false, 0);
+  const auto ac = MakeAlphaCombiner(0, 1, false, 0);
+  const TevCombiner::Stage stage = TevCombiner::SetUpStage(cc, ac);
+
+  // The color combiner negates after shifting the lerp down, and the alpha combiner before
+  const TevCombiner::Inputs inputs = MakeInputs(1, 0, 0, 0);
+  const Channels expected = TevCombiner::CombineScalar(cc, ac, inputs);
+  EXPECT_EQ(expected[RED_C], -1);
+  EXPECT_EQ(expected[ALP_C], -2);
+  EXPECT_EQ(TevCombiner::Combine(stage, inputs), expected);
+}
+
+TEST(SWTevCombiner, CompareStagesAreNotRegular)
+{
+  EXPECT_FALSE(TevCombiner::SetUpStage(MakeColorCombiner(3, 0, true, 0),
+                                       MakeAlphaCombiner(0, 0, true, 0))
+                   .is_regular);
+  EXPECT_FALSE(TevCombiner::SetUpStage(MakeColorCombiner(0, 0, true, 0),
+                                       MakeAlphaCombiner(3, 0, true, 0))
+                   .is_regular);
+}
+
+TEST(SWTevCombiner, MatchesScalarForAllRegularModes)
+{
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> full_range(-32768, 32767);
+  std::uniform_int_distribution<int> register_range(-1024, 1023);
+
+  for (u32 color_mode = 0; color_mode < 48; ++color_mode)
+  {
+    const auto cc = MakeColorCombiner(color_mode % 3, color_mode / 3 % 2, color_mode / 6 % 2,
+                                      color_mode / 12);
+    for (u32 alpha_mode = 0; alpha_mode < 48; ++alpha_mode)
+    {
+      const auto ac = MakeAlphaCombiner(alpha_mode % 3, alpha_mode / 3 % 2, alpha_mode / 6 % 2,
+                                        alpha_mode / 12);
+      const TevCombiner::Stage stage = TevCombiner::SetUpStage(cc, ac);
+      ASSERT_TRUE(stage.is_regular);
+
+      for (int i = 0; i < 64; ++i)
+      {
+        // Mostly values that registers can hold, but also ones that have to be truncated
+        auto& distribution = i % 4 == 0 ? full_range : register_range;
+        TevCombiner::Inputs inputs;
+        for (Channels* channels : {&inputs.a, &inputs.b, &inputs.c, &inputs.d})
+        {
+          for (s16& value : *channels)
+            value = static_cast<s16>(distribution(rng));
+        }
+
+        ASSERT_EQ(TevCombiner::Combine(stage, inputs), TevCombiner::CombineScalar(cc, ac, inputs))
+            << "color " << cc.hex << " alpha " << ac.hex << " input " << i;
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Measures the throughput of the CPU texture decoders, which texture cache misses are bound by.
+// This is not a test. Build the TextureDecoderBenchmark target and run it to compare the decoders
+// for each set of instructions this CPU supports.
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#include "../BenchmarkUtil.h"
+
+constexpr int WIDTH = 1024;
+constexpr int HEIGHT = 1024;
+constexpr size_t ITERATIONS = 16;
+
+int main()
+{
+  const Benchmark benchmark("Mtexels", WIDTH * HEIGHT / 1000000.0, ITERATIONS);
+
+  std::vector<u8> src(WIDTH * HEIGHT * 4);
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = static_cast<u8>(i * 31 + (i >> 8) * 7);
+  std::vector<u8> tlut(2 << 14);
+  for (size_t i = 0; i < tlut.size(); ++i)
+    tlut[i] = static_cast<u8>(i * 13);
+  std::vector<u8> dst(WIDTH * HEIGHT * 4);
+
+  const std::pair<const char*, TextureFormat> formats[] = {
+      {"I4", TextureFormat::I4},         {"I8", TextureFormat::I8},
+      {"IA4", TextureFormat::IA4},       {"IA8", TextureFormat::IA8},
+      {"RGB565", TextureFormat::RGB565}, {"RGB5A3", TextureFormat::RGB5A3},
+      {"RGBA8", TextureFormat::RGBA8},   {"CMPR", TextureFormat::CMPR},
+      {"C8", TextureFormat::C8},
+  };
+
+  const auto measure_all = [&](const char* instruction_set) {
+    for (const auto& [name, format] : formats)
+    {
+      benchmark.Measure(fmt::format("{} ({})", name, instruction_set), [&] {
+        TexDecoder_Decode(dst.data(), src.data(), WIDTH, HEIGHT, format, tlut.data(),
+                          TLUTFormat::RGB5A3);
+      });
+    }
+  };
+
+#if defined(_M_X86_64)
+  const CPUInfo original = cpu_info;
+  cpu_info.bSSSE3 = false;
+  cpu_info.bAVX2 = false;
+  measure_all("SSE2");
+  if (original.bSSSE3)
+  {
+    cpu_info.bSSSE3 = true;
+    measure_all("SSSE3");
+  }
+  if (original.bAVX2)
+  {
+    cpu_info.bAVX2 = true;
+    measure_all("AVX2");
+  }
+  cpu_info = original;
+#elif defined(_M_ARM_64)
+  measure_all("NEON");
+#else
+  measure_all("generic");
+#endif
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ParallelTextureDecoder.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/TextureDecoder_Util.h"
+
+#include "../TestUtil.h"
+
+namespace
+{
+constexpr int WIDTH = 40;
+constexpr int HEIGHT = 24;
+
+// Runs the function once for every set of instructions the decoders can pick between on this CPU
+void ForEachInstructionSet(const std::function<void()>& function)
+{
+#if defined(_M_X86_64)
+  const CPUInfo original = cpu_info;
+  const auto run = [&](const char* name, bool ssse3, bool avx2) {
+    SCOPED_TRACE(name);
+    cpu_info.bSSSE3 = ssse3;
+    cpu_info.bAVX2 = avx2;
+    function();
+  };
+
+  run("SSE2", false, false);
+  if (original.bSSSE3)
+    run("SSSE3", true, false);
+  if (original.bAVX2)
+    run("AVX2", original.bSSSE3, true);
+
+  cpu_info = original;
+#else
+  function();
+#endif
+}
+
+// Decodes a whole texture, and compares each texel with the one TexDecoder_DecodeTexel decodes
+void ExpectMatchesTexels(TextureFormat format, const std::vector<u8>& src,
+                         TLUTFormat tlut_format = TLUTFormat::IA8)
+{
+  const int size = TexDecoder_GetTextureSizeInBytes(WIDTH, HEIGHT, format);
+  ASSERT_GE(src.size(), static_cast<size_t>(size));
+
+  // Large enough for the 14-bit indices of C14X2
+  const std::vector<u8> tlut = MakeRandomData(2 << 14, 1);
+
+  ForEachInstructionSet([&] {
+    std::vector<u32> decoded(WIDTH * HEIGHT);
+    TexDecoder_Decode(reinterpret_cast<u8*>(decoded.data()), src.data(), WIDTH, HEIGHT, format,
+                      tlut.data(), tlut_format);
+
+    for (int t = 0; t < HEIGHT; ++t)
+    {
+      for (int s = 0; s < WIDTH; ++s)
+      {
+        u32 expected;
+        TexDecoder_DecodeTexel(reinterpret_cast<u8*>(&expected), src, s, t, WIDTH - 1, format,
+                               tlut, tlut_format);
+        ASSERT_EQ(expected, decoded[t * WIDTH + s]) << "texel " << s << ", " << t;
+      }
+    }
+  });
+}
+
+void ExpectMatchesTexels(TextureFormat format)
+{
+  ExpectMatchesTexels(format, MakeRandomData(WIDTH * HEIGHT * 4, 2));
+}
+}  // namespace
+
+TEST(TextureDecoder, I4)
+{
+  ExpectMatchesTexels(TextureFormat::I4);
+}
+
+TEST(TextureDecoder, I8)
+{
+  ExpectMatchesTexels(TextureFormat::I8);
+}
+
+TEST(TextureDecoder, IA4)
+{
+  ExpectMatchesTexels(TextureFormat::IA4);
+}
+
+TEST(TextureDecoder, IA8)
+{
+  ExpectMatchesTexels(TextureFormat::IA8);
+}
+
+TEST(TextureDecoder, RGB565)
+{
+  ExpectMatchesTexels(TextureFormat::RGB565);
+}
+
+TEST(TextureDecoder, RGB5A3)
+{
+  ExpectMatchesTexels(TextureFormat::RGB5A3);
+
+  // Rows where all texels are RGB555 or all are RGBA4443 take other paths
+  std::vector<u8> src = MakeRandomData(WIDTH * HEIGHT * 2, 3);
+  for (size_t i = 0; i < src.size(); i += 2)
+  {
+    const size_t row = i / 8;
+    if (row % 3 == 0)
+      src[i] |= 0x80;
+    else if (row % 3 == 1)
+      src[i] &= 0x7f;
+  }
+  ExpectMatchesTexels(TextureFormat::RGB5A3, src);
+}
+
+TEST(TextureDecoder, RGBA8)
+{
+  ExpectMatchesTexels(TextureFormat::RGBA8);
+}
+
+TEST(TextureDecoder, CMPR)
+{
+  ExpectMatchesTexels(TextureFormat::CMPR);
+
+  // Blocks with both colors equal use the transparent fourth color
+  std::vector<u8> src = MakeRandomData(WIDTH * HEIGHT / 2, 4);
+  for (size_t i = 0; i < src.size(); i += sizeof(DXTBlock))
+  {
+    src[i + 2] = src[i];
+    src[i + 3] = src[i + 1];
+  }
+  ExpectMatchesTexels(TextureFormat::CMPR, src);
+}
+
+TEST(TextureDecoder, Paletted)
+{
+  for (TLUTFormat tlut_format : {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3})
+  {
+    const std::vector<u8> src = MakeRandomData(WIDTH * HEIGHT * 2, 5);
+    ExpectMatchesTexels(TextureFormat::C4, src, tlut_format);
+    ExpectMatchesTexels(TextureFormat::C8, src, tlut_format);
+    ExpectMatchesTexels(TextureFormat::C14X2, src, tlut_format);
+  }
+}
+
+TEST(TextureDecoder, ParallelMatchesSerial)
+{
+  // A mip chain that is split into pieces, where the last piece of the first level is shorter
+  const std::vector<std::pair<u32, u32>> levels = {{1032, 520}, {512, 256}, {136, 72}, {8, 8}};
+  const std::vector<u8> tlut = MakeRandomData(512, 6);
+
+  VideoCommon::ParallelTextureDecoder decoder(4);
+  for (TextureFormat format : {TextureFormat::I4, TextureFormat::C8, TextureFormat::RGBA8,
+                               TextureFormat::CMPR})
+  {
+    std::vector<std::vector<u8>> src;
+    std::vector<std::vector<u32>> expected;
+    std::vector<std::vector<u32>> actual;
+    for (const auto& [width, height] : levels)
+    {
+      src.push_back(MakeRandomData(TexDecoder_GetTextureSizeInBytes(width, height, format), 7));
+      expected.emplace_back(width * height);
+      actual.emplace_back(width * height);
+
+      TexDecoder_Decode(reinterpret_cast<u8*>(expected.back().data()), src.back().data(), width,
+                        height, format, tlut.data(), TLUTFormat::RGB5A3);
+      decoder.Add(reinterpret_cast<u8*>(actual.back().data()), src.back().data(), width, height,
+                  format, tlut.data(), TLUTFormat::RGB5A3);
+    }
+    decoder.Run();
+
+    for (size_t i = 0; i < levels.size(); ++i)
+      EXPECT_EQ(expected[i], actual[i]) << "format " << static_cast<int>(format) << ", level " << i;
+  }
+}
@@ -39,3 +39,32 @@ def load_from_bytes(state_bytes: bytes, /) -> None:
     """
     Loads a savestate from the given bytes.
     """
+
+
+def prefetch_slot(slot: int, /) -> None:
+    """
+    Reads and decompresses the savestate in the given slot in the background,
+    so that a later load_from_slot of it only has to apply it.
+    The most recently prefetched savestate stays cached until another one
+    is prefetched or the savestate is overwritten.
+    The slot number must be between 0 and 99.
+    """
+
+
+def prefetch_file(filename: str, /) -> None:
+    """
+    Reads and decompresses the savestate in the given file in the background,
+    so that a later load_from_file of it only has to apply it.
+    The most recently prefetched savestate stays cached until another one
+    is prefetched or the savestate is overwritten.
+    """
+
+
+def compute_hash() -> bytes:
+    """
+    Computes a 128-bit hash of the current emulated state without creating
+    a savestate, and returns it as 16 bytes.
+    Two states with the same hash can be considered identical, which allows
+    e.g. input searches to skip states they have already visited.
+    Host-only state like the texture cache is not part of the hash.
+    """